@@ -87,7 +87,9 @@ ASM_FILES += \
 OTHER_FILES += \
     evt/fortevt.mc \
     loader/fort.rsa.pub \
-    scripts/*.bat
+    scripts/*.bat \
+    test/compat/*.h \
+    test/fortconf_fuzz.c
 
 # Windows
 LIBS *= -lntdll
@@ -114,14 +114,16 @@ static BOOL fort_conf_ip6_find(
 
 #define fort_conf_addr_list_pair6_ref(addr6_list) &(addr6_list)->ip[(addr6_list)->ip_n]
 
+#define fort_conf_addr6_list_ref(addr_list)                                                        \
+    ((PFORT_CONF_ADDR6_LIST) ((const PCHAR) (addr_list)                                            \
+            + FORT_CONF_ADDR4_LIST_SIZE((addr_list)->ip_n, (addr_list)->pair_n)))
+
 FORT_API BOOL fort_conf_ip_inlist(
         const UINT32 *ip, const PFORT_CONF_ADDR4_LIST addr_list, BOOL isIPv6)
 {
     if (isIPv6) {
         const ip6_addr_t *ip6 = (const ip6_addr_t *) ip;
-        const PFORT_CONF_ADDR6_LIST addr6_list =
-                (const PFORT_CONF_ADDR6_LIST)((const PCHAR) addr_list
-                        + FORT_CONF_ADDR4_LIST_SIZE(addr_list->ip_n, addr_list->pair_n));
+        const PFORT_CONF_ADDR6_LIST addr6_list = fort_conf_addr6_list_ref(addr_list);
 
         return fort_conf_ip6_inarr(fort_conf_addr_list_ip6_ref(addr6_list), ip6, addr6_list->ip_n)
                 || fort_conf_ip6_inrange(
@@ -133,6 +135,485 @@ FORT_API BOOL fort_conf_ip_inlist(
     }
 }
 
+FORT_API UINT32 fort_conf_addr_list_size(const PFORT_CONF_ADDR4_LIST addr_list)
+{
+    const PFORT_CONF_ADDR6_LIST addr6_list = fort_conf_addr6_list_ref(addr_list);
+
+    return FORT_CONF_ADDR_LIST_SIZE(
+            addr_list->ip_n, addr_list->pair_n, addr6_list->ip_n, addr6_list->pair_n);
+}
+
+typedef struct fort_conf_ip_arr
+{
+    char *from;
+    char *to; /* NULL for single addresses */
+
+    UINT32 n;
+} FORT_CONF_IP_ARR, *PFORT_CONF_IP_ARR;
+
+static int fort_conf_ip_cmp(const char *l, const char *r, UINT32 ip_size)
+{
+    if (ip_size == sizeof(UINT32)) {
+        const UINT32 l4 = *((const UINT32 *) l);
+        const UINT32 r4 = *((const UINT32 *) r);
+
+        return (l4 < r4) ? -1 : (l4 > r4);
+    }
+
+    return fort_memcmp(l, r, ip_size);
+}
+
+static void fort_conf_ip_arr_init(
+        PFORT_CONF_IP_ARR arr, const char *ip, UINT32 n, BOOL is_range, UINT32 ip_size)
+{
+    arr->from = (char *) ip;
+    arr->to = is_range ? (char *) ip + n * ip_size : NULL;
+    arr->n = n;
+}
+
+static void fort_conf_ip_arr_copy(PFORT_CONF_IP_ARR dst, UINT32 dst_index,
+        const PFORT_CONF_IP_ARR src, UINT32 src_index, UINT32 ip_size)
+{
+    RtlMoveMemory(dst->from + dst_index * ip_size, src->from + src_index * ip_size, ip_size);
+
+    if (dst->to != NULL) {
+        RtlMoveMemory(dst->to + dst_index * ip_size, src->to + src_index * ip_size, ip_size);
+    }
+}
+
+static BOOL fort_conf_ip_arr_equal(const PFORT_CONF_IP_ARR l, UINT32 l_index,
+        const PFORT_CONF_IP_ARR r, UINT32 r_index, UINT32 ip_size)
+{
+    return fort_conf_ip_cmp(l->from + l_index * ip_size, r->from + r_index * ip_size, ip_size) == 0
+            && (l->to == NULL
+                    || fort_conf_ip_cmp(l->to + l_index * ip_size, r->to + r_index * ip_size,
+                               ip_size)
+                            == 0);
+}
+
+/* Copy the sorted addresses except the removed ones */
+static BOOL fort_conf_ip_arr_remove(const PFORT_CONF_IP_ARR arr, const PFORT_CONF_IP_ARR removed,
+        PFORT_CONF_IP_ARR out, UINT32 ip_size)
+{
+    if (removed->n > arr->n)
+        return FALSE;
+
+    /* The out array is sized for the found removed addresses only */
+    const UINT32 out_n = arr->n - removed->n;
+
+    UINT32 j = 0;
+
+    out->n = 0;
+
+    for (UINT32 i = 0; i < arr->n; ++i) {
+        if (j < removed->n && fort_conf_ip_arr_equal(arr, i, removed, j, ip_size)) {
+            ++j;
+            continue;
+        }
+
+        /* All removed addresses must be found */
+        if (out->n == out_n)
+            return FALSE;
+
+        fort_conf_ip_arr_copy(out, out->n++, arr, i, ip_size);
+    }
+
+    return j == removed->n;
+}
+
+/* Merge the sorted added addresses in place, from the back */
+static BOOL fort_conf_ip_arr_merge(
+        PFORT_CONF_IP_ARR out, const PFORT_CONF_IP_ARR added, UINT32 ip_size)
+{
+    UINT32 i = out->n;
+    UINT32 k = added->n;
+    UINT32 o = out->n + added->n;
+
+    while (k > 0) {
+        --o;
+
+        if (i > 0) {
+            const int res = fort_conf_ip_cmp(
+                    out->from + (i - 1) * ip_size, added->from + (k - 1) * ip_size, ip_size);
+
+            if (res == 0)
+                return FALSE; /* Duplicate address */
+
+            if (res > 0) {
+                fort_conf_ip_arr_copy(out, o, out, --i, ip_size);
+                continue;
+            }
+        }
+
+        fort_conf_ip_arr_copy(out, o, added, --k, ip_size);
+    }
+
+    out->n += added->n;
+
+    return TRUE;
+}
+
+static BOOL fort_conf_ip_arr_patch(const char *ip, UINT32 n, const char *removed_ip,
+        UINT32 removed_n, const char *added_ip, UINT32 added_n, char *out_ip, BOOL is_range,
+        UINT32 ip_size)
+{
+    FORT_CONF_IP_ARR arr, removed, added, out;
+
+    fort_conf_ip_arr_init(&arr, ip, n, is_range, ip_size);
+    fort_conf_ip_arr_init(&removed, removed_ip, removed_n, is_range, ip_size);
+    fort_conf_ip_arr_init(&added, added_ip, added_n, is_range, ip_size);
+    fort_conf_ip_arr_init(&out, out_ip, n - removed_n + added_n, is_range, ip_size);
+
+    return fort_conf_ip_arr_remove(&arr, &removed, &out, ip_size)
+            && fort_conf_ip_arr_merge(&out, &added, ip_size);
+}
+
+static BOOL fort_conf_ip_count_patch(UINT32 n, UINT32 removed_n, UINT32 added_n, UINT32 *out_n)
+{
+    if (removed_n > n)
+        return FALSE;
+
+    *out_n = n - removed_n + added_n;
+
+    return *out_n < FORT_CONF_IP_MAX;
+}
+
+FORT_API UINT32 fort_conf_addr_list_patch_size(const PFORT_CONF_ADDR4_LIST addr_list,
+        const PFORT_CONF_ADDR4_LIST removed_list, const PFORT_CONF_ADDR4_LIST added_list)
+{
+    const PFORT_CONF_ADDR6_LIST addr6_list = fort_conf_addr6_list_ref(addr_list);
+    const PFORT_CONF_ADDR6_LIST removed6_list = fort_conf_addr6_list_ref(removed_list);
+    const PFORT_CONF_ADDR6_LIST added6_list = fort_conf_addr6_list_ref(added_list);
+
+    UINT32 ip4_n, pair4_n, ip6_n, pair6_n;
+
+    if (!fort_conf_ip_count_patch(addr_list->ip_n, removed_list->ip_n, added_list->ip_n, &ip4_n)
+            || !fort_conf_ip_count_patch(
+                    addr_list->pair_n, removed_list->pair_n, added_list->pair_n, &pair4_n)
+            || !fort_conf_ip_count_patch(
+                    addr6_list->ip_n, removed6_list->ip_n, added6_list->ip_n, &ip6_n)
+            || !fort_conf_ip_count_patch(
+                    addr6_list->pair_n, removed6_list->pair_n, added6_list->pair_n, &pair6_n))
+        return 0;
+
+    return FORT_CONF_ADDR_LIST_SIZE(ip4_n, pair4_n, ip6_n, pair6_n);
+}
+
+FORT_API BOOL fort_conf_addr_list_patch(const PFORT_CONF_ADDR4_LIST addr_list,
+        const PFORT_CONF_ADDR4_LIST removed_list, const PFORT_CONF_ADDR4_LIST added_list,
+        PFORT_CONF_ADDR4_LIST out_list)
+{
+    /* IPv4 */
+    out_list->ip_n = addr_list->ip_n - removed_list->ip_n + added_list->ip_n;
+    out_list->pair_n = addr_list->pair_n - removed_list->pair_n + added_list->pair_n;
+
+    if (!fort_conf_ip_arr_patch((const char *) addr_list->ip, addr_list->ip_n,
+                (const char *) removed_list->ip, removed_list->ip_n,
+                (const char *) added_list->ip, added_list->ip_n, (char *) out_list->ip,
+                /*is_range=*/FALSE, sizeof(UINT32))
+            || !fort_conf_ip_arr_patch((const char *) fort_conf_addr_list_pair4_ref(addr_list),
+                    addr_list->pair_n, (const char *) fort_conf_addr_list_pair4_ref(removed_list),
+                    removed_list->pair_n, (const char *) fort_conf_addr_list_pair4_ref(added_list),
+                    added_list->pair_n, (char *) fort_conf_addr_list_pair4_ref(out_list),
+                    /*is_range=*/TRUE, sizeof(UINT32)))
+        return FALSE;
+
+    /* IPv6 */
+    const PFORT_CONF_ADDR6_LIST addr6_list = fort_conf_addr6_list_ref(addr_list);
+    const PFORT_CONF_ADDR6_LIST removed6_list = fort_conf_addr6_list_ref(removed_list);
+    const PFORT_CONF_ADDR6_LIST added6_list = fort_conf_addr6_list_ref(added_list);
+    PFORT_CONF_ADDR6_LIST out6_list = fort_conf_addr6_list_ref(out_list);
+
+    out6_list->ip_n = addr6_list->ip_n - removed6_list->ip_n + added6_list->ip_n;
+    out6_list->pair_n = addr6_list->pair_n - removed6_list->pair_n + added6_list->pair_n;
+
+    return fort_conf_ip_arr_patch((const char *) addr6_list->ip, addr6_list->ip_n,
+                   (const char *) removed6_list->ip, removed6_list->ip_n,
+                   (const char *) added6_list->ip, added6_list->ip_n, (char *) out6_list->ip,
+                   /*is_range=*/FALSE, sizeof(ip6_addr_t))
+            && fort_conf_ip_arr_patch((const char *) fort_conf_addr_list_pair6_ref(addr6_list),
+                    addr6_list->pair_n, (const char *) fort_conf_addr_list_pair6_ref(removed6_list),
+                    removed6_list->pair_n,
+                    (const char *) fort_conf_addr_list_pair6_ref(added6_list), added6_list->pair_n,
+                    (char *) fort_conf_addr_list_pair6_ref(out6_list), /*is_range=*/TRUE,
+                    sizeof(ip6_addr_t));
+}
+
+#define fort_conf_zone_delta_removed_list_ref(zone_delta)                                          \
+    ((PFORT_CONF_ADDR4_LIST) (zone_delta)->data)
+
+#define fort_conf_zone_delta_added_list_ref(zone_delta)                                            \
+    ((PFORT_CONF_ADDR4_LIST) ((zone_delta)->data + (zone_delta)->added_off))
+
+#define fort_conf_zones_addr_list_ref(zones, zone_index)                                           \
+    ((PFORT_CONF_ADDR4_LIST) ((zones)->data + (zones)->addr_off[zone_index]))
+
+FORT_API UINT32 fort_conf_zones_patch_size(
+        const PFORT_CONF_ZONES zones, const PFORT_CONF_ZONE_DELTA zone_delta)
+{
+    const UINT32 delta_zone_index = zone_delta->zone_id - 1;
+
+    if (delta_zone_index >= FORT_CONF_ZONE_MAX || (zones->mask & (1u << delta_zone_index)) == 0)
+        return 0;
+
+    UINT32 size = FORT_CONF_ZONES_DATA_OFF;
+
+    for (UINT32 zone_index = 0; zone_index < FORT_CONF_ZONE_MAX; ++zone_index) {
+        if ((zones->mask & (1u << zone_index)) == 0)
+            continue;
+
+        const PFORT_CONF_ADDR4_LIST addr_list = fort_conf_zones_addr_list_ref(zones, zone_index);
+
+        if (zone_index == delta_zone_index) {
+            const UINT32 list_size = fort_conf_addr_list_patch_size(addr_list,
+                    fort_conf_zone_delta_removed_list_ref(zone_delta),
+                    fort_conf_zone_delta_added_list_ref(zone_delta));
+            if (list_size == 0)
+                return 0;
+
+            size += list_size;
+        } else {
+            size += fort_conf_addr_list_size(addr_list);
+        }
+    }
+
+    return size;
+}
+
+FORT_API BOOL fort_conf_zones_patch(const PFORT_CONF_ZONES zones,
+        const PFORT_CONF_ZONE_DELTA zone_delta, PFORT_CONF_ZONES out_zones)
+{
+    const UINT32 delta_zone_index = zone_delta->zone_id - 1;
+
+    RtlZeroMemory(out_zones, FORT_CONF_ZONES_DATA_OFF);
+
+    out_zones->mask = zones->mask;
+    out_zones->enabled_mask = zones->enabled_mask;
+
+    char *data = out_zones->data;
+
+    for (UINT32 zone_index = 0; zone_index < FORT_CONF_ZONE_MAX; ++zone_index) {
+        if ((zones->mask & (1u << zone_index)) == 0)
+            continue;
+
+        const PFORT_CONF_ADDR4_LIST addr_list = fort_conf_zones_addr_list_ref(zones, zone_index);
+        PFORT_CONF_ADDR4_LIST out_list = (PFORT_CONF_ADDR4_LIST) data;
+
+        out_zones->addr_off[zone_index] = (UINT32) (data - out_zones->data);
+
+        if (zone_index == delta_zone_index) {
+            if (!fort_conf_addr_list_patch(addr_list,
+                        fort_conf_zone_delta_removed_list_ref(zone_delta),
+                        fort_conf_zone_delta_added_list_ref(zone_delta), out_list))
+                return FALSE;
+        } else {
+            RtlCopyMemory(out_list, addr_list, fort_conf_addr_list_size(addr_list));
+        }
+
+        data += fort_conf_addr_list_size(out_list);
+    }
+
+    return TRUE;
+}
+
+FORT_API UINT32 fort_conf_addr_list_check(const PFORT_CONF_ADDR4_LIST addr_list, UINT32 len)
+{
+    if (len < FORT_CONF_ADDR4_LIST_OFF || addr_list->ip_n >= FORT_CONF_IP_MAX
+            || addr_list->pair_n >= FORT_CONF_IP_MAX)
+        return 0;
+
+    const UINT32 addr4_size = FORT_CONF_ADDR4_LIST_SIZE(addr_list->ip_n, addr_list->pair_n);
+
+    if (len < FORT_CONF_ADDR6_LIST_OFF || addr4_size > len - FORT_CONF_ADDR6_LIST_OFF)
+        return 0;
+
+    const PFORT_CONF_ADDR6_LIST addr6_list = fort_conf_addr6_list_ref(addr_list);
+
+    if (addr6_list->ip_n >= FORT_CONF_IP_MAX || addr6_list->pair_n >= FORT_CONF_IP_MAX)
+        return 0;
+
+    const UINT32 addr6_size = FORT_CONF_ADDR6_LIST_SIZE(addr6_list->ip_n, addr6_list->pair_n);
+
+    if (addr6_size > len - addr4_size)
+        return 0;
+
+    return addr4_size + addr6_size;
+}
+
+static BOOL fort_conf_addr_group_check(const PFORT_CONF_ADDR_GROUP addr_group, UINT32 len)
+{
+    if (len < FORT_CONF_ADDR_GROUP_OFF)
+        return FALSE;
+
+    len -= FORT_CONF_ADDR_GROUP_OFF;
+
+    const UINT32 exclude_off = addr_group->exclude_off;
+
+    return exclude_off <= len
+            && fort_conf_addr_list_check(
+                       fort_conf_addr_group_include_list_ref(addr_group), exclude_off)
+            != 0
+            && fort_conf_addr_list_check(
+                       fort_conf_addr_group_exclude_list_ref(addr_group), len - exclude_off)
+            != 0;
+}
+
+static BOOL fort_conf_addr_groups_check(const char *data, UINT32 len)
+{
+    const UINT32 *addr_group_offsets = (const UINT32 *) data;
+
+    if (len < FORT_CONF_ADDR_GROUP_MIN * sizeof(UINT32))
+        return FALSE;
+
+    /* The first group follows the offsets */
+    const UINT32 offsets_size = addr_group_offsets[0];
+
+    if (offsets_size % sizeof(UINT32) != 0
+            || offsets_size < FORT_CONF_ADDR_GROUP_MIN * sizeof(UINT32) || offsets_size > len)
+        return FALSE;
+
+    const UINT32 addr_groups_n = offsets_size / sizeof(UINT32);
+
+    for (UINT32 i = 0; i < addr_groups_n; ++i) {
+        const UINT32 off = addr_group_offsets[i];
+
+        if (off < offsets_size || off > len
+                || !fort_conf_addr_group_check((const PFORT_CONF_ADDR_GROUP) (data + off), len - off))
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+static UINT32 fort_conf_app_entry_check(const PFORT_APP_ENTRY app_entry, UINT32 len)
+{
+    if (len < FORT_CONF_APP_ENTRY_PATH_OFF)
+        return 0;
+
+    const UINT16 path_len = app_entry->path_len;
+    const UINT32 entry_size = FORT_CONF_APP_ENTRY_SIZE(path_len);
+
+    if (path_len % sizeof(WCHAR) != 0 || path_len > FORT_CONF_APP_PATH_MAX_SIZE
+            || entry_size > len)
+        return 0;
+
+    /* The path must be zero-terminated for the wildcard matching */
+    if (app_entry->path[path_len / sizeof(WCHAR)] != 0)
+        return 0;
+
+    return entry_size;
+}
+
+static BOOL fort_conf_apps_check(const char *data, UINT32 len, UINT16 apps_n)
+{
+    while (apps_n-- != 0) {
+        const UINT32 entry_size = fort_conf_app_entry_check((const PFORT_APP_ENTRY) data, len);
+        if (entry_size == 0)
+            return FALSE;
+
+        data += entry_size;
+        len -= entry_size;
+    }
+
+    return TRUE;
+}
+
+static BOOL fort_conf_prefix_apps_check(const char *data, UINT32 len, UINT16 apps_n)
+{
+    if (apps_n == 0)
+        return TRUE;
+
+    const UINT32 offsets_size = FORT_CONF_STR_HEADER_SIZE(apps_n);
+    if (offsets_size > len)
+        return FALSE;
+
+    const UINT32 *app_offsets = (const UINT32 *) data;
+    const char *app_entries = data + offsets_size;
+
+    len -= offsets_size;
+
+    for (UINT32 i = 0; i < apps_n; ++i) {
+        const UINT32 app_off = app_offsets[i];
+
+        if (app_off > len
+                || fort_conf_app_entry_check(
+                           (const PFORT_APP_ENTRY) (app_entries + app_off), len - app_off)
+                        == 0)
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+FORT_API BOOL fort_conf_check(const PFORT_CONF conf, UINT32 len)
+{
+    if (len < FORT_CONF_DATA_OFF)
+        return FALSE;
+
+    const UINT32 data_len = len - FORT_CONF_DATA_OFF;
+
+    /* The sections must follow each other */
+    if (conf->addr_groups_off > conf->app_periods_off
+            || conf->app_periods_off > conf->wild_apps_off
+            || conf->wild_apps_off > conf->prefix_apps_off
+            || conf->prefix_apps_off > conf->exe_apps_off || conf->exe_apps_off > data_len)
+        return FALSE;
+
+    if (conf->app_periods_n > FORT_CONF_GROUP_MAX)
+        return FALSE;
+
+    const char *data = conf->data;
+
+    return fort_conf_addr_groups_check(
+                   data + conf->addr_groups_off, conf->app_periods_off - conf->addr_groups_off)
+            && fort_conf_apps_check(data + conf->wild_apps_off,
+                    conf->prefix_apps_off - conf->wild_apps_off, conf->wild_apps_n)
+            && fort_conf_prefix_apps_check(data + conf->prefix_apps_off,
+                    conf->exe_apps_off - conf->prefix_apps_off, conf->prefix_apps_n)
+            && fort_conf_apps_check(
+                    data + conf->exe_apps_off, data_len - conf->exe_apps_off, conf->exe_apps_n);
+}
+
+FORT_API BOOL fort_conf_zones_check(const PFORT_CONF_ZONES zones, UINT32 len)
+{
+    if (len < FORT_CONF_ZONES_DATA_OFF)
+        return FALSE;
+
+    const UINT32 data_len = len - FORT_CONF_ZONES_DATA_OFF;
+
+    for (UINT32 zone_index = 0; zone_index < FORT_CONF_ZONE_MAX; ++zone_index) {
+        if ((zones->mask & (1u << zone_index)) == 0)
+            continue;
+
+        const UINT32 addr_off = zones->addr_off[zone_index];
+
+        if (addr_off > data_len
+                || fort_conf_addr_list_check(
+                           fort_conf_zones_addr_list_ref(zones, zone_index), data_len - addr_off)
+                        == 0)
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+FORT_API BOOL fort_conf_zone_delta_check(const PFORT_CONF_ZONE_DELTA zone_delta, UINT32 len)
+{
+    if (len < FORT_CONF_ZONE_DELTA_OFF)
+        return FALSE;
+
+    const UINT32 data_len = len - FORT_CONF_ZONE_DELTA_OFF;
+    const UINT32 added_off = zone_delta->added_off;
+
+    return added_off <= data_len
+            && fort_conf_addr_list_check(
+                       fort_conf_zone_delta_removed_list_ref(zone_delta), added_off)
+            != 0
+            && fort_conf_addr_list_check(
+                       fort_conf_zone_delta_added_list_ref(zone_delta), data_len - added_off)
+            != 0;
+}
+
 FORT_API PFORT_CONF_ADDR_GROUP fort_conf_addr_group_ref(const PFORT_CONF conf, int addr_group_index)
 {
     const UINT32 *addr_group_offsets = (const UINT32 *) (conf->data + conf->addr_groups_off);
@@ -355,7 +836,11 @@ FORT_API UINT16 fort_conf_app_period_bits(const PFORT_CONF conf, FORT_TIME time,
     UINT16 period_bits = (UINT16) conf->flags.group_bits;
     int n = 0;
 
-    for (int i = 0; i < FORT_CONF_GROUP_MAX; ++i) {
+    /* The periods are written only for the existing groups */
+    const int groups_n = (conf->wild_apps_off - conf->app_periods_off) / sizeof(FORT_PERIOD);
+    const int periods_max = (groups_n < FORT_CONF_GROUP_MAX) ? groups_n : FORT_CONF_GROUP_MAX;
+
+    for (int i = 0; i < periods_max; ++i) {
         const UINT16 bit = (1 << i);
         const FORT_PERIOD period = *app_periods++;
 
@@ -14,6 +14,7 @@
 #define FORT_CONF_RULE_SET_DEPTH_MAX  8
 #define FORT_CONF_ZONE_MAX            32
 #define FORT_CONF_GROUP_MAX           16
+#define FORT_CONF_ADDR_GROUP_MIN      2
 #define FORT_CONF_APPS_LEN_MAX        (64 * 1024 * 1024)
 #define FORT_CONF_APP_PATH_MAX        1024
 #define FORT_CONF_APP_PATH_MAX_SIZE   (FORT_CONF_APP_PATH_MAX * sizeof(WCHAR))
@@ -187,6 +188,15 @@ typedef struct fort_conf_zone_flag
     UCHAR enabled;
 } FORT_CONF_ZONE_FLAG, *PFORT_CONF_ZONE_FLAG;
 
+typedef struct fort_conf_zone_delta
+{
+    UCHAR zone_id;
+
+    UINT32 added_off;
+
+    char data[4]; /* removed address list, then added address list */
+} FORT_CONF_ZONE_DELTA, *PFORT_CONF_ZONE_DELTA;
+
 typedef struct fort_traf
 {
     union {
@@ -339,6 +349,7 @@ typedef struct fort_conf_io
 #define FORT_CONF_ADDR6_LIST_OFF offsetof(FORT_CONF_ADDR6_LIST, ip)
 #define FORT_CONF_ADDR_GROUP_OFF offsetof(FORT_CONF_ADDR_GROUP, data)
 #define FORT_CONF_ZONES_DATA_OFF offsetof(FORT_CONF_ZONES, data)
+#define FORT_CONF_ZONE_DELTA_OFF offsetof(FORT_CONF_ZONE_DELTA, data)
 
 #define FORT_CONF_ADDR4_LIST_SIZE(ip_n, pair_n)                                                    \
     (FORT_CONF_ADDR4_LIST_OFF + FORT_CONF_IP4_ARR_SIZE(ip_n) + FORT_CONF_IP4_RANGE_SIZE(pair_n))
@@ -367,6 +378,29 @@ FORT_API BOOL fort_conf_ip_inlist(
 FORT_API PFORT_CONF_ADDR_GROUP fort_conf_addr_group_ref(
         const PFORT_CONF conf, int addr_group_index);
 
+FORT_API UINT32 fort_conf_addr_list_size(const PFORT_CONF_ADDR4_LIST addr_list);
+
+FORT_API UINT32 fort_conf_addr_list_check(const PFORT_CONF_ADDR4_LIST addr_list, UINT32 len);
+
+FORT_API BOOL fort_conf_check(const PFORT_CONF conf, UINT32 len);
+
+FORT_API BOOL fort_conf_zones_check(const PFORT_CONF_ZONES zones, UINT32 len);
+
+FORT_API BOOL fort_conf_zone_delta_check(const PFORT_CONF_ZONE_DELTA zone_delta, UINT32 len);
+
+FORT_API UINT32 fort_conf_addr_list_patch_size(const PFORT_CONF_ADDR4_LIST addr_list,
+        const PFORT_CONF_ADDR4_LIST removed_list, const PFORT_CONF_ADDR4_LIST added_list);
+
+FORT_API BOOL fort_conf_addr_list_patch(const PFORT_CONF_ADDR4_LIST addr_list,
+        const PFORT_CONF_ADDR4_LIST removed_list, const PFORT_CONF_ADDR4_LIST added_list,
+        PFORT_CONF_ADDR4_LIST out_list);
+
+FORT_API UINT32 fort_conf_zones_patch_size(
+        const PFORT_CONF_ZONES zones, const PFORT_CONF_ZONE_DELTA zone_delta);
+
+FORT_API BOOL fort_conf_zones_patch(const PFORT_CONF_ZONES zones,
+        const PFORT_CONF_ZONE_DELTA zone_delta, PFORT_CONF_ZONES out_zones);
+
 #define fort_conf_addr_group_include_list_ref(addr_group)                                          \
     ((PFORT_CONF_ADDR4_LIST) (addr_group)->data)
 
@@ -176,24 +176,26 @@ DEFINE_GUID(FORT_GUID_EMPTY, 0x00000000, 0x0000, 0x0000, 0x00, 0x00, 0x00, 0x00,
 /* Macro to extract function index out of the device io control code */
 #define FORT_CTL_INDEX_FROM_CODE(ctrlCode) ((DWORD) ((ctrlCode >> 2) & 0xFF))
 
-#define FORT_IOCTL_INDEX_VALIDATE    0
-#define FORT_IOCTL_INDEX_SETSERVICES 1
-#define FORT_IOCTL_INDEX_SETCONF     2
-#define FORT_IOCTL_INDEX_SETFLAGS    3
-#define FORT_IOCTL_INDEX_GETLOG      4
-#define FORT_IOCTL_INDEX_ADDAPP      5
-#define FORT_IOCTL_INDEX_DELAPP      6
-#define FORT_IOCTL_INDEX_SETZONES    7
-#define FORT_IOCTL_INDEX_SETZONEFLAG 8
-
-#define FORT_IOCTL_VALIDATE    FORT_CTL_CODE(FORT_IOCTL_INDEX_VALIDATE, FILE_WRITE_DATA)
-#define FORT_IOCTL_SETSERVICES FORT_CTL_CODE(FORT_IOCTL_INDEX_SETSERVICES, FILE_WRITE_DATA)
-#define FORT_IOCTL_SETCONF     FORT_CTL_CODE(FORT_IOCTL_INDEX_SETCONF, FILE_WRITE_DATA)
-#define FORT_IOCTL_SETFLAGS    FORT_CTL_CODE(FORT_IOCTL_INDEX_SETFLAGS, FILE_WRITE_DATA)
-#define FORT_IOCTL_GETLOG      FORT_CTL_CODE(FORT_IOCTL_INDEX_GETLOG, FILE_READ_DATA)
-#define FORT_IOCTL_ADDAPP      FORT_CTL_CODE(FORT_IOCTL_INDEX_ADDAPP, FILE_WRITE_DATA)
-#define FORT_IOCTL_DELAPP      FORT_CTL_CODE(FORT_IOCTL_INDEX_DELAPP, FILE_WRITE_DATA)
-#define FORT_IOCTL_SETZONES    FORT_CTL_CODE(FORT_IOCTL_INDEX_SETZONES, FILE_WRITE_DATA)
-#define FORT_IOCTL_SETZONEFLAG FORT_CTL_CODE(FORT_IOCTL_INDEX_SETZONEFLAG, FILE_WRITE_DATA)
+#define FORT_IOCTL_INDEX_VALIDATE     0
+#define FORT_IOCTL_INDEX_SETSERVICES  1
+#define FORT_IOCTL_INDEX_SETCONF      2
+#define FORT_IOCTL_INDEX_SETFLAGS     3
+#define FORT_IOCTL_INDEX_GETLOG       4
+#define FORT_IOCTL_INDEX_ADDAPP       5
+#define FORT_IOCTL_INDEX_DELAPP       6
+#define FORT_IOCTL_INDEX_SETZONES     7
+#define FORT_IOCTL_INDEX_SETZONEFLAG  8
+#define FORT_IOCTL_INDEX_SETZONEDELTA 9
+
+#define FORT_IOCTL_VALIDATE     FORT_CTL_CODE(FORT_IOCTL_INDEX_VALIDATE, FILE_WRITE_DATA)
+#define FORT_IOCTL_SETSERVICES  FORT_CTL_CODE(FORT_IOCTL_INDEX_SETSERVICES, FILE_WRITE_DATA)
+#define FORT_IOCTL_SETCONF      FORT_CTL_CODE(FORT_IOCTL_INDEX_SETCONF, FILE_WRITE_DATA)
+#define FORT_IOCTL_SETFLAGS     FORT_CTL_CODE(FORT_IOCTL_INDEX_SETFLAGS, FILE_WRITE_DATA)
+#define FORT_IOCTL_GETLOG       FORT_CTL_CODE(FORT_IOCTL_INDEX_GETLOG, FILE_READ_DATA)
+#define FORT_IOCTL_ADDAPP       FORT_CTL_CODE(FORT_IOCTL_INDEX_ADDAPP, FILE_WRITE_DATA)
+#define FORT_IOCTL_DELAPP       FORT_CTL_CODE(FORT_IOCTL_INDEX_DELAPP, FILE_WRITE_DATA)
+#define FORT_IOCTL_SETZONES     FORT_CTL_CODE(FORT_IOCTL_INDEX_SETZONES, FILE_WRITE_DATA)
+#define FORT_IOCTL_SETZONEFLAG  FORT_CTL_CODE(FORT_IOCTL_INDEX_SETZONEFLAG, FILE_WRITE_DATA)
+#define FORT_IOCTL_SETZONEDELTA FORT_CTL_CODE(FORT_IOCTL_INDEX_SETZONEDELTA, FILE_WRITE_DATA)
 
 #endif // FORTIOCTL_H
@@ -74,14 +74,14 @@ static PFORT_CONF_EXE_NODE fort_conf_ref_exe_find_node(
     return NULL;
 }
 
-FORT_API FORT_APP_DATA fort_conf_exe_find(
-        const PFORT_CONF conf, PVOID context, const PVOID path, UINT32 path_len)
+FORT_API tommy_key_t fort_conf_exe_path_hash(const PVOID path, UINT32 path_len)
 {
-    UNUSED(conf);
-
-    PFORT_CONF_REF conf_ref = context;
-    const tommy_key_t path_hash = (tommy_key_t) tommy_hash_u64(0, path, path_len);
+    return (tommy_key_t) tommy_hash_u64(0, path, path_len);
+}
 
+static FORT_APP_DATA fort_conf_ref_exe_find_hash(
+        PFORT_CONF_REF conf_ref, const PVOID path, UINT32 path_len, tommy_key_t path_hash)
+{
     FORT_APP_DATA app_data = { 0 };
 
     KIRQL oldIrql = ExAcquireSpinLockShared(&conf_ref->conf_lock);
@@ -98,6 +98,27 @@ FORT_API FORT_APP_DATA fort_conf_exe_find(
     return app_data;
 }
 
+FORT_API FORT_APP_DATA fort_conf_exe_find(
+        const PFORT_CONF conf, PVOID context, const PVOID path, UINT32 path_len)
+{
+    UNUSED(conf);
+
+    PFORT_CONF_REF conf_ref = context;
+    const tommy_key_t path_hash = fort_conf_exe_path_hash(path, path_len);
+
+    return fort_conf_ref_exe_find_hash(conf_ref, path, path_len, path_hash);
+}
+
+FORT_API FORT_APP_DATA fort_conf_exe_find_hashed(
+        const PFORT_CONF conf, PVOID context, const PVOID path, UINT32 path_len)
+{
+    UNUSED(conf);
+
+    PCFORT_CONF_EXE_FIND_ARG arg = context;
+
+    return fort_conf_ref_exe_find_hash(arg->conf_ref, path, path_len, arg->path_hash);
+}
+
 static void fort_conf_ref_exe_new_path(
         PFORT_CONF_REF conf_ref, PFORT_APP_ENTRY entry, tommy_key_t path_hash)
 {
@@ -440,37 +461,91 @@ FORT_API BOOL fort_conf_ref_period_update(PFORT_DEVICE_CONF device_conf, BOOL fo
     return res;
 }
 
-FORT_API PFORT_CONF_ZONES fort_conf_zones_new(PFORT_CONF_ZONES zones, ULONG len)
+static PFORT_CONF_ZONES_REF fort_conf_zones_ref_alloc(ULONG len)
+{
+    const ULONG ref_len = len + offsetof(FORT_CONF_ZONES_REF, zones);
+
+    PFORT_CONF_ZONES_REF zones_ref = fort_mem_alloc(ref_len, FORT_ZONES_POOL_TAG);
+    if (zones_ref != NULL) {
+        zones_ref->refcount = 0;
+    }
+    return zones_ref;
+}
+
+static void fort_conf_zones_ref_free(PFORT_CONF_ZONES_REF zones_ref)
 {
-    PFORT_CONF_ZONES conf_zones = fort_mem_alloc(len, FORT_ZONES_POOL_TAG);
-    if (conf_zones != NULL) {
-        RtlCopyMemory(conf_zones, zones, len);
+    if (zones_ref != NULL) {
+        fort_mem_free(zones_ref, FORT_ZONES_POOL_TAG);
     }
-    return conf_zones;
 }
 
-static void fort_conf_zones_free(PFORT_CONF_ZONES zones)
+FORT_API PFORT_CONF_ZONES_REF fort_conf_zones_new(PFORT_CONF_ZONES zones, ULONG len)
 {
-    if (zones != NULL) {
-        fort_mem_free(zones, FORT_ZONES_POOL_TAG);
+    PFORT_CONF_ZONES_REF zones_ref = fort_conf_zones_ref_alloc(len);
+    if (zones_ref != NULL) {
+        RtlCopyMemory(&zones_ref->zones, zones, len);
     }
+    return zones_ref;
 }
 
-FORT_API void fort_conf_zones_set(PFORT_DEVICE_CONF device_conf, PFORT_CONF_ZONES zones)
+static PFORT_CONF_ZONES_REF fort_conf_zones_ref_take(PFORT_DEVICE_CONF device_conf)
 {
+    PFORT_CONF_ZONES_REF zones_ref;
+
     KIRQL oldIrql = ExAcquireSpinLockExclusive(&device_conf->zones_lock);
     {
-        fort_conf_zones_free(device_conf->zones);
-        device_conf->zones = zones;
+        zones_ref = device_conf->zones_ref;
+        if (zones_ref != NULL) {
+            ++zones_ref->refcount;
+        }
     }
     ExReleaseSpinLockExclusive(&device_conf->zones_lock, oldIrql);
+
+    return zones_ref;
+}
+
+static void fort_conf_zones_ref_put(PFORT_DEVICE_CONF device_conf, PFORT_CONF_ZONES_REF zones_ref)
+{
+    BOOL is_unused;
+
+    KIRQL oldIrql = ExAcquireSpinLockExclusive(&device_conf->zones_lock);
+    {
+        const UINT32 refcount = --zones_ref->refcount;
+
+        is_unused = (refcount == 0 && zones_ref != device_conf->zones_ref);
+    }
+    ExReleaseSpinLockExclusive(&device_conf->zones_lock, oldIrql);
+
+    if (is_unused) {
+        fort_conf_zones_ref_free(zones_ref);
+    }
+}
+
+FORT_API void fort_conf_zones_set(PFORT_DEVICE_CONF device_conf, PFORT_CONF_ZONES_REF zones_ref)
+{
+    PFORT_CONF_ZONES_REF old_zones_ref;
+
+    KIRQL oldIrql = ExAcquireSpinLockExclusive(&device_conf->zones_lock);
+    {
+        old_zones_ref = device_conf->zones_ref;
+        device_conf->zones_ref = zones_ref;
+
+        /* The referenced zones are freed by the last fort_conf_zones_ref_put() */
+        if (old_zones_ref != NULL && old_zones_ref->refcount != 0) {
+            old_zones_ref = NULL;
+        }
+    }
+    ExReleaseSpinLockExclusive(&device_conf->zones_lock, oldIrql);
+
+    fort_conf_zones_ref_free(old_zones_ref);
 }
 
 FORT_API void fort_conf_zone_flag_set(PFORT_DEVICE_CONF device_conf, PFORT_CONF_ZONE_FLAG zone_flag)
 {
     KIRQL oldIrql = ExAcquireSpinLockExclusive(&device_conf->zones_lock);
-    PFORT_CONF_ZONES zones = device_conf->zones;
-    if (zones != NULL) {
+    PFORT_CONF_ZONES_REF zones_ref = device_conf->zones_ref;
+    if (zones_ref != NULL) {
+        PFORT_CONF_ZONES zones = &zones_ref->zones;
         const UINT32 zone_mask = (1u << (zone_flag->zone_id - 1));
         if (zone_flag->enabled) {
             zones->enabled_mask |= zone_mask;
@@ -481,14 +556,64 @@ FORT_API void fort_conf_zone_flag_set(PFORT_DEVICE_CONF device_conf, PFORT_CONF_
     ExReleaseSpinLockExclusive(&device_conf->zones_lock, oldIrql);
 }
 
+static PFORT_CONF_ZONES_REF fort_conf_zones_patch_new(
+        const PFORT_CONF_ZONES zones, const PFORT_CONF_ZONE_DELTA zone_delta)
+{
+    const UINT32 len = fort_conf_zones_patch_size(zones, zone_delta);
+    if (len == 0)
+        return NULL;
+
+    PFORT_CONF_ZONES_REF zones_ref = fort_conf_zones_ref_alloc(len);
+    if (zones_ref != NULL && !fort_conf_zones_patch(zones, zone_delta, &zones_ref->zones)) {
+        fort_conf_zones_ref_free(zones_ref);
+        zones_ref = NULL;
+    }
+    return zones_ref;
+}
+
+FORT_API NTSTATUS fort_conf_zone_delta_apply(
+        PFORT_DEVICE_CONF device_conf, const PFORT_CONF_ZONE_DELTA zone_delta)
+{
+    PFORT_CONF_ZONES_REF old_zones_ref = fort_conf_zones_ref_take(device_conf);
+    if (old_zones_ref == NULL)
+        return STATUS_UNSUCCESSFUL;
+
+    /* Build the patched zones without the lock: the referenced zones are kept alive */
+    PFORT_CONF_ZONES_REF new_zones_ref =
+            fort_conf_zones_patch_new(&old_zones_ref->zones, zone_delta);
+
+    BOOL replaced = FALSE;
+
+    if (new_zones_ref != NULL) {
+        /* Swap the zones, when they are not replaced meanwhile */
+        KIRQL oldIrql = ExAcquireSpinLockExclusive(&device_conf->zones_lock);
+        if (device_conf->zones_ref == old_zones_ref) {
+            new_zones_ref->zones.enabled_mask = old_zones_ref->zones.enabled_mask;
+            device_conf->zones_ref = new_zones_ref;
+            replaced = TRUE;
+        }
+        ExReleaseSpinLockExclusive(&device_conf->zones_lock, oldIrql);
+
+        if (!replaced) {
+            fort_conf_zones_ref_free(new_zones_ref);
+        }
+    }
+
+    fort_conf_zones_ref_put(device_conf, old_zones_ref);
+
+    return replaced ? STATUS_SUCCESS : STATUS_UNSUCCESSFUL;
+}
+
 FORT_API BOOL fort_conf_zones_ip_included(
         PFORT_DEVICE_CONF device_conf, UINT32 zones_mask, const UINT32 *remote_ip, BOOL isIPv6)
 {
     BOOL res = FALSE;
 
     KIRQL oldIrql = ExAcquireSpinLockShared(&device_conf->zones_lock);
-    PFORT_CONF_ZONES zones = device_conf->zones;
-    if (zones != NULL) {
+    PFORT_CONF_ZONES_REF zones_ref = device_conf->zones_ref;
+    if (zones_ref != NULL) {
+        const PFORT_CONF_ZONES zones = &zones_ref->zones;
+
         zones_mask &= (zones->mask & zones->enabled_mask);
         while (zones_mask != 0) {
             const int zone_index = bit_scan_forward(zones_mask);
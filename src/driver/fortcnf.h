@@ -22,6 +22,22 @@ typedef struct fort_conf_ref
     FORT_CONF conf;
 } FORT_CONF_REF, *PFORT_CONF_REF;
 
+/* Context of fort_conf_exe_find_hashed(): the path's hash is already known */
+typedef struct fort_conf_exe_find_arg
+{
+    PFORT_CONF_REF conf_ref;
+    tommy_key_t path_hash; /* fort_conf_exe_path_hash() */
+} FORT_CONF_EXE_FIND_ARG, *PFORT_CONF_EXE_FIND_ARG;
+
+typedef const FORT_CONF_EXE_FIND_ARG *PCFORT_CONF_EXE_FIND_ARG;
+
+typedef struct fort_conf_zones_ref
+{
+    UINT32 refcount;
+
+    FORT_CONF_ZONES zones;
+} FORT_CONF_ZONES_REF, *PFORT_CONF_ZONES_REF;
+
 #define FORT_DEVICE_BOOT_FILTER         0x01
 #define FORT_DEVICE_BOOT_FILTER_LOCALS  0x02
 #define FORT_DEVICE_BOOT_MASK           (FORT_DEVICE_BOOT_FILTER | FORT_DEVICE_BOOT_FILTER_LOCALS)
@@ -39,7 +55,7 @@ typedef struct fort_device_conf
     PFORT_CONF_REF volatile ref;
     KSPIN_LOCK ref_lock;
 
-    PFORT_CONF_ZONES zones;
+    PFORT_CONF_ZONES_REF zones_ref;
     EX_SPIN_LOCK zones_lock;
 } FORT_DEVICE_CONF, *PFORT_DEVICE_CONF;
 
@@ -53,9 +69,14 @@ FORT_API UCHAR fort_device_flag_set(PFORT_DEVICE_CONF device_conf, UCHAR flag, B
 
 FORT_API UCHAR fort_device_flag(PFORT_DEVICE_CONF device_conf, UCHAR flag);
 
+FORT_API tommy_key_t fort_conf_exe_path_hash(const PVOID path, UINT32 path_len);
+
 FORT_API FORT_APP_DATA fort_conf_exe_find(
         const PFORT_CONF conf, PVOID context, const PVOID path, UINT32 path_len);
 
+FORT_API FORT_APP_DATA fort_conf_exe_find_hashed(
+        const PFORT_CONF conf, PVOID context, const PVOID path, UINT32 path_len);
+
 FORT_API NTSTATUS fort_conf_ref_exe_add_path(
         PFORT_CONF_REF conf_ref, const PFORT_APP_ENTRY app_entry, const PVOID path);
 
@@ -78,13 +99,16 @@ FORT_API FORT_CONF_FLAGS fort_conf_ref_flags_set(
 FORT_API BOOL fort_conf_ref_period_update(
         PFORT_DEVICE_CONF device_conf, BOOL force, int *periods_n);
 
-FORT_API PFORT_CONF_ZONES fort_conf_zones_new(PFORT_CONF_ZONES zones, ULONG len);
+FORT_API PFORT_CONF_ZONES_REF fort_conf_zones_new(PFORT_CONF_ZONES zones, ULONG len);
 
-FORT_API void fort_conf_zones_set(PFORT_DEVICE_CONF device_conf, PFORT_CONF_ZONES zones);
+FORT_API void fort_conf_zones_set(PFORT_DEVICE_CONF device_conf, PFORT_CONF_ZONES_REF zones_ref);
 
 FORT_API void fort_conf_zone_flag_set(
         PFORT_DEVICE_CONF device_conf, PFORT_CONF_ZONE_FLAG zone_flag);
 
+FORT_API NTSTATUS fort_conf_zone_delta_apply(
+        PFORT_DEVICE_CONF device_conf, const PFORT_CONF_ZONE_DELTA zone_delta);
+
 FORT_API BOOL fort_conf_zones_ip_included(
         PFORT_DEVICE_CONF device_conf, UINT32 zones_mask, const UINT32 *remote_ip, BOOL isIPv6);
 
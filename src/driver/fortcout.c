@@ -59,8 +59,13 @@ static FORT_APP_DATA fort_callout_ale_conf_app_data(
     if (cx->app_data_found)
         return cx->app_data;
 
-    const FORT_APP_DATA app_data = fort_conf_app_find(
-            &conf_ref->conf, cx->path->Buffer, cx->path->Length, fort_conf_exe_find, conf_ref);
+    FORT_CONF_EXE_FIND_ARG exe_arg = {
+        .conf_ref = conf_ref,
+        .path_hash = cx->path_hash,
+    };
+
+    const FORT_APP_DATA app_data = fort_conf_app_find(&conf_ref->conf, cx->path->Buffer,
+            cx->path->Length, fort_conf_exe_find_hashed, &exe_arg);
 
     fort_callout_ale_set_app_flags(cx, app_data);
 
@@ -144,7 +149,7 @@ inline static BOOL fort_callout_ale_log_blocked_ip_check_app(
 inline static BOOL fort_callout_ale_log_blocked_ip_check(
         PFORT_CALLOUT_ALE_EXTRA cx, PFORT_CONF_REF conf_ref, FORT_CONF_FLAGS conf_flags)
 {
-    if (cx->block_reason == FORT_BLOCK_REASON_UNKNOWN)
+    if (cx->block_reason == FORT_BLOCK_REASON_UNKNOWN || cx->ask_duplicate)
         return FALSE;
 
     if (!(conf_flags.ask_to_connect || conf_flags.log_blocked_ip))
@@ -175,14 +180,32 @@ inline static void fort_callout_ale_log_blocked_ip(PCFORT_CALLOUT_ARG ca,
             cx->process_id, cx->real_path->Length, cx->real_path->Buffer, &cx->irp, &cx->info);
 }
 
+inline static UINT32 fort_callout_ale_ask_endpoint(PCFORT_CALLOUT_ARG ca)
+{
+    const UINT16 remote_port = ca->inFixedValues->incomingValue[ca->fi->remotePort].value.uint16;
+    const UCHAR ip_proto = ca->inFixedValues->incomingValue[ca->fi->ipProto].value.uint8;
+
+    return fort_pending_ask_endpoint(ca->inbound, ip_proto, remote_port);
+}
+
 inline static BOOL fort_callout_ale_add_pending(
         PCFORT_CALLOUT_ARG ca, PFORT_CALLOUT_ALE_EXTRA cx, FORT_CONF_FLAGS conf_flags)
 {
-    if (!fort_pending_add_packet(&fort_device()->pending, ca, cx)) {
+    PFORT_PENDING pending = &fort_device()->pending;
+
+    const UINT32 path_hash = (UINT32) cx->path_hash; /* fort_pending_path_hash() */
+    const UINT32 endpoint = fort_callout_ale_ask_endpoint(ca);
+
+    const BOOL is_asked = (fort_pending_ask_check(pending, path_hash, endpoint, fort_pending_now())
+            == FORT_PENDING_ASK_PENDING);
+
+    if (!fort_pending_add_packet(pending, ca, cx, path_hash, endpoint)) {
         cx->block_reason = FORT_BLOCK_REASON_ASK_LIMIT;
         return TRUE; /* block (error) */
     }
 
+    /* The duplicate is pended too, but not logged while the prompt is outstanding */
+    cx->ask_duplicate = is_asked;
     cx->drop_blocked = TRUE;
     cx->block_reason = FORT_BLOCK_REASON_ASK_PENDING;
     return TRUE; /* drop (pending) */
@@ -364,12 +387,19 @@ inline static void fort_callout_ale_check_conf(
     real_path.MaximumLength = real_path.Length;
     real_path.Buffer = (PWSTR) ca->inMetaValues->processPath->data;
 
+    PFORT_PSTREE ps_tree = &fort_device()->ps_tree;
+
+    /* Keep the process's name alive */
+    const UINT32 read_token = fort_pstree_read_begin(ps_tree);
+
     BOOL isSvcHost = FALSE;
     BOOL inherited = FALSE;
     UNICODE_STRING path;
+    tommy_key_t path_hash;
     if (!fort_pstree_get_proc_name(
-                &fort_device()->ps_tree, process_id, &path, &isSvcHost, &inherited)) {
+                ps_tree, process_id, &path, &path_hash, &isSvcHost, &inherited)) {
         path = real_path;
+        path_hash = fort_conf_exe_path_hash(path.Buffer, path.Length);
     } else if (!inherited) {
         /* TODO: Check "ServiceTag" on Windows 10+ */
 #if 0 // !defined(FORT_WIN7_COMPAT)
@@ -383,6 +413,7 @@ inline static void fort_callout_ale_check_conf(
     cx->process_id = process_id;
     cx->path = &path;
     cx->real_path = &real_path;
+    cx->path_hash = path_hash;
     cx->inherited = (UCHAR) inherited;
 
     cx->blocked = TRUE;
@@ -394,6 +425,8 @@ inline static void fort_callout_ale_check_conf(
     }
 
     fort_callout_ale_classify_action(ca, cx, conf_ref, conf_flags);
+
+    fort_pstree_read_end(ps_tree, read_token);
 }
 
 inline static void fort_callout_ale_by_conf(
@@ -1087,4 +1120,10 @@ FORT_API void fort_callout_timer(void)
         fort_buffer_irp_clear_pending(irp);
         fort_request_complete_info(irp, STATUS_SUCCESS, info);
     }
+
+    /* Drop the expired pending packets */
+    fort_pending_expire(&fort_device()->pending, fort_pending_now());
+
+    /* Free the process names, which are released by the readers */
+    fort_pstree_reclaim(&fort_device()->ps_tree);
 }
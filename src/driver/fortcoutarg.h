@@ -4,6 +4,7 @@
 #include "fortdrv.h"
 
 #include "common/fortconf.h"
+#include "forttds.h"
 
 typedef struct fort_callout_field_index
 {
@@ -46,6 +47,7 @@ typedef struct fort_callout_ale_extra
     UCHAR drop_blocked : 1;
     UCHAR blocked : 1;
     UCHAR ignore : 1;
+    UCHAR ask_duplicate : 1;
     INT8 block_reason;
 
     FORT_APP_DATA app_data;
@@ -57,6 +59,8 @@ typedef struct fort_callout_ale_extra
     PCUNICODE_STRING path;
     PCUNICODE_STRING real_path;
 
+    tommy_key_t path_hash; /* of the path */
+
     PIRP irp;
     ULONG_PTR info;
 } FORT_CALLOUT_ALE_EXTRA, *PFORT_CALLOUT_ALE_EXTRA;
@@ -193,7 +193,9 @@ static NTSTATUS fort_device_control_setconf(PFORT_DEVICE_CONTROL_ARG dca)
     const PFORT_CONF_IO conf_io = dca->buffer;
     const ULONG len = dca->in_len;
 
-    if (len > sizeof(FORT_CONF_IO)) {
+    /* Validate the offsets once, to not check them on lookups */
+    if (len > sizeof(FORT_CONF_IO)
+            && fort_conf_check(&conf_io->conf, len - FORT_CONF_IO_CONF_OFF)) {
         const PFORT_CONF conf = &conf_io->conf;
         PFORT_CONF_REF conf_ref = fort_conf_ref_new(conf, len - FORT_CONF_IO_CONF_OFF);
 
@@ -260,6 +262,14 @@ inline static NTSTATUS fort_device_control_app_conf(
     return status;
 }
 
+inline static void fort_device_control_app_answer(const PFORT_APP_ENTRY app_entry)
+{
+    const UINT32 path_hash = fort_pending_path_hash(app_entry->path, app_entry->path_len);
+
+    /* Release the app's connections pending for the Ask-to-Connect answer, if any */
+    fort_pending_ask_answer(&fort_device()->pending, path_hash);
+}
+
 static NTSTATUS fort_device_control_app(PFORT_DEVICE_CONTROL_ARG dca, BOOL is_adding)
 {
     const PFORT_APP_ENTRY app_entry = dca->buffer;
@@ -278,6 +288,10 @@ static NTSTATUS fort_device_control_app(PFORT_DEVICE_CONTROL_ARG dca, BOOL is_ad
     fort_conf_ref_put(&fort_device()->conf, conf_ref);
 
     if (NT_SUCCESS(status)) {
+        if (is_adding) {
+            fort_device_control_app_answer(app_entry);
+        }
+
         fort_device_reauth_queue();
     }
 
@@ -299,13 +313,13 @@ static NTSTATUS fort_device_control_setzones(PFORT_DEVICE_CONTROL_ARG dca)
     const PFORT_CONF_ZONES zones = dca->buffer;
     const ULONG len = dca->in_len;
 
-    if (len >= FORT_CONF_ZONES_DATA_OFF) {
-        PFORT_CONF_ZONES conf_zones = fort_conf_zones_new(zones, len);
+    if (fort_conf_zones_check(zones, len)) {
+        PFORT_CONF_ZONES_REF zones_ref = fort_conf_zones_new(zones, len);
 
-        if (conf_zones == NULL) {
+        if (zones_ref == NULL) {
             return STATUS_INSUFFICIENT_RESOURCES;
         } else {
-            fort_conf_zones_set(&fort_device()->conf, conf_zones);
+            fort_conf_zones_set(&fort_device()->conf, zones_ref);
 
             fort_device_reauth_queue();
 
@@ -335,6 +349,27 @@ static NTSTATUS fort_device_control_setzoneflag(PFORT_DEVICE_CONTROL_ARG dca)
 static_assert(FORT_CTL_INDEX_FROM_CODE(FORT_IOCTL_SETZONEFLAG) == FORT_IOCTL_INDEX_SETZONEFLAG,
         "Invalid FORT_CTL_INDEX_FROM_CODE()");
 
+static NTSTATUS fort_device_control_setzonedelta(PFORT_DEVICE_CONTROL_ARG dca)
+{
+    const PFORT_CONF_ZONE_DELTA zone_delta = dca->buffer;
+    const ULONG len = dca->in_len;
+
+    if (fort_conf_zone_delta_check(zone_delta, len)) {
+        const NTSTATUS status = fort_conf_zone_delta_apply(&fort_device()->conf, zone_delta);
+
+        if (NT_SUCCESS(status)) {
+            fort_device_reauth_queue();
+        }
+
+        return status;
+    }
+
+    return STATUS_UNSUCCESSFUL;
+}
+
+static_assert(FORT_CTL_INDEX_FROM_CODE(FORT_IOCTL_SETZONEDELTA) == FORT_IOCTL_INDEX_SETZONEDELTA,
+        "Invalid FORT_CTL_INDEX_FROM_CODE()");
+
 typedef NTSTATUS(FORT_DEVICE_CONTROL_PROCESS_FUNC)(PFORT_DEVICE_CONTROL_ARG dca);
 typedef FORT_DEVICE_CONTROL_PROCESS_FUNC *PFORT_DEVICE_CONTROL_PROCESS_FUNC;
 
@@ -348,6 +383,7 @@ static PFORT_DEVICE_CONTROL_PROCESS_FUNC fortDeviceControlProcess_funcList[] = {
     &fort_device_control_delapp,
     &fort_device_control_setzones,
     &fort_device_control_setzoneflag,
+    &fort_device_control_setzonedelta,
 };
 
 static NTSTATUS fort_device_control_process(
@@ -356,7 +392,7 @@ static NTSTATUS fort_device_control_process(
     const UCHAR control_index =
             FORT_CTL_INDEX_FROM_CODE(irp_stack->Parameters.DeviceIoControl.IoControlCode);
 
-    if (control_index > FORT_IOCTL_INDEX_SETZONEFLAG)
+    if (control_index > FORT_IOCTL_INDEX_SETZONEDELTA)
         return STATUS_INVALID_PARAMETER;
 
     if (control_index != FORT_IOCTL_INDEX_VALIDATE
@@ -1084,13 +1084,19 @@ FORT_API void fort_shaper_drop_packets(PFORT_SHAPER shaper)
     fort_shaper_flush(shaper, FORT_PACKET_FLUSH_ALL, /*drop=*/TRUE);
 }
 
-static PFORT_PENDING_PROC fort_pending_proc_find_locked(PFORT_PENDING pending, UINT32 process_id)
+#define fort_pending_proc_hash(process_id) tommy_inthash_u32((UINT32) (process_id))
+
+static PFORT_PENDING_PROC fort_pending_proc_find_locked(
+        PFORT_PENDING pending, UINT32 process_id, tommy_key_t pid_hash)
 {
-    PFORT_PENDING_PROC proc = pending->procs_head;
+    PFORT_PENDING_PROC proc =
+            (PFORT_PENDING_PROC) tommy_hashdyn_bucket(&pending->procs_map, pid_hash);
 
-    for (; proc != NULL; proc = proc->next) {
+    while (proc != NULL) {
         if (proc->process_id == process_id)
             return proc;
+
+        proc = proc->next;
     }
 
     return NULL;
@@ -1098,120 +1104,253 @@ static PFORT_PENDING_PROC fort_pending_proc_find_locked(PFORT_PENDING pending, U
 
 static BOOL fort_pending_proc_check_limits(PFORT_PENDING pending, UINT32 process_id)
 {
-    UINT16 proc_count = 0;
-    UINT16 packet_count = 0;
+    const tommy_key_t pid_hash = fort_pending_proc_hash(process_id);
+
+    BOOL res = TRUE;
 
     KLOCK_QUEUE_HANDLE lock_queue;
     KeAcquireInStackQueuedSpinLock(&pending->lock, &lock_queue);
 
-    proc_count = pending->proc_count;
-
-    PFORT_PENDING_PROC proc = fort_pending_proc_find_locked(pending, process_id);
+    /* The oldest process is evicted when the processes count is exceeded */
+    PFORT_PENDING_PROC proc = fort_pending_proc_find_locked(pending, process_id, pid_hash);
     if (proc != NULL) {
-        packet_count = proc->packet_count;
+        res = (proc->packet_count < pending->limits.proc_packet_count_max);
     }
 
     KeReleaseInStackQueuedSpinLock(&lock_queue);
 
-    return proc_count < FORT_PENDING_PROC_COUNT_MAX
-            && packet_count < FORT_PENDING_PROC_PACKET_COUNT_MAX;
+    return res;
 }
 
-static PFORT_PENDING_PROC fort_pending_proc_get_locked(PFORT_PENDING pending, UINT32 process_id)
+static PFORT_PENDING_PROC fort_pending_proc_new_locked(
+        PFORT_PENDING pending, UINT32 process_id, tommy_key_t pid_hash, INT64 now)
 {
-    PFORT_PENDING_PROC proc;
+    tommy_hashdyn_node *proc_node = tommy_list_tail(&pending->free_procs);
 
-    if (pending->proc_free != NULL) {
-        proc = pending->proc_free;
-        pending->proc_free = proc->next;
+    if (proc_node != NULL) {
+        tommy_list_remove_existing(&pending->free_procs, proc_node);
     } else {
-        const tommy_size_t size = tommy_arrayof_size(&pending->procs);
+        tommy_arrayof *procs = &pending->procs;
+        const tommy_size_t size = tommy_arrayof_size(procs);
 
         /* TODO: tommy_arrayof_grow(): check calloc()'s result for NULL */
-        if (tommy_arrayof_grow(&pending->procs, size + 1), 0)
+        if (tommy_arrayof_grow(procs, size + 1), 0)
             return NULL;
 
-        proc = tommy_arrayof_ref(&pending->procs, size);
+        proc_node = tommy_arrayof_ref(procs, size);
     }
 
+    tommy_hashdyn_insert(&pending->procs_map, proc_node, /*data=*/NULL, pid_hash);
+
+    PFORT_PENDING_PROC proc = (PFORT_PENDING_PROC) proc_node;
+
     proc->packets_head = NULL;
+    proc->packets_tail = NULL;
+    proc->expire_time = now + pending->limits.expire_msec;
     proc->packet_count = 0;
     proc->process_id = process_id;
 
-    proc->next = pending->procs_head;
-    pending->procs_head = proc;
+    tommy_list_insert_tail(&pending->procs_time_list, &proc->time_node, proc);
 
-    pending->proc_count++;
+    ++pending->proc_count;
 
     return proc;
 }
 
-static PFORT_PENDING_PROC fort_pending_proc_get_check(PFORT_PENDING pending, UINT32 process_id)
+static void fort_pending_proc_del_locked(PFORT_PENDING pending, PFORT_PENDING_PROC proc)
 {
-    PFORT_PENDING_PROC proc = fort_pending_proc_find_locked(pending, process_id);
+    --pending->proc_count;
+
+    proc->process_id = 0;
+
+    /* Delete from the expiration list */
+    tommy_list_remove_existing(&pending->procs_time_list, &proc->time_node);
+
+    /* Delete from procs map */
+    tommy_hashdyn_remove_existing(&pending->procs_map, (tommy_hashdyn_node *) proc);
 
-    if (proc == NULL) {
-        return fort_pending_proc_get_locked(pending, process_id);
+    tommy_list_insert_tail_check(&pending->free_procs, (tommy_node *) proc);
+}
+
+static void fort_pending_proc_take_packets_locked(
+        PFORT_PENDING pending, PFORT_PENDING_PROC proc, PFORT_PENDING_PACKET *packets)
+{
+    if (proc->packets_tail != NULL) {
+        proc->packets_tail->next = *packets;
+        *packets = proc->packets_head;
     }
 
-    if (proc->packet_count >= FORT_PENDING_PROC_PACKET_COUNT_MAX)
-        return NULL;
+    fort_pending_proc_del_locked(pending, proc);
+}
 
-    return proc;
+static void fort_pending_expire_locked(
+        PFORT_PENDING pending, INT64 now, PFORT_PENDING_PACKET *packets)
+{
+    tommy_node *node;
+
+    while ((node = tommy_list_head(&pending->procs_time_list)) != NULL) {
+        PFORT_PENDING_PROC proc = node->data;
+
+        if (proc->expire_time > now)
+            break;
+
+        fort_pending_proc_take_packets_locked(pending, proc, packets);
+    }
+}
+
+static void fort_pending_evict_locked(PFORT_PENDING pending, PFORT_PENDING_PACKET *packets)
+{
+    tommy_node *node;
+
+    while (pending->proc_count >= pending->limits.proc_count_max
+            && (node = tommy_list_head(&pending->procs_time_list)) != NULL) {
+        PFORT_PENDING_PROC proc = node->data;
+
+        fort_pending_proc_take_packets_locked(pending, proc, packets);
+    }
 }
 
-static void fort_pending_proc_put_locked(PFORT_PENDING pending, PFORT_PENDING_PROC proc)
+static void fort_pending_app_take_packets_locked(
+        PFORT_PENDING pending, UINT32 path_hash, PFORT_PENDING_PACKET *packets)
 {
-    pending->proc_count--;
+    tommy_node *node = tommy_list_head(&pending->procs_time_list);
+
+    while (node != NULL) {
+        PFORT_PENDING_PROC proc = node->data;
+
+        node = node->next;
+
+        if (proc->path_hash == path_hash) {
+            fort_pending_proc_take_packets_locked(pending, proc, packets);
+        }
+    }
+}
+
+static void fort_pending_clear_locked(PFORT_PENDING pending, PFORT_PENDING_PACKET *packets)
+{
+    tommy_node *node;
+
+    while ((node = tommy_list_head(&pending->procs_time_list)) != NULL) {
+        PFORT_PENDING_PROC proc = node->data;
+
+        fort_pending_proc_take_packets_locked(pending, proc, packets);
+    }
 
-    proc->next = pending->proc_free;
-    pending->proc_free = proc;
+    RtlZeroMemory(pending->asks, sizeof(pending->asks));
 }
 
-static NTSTATUS fort_pending_proc_add_packet_locked(PFORT_PENDING pending, PCFORT_CALLOUT_ARG ca,
-        PFORT_CALLOUT_ALE_EXTRA cx, PFORT_PENDING_PACKET pkt)
+inline static PFORT_PENDING_ASK fort_pending_ask_ref(
+        PFORT_PENDING pending, UINT32 path_hash, UINT32 endpoint)
 {
-    /* Create the Pending Process */
-    PFORT_PENDING_PROC proc = fort_pending_proc_get_check(pending, cx->process_id);
+    const UINT32 index = tommy_inthash_u32(path_hash ^ endpoint) & (FORT_PENDING_ASK_COUNT - 1);
+
+    return &pending->asks[index];
+}
+
+static void fort_pending_ask_set_locked(PFORT_PENDING pending, UINT32 path_hash, UINT32 endpoint,
+        UCHAR state, INT64 expire_time)
+{
+    /* Replace the colliding entry */
+    PFORT_PENDING_ASK ask = fort_pending_ask_ref(pending, path_hash, endpoint);
+
+    ask->path_hash = path_hash;
+    ask->endpoint = endpoint;
+    ask->expire_time = expire_time;
+    ask->state = state;
+}
+
+static PFORT_PENDING_PROC fort_pending_proc_get_locked(PFORT_PENDING pending, UINT32 process_id,
+        INT64 now, PFORT_PENDING_PACKET *dropped_packets)
+{
+    fort_pending_expire_locked(pending, now, dropped_packets);
+
+    const tommy_key_t pid_hash = fort_pending_proc_hash(process_id);
+
+    PFORT_PENDING_PROC proc = fort_pending_proc_find_locked(pending, process_id, pid_hash);
+
+    if (proc != NULL) {
+        if (proc->packet_count >= pending->limits.proc_packet_count_max)
+            return NULL;
+
+        return proc;
+    }
+
+    fort_pending_evict_locked(pending, dropped_packets);
+
+    return fort_pending_proc_new_locked(pending, process_id, pid_hash, now);
+}
+
+static NTSTATUS fort_pending_proc_add_packet_locked(PFORT_PENDING pending, UINT32 process_id,
+        UINT32 path_hash, UINT32 endpoint, HANDLE completion_handle, PFORT_PENDING_PACKET pkt,
+        INT64 now, PFORT_PENDING_PACKET *dropped_packets)
+{
+    /* Get the Pending Process */
+    PFORT_PENDING_PROC proc =
+            fort_pending_proc_get_locked(pending, process_id, now, dropped_packets);
     if (proc == NULL)
         return STATUS_INSUFFICIENT_RESOURCES;
 
-    const NTSTATUS status =
-            FwpsPendOperation0(ca->inMetaValues->completionHandle, &pkt->completion_context);
+    const NTSTATUS status = FwpsPendOperation0(completion_handle, &pkt->completion_context);
 
     if (!NT_SUCCESS(status)) {
         if (proc->packet_count == 0) {
-            fort_pending_proc_put_locked(pending, proc);
+            fort_pending_proc_del_locked(pending, proc);
         }
         return status;
     }
 
     proc->packet_count++;
+    proc->path_hash = path_hash;
+
+    pkt->next = NULL;
+
+    if (proc->packets_tail != NULL) {
+        proc->packets_tail->next = pkt;
+    } else {
+        proc->packets_head = pkt;
+    }
+    proc->packets_tail = pkt;
 
-    pkt->next = proc->packets_head;
-    proc->packets_head = pkt;
+    /* Don't log the duplicate pends of the app while the prompt is outstanding */
+    fort_pending_ask_set_locked(
+            pending, path_hash, endpoint, FORT_PENDING_ASK_PENDING, proc->expire_time);
 
     return STATUS_SUCCESS;
 }
 
-static NTSTATUS fort_pending_proc_add_packet(PFORT_PENDING pending, PCFORT_CALLOUT_ARG ca,
-        PFORT_CALLOUT_ALE_EXTRA cx, PFORT_PENDING_PACKET pkt)
+static UINT16 fort_pending_packets_complete(PFORT_PENDING_PACKET pkt, BOOL drop)
 {
-    NTSTATUS status;
+    UINT16 count = 0;
 
-    KLOCK_QUEUE_HANDLE lock_queue;
-    KeAcquireInStackQueuedSpinLock(&pending->lock, &lock_queue);
+    while (pkt != NULL) {
+        PFORT_PENDING_PACKET pkt_next = pkt->next;
 
-    status = fort_pending_proc_add_packet_locked(pending, ca, cx, pkt);
+        FwpsCompleteOperation0(pkt->completion_context, NULL);
 
-    KeReleaseInStackQueuedSpinLock(&lock_queue);
+        if (drop || !NT_SUCCESS(fort_packet_inject(&pkt->io))) {
+            fort_pending_packet_free(pkt);
+        }
 
-    return status;
+        ++count;
+
+        pkt = pkt_next;
+    }
+
+    return count;
 }
 
 static void fort_pending_init(PFORT_PENDING pending)
 {
+    pending->proc_count = 0;
+
+    tommy_list_init(&pending->free_procs);
+
     tommy_arrayof_init(&pending->procs, sizeof(FORT_PENDING_PROC));
+    tommy_hashdyn_init(&pending->procs_map);
+
+    tommy_list_init(&pending->procs_time_list);
+
+    RtlZeroMemory(pending->asks, sizeof(pending->asks));
 }
 
 FORT_API void fort_pending_open(PFORT_PENDING pending)
@@ -1225,6 +1364,10 @@ FORT_API void fort_pending_open(PFORT_PENDING pending)
     FwpsInjectionHandleCreate0(
             AF_INET6, FWPS_INJECTION_TYPE_TRANSPORT, &pending->injection_transport6_out_id);
 
+    pending->limits.proc_count_max = FORT_PENDING_PROC_COUNT_MAX;
+    pending->limits.proc_packet_count_max = FORT_PENDING_PROC_PACKET_COUNT_MAX;
+    pending->limits.expire_msec = FORT_PENDING_EXPIRE_MSEC;
+
     fort_pending_init(pending);
 
     KeInitializeSpinLock(&pending->lock);
@@ -1233,10 +1376,13 @@ FORT_API void fort_pending_open(PFORT_PENDING pending)
 static void fort_pending_done(PFORT_PENDING pending)
 {
     tommy_arrayof_done(&pending->procs);
+    tommy_hashdyn_done(&pending->procs_map);
 }
 
 FORT_API void fort_pending_close(PFORT_PENDING pending)
 {
+    fort_pending_clear(pending);
+
     fort_pending_done(pending);
 
     FwpsInjectionHandleDestroy0(pending->injection_transport4_in_id);
@@ -1245,31 +1391,55 @@ FORT_API void fort_pending_close(PFORT_PENDING pending)
     FwpsInjectionHandleDestroy0(pending->injection_transport6_out_id);
 }
 
-static void fort_pending_clear_locked(PFORT_PENDING pending)
+FORT_API void fort_pending_clear(PFORT_PENDING pending)
 {
-    if (pending->proc_count == 0)
-        return;
+    PFORT_PENDING_PACKET packets = NULL;
 
-    pending->proc_count = 0;
-    pending->proc_free = NULL;
-    pending->procs_head = NULL;
+    KLOCK_QUEUE_HANDLE lock_queue;
+    KeAcquireInStackQueuedSpinLock(&pending->lock, &lock_queue);
 
-    fort_pending_done(pending);
-    fort_pending_init(pending);
+    fort_pending_clear_locked(pending, &packets);
+
+    KeReleaseInStackQueuedSpinLock(&lock_queue);
+
+    fort_pending_packets_complete(packets, /*drop=*/TRUE);
 }
 
-FORT_API void fort_pending_clear(PFORT_PENDING pending)
+FORT_API INT64 fort_pending_now(void)
 {
+    /* Monotonic: the expiration must not follow the wall clock changes */
+    return (INT64) (KeQueryInterruptTime() / 10000); /* to milliseconds */
+}
+
+FORT_API UINT32 fort_pending_path_hash(const PVOID path, UINT32 path_len)
+{
+    return (UINT32) fort_conf_exe_path_hash(path, path_len);
+}
+
+FORT_API NTSTATUS fort_pending_proc_add_packet(PFORT_PENDING pending, UINT32 process_id,
+        UINT32 path_hash, UINT32 endpoint, HANDLE completion_handle, PFORT_PENDING_PACKET pkt,
+        INT64 now)
+{
+    NTSTATUS status;
+
+    PFORT_PENDING_PACKET dropped_packets = NULL;
+
     KLOCK_QUEUE_HANDLE lock_queue;
     KeAcquireInStackQueuedSpinLock(&pending->lock, &lock_queue);
 
-    fort_pending_clear_locked(pending);
+    status = fort_pending_proc_add_packet_locked(pending, process_id, path_hash, endpoint,
+            completion_handle, pkt, now, &dropped_packets);
 
     KeReleaseInStackQueuedSpinLock(&lock_queue);
+
+    /* Drop the expired and evicted processes' packets */
+    fort_pending_packets_complete(dropped_packets, /*drop=*/TRUE);
+
+    return status;
 }
 
-FORT_API BOOL fort_pending_add_packet(
-        PFORT_PENDING pending, PCFORT_CALLOUT_ARG ca, PFORT_CALLOUT_ALE_EXTRA cx)
+FORT_API BOOL fort_pending_add_packet(PFORT_PENDING pending, PCFORT_CALLOUT_ARG ca,
+        PFORT_CALLOUT_ALE_EXTRA cx, UINT32 path_hash, UINT32 endpoint)
 {
     NTSTATUS status;
 
@@ -1293,7 +1463,8 @@ FORT_API BOOL fort_pending_add_packet(
     status = fort_packet_fill(ca, &pkt->io, ipsec_flag | FORT_PACKET_TYPE_PENDING);
     if (NT_SUCCESS(status)) {
         /* Add the Packet to Pending Process */
-        status = fort_pending_proc_add_packet(pending, ca, cx, pkt);
+        status = fort_pending_proc_add_packet(pending, cx->process_id, path_hash, endpoint,
+                ca->inMetaValues->completionHandle, pkt, fort_pending_now());
     }
 
     if (!NT_SUCCESS(status)) {
@@ -1303,3 +1474,81 @@ FORT_API BOOL fort_pending_add_packet(
 
     return TRUE;
 }
+
+FORT_API UINT16 fort_pending_proc_complete(PFORT_PENDING pending, UINT32 process_id, BOOL drop)
+{
+    const tommy_key_t pid_hash = fort_pending_proc_hash(process_id);
+
+    PFORT_PENDING_PACKET packets = NULL;
+
+    KLOCK_QUEUE_HANDLE lock_queue;
+    KeAcquireInStackQueuedSpinLock(&pending->lock, &lock_queue);
+
+    PFORT_PENDING_PROC proc = fort_pending_proc_find_locked(pending, process_id, pid_hash);
+    if (proc != NULL) {
+        fort_pending_proc_take_packets_locked(pending, proc, &packets);
+    }
+
+    KeReleaseInStackQueuedSpinLock(&lock_queue);
+
+    /* Release or drop all the process's packets at once */
+    return fort_pending_packets_complete(packets, drop);
+}
+
+FORT_API UINT16 fort_pending_expire(PFORT_PENDING pending, INT64 now)
+{
+    PFORT_PENDING_PACKET packets = NULL;
+
+    KLOCK_QUEUE_HANDLE lock_queue;
+    KeAcquireInStackQueuedSpinLock(&pending->lock, &lock_queue);
+
+    fort_pending_expire_locked(pending, now, &packets);
+
+    KeReleaseInStackQueuedSpinLock(&lock_queue);
+
+    return fort_pending_packets_complete(packets, /*drop=*/TRUE);
+}
+
+FORT_API UCHAR fort_pending_ask_check(
+        PFORT_PENDING pending, UINT32 path_hash, UINT32 endpoint, INT64 now)
+{
+    UCHAR state = FORT_PENDING_ASK_NONE;
+
+    KLOCK_QUEUE_HANDLE lock_queue;
+    KeAcquireInStackQueuedSpinLock(&pending->lock, &lock_queue);
+
+    const PFORT_PENDING_ASK ask = fort_pending_ask_ref(pending, path_hash, endpoint);
+
+    if (ask->path_hash == path_hash && ask->endpoint == endpoint && ask->expire_time > now) {
+        state = ask->state;
+    }
+
+    KeReleaseInStackQueuedSpinLock(&lock_queue);
+
+    return state;
+}
+
+FORT_API UINT16 fort_pending_ask_answer(PFORT_PENDING pending, UINT32 path_hash)
+{
+    PFORT_PENDING_PACKET packets = NULL;
+
+    KLOCK_QUEUE_HANDLE lock_queue;
+    KeAcquireInStackQueuedSpinLock(&pending->lock, &lock_queue);
+
+    /* Clear the app's outstanding prompts */
+    for (int i = 0; i < FORT_PENDING_ASK_COUNT; ++i) {
+        PFORT_PENDING_ASK ask = &pending->asks[i];
+
+        if (ask->path_hash == path_hash && ask->state != FORT_PENDING_ASK_NONE) {
+            ask->state = FORT_PENDING_ASK_NONE;
+        }
+    }
+
+    fort_pending_app_take_packets_locked(pending, path_hash, &packets);
+
+    KeReleaseInStackQueuedSpinLock(&lock_queue);
+
+    /* Reinject all the app's queued packets at once:
+     * they are classified again by the updated conf */
+    return fort_pending_packets_complete(packets, /*drop=*/FALSE);
+}
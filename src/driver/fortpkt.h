@@ -97,16 +97,56 @@ typedef struct fort_pending_packet
 
 #define FORT_PENDING_PROC_COUNT_MAX        1024
 #define FORT_PENDING_PROC_PACKET_COUNT_MAX 3
+#define FORT_PENDING_EXPIRE_MSEC           (30 * 1000)
 
+typedef struct fort_pending_limits
+{
+    UINT16 proc_count_max;
+    UINT16 proc_packet_count_max;
+
+    UINT32 expire_msec; /* pending time of a process's packets */
+} FORT_PENDING_LIMITS, *PFORT_PENDING_LIMITS;
+
+#define FORT_PENDING_ASK_COUNT 256 /* must be power of 2 */
+
+#define FORT_PENDING_ASK_NONE    0
+#define FORT_PENDING_ASK_PENDING 1 /* the prompt is outstanding */
+
+/* Cached Ask-to-Connect state of an app's remote endpoint class */
+typedef struct fort_pending_ask
+{
+    UINT32 path_hash;
+    UINT32 endpoint; /* fort_pending_ask_endpoint() */
+
+    INT64 expire_time; /* msec */
+
+    UCHAR state;
+} FORT_PENDING_ASK, *PFORT_PENDING_ASK;
+
+#define fort_pending_ask_endpoint(inbound, ip_proto, remote_port)                                  \
+    (((UINT32) (inbound) << 24) | ((UINT32) (ip_proto) << 16) | (UINT16) (remote_port))
+
+/* Synchronize with tommy_hashdyn_node! */
 typedef struct fort_pending_proc
 {
     struct fort_pending_proc *next;
+    struct fort_pending_proc *prev;
+
+    void *data; /* tommy_hashdyn_node::data */
+
+    tommy_key_t pid_hash; /* tommy_hashdyn_node::index */
+
+    tommy_node time_node; /* in the expiration ordered list */
 
     PFORT_PENDING_PACKET packets_head;
+    PFORT_PENDING_PACKET packets_tail;
+
+    INT64 expire_time; /* msec */
 
     UINT16 packet_count;
 
     UINT32 process_id;
+    UINT32 path_hash;
 } FORT_PENDING_PROC, *PFORT_PENDING_PROC;
 
 typedef struct fort_pending
@@ -116,12 +156,17 @@ typedef struct fort_pending
     HANDLE injection_transport6_in_id;
     HANDLE injection_transport6_out_id;
 
+    FORT_PENDING_LIMITS limits;
+
     UINT16 proc_count;
 
-    PFORT_PENDING_PROC proc_free;
+    tommy_list free_procs;
     tommy_arrayof procs;
+    tommy_hashdyn procs_map;
 
-    PFORT_PENDING_PROC procs_head;
+    tommy_list procs_time_list; /* the earliest expiration first */
+
+    FORT_PENDING_ASK asks[FORT_PENDING_ASK_COUNT]; /* direct-mapped cache */
 
     KSPIN_LOCK lock;
 } FORT_PENDING, *PFORT_PENDING;
@@ -172,8 +217,25 @@ FORT_API void fort_pending_close(PFORT_PENDING pending);
 
 FORT_API void fort_pending_clear(PFORT_PENDING pending);
 
-FORT_API BOOL fort_pending_add_packet(
-        PFORT_PENDING pending, PCFORT_CALLOUT_ARG ca, PFORT_CALLOUT_ALE_EXTRA cx);
+FORT_API INT64 fort_pending_now(void);
+
+FORT_API UINT32 fort_pending_path_hash(const PVOID path, UINT32 path_len);
+
+FORT_API NTSTATUS fort_pending_proc_add_packet(PFORT_PENDING pending, UINT32 process_id,
+        UINT32 path_hash, UINT32 endpoint, HANDLE completion_handle, PFORT_PENDING_PACKET pkt,
+        INT64 now);
+
+FORT_API BOOL fort_pending_add_packet(PFORT_PENDING pending, PCFORT_CALLOUT_ARG ca,
+        PFORT_CALLOUT_ALE_EXTRA cx, UINT32 path_hash, UINT32 endpoint);
+
+FORT_API UINT16 fort_pending_proc_complete(PFORT_PENDING pending, UINT32 process_id, BOOL drop);
+
+FORT_API UINT16 fort_pending_expire(PFORT_PENDING pending, INT64 now);
+
+FORT_API UCHAR fort_pending_ask_check(
+        PFORT_PENDING pending, UINT32 path_hash, UINT32 endpoint, INT64 now);
+
+FORT_API UINT16 fort_pending_ask_answer(PFORT_PENDING pending, UINT32 path_hash);
 
 #ifdef __cplusplus
 } // extern "C"
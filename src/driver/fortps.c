@@ -20,11 +20,22 @@
 #define FORT_PSTREE_NAME_LEN_MAX_SIZE (FORT_PSTREE_NAME_LEN_MAX * sizeof(WCHAR))
 #define FORT_PSTREE_NAMES_POOL_SIZE   (4 * 1024)
 
+#define FORT_PSTREE_INDEX_READ_TRIES 8
+
 #define FORT_PSNAME_DATA_OFF offsetof(FORT_PSNAME, data)
 
+/* Interned name, shared by the processes */
+/* Synchronize with tommy_hashdyn_node! */
 typedef struct fort_psname
 {
-    UINT16 refcount;
+    struct fort_psname *next;
+    struct fort_psname *prev;
+
+    PVOID unused; /* tommy_hashdyn_node::data */
+
+    tommy_key_t name_hash; /* tommy_hashdyn_node::index */
+
+    UINT32 refcount;
     UINT16 size;
     WCHAR data[1];
 } FORT_PSNAME, *PFORT_PSNAME;
@@ -117,6 +128,10 @@ typedef const FORT_PSTREE_NOTIFY_ARG *PCFORT_PSTREE_NOTIFY_ARG;
 #define fort_pstree_get_proc(ps_tree, index)                                                       \
     ((PFORT_PSNODE) tommy_arrayof_ref(&(ps_tree)->procs, (index)))
 
+/* Process ids are multiples of 4 */
+#define fort_pstree_index_slot(index, process_id)                                                  \
+    (&(index)[((process_id) / 4) & (FORT_PSTREE_INDEX_SIZE - 1)])
+
 inline static BOOL fort_is_system_process(DWORD processId, DWORD parentProcessId)
 {
     /* System (sub)processes */
@@ -191,15 +206,48 @@ static PFORT_PATH_BUFFER fort_pstree_path_buffer_new(void)
     return pb;
 }
 
-static PFORT_PSNAME fort_pstree_name_new(PFORT_PSTREE ps_tree, UINT16 name_size)
+static PFORT_PSNAME fort_pstree_name_find(
+        PFORT_PSTREE ps_tree, const PVOID name_buf, UINT16 name_size, tommy_key_t name_hash)
 {
-    PFORT_PSNAME ps_name = fort_pool_malloc(&ps_tree->pool_list,
-            FORT_PSNAME_DATA_OFF + name_size + sizeof(WCHAR)); /* include terminating zero */
+    PFORT_PSNAME ps_name = (PFORT_PSNAME) tommy_hashdyn_bucket(&ps_tree->names_map, name_hash);
+
+    while (ps_name != NULL) {
+        if (ps_name->name_hash == name_hash && ps_name->size == name_size
+                && RtlCompareMemory(ps_name->data, name_buf, name_size) == name_size)
+            return ps_name;
+
+        ps_name = ps_name->next;
+    }
+
+    return NULL;
+}
+
+static PFORT_PSNAME fort_pstree_name_intern(
+        PFORT_PSTREE ps_tree, const PVOID name_buf, UINT16 name_size)
+{
+    /* Reuse the hash by the exe-apps lookup */
+    const tommy_key_t name_hash = fort_conf_exe_path_hash(name_buf, name_size);
+
+    PFORT_PSNAME ps_name = fort_pstree_name_find(ps_tree, name_buf, name_size, name_hash);
     if (ps_name != NULL) {
-        ps_name->refcount = 1;
-        ps_name->size = name_size;
-        ps_name->data[name_size / sizeof(WCHAR)] = L'\0';
+        ++ps_name->refcount;
+        return ps_name;
     }
+
+    ps_name = fort_pool_malloc(&ps_tree->pool_list,
+            FORT_PSNAME_DATA_OFF + name_size + sizeof(WCHAR)); /* include terminating zero */
+    if (ps_name == NULL)
+        return NULL;
+
+    ps_name->refcount = 1;
+    ps_name->size = name_size;
+
+    RtlCopyMemory(ps_name->data, name_buf, name_size);
+    ps_name->data[name_size / sizeof(WCHAR)] = L'\0';
+
+    tommy_hashdyn_insert(
+            &ps_tree->names_map, (tommy_hashdyn_node *) ps_name, /*unused=*/NULL, name_hash);
+
     return ps_name;
 }
 
@@ -208,9 +256,141 @@ static void fort_pstree_name_del(PFORT_PSTREE ps_tree, PFORT_PSNAME ps_name)
     if (ps_name == NULL)
         return;
 
-    if (--ps_name->refcount == 0) {
-        fort_pool_free(&ps_tree->pool_list, ps_name);
+    if (--ps_name->refcount != 0)
+        return;
+
+    tommy_hashdyn_remove_existing(&ps_tree->names_map, (tommy_hashdyn_node *) ps_name);
+
+    /* The lock-free readers may still use the name */
+    tommy_list_insert_tail_check(&ps_tree->free_names[ps_tree->epoch], (tommy_node *) ps_name);
+}
+
+static LONG fort_pstree_readers_count(PFORT_PSTREE ps_tree, LONG epoch)
+{
+    LONG count = 0;
+
+    MemoryBarrier();
+
+    for (int i = 0; i < FORT_PSTREE_READERS_COUNT; ++i) {
+        count += ps_tree->readers[i].count[epoch];
+    }
+
+    return count;
+}
+
+static void fort_pstree_readers_wait(PFORT_PSTREE ps_tree)
+{
+    while (fort_pstree_readers_count(ps_tree, 0) + fort_pstree_readers_count(ps_tree, 1) != 0) {
+        LARGE_INTEGER delay = {
+            .QuadPart = -1 * 1000 * 10 /* sleep 1000us (1ms) */
+        };
+
+        KeDelayExecutionThread(KernelMode, FALSE, &delay);
+    }
+}
+
+static void fort_pstree_names_free(PFORT_PSTREE ps_tree, tommy_list *names)
+{
+    tommy_node *name_node;
+    while ((name_node = tommy_list_head(names)) != NULL) {
+        tommy_list_remove_existing(names, name_node);
+
+        fort_pool_free(&ps_tree->pool_list, name_node);
+    }
+}
+
+static void fort_pstree_names_reclaim(PFORT_PSTREE ps_tree)
+{
+    const LONG epoch = ps_tree->epoch;
+    const LONG old_epoch = epoch ^ 1;
+
+    if (tommy_list_empty(&ps_tree->free_names[epoch])
+            && tommy_list_empty(&ps_tree->free_names[old_epoch]))
+        return;
+
+    /* The names are already removed from the index;
+     * the old epoch's names may be used by its readers only */
+    if (fort_pstree_readers_count(ps_tree, old_epoch) != 0)
+        return;
+
+    fort_pstree_names_free(ps_tree, &ps_tree->free_names[old_epoch]);
+
+    /* The new readers start in the old epoch, the current epoch's names wait for its readers */
+    if (!tommy_list_empty(&ps_tree->free_names[epoch])) {
+        InterlockedExchange(&ps_tree->epoch, old_epoch);
+    }
+}
+
+static void fort_pstree_index_write(
+        PFORT_PSINDEX slot, UINT32 process_id, UINT16 flags, PFORT_PSNAME ps_name)
+{
+    const LONG seq = slot->seq;
+
+    slot->seq = seq + 1;
+    MemoryBarrier();
+
+    slot->process_id = process_id;
+    slot->flags = flags;
+    slot->ps_name = ps_name;
+
+    MemoryBarrier();
+    slot->seq = seq + 2;
+}
+
+static void fort_pstree_index_update(PFORT_PSTREE ps_tree, PFORT_PSNODE proc)
+{
+    if (ps_tree->index == NULL)
+        return;
+
+    const PFORT_PSINDEX slot = fort_pstree_index_slot(ps_tree->index, proc->process_id);
+
+    /* The colliding process is looked up under the lock */
+    if (slot->process_id != 0 && slot->process_id != proc->process_id)
+        return;
+
+    fort_pstree_index_write(slot, proc->process_id, proc->flags, proc->ps_name);
+}
+
+static void fort_pstree_index_remove(PFORT_PSTREE ps_tree, PFORT_PSNODE proc)
+{
+    if (ps_tree->index == NULL)
+        return;
+
+    const PFORT_PSINDEX slot = fort_pstree_index_slot(ps_tree->index, proc->process_id);
+
+    if (slot->process_id != proc->process_id)
+        return;
+
+    fort_pstree_index_write(slot, /*process_id=*/0, /*flags=*/0, /*ps_name=*/NULL);
+}
+
+static BOOL fort_pstree_index_read(PFORT_PSTREE ps_tree, DWORD processId, PFORT_PSINDEX entry)
+{
+    /* The index is detached on close */
+    const PFORT_PSINDEX index = ps_tree->index;
+    if (index == NULL)
+        return FALSE;
+
+    const PFORT_PSINDEX slot = fort_pstree_index_slot(index, processId);
+
+    for (int tries = 0; tries < FORT_PSTREE_INDEX_READ_TRIES; ++tries) {
+        const LONG seq = slot->seq;
+        MemoryBarrier();
+
+        if ((seq & 1) != 0)
+            continue; /* writing */
+
+        entry->process_id = slot->process_id;
+        entry->flags = slot->flags;
+        entry->ps_name = slot->ps_name;
+
+        MemoryBarrier();
+
+        if (slot->seq == seq)
+            return (entry->process_id == processId);
     }
+
+    return FALSE;
 }
 
 static BOOL fort_pstree_svchost_path_check(PCUNICODE_STRING path)
@@ -277,23 +457,23 @@ static PFORT_PSNAME fort_pstree_create_service_name(
         PFORT_PSTREE ps_tree, PCUNICODE_STRING serviceName)
 {
     const USHORT nameLen = serviceName->Length;
+    if (nameLen > FORT_SERVICE_INFO_NAME_MAX_SIZE)
+        return NULL;
 
-    PFORT_PSNAME ps_name = fort_pstree_name_new(ps_tree, FORT_SVCHOST_PREFIX_SIZE + nameLen);
+    WCHAR buffer[(FORT_SVCHOST_PREFIX_SIZE + FORT_SERVICE_INFO_NAME_MAX_SIZE) / sizeof(WCHAR)];
 
-    if (ps_name != NULL) {
-        PCHAR data = (PCHAR) &ps_name->data;
-        RtlCopyMemory(data, FORT_SVCHOST_PREFIX, FORT_SVCHOST_PREFIX_SIZE);
+    PCHAR data = (PCHAR) buffer;
+    RtlCopyMemory(data, FORT_SVCHOST_PREFIX, FORT_SVCHOST_PREFIX_SIZE);
 
-        UNICODE_STRING nameString;
-        nameString.Length = nameLen;
-        nameString.MaximumLength = nameLen;
-        nameString.Buffer = (PWSTR) (data + FORT_SVCHOST_PREFIX_SIZE);
+    UNICODE_STRING nameString;
+    nameString.Length = nameLen;
+    nameString.MaximumLength = nameLen;
+    nameString.Buffer = (PWSTR) (data + FORT_SVCHOST_PREFIX_SIZE);
 
-        /* RtlDowncaseUnicodeString() must be called in <DISPATCH level only! */
-        fort_ascii_downcase(&nameString, serviceName);
-    }
+    /* RtlDowncaseUnicodeString() must be called in <DISPATCH level only! */
+    fort_ascii_downcase(&nameString, serviceName);
 
-    return ps_name;
+    return fort_pstree_name_intern(ps_tree, buffer, FORT_SVCHOST_PREFIX_SIZE + nameLen);
 }
 
 static void fort_pstree_proc_set_service_name(PFORT_PSNODE proc, PFORT_PSNAME ps_name)
@@ -354,7 +534,10 @@ static void fort_pstree_proc_del(PFORT_PSTREE ps_tree, PFORT_PSNODE proc)
 {
     --ps_tree->procs_n;
 
-    /* Delete from pool */
+    /* Delete from index */
+    fort_pstree_index_remove(ps_tree, proc);
+
+    /* Delete from names */
     fort_pstree_name_del(ps_tree, proc->ps_name);
 
     proc->ps_name = NULL;
@@ -394,13 +577,7 @@ static PFORT_PSNODE fort_pstree_find_proc(PFORT_PSTREE ps_tree, DWORD processId)
 inline static void fort_pstree_proc_set_name(
         PFORT_PSTREE ps_tree, PFORT_PSNODE proc, const PVOID path_buf, UINT16 path_len)
 {
-    PFORT_PSNAME ps_name = fort_pstree_name_new(ps_tree, path_len);
-    if (ps_name == NULL)
-        return;
-
-    RtlCopyMemory(ps_name->data, path_buf, path_len);
-
-    proc->ps_name = ps_name;
+    proc->ps_name = fort_pstree_name_intern(ps_tree, path_buf, path_len);
 }
 
 inline static void fort_pstree_check_proc_app_flags(PFORT_PSTREE ps_tree, PFORT_PSNODE proc,
@@ -494,6 +671,8 @@ static PFORT_PSNODE fort_pstree_handle_new_proc(PFORT_PSTREE ps_tree, PCFORT_PSI
 
     fort_pstree_check_proc_inheritance(ps_tree, psi, proc);
 
+    fort_pstree_index_update(ps_tree, proc);
+
     return proc;
 }
 
@@ -578,6 +757,8 @@ inline static BOOL fort_pstree_notify_process_prepare(
     PFORT_PSNODE proc = fort_pstree_find_proc_hash(ps_tree, psi->processId, psi->pid_hash);
     if (proc != NULL) {
         fort_pstree_proc_del(ps_tree, proc);
+
+        fort_pstree_names_reclaim(ps_tree);
     }
 
     /* Check parent process */
@@ -618,6 +799,11 @@ inline static void fort_pstree_notify_process(PFORT_PSTREE ps_tree, PCFORT_PSTRE
     }
 #endif
 
+    if (createInfo == NULL) {
+        /* Drop the exited process's pending packets: its pid can be reused */
+        fort_pending_proc_complete(&fort_device()->pending, processId, /*drop=*/TRUE);
+    }
+
     if (!fort_pstree_notify_process_prepare(ps_tree, createInfo, &psi))
         return;
 
@@ -674,9 +860,18 @@ FORT_API void fort_pstree_open(PFORT_PSTREE ps_tree)
     fort_pool_init(&ps_tree->pool_list, FORT_PSTREE_NAMES_POOL_SIZE);
 
     tommy_list_init(&ps_tree->free_procs);
+    tommy_list_init(&ps_tree->free_names[0]);
+    tommy_list_init(&ps_tree->free_names[1]);
 
     tommy_arrayof_init(&ps_tree->procs, sizeof(FORT_PSNODE));
     tommy_hashdyn_init(&ps_tree->procs_map);
+    tommy_hashdyn_init(&ps_tree->names_map);
+
+    ps_tree->index =
+            fort_mem_alloc(FORT_PSTREE_INDEX_SIZE * sizeof(FORT_PSINDEX), FORT_PSTREE_POOL_TAG);
+    if (ps_tree->index != NULL) {
+        RtlZeroMemory(ps_tree->index, FORT_PSTREE_INDEX_SIZE * sizeof(FORT_PSINDEX));
+    }
 
     KeInitializeSpinLock(&ps_tree->lock);
 
@@ -687,15 +882,33 @@ FORT_API void fort_pstree_close(PFORT_PSTREE ps_tree)
 {
     fort_pstree_update(ps_tree, /*active=*/FALSE); /* Stop process monitor */
 
+    PFORT_PSINDEX index;
+
     KLOCK_QUEUE_HANDLE lock_queue;
+    KeAcquireInStackQueuedSpinLock(&ps_tree->lock, &lock_queue);
+    {
+        /* The new readers fall back to the locked lookup */
+        index = ps_tree->index;
+        ps_tree->index = NULL;
+    }
+    KeReleaseInStackQueuedSpinLock(&lock_queue);
+
+    /* Wait for the lock-free readers of the index and names */
+    fort_pstree_readers_wait(ps_tree);
+
     KeAcquireInStackQueuedSpinLock(&ps_tree->lock, &lock_queue);
     {
         fort_pool_done(&ps_tree->pool_list);
 
         tommy_arrayof_done(&ps_tree->procs);
         tommy_hashdyn_done(&ps_tree->procs_map);
+        tommy_hashdyn_done(&ps_tree->names_map);
     }
     KeReleaseInStackQueuedSpinLock(&lock_queue);
+
+    if (index != NULL) {
+        fort_mem_free(index, FORT_PSTREE_POOL_TAG);
+    }
 }
 
 inline static BOOL fort_pstree_enum_process_exists(
@@ -776,48 +989,108 @@ FORT_API void fort_pstree_enum_processes(PFORT_PSTREE ps_tree)
     fort_mem_free(buffer, FORT_PSTREE_POOL_TAG);
 }
 
-static BOOL fort_pstree_get_proc_name_locked(PFORT_PSTREE ps_tree, DWORD processId,
-        PUNICODE_STRING path, BOOL *isSvcHost, BOOL *inherited)
+FORT_API void fort_pstree_reclaim(PFORT_PSTREE ps_tree)
 {
-    PFORT_PSNODE proc = fort_pstree_find_proc(ps_tree, processId);
-    if (proc == NULL)
-        return FALSE;
+    KLOCK_QUEUE_HANDLE lock_queue;
+    KeAcquireInStackQueuedSpinLock(&ps_tree->lock, &lock_queue);
+    {
+        fort_pstree_names_reclaim(ps_tree);
+    }
+    KeReleaseInStackQueuedSpinLock(&lock_queue);
+}
 
-    const UINT16 procFlags = proc->flags;
-    *isSvcHost = (procFlags & FORT_PSNODE_IS_SVCHOST) != 0;
+FORT_API UINT32 fort_pstree_read_begin(PFORT_PSTREE ps_tree)
+{
+    const UINT32 cpu = KeGetCurrentProcessorIndex() & (FORT_PSTREE_READERS_COUNT - 1);
 
-    PFORT_PSNAME ps_name = proc->ps_name;
-    if (ps_name == NULL)
-        return FALSE;
+    PFORT_PSREADERS readers = &ps_tree->readers[cpu];
 
-    if ((procFlags & (FORT_PSNODE_NAME_INHERIT | FORT_PSNODE_NAME_CUSTOM))
-            == FORT_PSNODE_NAME_INHERIT)
+    for (;;) {
+        const LONG epoch = ps_tree->epoch;
+
+        InterlockedIncrement(&readers->count[epoch]);
+
+        /* The epoch may be changed meanwhile */
+        if (ps_tree->epoch == epoch)
+            return (cpu << 1) | epoch;
+
+        InterlockedDecrement(&readers->count[epoch]);
+    }
+}
+
+FORT_API void fort_pstree_read_end(PFORT_PSTREE ps_tree, UINT32 read_token)
+{
+    /* The thread may be moved to another CPU meanwhile */
+    PFORT_PSREADERS readers = &ps_tree->readers[read_token >> 1];
+
+    InterlockedDecrement(&readers->count[read_token & 1]);
+}
+
+static BOOL fort_pstree_get_proc_entry_locked(
+        PFORT_PSTREE ps_tree, DWORD processId, PFORT_PSINDEX entry)
+{
+    PFORT_PSNODE proc = fort_pstree_find_proc(ps_tree, processId);
+    if (proc == NULL)
         return FALSE;
 
-    path->Length = ps_name->size;
-    path->MaximumLength = ps_name->size;
-    path->Buffer = ps_name->data;
+    /* The slot may be released by the colliding process */
+    fort_pstree_index_update(ps_tree, proc);
 
-    *inherited = (procFlags & FORT_PSNODE_NAME_INHERITED) != 0;
+    entry->process_id = proc->process_id;
+    entry->flags = proc->flags;
+    entry->ps_name = proc->ps_name;
 
     return TRUE;
 }
 
-FORT_API BOOL fort_pstree_get_proc_name(PFORT_PSTREE ps_tree, DWORD processId, PUNICODE_STRING path,
-        BOOL *isSvcHost, BOOL *inherited)
+static BOOL fort_pstree_get_proc_entry(PFORT_PSTREE ps_tree, DWORD processId, PFORT_PSINDEX entry)
 {
+    if (fort_pstree_index_read(ps_tree, processId, entry))
+        return TRUE;
+
     BOOL res;
 
     KLOCK_QUEUE_HANDLE lock_queue;
     KeAcquireInStackQueuedSpinLock(&ps_tree->lock, &lock_queue);
     {
-        res = fort_pstree_get_proc_name_locked(ps_tree, processId, path, isSvcHost, inherited);
+        res = fort_pstree_get_proc_entry_locked(ps_tree, processId, entry);
     }
     KeReleaseInStackQueuedSpinLock(&lock_queue);
 
     return res;
 }
 
+FORT_API BOOL fort_pstree_get_proc_name(PFORT_PSTREE ps_tree, DWORD processId, PUNICODE_STRING path,
+        tommy_key_t *path_hash, BOOL *isSvcHost, BOOL *inherited)
+{
+    if (processId == 0)
+        return FALSE;
+
+    FORT_PSINDEX entry;
+    if (!fort_pstree_get_proc_entry(ps_tree, processId, &entry))
+        return FALSE;
+
+    const UINT16 procFlags = entry.flags;
+    *isSvcHost = (procFlags & FORT_PSNODE_IS_SVCHOST) != 0;
+
+    PFORT_PSNAME ps_name = entry.ps_name;
+    if (ps_name == NULL)
+        return FALSE;
+
+    if ((procFlags & (FORT_PSNODE_NAME_INHERIT | FORT_PSNODE_NAME_CUSTOM))
+            == FORT_PSNODE_NAME_INHERIT)
+        return FALSE;
+
+    path->Length = ps_name->size;
+    path->MaximumLength = ps_name->size;
+    path->Buffer = ps_name->data;
+
+    *path_hash = ps_name->name_hash;
+    *inherited = (procFlags & FORT_PSNODE_NAME_INHERITED) != 0;
+
+    return TRUE;
+}
+
 inline static void fort_pstree_update_service_proc(
         PFORT_PSTREE ps_tree, PCUNICODE_STRING serviceName, DWORD processId)
 {
@@ -826,16 +1099,20 @@ inline static void fort_pstree_update_service_proc(
     PFORT_PSNODE proc = fort_pstree_find_proc_hash(ps_tree, processId, pid_hash);
     if (proc == NULL) {
         proc = fort_pstree_proc_new(ps_tree, pid_hash);
+        if (proc == NULL)
+            return;
 
         proc->process_id = processId;
         proc->flags = 0;
     }
 
-    if (proc != NULL && proc->ps_name == NULL) {
+    if (proc->ps_name == NULL) {
         PFORT_PSNAME ps_name = fort_pstree_create_service_name(ps_tree, serviceName);
 
         fort_pstree_proc_set_service_name(proc, ps_name);
     }
+
+    fort_pstree_index_update(ps_tree, proc);
 }
 
 static int fort_pstree_update_service(
@@ -9,17 +9,50 @@
 
 #define FORT_PSTREE_ACTIVE 0x0001
 
+#define FORT_PSTREE_INDEX_SIZE 8192 /* must be power of 2 */
+
+/* Lock-free read slot of a process, the writers are serialized by the pstree lock */
+typedef struct fort_psindex
+{
+    LONG volatile seq; /* odd while writing */
+
+    UINT32 process_id;
+    UINT16 flags;
+
+    struct fort_psname *ps_name;
+} FORT_PSINDEX, *PFORT_PSINDEX;
+
+typedef const FORT_PSINDEX *PCFORT_PSINDEX;
+
+#define FORT_PSTREE_READERS_COUNT 64 /* must be power of 2 */
+
+/* Per-CPU counters of the lock-free readers by the reclamation epoch */
+typedef struct fort_psreaders
+{
+    LONG volatile count[2];
+
+    UCHAR padding[64 - 2 * sizeof(LONG)]; /* own cache line */
+} FORT_PSREADERS, *PFORT_PSREADERS;
+
 typedef struct fort_pstree
 {
     UCHAR volatile flags;
 
     UINT16 procs_n;
 
+    LONG volatile epoch; /* of the lock-free readers: 0 or 1 */
+
     FORT_POOL_LIST pool_list;
     tommy_list free_procs;
+    tommy_list free_names[2]; /* by epoch, freed when the epoch's readers are done */
 
     tommy_arrayof procs;
     tommy_hashdyn procs_map;
+    tommy_hashdyn names_map;
+
+    PFORT_PSINDEX index; /* indexed by process id */
+
+    FORT_PSREADERS readers[FORT_PSTREE_READERS_COUNT];
 
     KSPIN_LOCK lock;
 } FORT_PSTREE, *PFORT_PSTREE;
@@ -34,8 +67,15 @@ FORT_API void fort_pstree_close(PFORT_PSTREE ps_tree);
 
 FORT_API void fort_pstree_enum_processes(PFORT_PSTREE ps_tree);
 
+FORT_API void fort_pstree_reclaim(PFORT_PSTREE ps_tree);
+
+FORT_API UINT32 fort_pstree_read_begin(PFORT_PSTREE ps_tree);
+
+FORT_API void fort_pstree_read_end(PFORT_PSTREE ps_tree, UINT32 read_token);
+
+/* The path is valid until fort_pstree_read_end() */
 FORT_API BOOL fort_pstree_get_proc_name(PFORT_PSTREE ps_tree, DWORD processId, PUNICODE_STRING path,
-        BOOL *isSvcHost, BOOL *inherited);
+        tommy_key_t *path_hash, BOOL *isSvcHost, BOOL *inherited);
 
 FORT_API void fort_pstree_update_services(
         PFORT_PSTREE ps_tree, const PFORT_SERVICE_INFO_LIST services, ULONG data_len);
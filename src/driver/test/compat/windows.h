@@ -0,0 +1,45 @@
+#ifndef COMPAT_WINDOWS_H
+#define COMPAT_WINDOWS_H
+
+/* Minimal Windows types to build the driver's common code on Linux (fuzzing) */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+typedef int BOOL;
+typedef signed char INT8;
+typedef unsigned char UCHAR, UINT8;
+typedef short INT16;
+typedef unsigned short UINT16, WCHAR;
+typedef int INT32, LONG;
+typedef unsigned int UINT32, ULONG;
+typedef long long INT64;
+typedef unsigned long long UINT64;
+typedef char CHAR, *PCHAR;
+typedef void *PVOID;
+
+#define TRUE  1
+#define FALSE 0
+
+#define ERROR_INVALID_PARAMETER  87
+#define STATUS_INVALID_PARAMETER ((LONG) 0xC000000D)
+
+#define RtlCopyMemory memcpy
+#define RtlMoveMemory memmove
+#define RtlZeroMemory(p, n) memset((p), 0, (n))
+
+/* wchar_t is 32-bit on Linux */
+static inline const WCHAR *compat_wcschr(const WCHAR *str, WCHAR c)
+{
+    for (;; ++str) {
+        if (*str == c)
+            return str;
+        if (*str == 0)
+            return NULL;
+    }
+}
+
+#define wcschr compat_wcschr
+
+#endif // COMPAT_WINDOWS_H
@@ -0,0 +1 @@
+/* Empty: not needed by the common code on Linux */
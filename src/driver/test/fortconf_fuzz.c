@@ -0,0 +1,393 @@
+/* Fort Firewall Driver: Configuration Fuzzer
+ *
+ * Feeds arbitrary blobs to the config validators and runs the lookups on the accepted ones.
+ * The accepted zone deltas are applied to the seed zones.
+ *
+ * The blob layout is not naturally aligned, as in the driver.
+ *
+ * libFuzzer (Linux):
+ *   clang -g -O1 -fsanitize=fuzzer,address,undefined -fno-sanitize=alignment -DFORT_FUZZER \
+ *       -Itest/compat test/fortconf_fuzz.c -o fortconf_fuzz
+ *
+ * Throughput of the validation and lookups on mutated seed blobs:
+ *   cc -O2 -Itest/compat test/fortconf_fuzz.c -o fortconf_bench && ./fortconf_bench
+ */
+
+#define FORT_AMALG
+
+#include "../common/fort_wildmatch.c"
+#include "../common/fortconf.c"
+
+#include <stdlib.h>
+
+#ifndef FORT_FUZZER
+#    include <stdio.h>
+#    include <time.h>
+#endif
+
+enum FortFuzzBlob {
+    FORT_FUZZ_BLOB_CONF = 0,
+    FORT_FUZZ_BLOB_ZONES,
+    FORT_FUZZ_BLOB_ZONE_DELTA,
+    FORT_FUZZ_BLOB_COUNT,
+};
+
+#define SEED_BUF_SIZE 4096
+
+static const WCHAR fuzz_app_path[] = { 'c', ':', '\\', 'a', '.', 'e', 'x', 'e', 0 };
+
+static BOOL fuzz_zones_ip_included(void *ctx, UINT32 zones_mask, const UINT32 *remote_ip, BOOL isIPv6)
+{
+    const PFORT_CONF_ZONES zones = ctx;
+
+    if (zones == NULL)
+        return FALSE;
+
+    zones_mask &= zones->mask;
+
+    for (int zone_index = 0; zones_mask != 0; ++zone_index, zones_mask >>= 1) {
+        if ((zones_mask & 1) != 0
+                && fort_conf_ip_inlist(
+                        remote_ip, fort_conf_zones_addr_list_ref(zones, zone_index), isIPv6))
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
+static char *seed_addr_list(char *p, const UINT32 *ip, UINT32 ip_n, UINT32 pair_from,
+        UINT32 pair_to)
+{
+    PFORT_CONF_ADDR4_LIST addr_list = (PFORT_CONF_ADDR4_LIST) p;
+    addr_list->ip_n = ip_n;
+    addr_list->pair_n = 1;
+    memcpy(addr_list->ip, ip, ip_n * sizeof(UINT32));
+    addr_list->ip[ip_n] = pair_from;
+    addr_list->ip[ip_n + 1] = pair_to;
+
+    PFORT_CONF_ADDR6_LIST addr6_list = fort_conf_addr6_list_ref(addr_list);
+    addr6_list->ip_n = 0;
+    addr6_list->pair_n = 0;
+
+    return p + fort_conf_addr_list_size(addr_list);
+}
+
+/* Address list with an IPv6 range, which is the last patched array of the list */
+static char *seed_zone_addr_list(char *p, const UINT32 *ip, UINT32 ip_n, UINT32 pair_from,
+        UINT32 pair_to, UCHAR ip6_pair_last)
+{
+    PFORT_CONF_ADDR4_LIST addr_list = (PFORT_CONF_ADDR4_LIST) p;
+    seed_addr_list(p, ip, ip_n, pair_from, pair_to);
+
+    PFORT_CONF_ADDR6_LIST addr6_list = fort_conf_addr6_list_ref(addr_list);
+    addr6_list->pair_n = 1;
+
+    UCHAR *ip6 = (UCHAR *) addr6_list->ip;
+    memset(ip6, 0, 2 * sizeof(ip6_addr_t));
+    ip6[sizeof(ip6_addr_t) - 1] = 1;
+    ip6[2 * sizeof(ip6_addr_t) - 1] = ip6_pair_last;
+
+    return p + fort_conf_addr_list_size(addr_list);
+}
+
+static UINT32 seed_zones(char *buf)
+{
+    PFORT_CONF_ZONES zones = (PFORT_CONF_ZONES) buf;
+    memset(zones, 0, FORT_CONF_ZONES_DATA_OFF);
+
+    const UINT32 ip[] = { 0x01010101, 0x08080808 };
+
+    zones->mask = zones->enabled_mask = 0x5;
+    zones->addr_off[0] = 0;
+
+    char *p = seed_addr_list(zones->data, ip, 2, 0x0A000000, 0x0AFFFFFF);
+    zones->addr_off[2] = (UINT32) (p - zones->data);
+    p = seed_zone_addr_list(p, ip, 2, 0xC0A80000, 0xC0A8FFFF, 0xFF);
+
+    return (UINT32) (p - buf);
+}
+
+static PFORT_CONF_ZONES fuzz_seed_zones(void)
+{
+    static UINT32 zones_buf[SEED_BUF_SIZE / sizeof(UINT32)];
+    static UINT32 zones_size = 0;
+
+    if (zones_size == 0) {
+        zones_size = seed_zones((char *) zones_buf);
+    }
+
+    return (PFORT_CONF_ZONES) zones_buf;
+}
+
+static UINT32 fuzz_conf_lookup(const PFORT_CONF conf, const PFORT_CONF_ZONES zones)
+{
+    const UINT32 ip4 = 0x0A000001;
+    const UINT32 ip6[4] = { 0, 0, 0, 0x01000000 };
+    const FORT_TIME time = { .hour = 12, .minute = 30 };
+    int periods_n = 0;
+
+    UINT32 res = fort_conf_ip_is_inet(conf, fuzz_zones_ip_included, zones, &ip4, FALSE);
+    res += fort_conf_ip_inet_included(conf, fuzz_zones_ip_included, zones, ip6, TRUE);
+
+    const FORT_APP_DATA app_data = fort_conf_app_find(conf, (const PVOID) fuzz_app_path,
+            sizeof(fuzz_app_path) - sizeof(WCHAR), fort_conf_app_exe_find, /*exe_context=*/NULL);
+    res += app_data.flags.v;
+
+    INT8 block_reason = 0;
+    fort_conf_app_perms_mask_init(conf, conf->flags.group_bits);
+    res += fort_conf_app_blocked(conf, app_data.flags, &block_reason);
+
+    res += fort_conf_app_period_bits(conf, time, &periods_n);
+
+    return res;
+}
+
+/* Apply the zone delta to the seed zones */
+static UINT32 fuzz_zones_patch(const PFORT_CONF_ZONE_DELTA zone_delta)
+{
+    const PFORT_CONF_ZONES zones = fuzz_seed_zones();
+
+    const UINT32 size = fort_conf_zones_patch_size(zones, zone_delta);
+    if (size == 0)
+        return 0;
+
+    /* Exactly sized to catch the overflows */
+    PFORT_CONF_ZONES out_zones = malloc(size);
+    UINT32 res = 0;
+
+    if (fort_conf_zones_patch(zones, zone_delta, out_zones)) {
+        /* The patched zones must be valid */
+        if (!fort_conf_zones_check(out_zones, size))
+            abort();
+
+        const UINT32 ip4 = 0x0A000001;
+        res = 1 + fuzz_zones_ip_included(out_zones, (UINT32) -1, &ip4, FALSE);
+    }
+
+    free(out_zones);
+
+    return res;
+}
+
+static UINT32 fuzz_blob(const UCHAR *data, size_t size)
+{
+    if (size < 1 || size > FORT_CONF_IP_MAX)
+        return 0;
+
+    const UCHAR blob_type = data[0] % FORT_FUZZ_BLOB_COUNT;
+    const UINT32 len = (UINT32) size - 1;
+
+    /* Keep the blob aligned as the driver's pool buffers are */
+    UINT32 *buf = malloc(len + sizeof(UINT32));
+    memcpy(buf, data + 1, len);
+
+    UINT32 res = 0;
+
+    switch (blob_type) {
+    case FORT_FUZZ_BLOB_CONF: {
+        const PFORT_CONF conf = (PFORT_CONF) buf;
+        if (fort_conf_check(conf, len)) {
+            res = 1 + fuzz_conf_lookup(conf, NULL);
+        }
+    } break;
+    case FORT_FUZZ_BLOB_ZONES: {
+        const PFORT_CONF_ZONES zones = (PFORT_CONF_ZONES) buf;
+        if (fort_conf_zones_check(zones, len)) {
+            const UINT32 ip4 = 0x0A000001;
+            res = 1 + fuzz_zones_ip_included(zones, (UINT32) -1, &ip4, FALSE);
+        }
+    } break;
+    case FORT_FUZZ_BLOB_ZONE_DELTA: {
+        const PFORT_CONF_ZONE_DELTA zone_delta = (PFORT_CONF_ZONE_DELTA) buf;
+        if (fort_conf_zone_delta_check(zone_delta, len)) {
+            res = 1
+                    + fort_conf_addr_list_size(fort_conf_zone_delta_removed_list_ref(zone_delta))
+                    + fort_conf_addr_list_size(fort_conf_zone_delta_added_list_ref(zone_delta))
+                    + fuzz_zones_patch(zone_delta);
+        }
+    } break;
+    }
+
+    free(buf);
+
+    return res;
+}
+
+#ifdef FORT_FUZZER
+
+int LLVMFuzzerTestOneInput(const UCHAR *data, size_t size)
+{
+    fuzz_blob(data, size);
+    return 0;
+}
+
+#else
+
+static char *seed_app_entry(char *p, const char *path, UINT16 flags)
+{
+    PFORT_APP_ENTRY app_entry = (PFORT_APP_ENTRY) p;
+    const UINT16 path_n = (UINT16) strlen(path);
+
+    memset(app_entry, 0, FORT_CONF_APP_ENTRY_PATH_OFF);
+    app_entry->app_data.flags.v = flags;
+    app_entry->path_len = path_n * sizeof(WCHAR);
+
+    for (UINT16 i = 0; i <= path_n; ++i) {
+        app_entry->path[i] = (UCHAR) path[i];
+    }
+
+    return p + FORT_CONF_APP_ENTRY_SIZE(app_entry->path_len);
+}
+
+/* Same layout as ConfUtil::writeConf() */
+static UINT32 seed_conf(char *buf)
+{
+    PFORT_CONF conf = (PFORT_CONF) buf;
+    memset(conf, 0, FORT_CONF_DATA_OFF);
+
+    char *data = conf->data;
+    char *p = data;
+
+    /* Address Groups */
+    conf->addr_groups_off = 0;
+    {
+        UINT32 *offsets = (UINT32 *) p;
+        p += FORT_CONF_ADDR_GROUP_MIN * sizeof(UINT32);
+
+        for (int i = 0; i < FORT_CONF_ADDR_GROUP_MIN; ++i) {
+            const UINT32 ip[] = { 0x08080808, 0x0A000001 + i, 0xC0A80001 };
+
+            PFORT_CONF_ADDR_GROUP addr_group = (PFORT_CONF_ADDR_GROUP) p;
+            memset(addr_group, 0, FORT_CONF_ADDR_GROUP_OFF);
+            offsets[i] = (UINT32) (p - (char *) offsets);
+
+            char *list_end = seed_addr_list(addr_group->data, ip, 3, 0x0A000000, 0x0AFFFFFF);
+            addr_group->exclude_off = (UINT32) (list_end - addr_group->data);
+            p = seed_addr_list(list_end, ip, 1, 0xAC100000, 0xAC1FFFFF);
+        }
+    }
+
+    /* App Periods */
+    conf->app_periods_off = (UINT32) (p - data);
+    conf->app_periods_n = 1;
+    conf->flags.group_bits = 0x3;
+    {
+        PFORT_PERIOD periods = (PFORT_PERIOD) p;
+        periods[0].v = 0;
+        periods[1].from.hour = 9;
+        periods[1].to.hour = 18;
+        p += 2 * sizeof(FORT_PERIOD);
+    }
+
+    /* Wildcard Apps */
+    conf->wild_apps_off = (UINT32) (p - data);
+    conf->wild_apps_n = 1;
+    p = seed_app_entry(p, "c:\\*\\b.exe", 1);
+
+    /* Prefix Apps */
+    conf->prefix_apps_off = (UINT32) (p - data);
+    conf->prefix_apps_n = 1;
+    {
+        UINT32 *offsets = (UINT32 *) p;
+        char *entries = p + FORT_CONF_STR_HEADER_SIZE(1);
+
+        offsets[0] = 0;
+        p = seed_app_entry(entries, "c:\\windows\\", 2);
+        offsets[1] = (UINT32) (p - entries);
+    }
+
+    /* Exe Apps */
+    conf->exe_apps_off = (UINT32) (p - data);
+    conf->exe_apps_n = 2;
+    p = seed_app_entry(p, "c:\\a.exe", 4);
+    p = seed_app_entry(p, "c:\\c.exe", 8);
+
+    return (UINT32) (p - buf);
+}
+
+/* Patches the last seed zone */
+static UINT32 seed_zone_delta(char *buf)
+{
+    PFORT_CONF_ZONE_DELTA zone_delta = (PFORT_CONF_ZONE_DELTA) buf;
+    memset(zone_delta, 0, FORT_CONF_ZONE_DELTA_OFF);
+
+    const UINT32 ip[] = { 0x01010101 };
+
+    zone_delta->zone_id = 3;
+
+    char *p = seed_zone_addr_list(zone_delta->data, ip, 1, 0xC0A80000, 0xC0A8FFFF, 0xFF);
+    zone_delta->added_off = (UINT32) (p - zone_delta->data);
+    p = seed_zone_addr_list(p, ip, 0, 0xAC100000, 0xAC1FFFFF, 0x0F);
+
+    return (UINT32) (p - buf);
+}
+
+#    define BENCH_ITERATIONS  1000000
+#    define BENCH_MUTATIONS_N 4
+
+int main(void)
+{
+    static UCHAR seeds[FORT_FUZZ_BLOB_COUNT][SEED_BUF_SIZE + 1];
+    UINT32 seeds_size[FORT_FUZZ_BLOB_COUNT];
+
+    static UINT32 seed_buf[SEED_BUF_SIZE / sizeof(UINT32)];
+
+    seeds_size[FORT_FUZZ_BLOB_CONF] = seed_conf((char *) seed_buf);
+    memcpy(seeds[FORT_FUZZ_BLOB_CONF] + 1, seed_buf, seeds_size[FORT_FUZZ_BLOB_CONF]);
+
+    seeds_size[FORT_FUZZ_BLOB_ZONES] = seed_zones((char *) seed_buf);
+    memcpy(seeds[FORT_FUZZ_BLOB_ZONES] + 1, seed_buf, seeds_size[FORT_FUZZ_BLOB_ZONES]);
+
+    seeds_size[FORT_FUZZ_BLOB_ZONE_DELTA] = seed_zone_delta((char *) seed_buf);
+    memcpy(seeds[FORT_FUZZ_BLOB_ZONE_DELTA] + 1, seed_buf, seeds_size[FORT_FUZZ_BLOB_ZONE_DELTA]);
+
+    for (int i = 0; i < FORT_FUZZ_BLOB_COUNT; ++i) {
+        seeds[i][0] = (UCHAR) i;
+
+        if (fuzz_blob(seeds[i], seeds_size[i] + 1) == 0) {
+            fprintf(stderr, "Seed %d is rejected\n", i);
+            return 1;
+        }
+    }
+
+    if (fuzz_zones_patch((PFORT_CONF_ZONE_DELTA) (seeds[FORT_FUZZ_BLOB_ZONE_DELTA] + 1)) == 0) {
+        fprintf(stderr, "Seed zone delta is not applied\n");
+        return 1;
+    }
+
+    static UCHAR blob[SEED_BUF_SIZE + 1];
+    UINT32 accepted_n = 0;
+    UINT64 res = 0;
+
+    srand(1);
+
+    const clock_t start = clock();
+
+    for (int n = 0; n < BENCH_ITERATIONS; ++n) {
+        const int blob_type = n % FORT_FUZZ_BLOB_COUNT;
+        UINT32 size = seeds_size[blob_type] + 1;
+
+        memcpy(blob, seeds[blob_type], size);
+
+        /* Mutate the body bytes and maybe truncate */
+        for (int m = 0; m < BENCH_MUTATIONS_N; ++m) {
+            blob[1 + rand() % (size - 1)] ^= (UCHAR) (1 << (rand() % 8));
+        }
+        if (rand() % 4 == 0) {
+            size -= rand() % (size - 1);
+        }
+
+        const UINT32 r = fuzz_blob(blob, size);
+        accepted_n += (r != 0);
+        res += r;
+    }
+
+    const double secs = (double) (clock() - start) / CLOCKS_PER_SEC;
+
+    printf("blobs: %d, accepted: %u, time: %.3f s, %.0f blobs/s (%llu)\n", BENCH_ITERATIONS,
+            accepted_n, secs, BENCH_ITERATIONS / secs, (unsigned long long) res);
+
+    return 0;
+}
+
+#endif
@@ -8,6 +8,8 @@
 #include <stdio.h>
 
 #include "../fortcb.h"
+#include "../fortpkt.h"
+#include "../fortps.h"
 #include "../fortutl.h"
 #include "../proxycb/fortpcb_drv.h"
 #include "../proxycb/fortpcb_src.h"
@@ -96,6 +98,255 @@ static void test_utl_bits(void)
     assert(v == 0x33333333);
 }
 
+#define TEST_PENDING_POOL_TAG   'TwfF'
+#define TEST_PENDING_PROC_COUNT 5000
+#define TEST_PENDING_ENDPOINT   fort_pending_ask_endpoint(FALSE, IPPROTO_TCP, 443)
+
+static NTSTATUS test_pending_add_path(
+        PFORT_PENDING pending, UINT32 process_id, UINT32 path_hash, INT64 now)
+{
+    PFORT_PENDING_PACKET pkt = fort_mem_alloc(sizeof(FORT_PENDING_PACKET), TEST_PENDING_POOL_TAG);
+    assert(pkt != NULL);
+
+    RtlZeroMemory(pkt, sizeof(FORT_PENDING_PACKET));
+
+    const NTSTATUS status = fort_pending_proc_add_packet(pending, process_id, path_hash,
+            TEST_PENDING_ENDPOINT, /*completion_handle=*/NULL, pkt, now);
+
+    if (!NT_SUCCESS(status)) {
+        fort_mem_free(pkt, TEST_PENDING_POOL_TAG);
+    }
+
+    return status;
+}
+
+static NTSTATUS test_pending_add(PFORT_PENDING pending, UINT32 process_id, INT64 now)
+{
+    return test_pending_add_path(pending, process_id, /*path_hash=*/process_id, now);
+}
+
+static void test_pending(void)
+{
+    FORT_PENDING pending;
+    RtlZeroMemory(&pending, sizeof(FORT_PENDING));
+
+    fort_pending_open(&pending);
+
+    const FORT_PENDING_LIMITS limits = {
+        .proc_count_max = TEST_PENDING_PROC_COUNT / 2,
+        .proc_packet_count_max = 2,
+        .expire_msec = 10 * 1000,
+    };
+    pending.limits = limits; /* lower than the defaults */
+
+    /* Add 2 packets per process, a process per millisecond */
+    for (UINT32 process_id = 1; process_id <= TEST_PENDING_PROC_COUNT; ++process_id) {
+        const INT64 now = process_id;
+
+        assert(NT_SUCCESS(test_pending_add(&pending, process_id, now)));
+        assert(NT_SUCCESS(test_pending_add(&pending, process_id, now)));
+    }
+
+    printf("test_pending: proc_count=%d\n", pending.proc_count);
+
+    /* The oldest processes are evicted */
+    assert(pending.proc_count == limits.proc_count_max);
+    assert(fort_pending_proc_complete(&pending, 1, /*drop=*/TRUE) == 0);
+
+    /* The process's packets limit */
+    assert(!NT_SUCCESS(test_pending_add(&pending, TEST_PENDING_PROC_COUNT, 0)));
+
+    /* Drop all the process's packets at once */
+    assert(fort_pending_proc_complete(&pending, TEST_PENDING_PROC_COUNT, /*drop=*/TRUE) == 2);
+    assert(fort_pending_proc_complete(&pending, TEST_PENDING_PROC_COUNT, /*drop=*/TRUE) == 0);
+
+    /* Expire the processes added before the 4000th msec */
+    const UINT16 expired_count = fort_pending_expire(&pending, 4000 + limits.expire_msec);
+
+    printf("test_pending: expired_count=%d proc_count=%d\n", expired_count, pending.proc_count);
+
+    assert(expired_count == (4000 - TEST_PENDING_PROC_COUNT / 2) * 2);
+    assert(pending.proc_count == TEST_PENDING_PROC_COUNT - 4000 - 1);
+
+    /* The freed processes are reused */
+    const tommy_size_t procs_size = tommy_arrayof_size(&pending.procs);
+
+    assert(NT_SUCCESS(test_pending_add(&pending, 1, 5000)));
+    assert(tommy_arrayof_size(&pending.procs) == procs_size);
+    assert(fort_pending_proc_complete(&pending, 1, /*drop=*/TRUE) == 1);
+
+    fort_pending_clear(&pending);
+    assert(pending.proc_count == 0);
+
+    fort_pending_close(&pending);
+}
+
+static void test_pending_ask(void)
+{
+    FORT_PENDING pending;
+    RtlZeroMemory(&pending, sizeof(FORT_PENDING));
+
+    fort_pending_open(&pending);
+
+    WCHAR path[] = L"c:\\test.exe";
+
+    const UINT32 path_hash = fort_pending_path_hash(path, sizeof(path) - sizeof(WCHAR));
+    const UINT32 other_endpoint = fort_pending_ask_endpoint(FALSE, IPPROTO_UDP, 53);
+    const INT64 now = 1000;
+
+    assert(fort_pending_ask_check(&pending, path_hash, TEST_PENDING_ENDPOINT, now)
+            == FORT_PENDING_ASK_NONE);
+
+    /* 3 processes of the app and another app */
+    for (UINT32 process_id = 1; process_id <= 3; ++process_id) {
+        assert(NT_SUCCESS(test_pending_add_path(&pending, process_id, path_hash, now)));
+    }
+    assert(NT_SUCCESS(test_pending_add_path(&pending, 4, path_hash + 1, now)));
+
+    /* The duplicates are not logged while the prompt is outstanding */
+    assert(fort_pending_ask_check(&pending, path_hash, TEST_PENDING_ENDPOINT, now)
+            == FORT_PENDING_ASK_PENDING);
+    assert(fort_pending_ask_check(&pending, path_hash, other_endpoint, now)
+            == FORT_PENDING_ASK_NONE);
+
+    /* ... but they are pended with the first packet */
+    assert(NT_SUCCESS(test_pending_add_path(&pending, 1, path_hash, now + 1)));
+
+    /* The answer releases all the app's queued packets at once */
+    assert(fort_pending_ask_answer(&pending, path_hash) == 4);
+    assert(pending.proc_count == 1);
+
+    assert(fort_pending_ask_check(&pending, path_hash, TEST_PENDING_ENDPOINT, now)
+            == FORT_PENDING_ASK_NONE);
+
+    /* Adding an app without an outstanding prompt releases nothing */
+    assert(fort_pending_ask_answer(&pending, path_hash) == 0);
+
+    fort_pending_close(&pending);
+}
+
+#define TEST_PSTREE_POOL_TAG     'TwfF'
+#define TEST_PSTREE_PROC_COUNT   10000
+#define TEST_PSTREE_NAME_COUNT   100
+#define TEST_PSTREE_LOOKUP_COUNT 100
+
+static PFORT_SERVICE_INFO_LIST test_pstree_services_new(ULONG *data_len)
+{
+    const ULONG size =
+            FORT_SERVICE_INFO_LIST_DATA_OFF + TEST_PSTREE_PROC_COUNT * FORT_SERVICE_INFO_MAX_SIZE;
+
+    PFORT_SERVICE_INFO_LIST services = fort_mem_alloc(size, TEST_PSTREE_POOL_TAG);
+    assert(services != NULL);
+
+    services->services_n = TEST_PSTREE_PROC_COUNT;
+
+    /* Services "SvcNN" with the process ids 4, 8, ... */
+    PCHAR data = (PCHAR) services->data;
+
+    for (UINT32 i = 0; i < TEST_PSTREE_PROC_COUNT; ++i) {
+        PFORT_SERVICE_INFO service = (PFORT_SERVICE_INFO) data;
+        const UINT32 name_index = i % TEST_PSTREE_NAME_COUNT;
+
+        service->process_id = (i + 1) * 4;
+        service->name_len = 5 * sizeof(WCHAR);
+
+        RtlCopyMemory(service->name, L"Svc", 3 * sizeof(WCHAR));
+        service->name[3] = (WCHAR) (L'0' + name_index / 10);
+        service->name[4] = (WCHAR) (L'0' + name_index % 10);
+
+        data += FORT_SERVICE_INFO_NAME_OFF + FORT_CONF_STR_DATA_SIZE(service->name_len);
+    }
+
+    *data_len = (ULONG) (data - (PCHAR) services->data);
+
+    return services;
+}
+
+static BOOL test_pstree_get_proc_name(
+        PFORT_PSTREE ps_tree, DWORD processId, PUNICODE_STRING path, tommy_key_t *path_hash)
+{
+    BOOL isSvcHost = FALSE;
+    BOOL inherited = FALSE;
+
+    return fort_pstree_get_proc_name(ps_tree, processId, path, path_hash, &isSvcHost, &inherited);
+}
+
+static void test_pstree(void)
+{
+    FORT_PSTREE ps_tree;
+    RtlZeroMemory(&ps_tree, sizeof(FORT_PSTREE));
+
+    fort_pstree_open(&ps_tree);
+
+    ULONG data_len;
+    PFORT_SERVICE_INFO_LIST services = test_pstree_services_new(&data_len);
+
+    fort_pstree_update_services(&ps_tree, services, data_len);
+
+    fort_mem_free(services, TEST_PSTREE_POOL_TAG);
+
+    /* The processes share the interned names */
+    printf("test_pstree: procs_n=%d names_n=%d\n", ps_tree.procs_n,
+            (int) tommy_hashdyn_count(&ps_tree.names_map));
+
+    assert(ps_tree.procs_n == TEST_PSTREE_PROC_COUNT);
+    assert(tommy_hashdyn_count(&ps_tree.names_map) == TEST_PSTREE_NAME_COUNT);
+
+    const UINT32 read_token = fort_pstree_read_begin(&ps_tree);
+
+    UNICODE_STRING path;
+    tommy_key_t path_hash;
+    assert(test_pstree_get_proc_name(&ps_tree, 4, &path, &path_hash));
+
+    const WCHAR svc_path[] = L"\\svchost\\svc00";
+    assert(path.Length == sizeof(svc_path) - sizeof(WCHAR));
+    assert(RtlCompareMemory(path.Buffer, svc_path, path.Length) == path.Length);
+
+    /* The hash is reused by the exe-apps lookup */
+    assert(path_hash == fort_conf_exe_path_hash(path.Buffer, path.Length));
+
+    UNICODE_STRING same_path;
+    tommy_key_t same_path_hash;
+    assert(test_pstree_get_proc_name(
+            &ps_tree, (1 + TEST_PSTREE_NAME_COUNT) * 4, &same_path, &same_path_hash));
+    assert(same_path.Buffer == path.Buffer);
+
+    /* The colliding process is looked up under the lock */
+    assert(test_pstree_get_proc_name(
+            &ps_tree, (1 + FORT_PSTREE_INDEX_SIZE) * 4, &path, &path_hash));
+
+    assert(!test_pstree_get_proc_name(
+            &ps_tree, (1 + TEST_PSTREE_PROC_COUNT) * 4, &path, &path_hash));
+
+    /* Lookup all the processes */
+    LARGE_INTEGER freq, start, end;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&start);
+
+    UINT32 found_count = 0;
+
+    for (int n = 0; n < TEST_PSTREE_LOOKUP_COUNT; ++n) {
+        for (UINT32 i = 1; i <= TEST_PSTREE_PROC_COUNT; ++i) {
+            if (test_pstree_get_proc_name(&ps_tree, i * 4, &path, &path_hash)) {
+                ++found_count;
+            }
+        }
+    }
+
+    QueryPerformanceCounter(&end);
+
+    fort_pstree_read_end(&ps_tree, read_token);
+
+    assert(found_count == TEST_PSTREE_PROC_COUNT * TEST_PSTREE_LOOKUP_COUNT);
+
+    const double lookup_nsec = (double) (end.QuadPart - start.QuadPart) * 1e9
+            / ((double) freq.QuadPart * found_count);
+
+    printf("test_pstree: lookups=%u nsec/lookup=%.1f\n", found_count, lookup_nsec);
+
+    fort_pstree_close(&ps_tree);
+}
+
 int main(int argc, char *argv[])
 {
     (void) argc;
@@ -105,6 +356,9 @@ int main(int argc, char *argv[])
     test_major();
     test_utl_ascii();
     test_utl_bits();
+    test_pending();
+    test_pending_ask();
+    test_pstree();
 
     return 0;
 }
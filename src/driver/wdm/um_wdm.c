@@ -211,6 +211,11 @@ KIRQL KeGetCurrentIrql(void)
     return 0;
 }
 
+ULONG KeGetCurrentProcessorIndex(void)
+{
+    return 0;
+}
+
 void IoCompleteRequest(PIRP irp, CCHAR priorityBoost)
 {
     UNUSED(irp);
@@ -336,6 +341,11 @@ LARGE_INTEGER KeQueryPerformanceCounter(PLARGE_INTEGER performanceFrequency)
     return res;
 }
 
+ULONGLONG KeQueryInterruptTime(void)
+{
+    return 0;
+}
+
 void KeQuerySystemTime(PLARGE_INTEGER time)
 {
     UNUSED(time);
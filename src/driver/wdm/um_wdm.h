@@ -367,6 +367,7 @@ FORT_API void ExReleaseSpinLockShared(PEX_SPIN_LOCK lock, KIRQL oldIrql);
 FORT_API void ExReleaseSpinLockExclusive(PEX_SPIN_LOCK lock, KIRQL oldIrql);
 
 FORT_API KIRQL KeGetCurrentIrql(void);
+FORT_API ULONG KeGetCurrentProcessorIndex(void);
 
 #define IO_NO_INCREMENT 0
 FORT_API void IoCompleteRequest(PIRP irp, CCHAR priorityBoost);
@@ -401,6 +402,7 @@ FORT_API NTSTATUS PsCreateSystemThread(PHANDLE threadHandle, ULONG desiredAccess
         PKSTART_ROUTINE startRoutine, PVOID startContext);
 
 FORT_API LARGE_INTEGER KeQueryPerformanceCounter(PLARGE_INTEGER performanceFrequency);
+FORT_API ULONGLONG KeQueryInterruptTime(void);
 
 FORT_API void KeQuerySystemTime(PLARGE_INTEGER time);
 FORT_API void ExSystemTimeToLocalTime(PLARGE_INTEGER systemTime, PLARGE_INTEGER localTime);
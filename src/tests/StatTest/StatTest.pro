@@ -1,7 +1,8 @@
 include(../Common/Common.pri)
 
 HEADERS += \
-    tst_stat.h
+    tst_stat.h \
+    tst_statfeed.h
 
 SOURCES += \
     tst_main.cpp
@@ -1,4 +1,5 @@
 #include "tst_stat.h"
+#include "tst_statfeed.h"
 
 #include <QCoreApplication>
 
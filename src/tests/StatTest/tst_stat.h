@@ -1,21 +1,30 @@
 #pragma once
 
+#include <QCoreApplication>
 #include <QDebug>
+#include <QDir>
 #include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
 #include <QSignalSpy>
+#include <QThread>
 
 #include <googletest.h>
 
+#include <sqlite/dbquery.h>
 #include <sqlite/sqlitedb.h>
 #include <sqlite/sqlitestmt.h>
 
 #include <conf/confmanager.h>
 #include <conf/firewallconf.h>
 #include <fortsettings.h>
+#include <log/logentryblockedip.h>
 #include <log/logentryprocnew.h>
 #include <log/logentrystattraf.h>
 #include <stat/quotamanager.h>
+#include <stat/statblockmanager.h>
 #include <stat/statmanager.h>
+#include <stat/trafsegmentstore.h>
 #include <util/dateutil.h>
 #include <util/fileutil.h>
 #include <util/ioc/ioccontainer.h>
@@ -36,6 +45,17 @@ void StatTest::TearDown() { }
 
 namespace {
 
+class TestStatBlockManager : public StatBlockManager
+{
+public:
+    using StatBlockManager::StatBlockManager;
+    using StatBlockManager::jobCount;
+    using StatBlockManager::setKeepCount;
+
+protected:
+    void setupConfManager() override { }
+};
+
 void debugProcNew(SqliteDb *sqliteDb)
 {
     SqliteStmt stmt;
@@ -124,8 +144,6 @@ TEST_F(StatTest, dbWriteRead)
         statManager.logProcNew(entry);
     }
 
-    debugProcNew(statManager.sqliteDb());
-
     QElapsedTimer timer;
     timer.start();
 
@@ -150,9 +168,495 @@ TEST_F(StatTest, dbWriteRead)
 
     qDebug() << "elapsed>" << timer.elapsed() << "msec";
 
+    // Wait for the writer
+    statManager.tearDown();
+
+    debugProcNew(statManager.sqliteDb());
+
     debugStatTraf(statManager.sqliteDb());
 }
 
+TEST_F(StatTest, trafFlushBench)
+{
+    IocContainer ioc;
+    ioc.pinToThread();
+
+    NiceMock<MockQuotaManager> quotaManager;
+    ioc.set<QuotaManager>(quotaManager);
+
+    FirewallConf conf;
+    conf.setLogStat(true);
+
+    const QString filePath = FileUtil::tempLocation() + "/fort-stat-test.db";
+    FileUtil::removeFile(filePath);
+
+    StatManager statManager(filePath);
+    statManager.setConf(&conf);
+
+    statManager.setUp();
+
+    // Replay 1000 processes at 1 Hz
+    constexpr quint16 procCount = 1000;
+    constexpr int tickCount = 10 * 60;
+    constexpr qint64 unixTime = 1704067200; // 2024-01-01 00:00 UTC
+
+    QVector<quint32> trafBytes(procCount * 3);
+
+    for (int i = 0; i < procCount; ++i) {
+        const quint32 pid = (i + 1) * 10;
+
+        LogEntryProcNew entry(pid, QString("C:\\test\\test%1.exe").arg(i));
+        statManager.logProcNew(entry);
+
+        trafBytes[i * 3] = pid;
+        trafBytes[i * 3 + 1] = 100;
+        trafBytes[i * 3 + 2] = 10;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    {
+        LogEntryStatTraf entry(procCount, trafBytes.constData());
+
+        for (int tick = 0; tick < tickCount; ++tick) {
+            statManager.logStatTraf(entry, unixTime + tick);
+        }
+    }
+
+    qDebug() << "elapsed>" << timer.restart() << "msec";
+
+    // Wait for the writer
+    statManager.tearDown();
+
+    qDebug() << "flush elapsed>" << timer.elapsed() << "msec"
+             << "max jobs>" << statManager.maxJobCount() << "max flush>"
+             << statManager.maxFlushMsec() << "msec";
+
+    qint64 inBytes = 0;
+    qint64 outBytes = 0;
+
+    statManager.getTraffic(
+            StatManager::TrafHour, DateUtil::getUnixHour(unixTime), inBytes, outBytes);
+
+    ASSERT_EQ(inBytes, qint64(procCount) * 100 * tickCount);
+    ASSERT_EQ(outBytes, qint64(procCount) * 10 * tickCount);
+
+    QStringList appPaths;
+    QVector<qint64> appIds;
+    statManager.getStatAppList(appPaths, appIds);
+
+    ASSERT_EQ(appIds.size(), procCount);
+
+    statManager.getTraffic(StatManager::TrafTotal, 1, inBytes, outBytes, appIds.first());
+
+    ASSERT_EQ(inBytes, qint64(100) * tickCount);
+    ASSERT_EQ(outBytes, qint64(10) * tickCount);
+
+    statManager.roSqliteDb()->close();
+    statManager.sqliteDb()->close();
+
+    FileUtil::removeFile(filePath);
+    FileUtil::removePath(filePath + ".traf");
+}
+
+TEST_F(StatTest, trafRollup)
+{
+    IocContainer ioc;
+    ioc.pinToThread();
+
+    NiceMock<MockQuotaManager> quotaManager;
+    ioc.set<QuotaManager>(quotaManager);
+
+    FirewallConf conf;
+    conf.setLogStat(true);
+
+    const QString filePath = FileUtil::tempLocation() + "/fort-stat-rollup-test.db";
+    FileUtil::removeFile(filePath);
+
+    StatManager statManager(filePath);
+    statManager.setConf(&conf);
+
+    statManager.setUp();
+
+    constexpr quint16 procCount = 3;
+    constexpr qint64 unixTime = 1704067200; // 2024-01-01 00:00 UTC
+
+    const quint32 trafBytes[procCount * 3] = { 10, 100, 10, 20, 100, 10, 30, 100, 10 };
+
+    for (quint32 pid = 10; pid <= 30; pid += 10) {
+        LogEntryProcNew entry(pid, QString("C:\\test\\test%1.exe").arg(pid));
+        statManager.logProcNew(entry);
+    }
+
+    {
+        LogEntryStatTraf entry(procCount, trafBytes);
+
+        for (int tick = 0; tick < 10; ++tick) {
+            statManager.logStatTraf(entry, unixTime + tick);
+        }
+
+        // Next hour: the previous one is rolled up
+        statManager.logStatTraf(entry, unixTime + 3600);
+    }
+
+    // Wait for the writer and process its results
+    statManager.tearDown();
+
+    QCoreApplication::processEvents();
+
+    const qint32 trafDay = DateUtil::getUnixDay(unixTime);
+
+    // Rolled up hour
+    {
+        SqliteStmt stmt;
+        ASSERT_TRUE(stmt.prepare(statManager.sqliteDb()->db(),
+                "SELECT in_bytes FROM traffic_day WHERE traf_time = ?1;"));
+        stmt.bindInt(1, trafDay);
+        ASSERT_EQ(stmt.step(), SqliteStmt::StepRow);
+        ASSERT_EQ(stmt.columnInt64(), 10 * 300);
+    }
+
+    // Rolled up hour + the current unrolled hour
+    qint64 inBytes = 0;
+    qint64 outBytes = 0;
+    statManager.getTraffic(StatManager::TrafDay, trafDay, inBytes, outBytes);
+
+    ASSERT_EQ(inBytes, 11 * 300);
+    ASSERT_EQ(outBytes, 11 * 30);
+
+    const qint32 trafMonth = DateUtil::getUnixMonth(unixTime);
+
+    statManager.getTraffic(StatManager::TrafMonth, trafMonth, inBytes, outBytes);
+    ASSERT_EQ(inBytes, 11 * 300);
+
+    QStringList appPaths;
+    QVector<qint64> appIds;
+    statManager.getStatAppList(appPaths, appIds);
+    ASSERT_EQ(appIds.size(), procCount);
+
+    statManager.getTraffic(StatManager::TrafDay, trafDay, inBytes, outBytes, appIds.first());
+    ASSERT_EQ(inBytes, 11 * 100);
+
+    ASSERT_EQ(statManager.getTrafficTime(StatManager::TrafDay, appIds.first()), trafDay);
+
+    // The service's client reads the same live totals from the database
+    {
+        StatManager clientStatManager(filePath, nullptr, SqliteDb::OpenDefaultReadOnly);
+        ASSERT_TRUE(clientStatManager.sqliteDb()->open());
+
+        clientStatManager.getTraffic(StatManager::TrafDay, trafDay, inBytes, outBytes);
+        ASSERT_EQ(inBytes, 11 * 300);
+        ASSERT_EQ(outBytes, 11 * 30);
+    }
+
+    statManager.roSqliteDb()->close();
+    statManager.sqliteDb()->close();
+
+    FileUtil::removeFile(filePath);
+    FileUtil::removePath(filePath + ".traf");
+}
+
+TEST_F(StatTest, trafRollupUpgrade)
+{
+    IocContainer ioc;
+    ioc.pinToThread();
+
+    NiceMock<MockQuotaManager> quotaManager;
+    ioc.set<QuotaManager>(quotaManager);
+
+    FirewallConf conf;
+
+    const QString filePath = FileUtil::tempLocation() + "/fort-stat-upgrade-test.db";
+    FileUtil::removeFile(filePath);
+
+    constexpr qint64 unixTime = 1704070800; // 2024-01-01 01:00 UTC
+
+    const qint32 trafHour = DateUtil::getUnixHour(unixTime);
+    const qint32 trafDay = DateUtil::getUnixDay(unixTime);
+    const qint32 trafMonth = DateUtil::getUnixMonth(unixTime);
+
+    // The old database wrote the hours to the days and months directly
+    {
+        StatManager statManager(filePath);
+        statManager.setConf(&conf);
+        statManager.setUp();
+
+        ASSERT_TRUE(statManager.sqliteDb()->executeStr(
+                QString("DELETE FROM traffic_rollup;"
+                        "INSERT INTO traffic_hour VALUES(%1, 50, 5), (%2, 100, 10);"
+                        "INSERT INTO traffic_day VALUES(%3, 150, 15);"
+                        "INSERT INTO traffic_month VALUES(%4, 150, 15);")
+                        .arg(trafHour - 1)
+                        .arg(trafHour)
+                        .arg(trafDay)
+                        .arg(trafMonth)));
+
+        statManager.tearDown();
+
+        statManager.roSqliteDb()->close();
+        statManager.sqliteDb()->close();
+    }
+
+    StatManager statManager(filePath);
+    statManager.setConf(&conf);
+    statManager.setUp();
+
+    // The last hour is unrolled to be rolled up with the rest of its traffic
+    qint64 inBytes = 0;
+    qint64 outBytes = 0;
+    statManager.getTraffic(StatManager::TrafDay, trafDay, inBytes, outBytes);
+    ASSERT_EQ(inBytes, 150);
+    ASSERT_EQ(outBytes, 15);
+
+    statManager.getTraffic(StatManager::TrafMonth, trafMonth, inBytes, outBytes);
+    ASSERT_EQ(inBytes, 150);
+
+    {
+        SqliteStmt stmt;
+        ASSERT_TRUE(stmt.prepare(statManager.sqliteDb()->db(),
+                "SELECT t.traf_time, d.in_bytes FROM traffic_rollup t, traffic_day d;"));
+        ASSERT_EQ(stmt.step(), SqliteStmt::StepRow);
+        ASSERT_EQ(stmt.columnInt(0), trafHour);
+        ASSERT_EQ(stmt.columnInt64(1), 50);
+    }
+
+    statManager.tearDown();
+
+    statManager.roSqliteDb()->close();
+    statManager.sqliteDb()->close();
+
+    FileUtil::removeFile(filePath);
+    FileUtil::removePath(filePath + ".traf");
+}
+
+TEST_F(StatTest, trafSegmentStore)
+{
+    const QString dirPath = FileUtil::tempLocation() + "/fort-traf-segments-test";
+    FileUtil::removePath(dirPath);
+
+    TrafSegmentStore store(dirPath);
+    ASSERT_TRUE(store.isEnabled());
+
+    const qint32 trafHour = DateUtil::getUnixHour(1704067200); // 2024-01-01 00:00 UTC
+
+    ASSERT_TRUE(store.appendHour(trafHour, { { 1, { 100, 10 } }, { 3, { 300, 30 } } }));
+    ASSERT_TRUE(store.appendHour(trafHour + 1, { { 3, { 5, 6 } } }));
+
+    // Sealed hours are immutable
+    ASSERT_TRUE(store.appendHour(trafHour, { { 2, { 1, 1 } } }));
+
+    TrafBytes trafBytes;
+    ASSERT_TRUE(store.getAppTraffic(3, trafHour, trafBytes));
+    ASSERT_EQ(trafBytes.inBytes, 300);
+    ASSERT_EQ(trafBytes.outBytes, 30);
+
+    ASSERT_FALSE(store.getAppTraffic(2, trafHour, trafBytes));
+
+    ASSERT_TRUE(store.getAppTraffic(3, trafHour + 1, trafBytes));
+    ASSERT_EQ(trafBytes.inBytes, 5);
+    ASSERT_EQ(trafBytes.outBytes, 6);
+
+    ASSERT_EQ(store.getAppMinTrafHour(3), trafHour);
+    ASSERT_EQ(store.getAppMinTrafHour(7), 0);
+
+    // Torn tail of an interrupted write
+    {
+        const qint32 day = TrafSegmentStore::segmentDay(trafHour);
+
+        QFile file(dirPath + '/' + QString::number(day) + ".seg");
+        ASSERT_TRUE(file.open(QFile::Append));
+        file.write("torn");
+    }
+
+    ASSERT_TRUE(store.appendHour(trafHour + 2, { { 1, { 7, 8 } } }));
+    ASSERT_TRUE(store.getAppTraffic(1, trafHour + 2, trafBytes));
+    ASSERT_EQ(trafBytes.inBytes, 7);
+
+    // Remove app
+    ASSERT_TRUE(store.removeApp(3));
+    ASSERT_FALSE(store.getAppTraffic(3, trafHour, trafBytes));
+    ASSERT_TRUE(store.getAppTraffic(1, trafHour, trafBytes));
+    ASSERT_EQ(trafBytes.inBytes, 100);
+
+    // The corrupted segment is not rewritten
+    {
+        const qint32 day = TrafSegmentStore::segmentDay(trafHour);
+
+        QFile file(dirPath + '/' + QString::number(day) + ".seg");
+        ASSERT_TRUE(file.open(QFile::ReadWrite));
+
+        const qint64 fileSize = file.size();
+
+        ASSERT_TRUE(file.seek(fileSize - 1));
+        file.write("\xFF");
+        file.close();
+
+        ASSERT_FALSE(store.removeApp(1));
+        ASSERT_EQ(QFileInfo(file.fileName()).size(), fileSize);
+    }
+
+    // Retention
+    store.removeBefore(trafHour + 24);
+    ASSERT_FALSE(store.getAppTraffic(1, trafHour, trafBytes));
+    ASSERT_TRUE(QDir(dirPath).isEmpty());
+
+    FileUtil::removePath(dirPath);
+}
+
+TEST_F(StatTest, trafSegmentBench)
+{
+    const QString dirPath = FileUtil::tempLocation() + "/fort-traf-segments-bench";
+    FileUtil::removePath(dirPath);
+
+    TrafSegmentStore store(dirPath);
+
+    // 2 years of 5000 apps, 250 of them active per hour
+    constexpr int dayCount = 2 * 365;
+    constexpr int appCount = 5000;
+    constexpr int activeAppCount = 250;
+
+    const qint32 fromHour = DateUtil::getUnixHour(1704067200); // 2024-01-01 00:00 UTC
+    const qint32 toHour = fromHour + dayCount * 24 - 1;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (qint32 trafHour = fromHour; trafHour <= toHour; ++trafHour) {
+        QVector<qint64> appIds = { 1 };
+        for (int i = 0; i < activeAppCount; ++i) {
+            appIds.append((trafHour * activeAppCount + i) % (appCount - 1) + 2);
+        }
+        std::sort(appIds.begin(), appIds.end());
+
+        AppTrafRowList rows;
+        for (const qint64 appId : appIds) {
+            rows.append({ appId, { appId * 1000 + trafHour % 24, appId * 100 } });
+        }
+
+        ASSERT_TRUE(store.appendHour(trafHour, rows));
+    }
+
+    qDebug() << "write elapsed>" << timer.restart() << "msec";
+
+    // Point queries of the hourly list
+    TrafBytes trafBytes;
+    for (qint32 trafHour = toHour; trafHour > toHour - 24 * 31; --trafHour) {
+        ASSERT_TRUE(store.getAppTraffic(1, trafHour, trafBytes));
+    }
+
+    qDebug() << "point elapsed>" << timer.restart() << "msec";
+
+    ASSERT_EQ(store.getAppMinTrafHour(appCount), fromHour + 13);
+
+    qDebug() << "min elapsed>" << timer.restart() << "msec";
+
+    // Retention of the first year
+    store.removeBefore(fromHour + 365 * 24);
+
+    ASSERT_FALSE(store.getAppTraffic(1, fromHour, trafBytes));
+
+    qDebug() << "retention elapsed>" << timer.elapsed() << "msec";
+
+    store.clear();
+
+    FileUtil::removePath(dirPath);
+}
+
+TEST_F(StatTest, blockedIpBench)
+{
+    const QString filePath = FileUtil::tempLocation() + "/fort-block-test.db";
+    FileUtil::removeFile(filePath);
+
+    TestStatBlockManager statBlockManager(filePath);
+    statBlockManager.setUp();
+
+    // One second of 100k blocked connections of 500 programs
+    constexpr int entryCount = 100000;
+    constexpr int appCount = 500;
+    constexpr qint64 unixTime = 1704067200; // 2024-01-01 00:00 UTC
+
+    QElapsedTimer timer;
+    timer.start();
+
+    LogEntryBlockedIp entry;
+    entry.setBlockReason(1);
+    entry.setIpProto(6);
+    entry.setConnTime(unixTime);
+
+    for (int i = 0; i < entryCount; ++i) {
+        const int appIndex = i % appCount;
+
+        entry.setKernelPath(QString("\\Device\\HarddiskVolume1\\test\\test%1.exe").arg(appIndex));
+        entry.setPid(appIndex + 1);
+        entry.setLocalPort(i % 65536);
+        entry.setRemoteIp4(i);
+
+        // Keep the queue below the drop limit
+        while (statBlockManager.jobCount() >= 8) {
+            QThread::yieldCurrentThread();
+        }
+
+        statBlockManager.logBlockedIp(entry);
+    }
+
+    // Wait for the writer
+    statBlockManager.finishWorkers();
+
+    const qint64 elapsed = timer.elapsed();
+
+    qint64 idMin, idMax;
+    StatBlockManager::getConnIdRange(statBlockManager.sqliteDb(), idMin, idMax);
+
+    ASSERT_EQ(idMax - idMin + 1, entryCount);
+
+    const int appRowCount =
+            DbQuery(statBlockManager.sqliteDb()).sql("SELECT COUNT(*) FROM app;").execute().toInt();
+
+    ASSERT_EQ(appRowCount, appCount);
+
+    qDebug() << "elapsed>" << elapsed << "msec"
+             << "rate>" << (entryCount * 1000LL / qMax(elapsed, 1LL)) << "events/sec";
+
+    // Retention of the last connections of another program
+    constexpr int keepCount = entryCount / 10;
+
+    statBlockManager.setKeepCount(keepCount);
+
+    entry.setKernelPath("\\Device\\HarddiskVolume1\\test\\other.exe");
+
+    timer.restart();
+
+    for (int i = 0; i < keepCount; ++i) {
+        while (statBlockManager.jobCount() >= 8) {
+            QThread::yieldCurrentThread();
+        }
+
+        statBlockManager.logBlockedIp(entry);
+    }
+
+    statBlockManager.finishWorkers();
+
+    qDebug() << "retention elapsed>" << timer.elapsed() << "msec";
+
+    StatBlockManager::getConnIdRange(statBlockManager.sqliteDb(), idMin, idMax);
+
+    ASSERT_EQ(idMax - idMin + 1, keepCount);
+
+    const auto appVars = DbQuery(statBlockManager.sqliteDb())
+                                 .sql("SELECT COUNT(*), SUM(conn_count) FROM app;")
+                                 .execute(2)
+                                 .toList();
+
+    ASSERT_EQ(appVars.value(0).toInt(), 1);
+    ASSERT_EQ(appVars.value(1).toInt(), keepCount);
+
+    statBlockManager.roSqliteDb()->close();
+    statBlockManager.sqliteDb()->close();
+
+    FileUtil::removeFile(filePath);
+}
+
 TEST_F(StatTest, monthStart)
 {
     const QDate d1(2018, 1, 8);
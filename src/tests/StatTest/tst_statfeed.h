@@ -0,0 +1,170 @@
+#pragma once
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QThread>
+
+#ifdef Q_OS_LINUX
+#    include <sys/wait.h>
+#    include <unistd.h>
+#endif
+
+#include <googletest.h>
+
+#include <stat/statfeed.h>
+
+namespace FeedTest {
+
+constexpr int publishCount = 100000;
+
+QString testKey()
+{
+    return QString("FortFirewallStatFeedTest%1").arg(QCoreApplication::applicationPid());
+}
+
+void publishTraffic(StatFeed &feed, int count)
+{
+    for (int i = 1; i <= count; ++i) {
+        const quint32 inBytes = quint32(i);
+        const quint32 outBytes = inBytes * 2;
+
+        feed.publish(i, inBytes, outBytes);
+    }
+}
+
+// Returns the count of the inconsistent snapshots
+int readTraffic(StatFeed &feed, int count)
+{
+    StatFeedSnapshot snapshot;
+    quint32 version = 0;
+    int badCount = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    while (version < quint32(count) && timer.elapsed() < 30000) {
+        if (!feed.read(snapshot, version))
+            continue;
+
+        qint64 unixTime = version;
+
+        for (const auto &traf : std::as_const(snapshot.trafs)) {
+            if (traf.outBytes != traf.inBytes * 2 || traf.unixTime <= unixTime) {
+                ++badCount;
+            }
+            unixTime = traf.unixTime;
+        }
+
+        version = snapshot.version;
+    }
+
+    return version < quint32(count) ? -1 : badCount;
+}
+
+}
+
+class StatFeedTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+};
+
+void StatFeedTest::SetUp() { }
+
+void StatFeedTest::TearDown() { }
+
+TEST_F(StatFeedTest, publishRead)
+{
+    StatFeed writer(FeedTest::testKey());
+    ASSERT_TRUE(writer.create());
+
+    StatFeed reader(FeedTest::testKey());
+    ASSERT_TRUE(reader.attach());
+
+    ASSERT_EQ(reader.version(), 0);
+
+    writer.publish(10, 1, 2);
+    writer.publish(11, 3, 4);
+
+    StatFeedSnapshot snapshot;
+    ASSERT_TRUE(reader.read(snapshot));
+    ASSERT_EQ(snapshot.version, 2);
+    ASSERT_EQ(snapshot.trafs.size(), 2);
+    ASSERT_EQ(snapshot.trafs[0].unixTime, 10);
+    ASSERT_EQ(snapshot.trafs[1].outBytes, 4);
+
+    // Only the newer ones
+    writer.publish(12, 5, 6);
+
+    ASSERT_TRUE(reader.read(snapshot, /*sinceVersion=*/2));
+    ASSERT_EQ(snapshot.trafs.size(), 1);
+    ASSERT_EQ(snapshot.trafs[0].unixTime, 12);
+
+    // The ring buffer keeps the last ones
+    for (int i = 0; i < StatFeed::trafMaxCount * 2; ++i) {
+        writer.publish(100 + i, 0, 0);
+    }
+
+    ASSERT_TRUE(reader.read(snapshot, /*sinceVersion=*/3));
+    ASSERT_EQ(snapshot.trafs.size(), StatFeed::trafMaxCount);
+    ASSERT_EQ(snapshot.trafs.last().unixTime, 100 + StatFeed::trafMaxCount * 2 - 1);
+}
+
+TEST_F(StatFeedTest, concurrentRead)
+{
+    using namespace FeedTest;
+
+    StatFeed writer(testKey());
+    ASSERT_TRUE(writer.create());
+
+    StatFeed reader(testKey());
+    ASSERT_TRUE(reader.attach());
+
+    int badCount = 0;
+
+    QThread *readerThread = QThread::create([&] { badCount = readTraffic(reader, publishCount); });
+    readerThread->start();
+
+    publishTraffic(writer, publishCount);
+
+    readerThread->wait();
+    delete readerThread;
+
+    ASSERT_EQ(badCount, 0);
+}
+
+#ifdef Q_OS_LINUX
+TEST_F(StatFeedTest, twoProcesses)
+{
+    using namespace FeedTest;
+
+    StatFeed writer(testKey());
+    ASSERT_TRUE(writer.create());
+
+    const pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+
+    if (pid == 0) {
+        // Reader process
+        StatFeed reader(testKey());
+
+        while (!reader.attach()) {
+            QThread::msleep(1);
+        }
+
+        _exit(readTraffic(reader, publishCount) == 0 ? 0 : 1);
+    }
+
+    // Let the reader attach
+    QThread::msleep(50);
+
+    publishTraffic(writer, publishCount);
+
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+}
+#endif
@@ -1,12 +1,18 @@
 include(../Common/Common.pri)
 
 HEADERS += \
+    tst_appinfo.h \
     tst_bitutil.h \
     tst_confutil.h \
+    tst_controlworker.h \
     tst_fileutil.h \
+    tst_hostinfo.h \
     tst_ioccontainer.h \
     tst_netutil.h \
-    tst_stringutil.h
+    tst_sqlitedb.h \
+    tst_stringutil.h \
+    tst_tablesqlmodel.h \
+    tst_workermanager.h
 
 SOURCES += \
     tst_main.cpp
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QSet>
+
+#include <googletest.h>
+
+#include <appinfo/appinfomanager.h>
+#include <util/fileutil.h>
+
+class AppInfoTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+};
+
+void AppInfoTest::SetUp() { }
+
+void AppInfoTest::TearDown() { }
+
+TEST_F(AppInfoTest, coldStartBench)
+{
+    constexpr int appCount = 10000;
+    constexpr int existingAppStep = 10;
+
+    const QString dirPath = FileUtil::tempLocation() + "/fort-appinfo-test";
+    FileUtil::removePath(dirPath);
+    ASSERT_TRUE(FileUtil::makePath(dirPath));
+
+    const QString filePath = dirPath + "/appinfo.db";
+
+    // Most of the logged apps were removed
+    QStringList appPaths;
+    for (int i = 0; i < appCount; ++i) {
+        const QString appPath = dirPath + QString("/app-%1.exe").arg(i);
+
+        if (i % existingAppStep == 0) {
+            ASSERT_TRUE(FileUtil::writeFileData(appPath, "MZ"));
+        }
+
+        appPaths.append(FileUtil::toNativeSeparators(appPath));
+    }
+
+    const auto lookupApps = [&](int &validCount) -> qint64 {
+        AppInfoManager manager(filePath);
+        manager.setUp();
+
+        QSet<QString> finishedPaths;
+        validCount = 0;
+
+        QObject::connect(
+                &manager, &AppInfoManager::lookupInfoFinished, &manager,
+                [&](const QString &appPath, const AppInfo &appInfo) {
+                    finishedPaths.insert(appPath);
+
+                    if (appInfo.isValid()) {
+                        ++validCount;
+                    }
+                },
+                Qt::DirectConnection);
+
+        QElapsedTimer timer;
+        timer.start();
+
+        // The rows are painted several times
+        for (int pass = 0; pass < 3; ++pass) {
+            for (const QString &appPath : std::as_const(appPaths)) {
+                manager.lookupAppInfo(appPath);
+            }
+        }
+
+        manager.finishWorkers();
+
+        const qint64 elapsed = timer.elapsed();
+
+        EXPECT_EQ(finishedPaths.size(), appCount);
+
+        return elapsed;
+    };
+
+    int coldValidCount = 0;
+    const qint64 coldMsec = lookupApps(coldValidCount);
+
+    // Missing files are not looked up again
+    int warmValidCount = 0;
+    const qint64 warmMsec = lookupApps(warmValidCount);
+
+    ASSERT_EQ(coldValidCount, warmValidCount);
+    ASSERT_EQ(coldValidCount, appCount / existingAppStep);
+
+    qDebug() << "apps>" << appCount << "cold>" << coldMsec << "msec"
+             << "warm>" << warmMsec << "msec";
+
+    FileUtil::removePath(dirPath);
+}
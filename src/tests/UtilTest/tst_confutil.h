@@ -1,5 +1,8 @@
 #pragma once
 
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
 #include <QSignalSpy>
 
 #include <googletest.h>
@@ -10,9 +13,13 @@
 #include <driver/drivercommon.h>
 #include <log/logentryblockedip.h>
 #include <manager/envmanager.h>
+#include <task/taskzonecompiler.h>
+#include <task/taskzonedownloader.h>
 #include <util/conf/confappswalker.h>
 #include <util/conf/confutil.h>
+#include <util/conf/zonefile.h>
 #include <util/fileutil.h>
+#include <util/net/iprange.h>
 #include <util/net/netutil.h>
 
 class ConfUtilTest : public Test
@@ -77,6 +84,10 @@ TEST_F(ConfUtilTest, confWriteRead)
 
     // Check the buffer
     const char *data = confUtil.data() + DriverCommon::confIoConfOff();
+    const quint32 dataSize = confIoSize - DriverCommon::confIoConfOff();
+
+    ASSERT_TRUE(DriverCommon::confCheck(data, dataSize));
+    ASSERT_FALSE(DriverCommon::confCheck(data, dataSize - 1));
 
     ASSERT_FALSE(DriverCommon::confIp4InRange(data, 0, true));
     ASSERT_FALSE(DriverCommon::confIp4InRange(data, NetUtil::textToIp4("9.255.255.255")));
@@ -171,3 +182,191 @@ TEST_F(ConfUtilTest, checkEnvManager)
 
     ASSERT_NE(envManager.expandString("%HOME%"), QString());
 }
+
+TEST_F(ConfUtilTest, zoneFileMap)
+{
+    IpRange ipRange;
+    ASSERT_TRUE(ipRange.fromText("10.0.0.0/8\n192.168.0.1\n::1\n"));
+
+    ConfUtil confUtil;
+    confUtil.writeZone(ipRange);
+
+    const QString filePath = FileUtil::tempLocation() + "/fort-zone-test.bin";
+
+    QString checksum;
+    ASSERT_TRUE(ZoneFile::write(filePath, confUtil.buffer(), checksum));
+
+    {
+        ZoneFile zoneFile(filePath);
+
+        ASSERT_EQ(checksum.size(), 64);
+        ASSERT_FALSE(zoneFile.map(QString(64, '0')));
+        ASSERT_TRUE(zoneFile.map(checksum));
+        ASSERT_EQ(zoneFile.zoneData(), confUtil.buffer());
+
+        ConfUtil zoneUtil(zoneFile.zoneData());
+
+        IpRange loadedRange;
+        ASSERT_TRUE(zoneUtil.loadZone(loadedRange));
+        ASSERT_EQ(loadedRange.toText(), ipRange.toText());
+
+        // Check the driver's zones buffer
+        const QByteArray &zoneData = zoneFile.zoneData();
+
+        ConfUtil zonesUtil;
+        zonesUtil.writeZones(1, 1, zoneData.size(), { zoneData });
+
+        const quint32 zonesSize = zonesUtil.buffer().size();
+        ASSERT_TRUE(DriverCommon::confZonesCheck(zonesUtil.data(), zonesSize));
+        ASSERT_FALSE(DriverCommon::confZonesCheck(zonesUtil.data(), zonesSize - 1));
+    }
+
+    // Corrupt the last section's data
+    {
+        QFile file(filePath);
+        ASSERT_TRUE(file.open(QFile::ReadWrite));
+        ASSERT_TRUE(file.seek(file.size() - 1));
+        ASSERT_TRUE(file.putChar('\xFF'));
+        ASSERT_TRUE(file.flush());
+        ASSERT_TRUE(file.setFileTime(QDateTime::currentDateTimeUtc().addSecs(60),
+                QFileDevice::FileModificationTime));
+    }
+
+    // The changed file's sections are checked again
+    {
+        ZoneFile zoneFile(filePath);
+
+        ASSERT_FALSE(zoneFile.map(checksum));
+    }
+
+    FileUtil::removeFile(filePath);
+}
+
+TEST_F(ConfUtilTest, zoneDeltaPatch)
+{
+    IpRange prevRange;
+    ASSERT_TRUE(prevRange.fromText("1.1.1.1\n2.2.2.2\n10.0.0.0/8\n172.16.0.0/12\n::1\n"));
+
+    IpRange ipRange;
+    ASSERT_TRUE(ipRange.fromText("1.1.1.1\n3.3.3.3\n10.0.0.0/8\n192.168.0.0/16\n::2\n"));
+
+    IpRange removedRange;
+    IpRange addedRange;
+    prevRange.difference(ipRange, removedRange);
+    ipRange.difference(prevRange, addedRange);
+
+    ASSERT_EQ(removedRange.size(), 3);
+    ASSERT_EQ(addedRange.size(), 3);
+
+    ConfUtil prevUtil;
+    prevUtil.writeZone(prevRange);
+
+    ConfUtil zoneUtil;
+    zoneUtil.writeZone(ipRange);
+
+    ConfUtil removedUtil;
+    removedUtil.writeZone(removedRange);
+
+    ConfUtil addedUtil;
+    addedUtil.writeZone(addedRange);
+
+    QByteArray patchedData;
+    ASSERT_TRUE(DriverCommon::confAddrListPatch(
+            prevUtil.data(), removedUtil.data(), addedUtil.data(), patchedData));
+    ASSERT_EQ(patchedData, zoneUtil.buffer());
+
+    // Removing of absent addresses must fail
+    ASSERT_FALSE(DriverCommon::confAddrListPatch(
+            zoneUtil.data(), removedUtil.data(), addedUtil.data(), patchedData));
+}
+
+TEST_F(ConfUtilTest, zoneDeltaPatchNotContained)
+{
+    IpRange ipRange;
+    ASSERT_TRUE(ipRange.fromText("1.1.1.1\n2.2.2.2\n3.3.3.3\n10.0.0.0/8\n172.16.0.0/12\n"));
+
+    // Not contained in the current addresses: the patched list is smaller than the current one
+    IpRange removedRange;
+    ASSERT_TRUE(removedRange.fromText("5.5.5.5\n6.6.6.6\n192.168.0.0/16\n"));
+
+    ConfUtil zoneUtil;
+    zoneUtil.writeZone(ipRange);
+
+    ConfUtil removedUtil;
+    removedUtil.writeZone(removedRange);
+
+    IpRange addedRange;
+
+    ConfUtil addedUtil;
+    addedUtil.writeZone(addedRange);
+
+    // Must fail without writing past the patched list
+    QByteArray patchedData;
+    ASSERT_FALSE(DriverCommon::confAddrListPatch(
+            zoneUtil.data(), removedUtil.data(), addedUtil.data(), patchedData));
+
+    // Partially contained
+    IpRange partialRange;
+    ASSERT_TRUE(partialRange.fromText("1.1.1.1\n6.6.6.6\n"));
+
+    ConfUtil partialUtil;
+    partialUtil.writeZone(partialRange);
+
+    ASSERT_FALSE(DriverCommon::confAddrListPatch(
+            zoneUtil.data(), partialUtil.data(), addedUtil.data(), patchedData));
+}
+
+TEST_F(ConfUtilTest, zoneCompilerParallel)
+{
+    constexpr int zonesCount = 8;
+
+    const QString cachePath = FileUtil::tempLocation() + "/fort-zones-test/";
+    ASSERT_TRUE(FileUtil::makePath(cachePath));
+
+    TaskZoneCompiler zoneCompiler;
+
+    QList<TaskZoneDownloader *> workers;
+    QList<QSignalSpy *> spies;
+
+    // Local source files stand in for the HTTP downloads
+    for (int zoneId = 1; zoneId <= zonesCount; ++zoneId) {
+        const QString sourcePath = cachePath + QString("source-%1.txt").arg(zoneId);
+
+        ASSERT_TRUE(FileUtil::writeFile(sourcePath,
+                QString("# Zone %1\n10.%1.0.0/16\n192.168.%1.1\n").arg(zoneId)));
+
+        auto worker = new TaskZoneDownloader();
+        worker->setZoneId(zoneId);
+        worker->setSort(true);
+        worker->setPattern("^\\D*([\\d./-]{7,})");
+        worker->setUrl(sourcePath);
+        worker->setCachePath(cachePath);
+        worker->setZoneCompiler(&zoneCompiler);
+
+        workers.append(worker);
+        spies.append(new QSignalSpy(worker, &TaskWorker::finished));
+    }
+
+    for (auto worker : workers) {
+        worker->run();
+    }
+
+    for (int i = 0; i < zonesCount; ++i) {
+        QSignalSpy *spy = spies[i];
+
+        ASSERT_TRUE(spy->count() > 0 || spy->wait());
+        ASSERT_TRUE(spy->at(0).at(0).toBool());
+
+        ConfUtil zoneUtil(workers[i]->zoneData());
+
+        IpRange ipRange;
+        ASSERT_TRUE(zoneUtil.loadZone(ipRange));
+        ASSERT_EQ(ipRange.size(), 2);
+        ASSERT_EQ(workers[i]->addressCount(), 2);
+    }
+
+    qDeleteAll(spies);
+    qDeleteAll(workers);
+
+    QDir(cachePath).removeRecursively();
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QLocalServer>
+#include <QLocalSocket>
+
+#include <googletest.h>
+
+#include <control/controlworker.h>
+
+namespace ControlTest {
+
+struct WorkerPair
+{
+    bool setup(const QString &serverName)
+    {
+        QLocalServer::removeServer(serverName);
+
+        if (!server.listen(serverName))
+            return false;
+
+        auto clientSocket = new QLocalSocket();
+        clientSocket->connectToServer(serverName);
+        if (!clientSocket->waitForConnected() || !server.waitForNewConnection(1000)) {
+            delete clientSocket;
+            return false;
+        }
+
+        client = new ControlWorker(clientSocket, &server);
+        client->setupForAsync();
+
+        service = new ControlWorker(server.nextPendingConnection(), &server);
+        service->setupForAsync();
+
+        return true;
+    }
+
+    QLocalServer server;
+    ControlWorker *client = nullptr;
+    ControlWorker *service = nullptr;
+};
+
+// Returns the received messages per second
+double sendMessages(WorkerPair &pair, Control::Command command, int count, QVariantList &lastArgs)
+{
+    int receivedCount = 0;
+
+    const auto conn = QObject::connect(pair.service, &ControlWorker::requestReady,
+            [&](Control::Command /*command*/, const QVariantList &args) {
+                ++receivedCount;
+                lastArgs = args;
+            });
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int i = 1; i <= count; ++i) {
+        pair.client->sendCommand(command, { qint64(i) << 32, quint32(i), quint32(i * 2) });
+
+        if ((i % 64) == 0) {
+            QCoreApplication::processEvents();
+        }
+    }
+
+    while (receivedCount < count && timer.elapsed() < 30000) {
+        pair.client->waitForSent(10);
+        QCoreApplication::processEvents();
+    }
+
+    const qint64 elapsedNsec = timer.nsecsElapsed();
+
+    QObject::disconnect(conn);
+
+    return receivedCount < count ? 0 : count * 1e9 / elapsedNsec;
+}
+
+}
+
+class ControlWorkerTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+};
+
+void ControlWorkerTest::SetUp() { }
+
+void ControlWorkerTest::TearDown() { }
+
+TEST_F(ControlWorkerTest, fixedLayoutArgs)
+{
+    const QVariantList badArgs = { qint64(1) << 40, quint32(1), quint32(2), "C:\\app.exe" };
+
+    const QByteArray data = ControlWorker::buildCommandData(
+            Control::Rpc_StatManager_trafficAdded, { qint64(3), quint32(1), quint32(2) });
+    ASSERT_FALSE(data.isEmpty());
+
+    // Header + qint64 + 2 * quint32
+    ASSERT_EQ(data.size(), 4 + 8 + 4 + 4);
+
+    // Wrong args count
+    ASSERT_TRUE(ControlWorker::buildCommandData(Control::Rpc_StatManager_trafficAdded, badArgs)
+                    .isEmpty());
+}
+
+TEST_F(ControlWorkerTest, loopbackBench)
+{
+    using namespace ControlTest;
+
+    constexpr int messageCount = 100000;
+
+    WorkerPair pair;
+    ASSERT_TRUE(pair.setup("fort-control-test"));
+
+    QVariantList lastArgs;
+
+    const double fixedRate =
+            sendMessages(pair, Control::Rpc_StatManager_trafficAdded, messageCount, lastArgs);
+    ASSERT_GT(fixedRate, 0);
+
+    ASSERT_EQ(lastArgs.size(), 3);
+    ASSERT_EQ(lastArgs[0].toLongLong(), qint64(messageCount) << 32);
+    ASSERT_EQ(lastArgs[1].toUInt(), quint32(messageCount));
+    ASSERT_EQ(lastArgs[2].toUInt(), quint32(messageCount * 2));
+
+    const double streamRate =
+            sendMessages(pair, Control::Rpc_ConfAppManager_appsChanged, messageCount, lastArgs);
+    ASSERT_GT(streamRate, 0);
+
+    ASSERT_EQ(lastArgs.size(), 3);
+    ASSERT_EQ(lastArgs[0].toLongLong(), qint64(messageCount) << 32);
+
+    qDebug() << "msgs/sec>" << qRound(fixedRate) << "(fixed)" << qRound(streamRate)
+             << "(stream)";
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <QHash>
+#include <QMutex>
+#include <QSemaphore>
+
+#include <googletest.h>
+
+#include <hostinfo/hostinfomanager.h>
+#include <util/fileutil.h>
+
+namespace HostTest {
+
+// Names the even addresses only
+class StubHostInfoManager : public HostInfoManager
+{
+public:
+    explicit StubHostInfoManager(const QString &filePath, QSemaphore *gate = nullptr) :
+        HostInfoManager(filePath), m_gate(gate)
+    {
+    }
+
+    int resolveCount() const { return m_resolveCount.loadRelaxed(); }
+
+protected:
+    QString resolveHostName(const QString &address) override
+    {
+        if (m_gate) {
+            m_gate->acquire();
+            m_gate->release();
+        }
+
+        m_resolveCount.fetchAndAddRelaxed(1);
+
+        const int lastOctet = address.section('.', -1).toInt();
+
+        return (lastOctet % 2 == 0) ? QString("host-%1").arg(lastOctet) : address;
+    }
+
+private:
+    QSemaphore *m_gate = nullptr;
+    QAtomicInt m_resolveCount;
+};
+
+}
+
+class HostInfoTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+};
+
+void HostInfoTest::SetUp() { }
+
+void HostInfoTest::TearDown() { }
+
+TEST_F(HostInfoTest, coalesceAndPersist)
+{
+    using namespace HostTest;
+
+    constexpr int addressCount = 200;
+
+    const QString filePath = FileUtil::tempLocation() + "/fort-hostinfo-test.db";
+    FileUtil::removeFile(filePath);
+
+    QStringList addresses;
+    for (int i = 0; i < addressCount; ++i) {
+        addresses.append(QString("10.0.%1.%2").arg(i / 250).arg(i % 250));
+    }
+
+    const auto lookupAddresses = [&](StubHostInfoManager &manager, QSemaphore *gate) {
+        QHash<QString, HostInfo> results;
+        QMutex mutex;
+
+        QObject::connect(
+                &manager, &HostInfoManager::lookupFinished, &manager,
+                [&](const QString &address, const HostInfo &hostInfo) {
+                    QMutexLocker locker(&mutex);
+                    results.insert(address, hostInfo);
+                },
+                Qt::DirectConnection);
+
+        // The rows are painted several times, while the queries are in progress
+        for (int pass = 0; pass < 3; ++pass) {
+            for (const QString &address : std::as_const(addresses)) {
+                manager.lookupHost(address);
+            }
+        }
+
+        if (gate) {
+            gate->release();
+        }
+
+        manager.finishWorkers();
+
+        return results;
+    };
+
+    QHash<QString, HostInfo> resolved;
+    {
+        QSemaphore gate;
+        StubHostInfoManager manager(filePath, &gate);
+
+        resolved = lookupAddresses(manager, &gate);
+
+        ASSERT_EQ(manager.resolveCount(), addressCount);
+    }
+
+    ASSERT_EQ(resolved.size(), addressCount);
+    ASSERT_EQ(resolved.value("10.0.0.2").hostName, QString("host-2"));
+    ASSERT_TRUE(resolved.value("10.0.0.3").hostName.isEmpty());
+    ASSERT_FALSE(resolved.value("10.0.0.3").isExpired());
+
+    // Found and not found names survive the restart
+    {
+        StubHostInfoManager manager(filePath);
+
+        const auto loaded = lookupAddresses(manager, nullptr);
+
+        ASSERT_EQ(manager.resolveCount(), 0);
+        ASSERT_EQ(loaded.size(), addressCount);
+
+        for (const QString &address : std::as_const(addresses)) {
+            ASSERT_EQ(loaded.value(address).hostName, resolved.value(address).hostName);
+        }
+    }
+
+    FileUtil::removeFile(filePath);
+}
@@ -1,9 +1,15 @@
+#include "tst_appinfo.h"
 #include "tst_bitutil.h"
 #include "tst_confutil.h"
+#include "tst_controlworker.h"
 #include "tst_fileutil.h"
+#include "tst_hostinfo.h"
 #include "tst_ioccontainer.h"
 #include "tst_netutil.h"
+#include "tst_sqlitedb.h"
 #include "tst_stringutil.h"
+#include "tst_tablesqlmodel.h"
+#include "tst_workermanager.h"
 
 #include <QCoreApplication>
 
@@ -131,9 +131,41 @@ TEST_F(NetUtilTest, ip6Ranges)
 
     ASSERT_TRUE(ipRange.fromText("[::2]/126\n"
                                  "[::1]/126\n"));
+    ASSERT_EQ(ipRange.toText(), QString("::1-::3\n"));
+}
+
+TEST_F(NetUtilTest, ipRangesOptimize)
+{
+    IpRange ipRange;
+
+    // Adjacent addresses and ranges, duplicates and addresses covered by ranges
+    ASSERT_TRUE(ipRange.fromText("10.0.0.5\n"
+                                 "10.0.0.1\n"
+                                 "10.0.0.2\n"
+                                 "10.0.0.3 - 10.0.0.4\n"
+                                 "10.0.0.0/8\n"
+                                 "10.0.0.0\n"
+                                 "192.168.0.1\n"
+                                 "192.168.0.3\n"
+                                 "192.168.0.3\n"
+                                 "255.255.255.254 - 255.255.255.255\n"
+                                 "255.255.255.253\n"
+                                 "::1\n"
+                                 "::2\n"
+                                 "::3 - ::10\n"
+                                 "::5\n"
+                                 "::f0 - ::ff\n"
+                                 "::100 - ::1ff\n"
+                                 "2002::/16\n"));
     ASSERT_EQ(ipRange.toText(),
-            QString("::1-::3\n"
-                    "::2-::3\n"));
+            QString("192.168.0.1\n"
+                    "192.168.0.3\n"
+                    "10.0.0.0-10.255.255.255\n"
+                    "255.255.255.253-255.255.255.255\n"
+                    "::1-::10\n"
+                    "::f0-::1ff\n"
+                    "2002::-2002:ffff:ffff:ffff:ffff:ffff:ffff:ffff\n"));
+    ASSERT_EQ(ipRange.size(), 7);
 }
 
 TEST_F(NetUtilTest, taskTasix)
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <QDebug>
+
+#include <googletest.h>
+
+#include <sqlite/sqlitedb.h>
+#include <sqlite/sqlitestmt.h>
+
+class SqliteDbTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+};
+
+void SqliteDbTest::SetUp() { }
+
+void SqliteDbTest::TearDown() { }
+
+TEST_F(SqliteDbTest, stmtCache)
+{
+    SqliteDb sqliteDb(":memory:");
+    ASSERT_TRUE(sqliteDb.open());
+
+    sqliteDb.setStmtCacheMaxCount(2);
+
+    const char *const sqlA = "SELECT 1;";
+    const char *const sqlB = "SELECT 2 UNION ALL SELECT 3;";
+    const char *const sqlC = "SELECT 4;";
+    const char *const sqlD = "SELECT 5;";
+
+    // Cached by the text
+    const QByteArray sqlCopyA(sqlA);
+    ASSERT_EQ(sqliteDb.stmt(sqlA), sqliteDb.stmt(sqlCopyA.constData()));
+
+    SqliteStmt *stmtA = sqliteDb.stmt(sqlA);
+    ASSERT_EQ(stmtA->step(), SqliteStmt::StepRow);
+    stmtA->reset();
+
+    // The statements handed out since the transaction end are not evicted
+    SqliteStmt *stmtB = sqliteDb.stmt(sqlB);
+    sqliteDb.stmt(sqlA);
+    sqliteDb.stmt(sqlC);
+
+    ASSERT_EQ(sqliteDb.stmtCacheCount(), 3);
+
+    ASSERT_TRUE(sqliteDb.beginTransaction());
+    ASSERT_TRUE(sqliteDb.commitTransaction());
+
+    // The least recently used, but busy statement is not evicted
+    ASSERT_EQ(stmtB->step(), SqliteStmt::StepRow);
+
+    sqliteDb.stmt(sqlD);
+
+    ASSERT_EQ(sqliteDb.stmtCacheCount(), 3);
+    ASSERT_EQ(sqliteDb.stmt(sqlB), stmtB);
+
+    ASSERT_EQ(stmtB->step(), SqliteStmt::StepRow);
+    ASSERT_EQ(stmtB->columnInt(), 3);
+    stmtB->reset();
+
+    // The stats of a cached statement are published on its execution finish
+    SqliteStmt *stmtD = sqliteDb.stmt(sqlD);
+    ASSERT_EQ(stmtD->step(), SqliteStmt::StepRow);
+    ASSERT_EQ(stmtD->step(), SqliteStmt::StepDone);
+    stmtD->reset();
+
+    // The stats of the evicted statement are kept
+    bool isStatA = false;
+    bool isStatD = false;
+    const auto stats = sqliteDb.stmtStats();
+    for (const SqliteStmtStat &stat : stats) {
+        if (stat.sql == sqlA) {
+            ASSERT_EQ(stat.execCount, 1ULL);
+            ASSERT_GT(stat.vmStepCount, 0ULL);
+            isStatA = true;
+        } else if (stat.sql == sqlD) {
+            ASSERT_EQ(stat.execCount, 1ULL);
+            ASSERT_EQ(stat.stepCount, 2ULL);
+            isStatD = true;
+        }
+    }
+    ASSERT_TRUE(isStatA);
+    ASSERT_TRUE(isStatD);
+}
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <functional>
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QThread>
+
+#include <googletest.h>
+
+#include <sqlite/sqlitedb.h>
+#include <sqlite/sqlitestmt.h>
+
+#include <util/fileutil.h>
+#include <util/model/tablesqlloader.h>
+#include <util/model/tablesqlmodel.h>
+
+namespace TableSqlTest {
+
+struct BenchRow : TableRow
+{
+    qint64 id = 0;
+    qint64 value = 0;
+    QString name;
+};
+
+class BenchModel : public TableSqlModel
+{
+public:
+    explicit BenchModel(SqliteDb *sqliteDb) : m_sqliteDb(sqliteDb) { setSortColumn(0); }
+
+    SqliteDb *sqliteDb() const override { return m_sqliteDb; }
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : 3;
+    }
+
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override
+    {
+        if (!index.isValid() || role != Qt::DisplayRole)
+            return QVariant();
+
+        const auto &benchRow = benchRowAt(index.row());
+        if (benchRow.isNull())
+            return QVariant();
+
+        switch (index.column()) {
+        case 0:
+            return benchRow.id;
+        case 1:
+            return benchRow.name;
+        case 2:
+            return benchRow.value;
+        }
+
+        return QVariant();
+    }
+
+    const BenchRow &benchRowAt(int row) const
+    {
+        updateRowCache(row);
+
+        return m_benchRow;
+    }
+
+protected:
+    bool updateTableRow(const QVariantHash & /*vars*/, int row) const override
+    {
+        return updateTableRowCached(m_benchRows, row, m_benchRow, &BenchModel::fillBenchRow);
+    }
+
+    TableRow &tableRow() const override { return m_benchRow; }
+    TableRowCacheBase *rowCache() const override { return &m_benchRows; }
+
+    QString sqlBase() const override { return "SELECT id, name, value FROM bench"; }
+    QString sqlOrderColumn() const override { return "id" + sqlOrderAsc(); }
+
+private:
+    static void fillBenchRow(SqliteStmt &stmt, BenchRow &benchRow)
+    {
+        benchRow.id = stmt.columnInt64(0);
+        benchRow.name = stmt.columnText(1);
+        benchRow.value = stmt.columnInt64(2);
+    }
+
+private:
+    SqliteDb *m_sqliteDb = nullptr;
+
+    mutable BenchRow m_benchRow;
+    mutable TableRowCache<BenchRow> m_benchRows;
+};
+
+bool waitFor(const std::function<bool()> &isDone, int timeoutMsec = 30000)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    while (!isDone()) {
+        if (timer.elapsed() > timeoutMsec)
+            return false;
+
+        QCoreApplication::processEvents();
+        QThread::msleep(1);
+    }
+    return true;
+}
+
+// Returns the worst frame time in msec
+double scrollFrames(BenchModel &model)
+{
+    constexpr int visibleRows = 40;
+    constexpr int scrollFrameCount = 500;
+    constexpr int jumpFrameCount = 50;
+
+    const int rowCount = model.rowCount();
+    const int columnCount = model.columnCount();
+
+    qint64 maxFrameNsec = 0;
+
+    const auto paintFrame = [&](int topRow) {
+        QElapsedTimer timer;
+        timer.start();
+
+        for (int row = topRow; row < qMin(topRow + visibleRows, rowCount); ++row) {
+            for (int column = 0; column < columnCount; ++column) {
+                model.data(model.index(row, column));
+            }
+        }
+
+        QCoreApplication::processEvents();
+
+        maxFrameNsec = qMax(maxFrameNsec, timer.nsecsElapsed());
+    };
+
+    // Wheel scrolling
+    for (int frame = 0; frame < scrollFrameCount; ++frame) {
+        paintFrame(frame * visibleRows / 4);
+    }
+
+    // Scroll bar dragging
+    for (int frame = 0; frame < jumpFrameCount; ++frame) {
+        paintFrame(qint64(rowCount - visibleRows) * frame / (jumpFrameCount - 1));
+    }
+
+    return maxFrameNsec / 1000000.0;
+}
+
+}
+
+class TableSqlModelTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+};
+
+void TableSqlModelTest::SetUp() { }
+
+void TableSqlModelTest::TearDown() { }
+
+TEST_F(TableSqlModelTest, scrollBench)
+{
+    using namespace TableSqlTest;
+
+    constexpr int rowCount = 1000000;
+
+    const QString filePath = FileUtil::tempLocation() + "/fort-table-test.db";
+    FileUtil::removeFile(filePath);
+
+    SqliteDb sqliteDb(filePath);
+    ASSERT_TRUE(sqliteDb.open());
+
+    ASSERT_TRUE(sqliteDb.execute(
+            "CREATE TABLE bench(id INTEGER PRIMARY KEY, name TEXT, value INTEGER);"
+            "WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM c WHERE x < 1000000)"
+            "  INSERT INTO bench(id, name, value)"
+            "    SELECT x, 'row ' || x, x * 7 FROM c;"));
+
+    double syncMaxFrameMsec = 0;
+    {
+        BenchModel model(&sqliteDb);
+        ASSERT_EQ(model.rowCount(), rowCount);
+
+        syncMaxFrameMsec = scrollFrames(model);
+    }
+
+    double asyncMaxFrameMsec = 0;
+    {
+        BenchModel model(&sqliteDb);
+        model.setupAsyncLoading();
+        ASSERT_NE(model.loader(), nullptr);
+
+        // Counted in the worker
+        ASSERT_EQ(model.rowCount(), 0);
+        ASSERT_TRUE(waitFor([&] { return model.rowCount() == rowCount; }));
+
+        asyncMaxFrameMsec = scrollFrames(model);
+
+        // The last row is loaded after its placeholder
+        const auto lastIndex = model.index(rowCount - 1, 1);
+        ASSERT_TRUE(waitFor([&] { return !model.data(lastIndex).isNull(); }));
+        ASSERT_EQ(model.data(lastIndex).toString(), QString("row %1").arg(rowCount));
+    }
+
+    qDebug() << "max frame>" << syncMaxFrameMsec << "msec (sync)" << asyncMaxFrameMsec
+             << "msec (async)";
+
+    sqliteDb.close();
+
+    FileUtil::removeFile(filePath);
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QSemaphore>
+
+#include <googletest.h>
+
+#include <util/worker/workerjob.h>
+#include <util/worker/workermanager.h>
+
+namespace WorkerTest {
+
+class OrderJob : public WorkerJob
+{
+public:
+    explicit OrderJob(QSemaphore *gate, QStringList *order, QMutex *mutex, const QString &text) :
+        WorkerJob(text), m_gate(gate), m_order(order), m_mutex(mutex)
+    {
+    }
+
+    void doJob(WorkerObject & /*worker*/) override
+    {
+        if (m_gate) {
+            m_gate->acquire();
+            return;
+        }
+
+        QMutexLocker locker(m_mutex);
+        m_order->append(text());
+    }
+
+private:
+    QSemaphore *m_gate = nullptr;
+    QStringList *m_order = nullptr;
+    QMutex *m_mutex = nullptr;
+};
+
+class CountJob : public WorkerJob
+{
+public:
+    explicit CountJob(QAtomicInt *counter) : m_counter(counter) { }
+
+    void doJob(WorkerObject & /*worker*/) override { m_counter->fetchAndAddRelaxed(1); }
+
+private:
+    QAtomicInt *m_counter = nullptr;
+};
+
+}
+
+class WorkerManagerTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+};
+
+void WorkerManagerTest::SetUp() { }
+
+void WorkerManagerTest::TearDown() { }
+
+TEST_F(WorkerManagerTest, priorityAndCancel)
+{
+    using namespace WorkerTest;
+
+    WorkerManager manager;
+    manager.setMaxWorkersCount(1);
+
+    QSemaphore gate;
+    QStringList order;
+    QMutex mutex;
+
+    // Hold the worker until all jobs are queued
+    manager.enqueueJob(WorkerJobPtr(new OrderJob(&gate, nullptr, nullptr, "gate")));
+
+    const auto addJob = [&](const QString &text, WorkerJob::Priority priority,
+                                const WorkerCancelTokenPtr &cancelToken = {}) {
+        auto job = new OrderJob(nullptr, &order, &mutex, text);
+        job->setPriority(priority);
+        job->setCancelToken(cancelToken);
+
+        manager.enqueueJob(WorkerJobPtr(job));
+    };
+
+    WorkerCancelTokenPtr cancelToken(new WorkerCancelToken());
+
+    addJob("low", WorkerJob::PriorityLow);
+    addJob("normal-1", WorkerJob::PriorityNormal);
+    addJob("canceled", WorkerJob::PriorityHigh, cancelToken);
+    addJob("high", WorkerJob::PriorityHigh);
+    addJob("normal-2", WorkerJob::PriorityNormal);
+
+    cancelToken->cancel();
+
+    gate.release();
+    manager.finishWorkers();
+
+    ASSERT_EQ(order, QStringList({ "high", "normal-1", "normal-2", "low" }));
+
+    const WorkerStats stats = manager.stats();
+    ASSERT_EQ(stats.enqueuedCount, 6ULL);
+    ASSERT_EQ(stats.canceledCount, 1ULL);
+    ASSERT_EQ(stats.processedCount, 5ULL);
+}
+
+TEST_F(WorkerManagerTest, throughputBench)
+{
+    using namespace WorkerTest;
+
+    constexpr int jobCount = 200000;
+
+    for (const int workersCount : { 1, 2, 4 }) {
+        WorkerManager manager;
+        manager.setMaxWorkersCount(workersCount);
+
+        QAtomicInt counter;
+
+        QElapsedTimer timer;
+        timer.start();
+
+        for (int i = 0; i < jobCount; ++i) {
+            manager.enqueueJob(WorkerJobPtr(new CountJob(&counter)));
+        }
+
+        manager.finishWorkers();
+
+        const qint64 elapsed = timer.elapsed();
+
+        ASSERT_EQ(counter.loadRelaxed(), jobCount);
+
+        const WorkerStats stats = manager.stats();
+
+        qDebug() << "workers>" << workersCount << "elapsed>" << elapsed << "msec"
+                 << "rate>" << (jobCount * 1000LL / qMax(elapsed, 1LL)) << "jobs/sec"
+                 << "latency>" << (stats.queueLatencyUsec / qMax(stats.processedCount, 1ULL))
+                 << "usec avg" << stats.maxQueueLatencyUsec << "usec max";
+    }
+}
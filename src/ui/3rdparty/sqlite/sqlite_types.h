@@ -1,14 +1,33 @@
 #ifndef SQLITE_TYPES_H
 #define SQLITE_TYPES_H
 
+#include <QByteArray>
 #include <QList>
 #include <QSharedPointer>
 
 class SqliteDb;
+class SqliteDbPool;
 class SqliteStmt;
 
 using SqliteDbPtr = QSharedPointer<SqliteDb>;
 
 using SqliteStmtList = QList<SqliteStmt *>;
 
+struct SqliteStmtStat
+{
+    QByteArray sql;
+    quint64 execCount = 0;
+    quint64 stepCount = 0;
+    quint64 busyWaitCount = 0;
+    qint64 stepTimeNsec = 0;
+
+    // sqlite3_stmt_status() counters
+    quint64 fullscanStepCount = 0;
+    quint64 sortCount = 0;
+    quint64 autoindexCount = 0;
+    quint64 vmStepCount = 0;
+};
+
+using SqliteStmtStatList = QList<SqliteStmtStat>;
+
 #endif // SQLITE_TYPES_H
@@ -50,6 +50,18 @@ bool renameDbFile(const QString &filePath, const QString &newFilePath)
     return true;
 }
 
+void addStmtStat(SqliteStmtStat &stat, const SqliteStmtStat &v)
+{
+    stat.execCount += v.execCount;
+    stat.stepCount += v.stepCount;
+    stat.busyWaitCount += v.busyWaitCount;
+    stat.stepTimeNsec += v.stepTimeNsec;
+    stat.fullscanStepCount += v.fullscanStepCount;
+    stat.sortCount += v.sortCount;
+    stat.autoindexCount += v.autoindexCount;
+    stat.vmStepCount += v.vmStepCount;
+}
+
 QString makeTriggerColumnNames(
         const QString &rowIdName, const QStringList &columnNames, const QString &prefix)
 {
@@ -79,7 +91,14 @@ bool SqliteDb::open()
 {
     const auto filePathUtf8 = m_filePath.toUtf8();
 
-    return sqlite3_open_v2(filePathUtf8.data(), &m_db, m_openFlags, nullptr) == SQLITE_OK;
+    if (sqlite3_open_v2(filePathUtf8.data(), &m_db, m_openFlags, nullptr) != SQLITE_OK)
+        return false;
+
+    if (m_tuneProfile != TuneDefault) {
+        tune(tuneOptions(m_tuneProfile));
+    }
+
+    return true;
 }
 
 void SqliteDb::close()
@@ -167,12 +186,16 @@ bool SqliteDb::endTransaction(bool ok)
 
 bool SqliteDb::commitTransaction()
 {
-    return execute("COMMIT;");
+    const bool ok = execute("COMMIT;");
+    unpinStmts();
+    return ok;
 }
 
 bool SqliteDb::rollbackTransaction()
 {
-    return execute("ROLLBACK;");
+    const bool ok = execute("ROLLBACK;");
+    unpinStmts();
+    return ok;
 }
 
 bool SqliteDb::beginSavepoint(const char *name)
@@ -226,7 +249,91 @@ bool SqliteDb::setEncoding(const QString &v)
 
 bool SqliteDb::setBusyTimeoutMs(int v)
 {
-    return sqlite3_busy_timeout(m_db, v) == SQLITE_OK;
+    m_busyTimeoutMs = v;
+
+    // Counts the waits, unlike the sqlite3_busy_timeout()
+    return sqlite3_busy_handler(m_db, v > 0 ? &busyHandler : nullptr, this) == SQLITE_OK;
+}
+
+int SqliteDb::busyHandler(void *context, int count)
+{
+    static const int delays[] = { 1, 2, 5, 10, 15, 20, 25, 25, 25, 50, 50, 100 };
+    constexpr int delaysCount = int(std::size(delays));
+
+    auto db = static_cast<SqliteDb *>(context);
+
+    // Total time of the prior waits
+    int priorMs = 0;
+    for (int i = 0; i < count; ++i) {
+        priorMs += delays[qMin(i, delaysCount - 1)];
+    }
+
+    int delayMs = delays[qMin(count, delaysCount - 1)];
+    if (priorMs + delayMs > db->m_busyTimeoutMs) {
+        delayMs = db->m_busyTimeoutMs - priorMs;
+        if (delayMs <= 0)
+            return 0; // give up
+    }
+
+    ++db->m_busyWaitCount;
+
+    sqlite3_sleep(delayMs);
+
+    return 1;
+}
+
+bool SqliteDb::tune(const TuneOptions &options)
+{
+    QString sql;
+
+    // Must precede the journal mode
+    if (options.pageSize > 0) {
+        sql += QString("PRAGMA page_size = %1;").arg(options.pageSize);
+    }
+    if (options.journalMode) {
+        sql += QString("PRAGMA journal_mode = %1;").arg(options.journalMode);
+    }
+    if (options.synchronous) {
+        sql += QString("PRAGMA synchronous = %1;").arg(options.synchronous);
+    }
+    if (options.mmapSize >= 0) {
+        sql += QString("PRAGMA mmap_size = %1;").arg(options.mmapSize);
+    }
+    if (options.cacheSizeKb > 0) {
+        sql += QString("PRAGMA cache_size = -%1;").arg(options.cacheSizeKb);
+    }
+    if (options.tempStoreMemory) {
+        sql += "PRAGMA temp_store = MEMORY;";
+    }
+
+    return sql.isEmpty() || executeStr(sql);
+}
+
+SqliteDb::TuneOptions SqliteDb::tuneOptions(TuneProfile profile)
+{
+    switch (profile) {
+    case TuneWriter:
+        return {
+            .journalMode = "WAL",
+            .synchronous = "NORMAL",
+            .mmapSize = 64 * 1024 * 1024,
+            .cacheSizeKb = 8 * 1024,
+            .pageSize = 8192,
+            .tempStoreMemory = true,
+        };
+    case TuneReader:
+        return {
+            .mmapSize = 256 * 1024 * 1024,
+            .cacheSizeKb = 4 * 1024,
+            .tempStoreMemory = true,
+        };
+    case TuneSmall:
+        return {
+            .cacheSizeKb = 1024,
+        };
+    default:
+        return {};
+    }
 }
 
 QString SqliteDb::getFtsTableName(const QString &tableName)
@@ -613,21 +720,115 @@ bool SqliteDb::copyTable(
 
 SqliteStmt *SqliteDb::stmt(const char *sql)
 {
-    SqliteStmt *stmt = m_stmts.value(sql);
+    // Look up without copying the text
+    const auto sqlKey = QByteArray::fromRawData(sql, qstrlen(sql));
+
+    QMutexLocker locker(&m_stmtsMutex);
 
-    if (!stmt) {
-        stmt = new SqliteStmt();
-        stmt->prepare(db(), sql, SqliteStmt::PreparePersistent);
+    auto it = m_stmts.find(sqlKey);
+    if (it != m_stmts.end()) {
+        it->useTick = ++m_stmtUseTick;
+        return it->stmt;
+    }
 
-        m_stmts.insert(sql, stmt);
+    if (m_stmts.size() >= m_stmtCacheMaxCount) {
+        evictStmt();
     }
 
+    auto stmt = new SqliteStmt();
+    stmt->prepare(db(), sql, SqliteStmt::PreparePersistent);
+    stmt->setStatDb(this);
+
+    m_stmts.insert(QByteArray(sql), { stmt, ++m_stmtUseTick });
+
     return stmt;
 }
 
+int SqliteDb::stmtCacheCount() const
+{
+    QMutexLocker locker(&m_stmtsMutex);
+
+    return m_stmts.size();
+}
+
+void SqliteDb::publishStmtStat(SqliteStmt *stmt)
+{
+    const SqliteStmtStat stat = stmt->stat();
+
+    QMutexLocker locker(&m_stmtsMutex);
+
+    stmt->setPublishedStat(stat);
+}
+
+SqliteStmtStatList SqliteDb::stmtStats() const
+{
+    QMutexLocker locker(&m_stmtsMutex);
+
+    QHash<QByteArray, SqliteStmtStat> statsMap = m_evictedStmtStats;
+
+    // Don't touch the statements: they are owned by the connection's thread
+    for (auto it = m_stmts.constBegin(); it != m_stmts.constEnd(); ++it) {
+        addStmtStat(statsMap[it.key()], it->stmt->publishedStat());
+    }
+
+    SqliteStmtStatList list;
+    list.reserve(statsMap.size());
+
+    for (auto it = statsMap.begin(); it != statsMap.end(); ++it) {
+        it->sql = it.key();
+        list.append(*it);
+    }
+
+    return list;
+}
+
+void SqliteDb::unpinStmts()
+{
+    QMutexLocker locker(&m_stmtsMutex);
+
+    m_stmtPinTick = m_stmtUseTick;
+}
+
+void SqliteDb::evictStmt()
+{
+    QByteArray lruSql;
+    quint64 lruTick = 0;
+
+    for (auto it = m_stmts.constBegin(); it != m_stmts.constEnd(); ++it) {
+        if (it->useTick > m_stmtPinTick)
+            continue; // handed out since the last transaction end, callers may still hold it
+
+        if (it->stmt->isBusy())
+            continue; // in use
+
+        if (lruSql.isNull() || it->useTick < lruTick) {
+            lruSql = it.key();
+            lruTick = it->useTick;
+        }
+    }
+
+    if (!lruSql.isNull()) {
+        removeStmt(lruSql);
+    }
+}
+
+void SqliteDb::removeStmt(const QByteArray &sql)
+{
+    SqliteStmt *stmt = m_stmts.take(sql).stmt;
+
+    // Keep the stats of the statement
+    addStmtStat(m_evictedStmtStats[sql], stmt->stat());
+
+    delete stmt;
+}
+
 void SqliteDb::clearStmts()
 {
-    qDeleteAll(m_stmts);
+    QMutexLocker locker(&m_stmtsMutex);
+
+    for (const StmtEntry &entry : std::as_const(m_stmts)) {
+        delete entry.stmt;
+    }
     m_stmts.clear();
 }
 
@@ -2,19 +2,19 @@
 #define SQLITEDB_H
 
 #include <QHash>
+#include <QMutex>
 #include <QObject>
 #include <QString>
 #include <QVariant>
 
 #include <util/classhelpers.h>
 
+#include "sqlite_types.h"
+
 QT_FORWARD_DECLARE_CLASS(QDir)
 
 struct sqlite3;
 
-class SqliteDb;
-class SqliteStmt;
-
 using SQLITEDB_ERRORLOG_FUNC = void (*)(void *context, int errCode, const char *message);
 using SQLITEDB_MIGRATE_FUNC = bool (*)(SqliteDb *db, int version, bool isNewDb, void *context);
 
@@ -36,6 +36,23 @@ public:
         OpenDefaultReadWrite = (OpenReadWrite | OpenCreate | OpenNoMutex)
     };
 
+    enum TuneProfile : qint8 {
+        TuneDefault = 0, // SQLite's defaults
+        TuneWriter, // Stores of logged events
+        TuneReader, // Read-only connections of the UI
+        TuneSmall, // Small databases
+    };
+
+    struct TuneOptions
+    {
+        const char *journalMode = nullptr;
+        const char *synchronous = nullptr;
+        qint64 mmapSize = -1;
+        int cacheSizeKb = 0;
+        int pageSize = 0; // applied to new databases only
+        bool tempStoreMemory = false;
+    };
+
     struct FtsTable
     {
         const QString contentTable;
@@ -69,6 +86,12 @@ public:
     QString filePath() const { return m_filePath; }
     void setFilePath(const QString &v) { m_filePath = v; }
 
+    // Applied on open()
+    TuneProfile tuneProfile() const { return m_tuneProfile; }
+    void setTuneProfile(TuneProfile v) { m_tuneProfile = v; }
+
+    quint64 busyWaitCount() const { return m_busyWaitCount; }
+
     bool open();
     void close();
 
@@ -107,6 +130,9 @@ public:
 
     bool setBusyTimeoutMs(int v);
 
+    bool tune(const TuneOptions &options);
+    static TuneOptions tuneOptions(TuneProfile profile);
+
     static QString getFtsTableName(const QString &tableName);
 
     static QString migrationOldSchemaName();
@@ -117,14 +143,27 @@ public:
 
     bool migrate(SqliteDb::MigrateOptions &opt);
 
+    // Cached by the SQL text, the least recently used statements are finalized
     SqliteStmt *stmt(const char *sql);
 
+    int stmtCacheMaxCount() const { return m_stmtCacheMaxCount; }
+    void setStmtCacheMaxCount(int v) { m_stmtCacheMaxCount = v; }
+
+    int stmtCacheCount() const;
+
+    // Published by the owner thread, when a statement's execution is finished
+    void publishStmtStat(SqliteStmt *stmt);
+
+    SqliteStmtStatList stmtStats() const;
+
     static bool isIoError(int errCode);
     static bool isDebugError(int errCode);
 
     static bool setErrorLogCallback(SQLITEDB_ERRORLOG_FUNC errorLogFunc, void *context = nullptr);
 
 private:
+    static int busyHandler(void *context, int count);
+
     bool canMigrate(const MigrateOptions &opt) const;
     bool migrateDb(const MigrateOptions &opt, int userVersion, bool isNewDb);
     bool migrateSqlScripts(const MigrateOptions &opt, int userVersion, bool isNewDb);
@@ -145,14 +184,37 @@ private:
     bool copyTables(const QString &srcSchema, const QString &dstSchema);
     bool copyTable(const QString &srcSchema, const QString &dstSchema, const QString &tableName);
 
+    void unpinStmts();
+    void evictStmt();
+    void removeStmt(const QByteArray &sql);
     void clearStmts();
 
 private:
+    TuneProfile m_tuneProfile = TuneDefault;
+
+    int m_busyTimeoutMs = 0;
+    quint64 m_busyWaitCount = 0;
+
     quint32 m_openFlags = 0;
     sqlite3 *m_db = nullptr;
     QString m_filePath;
 
-    QHash<const char *, SqliteStmt *> m_stmts;
+    struct StmtEntry
+    {
+        SqliteStmt *stmt = nullptr;
+        quint64 useTick = 0;
+    };
+
+    int m_stmtCacheMaxCount = 128;
+    quint64 m_stmtUseTick = 0;
+    quint64 m_stmtPinTick = 0; // statements used after it are not evicted
+
+    // Guards the statements against the stats readers of other threads
+    mutable QMutex m_stmtsMutex;
+
+    QHash<QByteArray, StmtEntry> m_stmts; // SQL text -> statement
+
+    QHash<QByteArray, SqliteStmtStat> m_evictedStmtStats;
 };
 
 #endif // SQLITEDB_H
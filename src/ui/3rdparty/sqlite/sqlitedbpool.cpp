@@ -0,0 +1,84 @@
+#include "sqlitedbpool.h"
+
+#include <QLoggingCategory>
+#include <QThread>
+
+#include "sqlitestmt.h"
+
+namespace {
+
+const QLoggingCategory LC("dbPool");
+
+}
+
+SqliteDbPool::SqliteDbPool(const QString &filePath, QObject *parent, quint32 openFlags,
+        SqliteDb::TuneProfile tuneProfile) :
+    QObject(parent), m_openFlags(openFlags), m_tuneProfile(tuneProfile), m_filePath(filePath)
+{
+}
+
+SqliteDbPool::~SqliteDbPool()
+{
+    close();
+}
+
+SqliteDb *SqliteDbPool::threadDb()
+{
+    QThread *thread = QThread::currentThread();
+
+    QMutexLocker locker(&m_mutex);
+
+    SqliteDb *db = m_dbs.value(thread);
+    if (db)
+        return db;
+
+    db = new SqliteDb(m_filePath, m_openFlags);
+    db->setTuneProfile(m_tuneProfile);
+
+    if (!db->open()) {
+        qCWarning(LC) << "File open error:" << m_filePath << db->errorMessage();
+    }
+
+    m_dbs.insert(thread, db);
+
+    connect(
+            thread, &QThread::finished, this, [=, this] { closeThreadDb(thread); },
+            Qt::DirectConnection);
+
+    return db;
+}
+
+int SqliteDbPool::count() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    return m_dbs.size();
+}
+
+SqliteStmtStatList SqliteDbPool::stmtStats() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    // The stats are published by the connections' threads
+    SqliteStmtStatList list;
+    for (const SqliteDb *db : m_dbs) {
+        list.append(db->stmtStats());
+    }
+
+    return list;
+}
+
+void SqliteDbPool::close()
+{
+    QMutexLocker locker(&m_mutex);
+
+    qDeleteAll(m_dbs);
+    m_dbs.clear();
+}
+
+void SqliteDbPool::closeThreadDb(QThread *thread)
+{
+    QMutexLocker locker(&m_mutex);
+
+    delete m_dbs.take(thread);
+}
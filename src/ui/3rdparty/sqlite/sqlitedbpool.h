@@ -0,0 +1,48 @@
+#ifndef SQLITEDBPOOL_H
+#define SQLITEDBPOOL_H
+
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+
+#include "sqlitedb.h"
+
+QT_FORWARD_DECLARE_CLASS(QThread)
+
+class SqliteDbPool : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SqliteDbPool(const QString &filePath, QObject *parent = nullptr,
+            quint32 openFlags = SqliteDb::OpenDefaultReadOnly,
+            SqliteDb::TuneProfile tuneProfile = SqliteDb::TuneReader);
+    ~SqliteDbPool() override;
+    CLASS_DELETE_COPY_MOVE(SqliteDbPool)
+
+    QString filePath() const { return m_filePath; }
+
+    // Connection of the current thread: opened on first use, closed on the thread's finish
+    SqliteDb *threadDb();
+
+    int count() const;
+
+    SqliteStmtStatList stmtStats() const;
+
+    void close();
+
+private:
+    void closeThreadDb(QThread *thread);
+
+private:
+    const quint32 m_openFlags = 0;
+    const SqliteDb::TuneProfile m_tuneProfile = SqliteDb::TuneDefault;
+
+    const QString m_filePath;
+
+    mutable QMutex m_mutex;
+
+    QHash<QThread *, SqliteDb *> m_dbs;
+};
+
+#endif // SQLITEDBPOOL_H
@@ -2,11 +2,14 @@
 
 #include <QBuffer>
 #include <QDataStream>
+#include <QElapsedTimer>
 #include <QHash>
 #include <QImage>
 
 #include <sqlite.h>
 
+#include "sqlitedb.h"
+
 namespace {
 
 bool stmtBindVarNull(SqliteStmt &stmt, int index, const QVariant & /*v*/)
@@ -244,6 +247,53 @@ bool SqliteStmt::isBusy() const
 }
 
 SqliteStmt::StepResult SqliteStmt::step()
+{
+    return m_statDb ? stepStat() : doStep();
+}
+
+SqliteStmtStat SqliteStmt::stat() const
+{
+    SqliteStmtStat stat = m_stat;
+
+    stat.fullscanStepCount = status(StatusFullscanStep);
+    stat.sortCount = status(StatusSort);
+    stat.autoindexCount = status(StatusAutoindex);
+    stat.vmStepCount = status(StatusVmStep);
+
+    return stat;
+}
+
+int SqliteStmt::status(StatusCounter counter) const
+{
+    return m_stmt ? sqlite3_stmt_status(m_stmt, counter, /*resetFlg=*/0) : 0;
+}
+
+SqliteStmt::StepResult SqliteStmt::stepStat()
+{
+    const bool isNewExec = !isBusy();
+    const quint64 busyWaitCount = m_statDb->busyWaitCount();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const StepResult res = doStep();
+
+    m_stat.stepTimeNsec += timer.nsecsElapsed();
+    m_stat.busyWaitCount += m_statDb->busyWaitCount() - busyWaitCount;
+    ++m_stat.stepCount;
+
+    if (isNewExec) {
+        ++m_stat.execCount;
+    }
+
+    if (res != StepRow) {
+        m_statDb->publishStmtStat(this);
+    }
+
+    return res;
+}
+
+SqliteStmt::StepResult SqliteStmt::doStep()
 {
     const int res = sqlite3_step(m_stmt);
 
@@ -19,6 +19,13 @@ public:
         PreparePersistent = 0x01 // SQLITE_PREPARE_PERSISTENT
     };
 
+    enum StatusCounter {
+        StatusFullscanStep = 1, // SQLITE_STMTSTATUS_FULLSCAN_STEP
+        StatusSort = 2, // SQLITE_STMTSTATUS_SORT
+        StatusAutoindex = 3, // SQLITE_STMTSTATUS_AUTOINDEX
+        StatusVmStep = 4 // SQLITE_STMTSTATUS_VM_STEP
+    };
+
     enum StepResult {
         StepError = -1,
         StepRow = 100, // SQLITE_ROW
@@ -55,6 +62,18 @@ public:
 
     SqliteStmt::StepResult step();
 
+    // Collect the execution stats, when the statement is cached by the DB
+    SqliteDb *statDb() const { return m_statDb; }
+    void setStatDb(SqliteDb *v) { m_statDb = v; }
+
+    SqliteStmtStat stat() const;
+
+    // Snapshot of the stat for the readers of other threads, guarded by the stat DB
+    const SqliteStmtStat &publishedStat() const { return m_publishedStat; }
+    void setPublishedStat(const SqliteStmtStat &v) { m_publishedStat = v; }
+
+    int status(StatusCounter counter) const;
+
     int dataCount() const;
     int columnCount() const;
 
@@ -73,9 +92,17 @@ public:
     QVariant columnVar(int column = 0) const;
     bool columnIsNull(int column = 0) const;
 
+private:
+    SqliteStmt::StepResult stepStat();
+    SqliteStmt::StepResult doStep();
+
 private:
     sqlite3_stmt *m_stmt = nullptr;
 
+    SqliteDb *m_statDb = nullptr;
+    SqliteStmtStat m_stat;
+    SqliteStmtStat m_publishedStat;
+
     QHash<int, QVariant> m_bindObjects;
 };
 
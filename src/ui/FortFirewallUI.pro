@@ -160,13 +160,20 @@ SOURCES += \
     rpc/windowmanagerfake.cpp \
     stat/askpendingmanager.cpp \
     stat/deleteconnblockjob.cpp \
+    stat/deletestattrafjob.cpp \
     stat/logblockedipjob.cpp \
+    stat/logstattrafjob.cpp \
     stat/quotamanager.cpp \
+    stat/rollupstattrafjob.cpp \
+    stat/statbasejob.cpp \
     stat/statblockbasejob.cpp \
     stat/statblockmanager.cpp \
     stat/statblockworker.cpp \
+    stat/statfeed.cpp \
     stat/statmanager.cpp \
     stat/statsql.cpp \
+    stat/statworker.cpp \
+    stat/trafsegmentstore.cpp \
     task/taskdownloader.cpp \
     task/taskeditinfo.cpp \
     task/taskinfo.cpp \
@@ -177,6 +184,8 @@ SOURCES += \
     task/taskmanager.cpp \
     task/taskupdatechecker.cpp \
     task/taskworker.cpp \
+    task/taskzonecompilejob.cpp \
+    task/taskzonecompiler.cpp \
     task/taskzonedownloader.cpp \
     user/iniuser.cpp \
     user/usersettings.cpp \
@@ -185,6 +194,7 @@ SOURCES += \
     util/conf/appparseoptions.cpp \
     util/conf/confutil.cpp \
     util/conf/ruletextparser.cpp \
+    util/conf/zonefile.cpp \
     util/dateutil.cpp \
     util/device.cpp \
     util/dirinfo.cpp \
@@ -199,6 +209,8 @@ SOURCES += \
     util/model/ftstablesqlmodel.cpp \
     util/model/stringlistmodel.cpp \
     util/model/tableitemmodel.cpp \
+    util/model/tablesqljob.cpp \
+    util/model/tablesqlloader.cpp \
     util/model/tablesqlmodel.cpp \
     util/net/iprange.cpp \
     util/net/netdownloader.cpp \
@@ -381,13 +393,21 @@ HEADERS += \
     rpc/windowmanagerfake.h \
     stat/askpendingmanager.h \
     stat/deleteconnblockjob.h \
+    stat/deletestattrafjob.h \
     stat/logblockedipjob.h \
+    stat/logstattrafjob.h \
     stat/quotamanager.h \
+    stat/rollupstattrafjob.h \
+    stat/stat_types.h \
+    stat/statbasejob.h \
     stat/statblockbasejob.h \
     stat/statblockmanager.h \
     stat/statblockworker.h \
+    stat/statfeed.h \
     stat/statmanager.h \
     stat/statsql.h \
+    stat/statworker.h \
+    stat/trafsegmentstore.h \
     task/taskdownloader.h \
     task/taskeditinfo.h \
     task/taskinfo.h \
@@ -398,6 +418,8 @@ HEADERS += \
     task/taskmanager.h \
     task/taskupdatechecker.h \
     task/taskworker.h \
+    task/taskzonecompilejob.h \
+    task/taskzonecompiler.h \
     task/taskzonedownloader.h \
     user/iniuser.h \
     user/usersettings.h \
@@ -409,6 +431,7 @@ HEADERS += \
     util/conf/confruleswalker.h \
     util/conf/confutil.h \
     util/conf/ruletextparser.h \
+    util/conf/zonefile.h \
     util/dateutil.h \
     util/device.h \
     util/dirinfo.h \
@@ -424,6 +447,10 @@ HEADERS += \
     util/model/ftstablesqlmodel.h \
     util/model/stringlistmodel.h \
     util/model/tableitemmodel.h \
+    util/model/tablerowcache.h \
+    util/model/tablesqlblock.h \
+    util/model/tablesqljob.h \
+    util/model/tablesqlloader.h \
     util/model/tablesqlmodel.h \
     util/net/iprange.h \
     util/net/netdownloader.h \
@@ -465,6 +492,7 @@ RESOURCES += \
 OTHER_FILES += \
     appinfo/migrations/*.sql \
     conf/migrations/*.sql \
+    hostinfo/migrations/*.sql \
     stat/migrations/block/*.sql \
     stat/migrations/conn/*.sql \
     stat/migrations/traf/*.sql
@@ -472,6 +500,7 @@ OTHER_FILES += \
 RESOURCES += \
     appinfo/appinfo_migrations.qrc \
     conf/conf_migrations.qrc \
+    hostinfo/hostinfo_migrations.qrc \
     stat/stat_migrations.qrc
 
 # Zone
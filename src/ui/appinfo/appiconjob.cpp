@@ -4,8 +4,8 @@
 
 #include "appinfomanager.h"
 
-AppIconJob::AppIconJob(const QString &appPath, qint64 iconId) :
-    AppBaseJob(appPath), m_iconId(iconId)
+AppIconJob::AppIconJob(const QString &appPath, quint32 iconHash) :
+    AppBaseJob(appPath), m_iconHash(iconHash)
 {
 }
 
@@ -22,10 +22,10 @@ void AppIconJob::reportResult(WorkerObject &worker)
 void AppIconJob::loadAppIcon(AppInfoManager *manager)
 {
     // Try to load from DB
-    m_image = manager->loadIconFromDb(iconId());
+    m_image = manager->loadIconFromDb(iconHash());
 }
 
 void AppIconJob::emitFinished(AppInfoManager *manager)
 {
-    emit manager->lookupIconFinished(appPath(), m_image);
+    emit manager->lookupIconFinished(iconHash(), m_image);
 }
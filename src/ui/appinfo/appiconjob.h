@@ -10,9 +10,9 @@ class AppInfoManager;
 class AppIconJob : public AppBaseJob
 {
 public:
-    explicit AppIconJob(const QString &appPath, qint64 iconId);
+    explicit AppIconJob(const QString &appPath, quint32 iconHash);
 
-    qint64 iconId() const { return m_iconId; }
+    quint32 iconHash() const { return m_iconHash; }
 
     void doJob(WorkerObject &worker) override;
     void reportResult(WorkerObject &worker) override;
@@ -22,7 +22,7 @@ private:
     void emitFinished(AppInfoManager *manager);
 
 private:
-    const qint64 m_iconId = 0;
+    const quint32 m_iconHash = 0;
 
     QImage m_image;
 };
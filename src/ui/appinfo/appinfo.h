@@ -2,6 +2,7 @@
 #define APPINFO_H
 
 #include <QDateTime>
+#include <QImage>
 #include <QObject>
 
 class AppInfo
@@ -14,6 +15,7 @@ public:
 
 public:
     qint64 iconId = 0;
+    quint32 iconHash = 0; // of the icon's image, the icon ids are reused
 
     QDateTime fileModTime;
 
@@ -26,4 +28,18 @@ public:
 
 Q_DECLARE_METATYPE(AppInfo)
 
+struct AppInfoLookup
+{
+    bool loadedFromDb = false;
+    bool loadedFromFs = false;
+    bool missing = false; // not found, until its folder is modified
+
+    QString appPath;
+
+    AppInfo appInfo;
+    QImage appIcon;
+};
+
+using AppInfoLookupList = QList<AppInfoLookup>;
+
 #endif // APPINFO_H
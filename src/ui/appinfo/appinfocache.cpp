@@ -39,21 +39,24 @@ QString AppInfoCache::appName(const QString &appPath)
 
 QIcon AppInfoCache::appIcon(const QString &appPath, const QString &nullIconPath)
 {
-    QIcon icon;
-    if (IconCache::find(appPath, icon))
-        return icon;
-
-    const auto info = appInfo(appPath);
-    if (info.isValid()) {
-        IoC<AppInfoManager>()->lookupAppIcon(appPath, info.iconId);
+    const AppInfo *cachedInfo = m_cache.object(appPath);
+    const quint32 iconHash = cachedInfo ? cachedInfo->iconHash : appInfo(appPath).iconHash;
+
+    // The same icons of different apps are shared by the image's hash
+    if (iconHash != 0) {
+        QIcon icon;
+        if (IconCache::findImage(iconHash, icon)) {
+            if (!icon.isNull())
+                return icon;
+        } else if (!m_lookupIconHashes.contains(iconHash)) {
+            m_lookupIconHashes.insert(iconHash);
+
+            IoC<AppInfoManager>()->lookupAppIcon(appPath, iconHash);
+        }
     }
 
-    icon = IconCache::icon(
+    return IconCache::icon(
             !nullIconPath.isEmpty() ? nullIconPath : ":/icons/application-window-96.png");
-
-    IconCache::insert(appPath, icon);
-
-    return icon;
 }
 
 AppInfo AppInfoCache::appInfo(const QString &appPath)
@@ -85,19 +88,17 @@ void AppInfoCache::handleFinishedInfoLookup(const QString &appPath, const AppInf
 
     *appInfo = info;
 
-    IconCache::remove(appPath); // invalidate cached icon
-
     emitCacheChanged();
 }
 
-void AppInfoCache::handleFinishedIconLookup(const QString &appPath, const QImage &image)
+void AppInfoCache::handleFinishedIconLookup(quint32 iconHash, const QImage &image)
 {
-    if (image.isNull())
-        return;
+    m_lookupIconHashes.remove(iconHash);
 
-    const QPixmap pixmap = QPixmap::fromImage(image);
+    IconCache::insertImage(iconHash, image); // null image is cached too
 
-    IconCache::insert(appPath, pixmap); // update cached icon
+    if (image.isNull())
+        return;
 
     emitCacheChanged();
 }
@@ -3,6 +3,7 @@
 
 #include <QCache>
 #include <QObject>
+#include <QSet>
 
 #include <util/ioc/iocservice.h>
 #include <util/triggertimer.h>
@@ -30,7 +31,7 @@ signals:
 
 private slots:
     void handleFinishedInfoLookup(const QString &appPath, const AppInfo &info);
-    void handleFinishedIconLookup(const QString &appPath, const QImage &image);
+    void handleFinishedIconLookup(quint32 iconHash, const QImage &image);
 
 private:
     void appInfoCached(const QString &appPath, AppInfo &info, bool &lookupRequired);
@@ -40,6 +41,8 @@ private:
 private:
     QCache<QString, AppInfo> m_cache;
 
+    QSet<quint32> m_lookupIconHashes;
+
     TriggerTimer m_triggerTimer;
 };
 
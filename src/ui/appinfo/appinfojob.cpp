@@ -7,11 +7,14 @@
 #include "appinfo.h"
 #include "appinfomanager.h"
 
-AppInfoJob::AppInfoJob(const QString &appPath) : AppBaseJob(appPath) { }
+AppInfoJob::AppInfoJob()
+{
+    setPriority(PriorityHigh); // before the icons
+}
 
 void AppInfoJob::doJob(WorkerObject &worker)
 {
-    loadAppInfo(static_cast<AppInfoManager *>(worker.manager()));
+    loadAppInfos(static_cast<AppInfoManager *>(worker.manager()));
 }
 
 void AppInfoJob::reportResult(WorkerObject &worker)
@@ -19,26 +22,61 @@ void AppInfoJob::reportResult(WorkerObject &worker)
     emitFinished(static_cast<AppInfoManager *>(worker.manager()));
 }
 
-void AppInfoJob::loadAppInfo(AppInfoManager *manager)
+void AppInfoJob::loadAppInfos(AppInfoManager *manager)
 {
-    // Try to load from DB
-    bool loadedFromDb = manager->loadInfoFromDb(appPath(), m_appInfo);
+    // Paths are taken by batches, when the job starts
+    const QStringList appPaths = manager->takeLookupAppPaths();
 
-    // Was the file modified?
-    if (loadedFromDb && m_appInfo.isFileModified(appPath())) {
-        loadedFromDb = false;
-        manager->deleteAppInfo(appPath(), m_appInfo);
+    m_lookups.reserve(appPaths.size());
+
+    for (const QString &appPath : appPaths) {
+        m_lookups.append({ .appPath = appPath });
     }
 
-    // Try to load from FS
-    if (!loadedFromDb && manager->loadInfoFromFs(appPath(), m_appInfo)) {
-        const QImage appIcon = manager->loadIconFromFs(appPath(), m_appInfo);
+    // Try to load from DB
+    manager->loadInfosFromDb(m_lookups);
+
+    bool saveRequired = false;
+
+    for (auto &lookup : m_lookups) {
+        const QString &appPath = lookup.appPath;
+        AppInfo &appInfo = lookup.appInfo;
+
+        // Was the file modified?
+        if (lookup.loadedFromDb && appInfo.isFileModified(appPath)) {
+            lookup.loadedFromDb = false;
+            manager->deleteAppInfo(appPath, appInfo);
+        }
+
+        if (lookup.loadedFromDb || lookup.missing)
+            continue;
 
-        manager->saveToDb(appPath(), m_appInfo, appIcon);
+        // Try to load from FS
+        lookup.loadedFromFs = manager->loadInfoFromFs(appPath, appInfo);
+        if (lookup.loadedFromFs) {
+            lookup.appIcon = manager->loadIconFromFs(appPath, appInfo);
+        }
+
+        saveRequired = true;
+    }
+
+    if (saveRequired) {
+        manager->saveToDb(m_lookups);
     }
 }
 
 void AppInfoJob::emitFinished(AppInfoManager *manager)
 {
-    emit manager->lookupInfoFinished(appPath(), m_appInfo);
+    QStringList appPaths;
+    appPaths.reserve(m_lookups.size());
+
+    for (const auto &lookup : std::as_const(m_lookups)) {
+        appPaths.append(lookup.appPath);
+    }
+
+    manager->finishLookupAppPaths(appPaths);
+
+    for (const auto &lookup : std::as_const(m_lookups)) {
+        emit manager->lookupInfoFinished(lookup.appPath, lookup.appInfo);
+    }
 }
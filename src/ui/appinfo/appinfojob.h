@@ -1,25 +1,26 @@
 #ifndef APPINFOJOB_H
 #define APPINFOJOB_H
 
-#include "appbasejob.h"
+#include <util/worker/workerjob.h>
+
 #include "appinfo.h"
 
 class AppInfoManager;
 
-class AppInfoJob : public AppBaseJob
+class AppInfoJob : public WorkerJob
 {
 public:
-    explicit AppInfoJob(const QString &appPath);
+    explicit AppInfoJob();
 
     void doJob(WorkerObject &worker) override;
     void reportResult(WorkerObject &worker) override;
 
 private:
-    void loadAppInfo(AppInfoManager *manager);
+    void loadAppInfos(AppInfoManager *manager);
     void emitFinished(AppInfoManager *manager);
 
 private:
-    AppInfo m_appInfo;
+    AppInfoLookupList m_lookups;
 };
 
 #endif // APPINFOJOB_H
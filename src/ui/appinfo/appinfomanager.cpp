@@ -1,5 +1,6 @@
 #include "appinfomanager.h"
 
+#include <QFileInfo>
 #include <QImage>
 #include <QLoggingCategory>
 
@@ -16,19 +17,36 @@ namespace {
 
 const QLoggingCategory LC("appInfo");
 
-constexpr int DATABASE_USER_VERSION = 6;
+constexpr int DATABASE_USER_VERSION = 7;
 
 constexpr int APP_CACHE_MAX_COUNT = 2000;
+constexpr int APP_MISSING_MAX_COUNT = 10000;
+
+constexpr int APP_LOOKUP_BATCH_SIZE = 64;
 
 const char *const sqlSelectAppInfo = "SELECT alt_path, file_descr, company_name,"
-                                     "    product_name, product_ver, file_mod_time, icon_id"
+                                     "    product_name, product_ver, file_mod_time, icon_id,"
+                                     "    (SELECT hash FROM icon WHERE icon_id = app.icon_id)"
                                      "  FROM app WHERE path = ?1;";
 
 const char *const sqlUpdateAppAccessTime = "UPDATE app"
                                            "  SET access_time = datetime('now')"
                                            "  WHERE path = ?1;";
 
-const char *const sqlSelectIconImage = "SELECT image FROM icon WHERE icon_id = ?1;";
+const char *const sqlSelectAppMissing = "SELECT dir_mod_time FROM app_missing WHERE path = ?1;";
+
+const char *const sqlInsertAppMissing = "INSERT OR REPLACE INTO app_missing(path, dir_mod_time,"
+                                        "    access_time)"
+                                        "  VALUES(?1, ?2, datetime('now'));";
+
+const char *const sqlDeleteAppMissing = "DELETE FROM app_missing WHERE path = ?1;";
+
+const char *const sqlDeleteExcessAppMissings =
+        "DELETE FROM app_missing WHERE path IN ("
+        "  SELECT path FROM app_missing ORDER BY access_time"
+        "    LIMIT max(0, (SELECT count(*) FROM app_missing) - ?1));";
+
+const char *const sqlSelectIconImage = "SELECT image FROM icon WHERE hash = ?1 LIMIT 1;";
 
 const char *const sqlSelectIconIdByHash = "SELECT icon_id FROM icon WHERE hash = ?1;";
 
@@ -56,11 +74,19 @@ const char *const sqlDeleteIconIfNotUsed = "DELETE FROM icon"
 
 const char *const sqlDeleteApp = "DELETE FROM app WHERE path = ?1;";
 
+// The folder is modified, when its files are created or renamed
+QDateTime appDirModTime(const QString &appPath)
+{
+    return AppInfoUtil::fileModTime(QFileInfo(appPath).path());
+}
+
 }
 
 AppInfoManager::AppInfoManager(const QString &filePath, QObject *parent, quint32 openFlags) :
     WorkerManager(parent), m_sqliteDb(new SqliteDb(filePath, openFlags))
 {
+    m_sqliteDb->setTuneProfile(SqliteDb::TuneSmall);
+
     setMaxWorkersCount(1);
 }
 
@@ -76,12 +102,65 @@ WorkerObject *AppInfoManager::createWorker()
 
 void AppInfoManager::lookupAppInfo(const QString &appPath)
 {
-    enqueueJob(WorkerJobPtr(new AppInfoJob(appPath)));
+    {
+        QMutexLocker locker(&m_lookupMutex);
+
+        if (m_lookupAppPathSet.contains(appPath))
+            return; // already queued or in progress
+
+        m_lookupAppPathSet.insert(appPath);
+        m_lookupAppPaths.append(appPath);
+
+        if (m_lookupJobQueued)
+            return;
+
+        m_lookupJobQueued = true;
+    }
+
+    enqueueLookupJob();
 }
 
-void AppInfoManager::lookupAppIcon(const QString &appPath, qint64 iconId)
+void AppInfoManager::enqueueLookupJob()
 {
-    enqueueJob(WorkerJobPtr(new AppIconJob(appPath, iconId)));
+    enqueueJob(WorkerJobPtr(new AppInfoJob()));
+}
+
+QStringList AppInfoManager::takeLookupAppPaths()
+{
+    QStringList appPaths;
+
+    {
+        QMutexLocker locker(&m_lookupMutex);
+
+        // The latest paths are of the currently visible rows
+        const int count = qMin(m_lookupAppPaths.size(), APP_LOOKUP_BATCH_SIZE);
+        const int index = m_lookupAppPaths.size() - count;
+
+        appPaths = m_lookupAppPaths.mid(index);
+        m_lookupAppPaths.remove(index, count);
+
+        m_lookupJobQueued = !m_lookupAppPaths.isEmpty();
+        if (!m_lookupJobQueued)
+            return appPaths;
+    }
+
+    enqueueLookupJob();
+
+    return appPaths;
+}
+
+void AppInfoManager::finishLookupAppPaths(const QStringList &appPaths)
+{
+    QMutexLocker locker(&m_lookupMutex);
+
+    for (const QString &appPath : appPaths) {
+        m_lookupAppPathSet.remove(appPath);
+    }
+}
+
+void AppInfoManager::lookupAppIcon(const QString &appPath, quint32 iconHash)
+{
+    enqueueJob(WorkerJobPtr(new AppIconJob(appPath, iconHash)));
 }
 
 void AppInfoManager::checkLookupInfoFinished(const QString &appPath)
@@ -109,6 +188,28 @@ bool AppInfoManager::loadInfoFromDb(const QString &appPath, AppInfo &appInfo)
 
     QMutexLocker locker(&m_mutex);
 
+    return loadAppInfo(appPath, appInfo);
+}
+
+void AppInfoManager::loadInfosFromDb(AppInfoLookupList &lookups)
+{
+    QMutexLocker locker(&m_mutex);
+
+    sqliteDb()->beginWriteTransaction();
+
+    for (auto &lookup : lookups) {
+        lookup.loadedFromDb = loadAppInfo(lookup.appPath, lookup.appInfo);
+
+        if (!lookup.loadedFromDb) {
+            lookup.missing = isAppMissing(lookup.appPath);
+        }
+    }
+
+    sqliteDb()->endTransaction();
+}
+
+bool AppInfoManager::loadAppInfo(const QString &appPath, AppInfo &appInfo)
+{
     // Load version info
     SqliteStmt stmt;
     if (!stmt.prepare(sqliteDb()->db(), sqlSelectAppInfo))
@@ -126,6 +227,7 @@ bool AppInfoManager::loadInfoFromDb(const QString &appPath, AppInfo &appInfo)
     appInfo.productVersion = stmt.columnText(4);
     appInfo.fileModTime = stmt.columnDateTime(5);
     appInfo.iconId = stmt.columnInt64(6);
+    appInfo.iconHash = quint32(stmt.columnInt64(7));
 
     // Update last access time
     updateAppAccessTime(appPath);
@@ -138,6 +240,21 @@ void AppInfoManager::updateAppAccessTime(const QString &appPath)
     DbQuery(sqliteDb()).sql(sqlUpdateAppAccessTime).vars({ appPath }).executeOk();
 }
 
+bool AppInfoManager::isAppMissing(const QString &appPath)
+{
+    SqliteStmt stmt;
+    if (!stmt.prepare(sqliteDb()->db(), sqlSelectAppMissing))
+        return false;
+
+    stmt.bindText(1, appPath);
+
+    if (stmt.step() != SqliteStmt::StepRow)
+        return false;
+
+    // The drive's folder has no time, when the drive is not mounted
+    return stmt.columnDateTime(0) == appDirModTime(appPath);
+}
+
 bool AppInfoManager::setupDb()
 {
     if (!sqliteDb()->open()) {
@@ -161,10 +278,9 @@ bool AppInfoManager::setupDb()
     return true;
 }
 
-void AppInfoManager::saveAppIcon(const QImage &appIcon, QVariant &iconId, bool &ok)
+void AppInfoManager::saveAppIcon(
+        const QImage &appIcon, quint32 iconHash, QVariant &iconId, bool &ok)
 {
-    const uint iconHash = uint(qHashBits(appIcon.constBits(), size_t(appIcon.sizeInBytes())));
-
     iconId = DbQuery(sqliteDb()).sql(sqlSelectIconIdByHash).vars({ iconHash }).execute();
     if (iconId.isNull()) {
         DbQuery(sqliteDb(), &ok).sql(sqlInsertIcon).vars({ iconHash, appIcon }).executeOk();
@@ -196,6 +312,19 @@ void AppInfoManager::saveAppInfo(
     DbQuery(sqliteDb(), &ok).sql(sqlInsertAppInfo).vars(vars).executeOk();
 }
 
+void AppInfoManager::saveAppMissing(const QString &appPath, bool &ok)
+{
+    DbQuery(sqliteDb(), &ok)
+            .sql(sqlInsertAppMissing)
+            .vars({ appPath, appDirModTime(appPath) })
+            .executeOk();
+}
+
+void AppInfoManager::deleteAppMissing(const QString &appPath, bool &ok)
+{
+    DbQuery(sqliteDb(), &ok).sql(sqlDeleteAppMissing).vars({ appPath }).executeOk();
+}
+
 void AppInfoManager::deleteExcessAppInfos()
 {
     const int appCount = DbQuery(sqliteDb()).sql(sqlSelectAppCount).execute().toInt();
@@ -206,19 +335,25 @@ void AppInfoManager::deleteExcessAppInfos()
     }
 }
 
-QImage AppInfoManager::loadIconFromDb(qint64 iconId)
+void AppInfoManager::deleteExcessAppMissings()
 {
-    if (iconId == 0)
+    DbQuery(sqliteDb()).sql(sqlDeleteExcessAppMissings).vars({ APP_MISSING_MAX_COUNT }).executeOk();
+}
+
+QImage AppInfoManager::loadIconFromDb(quint32 iconHash)
+{
+    if (iconHash == 0)
         return {};
 
     QMutexLocker locker(&m_mutex);
 
-    const QVariant icon = DbQuery(sqliteDb()).sql(sqlSelectIconImage).vars({ iconId }).execute();
+    const QVariant icon =
+            DbQuery(sqliteDb()).sql(sqlSelectIconImage).vars({ iconHash }).execute();
 
     return icon.value<QImage>();
 }
 
-bool AppInfoManager::saveToDb(const QString &appPath, AppInfo &appInfo, const QImage &appIcon)
+bool AppInfoManager::saveToDb(AppInfoLookupList &lookups)
 {
     QMutexLocker locker(&m_mutex);
 
@@ -226,22 +361,47 @@ bool AppInfoManager::saveToDb(const QString &appPath, AppInfo &appInfo, const QI
 
     sqliteDb()->beginWriteTransaction();
 
-    // Save icon image
-    QVariant iconId;
-    saveAppIcon(appIcon, iconId, ok);
+    for (auto &lookup : lookups) {
+        if (lookup.loadedFromFs) {
+            // Save icon image
+            const quint32 iconHash = quint32(
+                    qHashBits(lookup.appIcon.constBits(), size_t(lookup.appIcon.sizeInBytes())));
 
-    // Save version info
-    if (ok) {
-        saveAppInfo(appPath, appInfo, iconId, ok);
+            QVariant iconId;
+            saveAppIcon(lookup.appIcon, iconHash, iconId, ok);
+
+            // Save version info
+            if (ok) {
+                saveAppInfo(lookup.appPath, lookup.appInfo, iconId, ok);
+            }
+
+            if (ok) {
+                lookup.appInfo.iconId = iconId.toLongLong();
+                lookup.appInfo.iconHash = iconHash;
+
+                deleteAppMissing(lookup.appPath, ok);
+            }
+        } else if (!lookup.loadedFromDb && !lookup.missing) {
+            saveAppMissing(lookup.appPath, ok);
+        }
+
+        if (!ok)
+            break;
     }
 
     sqliteDb()->endTransaction(ok);
 
     if (ok) {
-        appInfo.iconId = iconId.toLongLong();
-
         // Delete excess info
         deleteExcessAppInfos();
+        deleteExcessAppMissings();
+    } else {
+        for (auto &lookup : lookups) {
+            if (lookup.loadedFromFs) {
+                lookup.appInfo.iconId = 0;
+                lookup.appInfo.iconHash = 0;
+            }
+        }
     }
 
     return ok;
@@ -2,6 +2,7 @@
 #define APPINFOMANAGER_H
 
 #include <QMutex>
+#include <QSet>
 
 #include <sqlite/sqlite_types.h>
 
@@ -28,20 +29,24 @@ public:
     QImage loadIconFromFs(const QString &appPath, const AppInfo &appInfo);
 
     bool loadInfoFromDb(const QString &appPath, AppInfo &appInfo);
-    QImage loadIconFromDb(qint64 iconId);
+    void loadInfosFromDb(AppInfoLookupList &lookups);
+    QImage loadIconFromDb(quint32 iconHash);
 
-    bool saveToDb(const QString &appPath, AppInfo &appInfo, const QImage &appIcon);
+    bool saveToDb(AppInfoLookupList &lookups);
+
+    QStringList takeLookupAppPaths();
+    void finishLookupAppPaths(const QStringList &appPaths);
 
     void deleteAppInfo(const QString &appPath, const AppInfo &appInfo);
     void deleteOldApps(int limitCount = 0);
 
 signals:
     void lookupInfoFinished(const QString &appPath, const AppInfo &appInfo);
-    void lookupIconFinished(const QString &appPath, const QImage &image);
+    void lookupIconFinished(quint32 iconHash, const QImage &image);
 
 public slots:
     virtual void lookupAppInfo(const QString &appPath);
-    void lookupAppIcon(const QString &appPath, qint64 iconId);
+    void lookupAppIcon(const QString &appPath, quint32 iconHash);
 
     void checkLookupInfoFinished(const QString &appPath);
 
@@ -53,11 +58,19 @@ protected:
 private:
     bool setupDb();
 
-    void saveAppIcon(const QImage &appIcon, QVariant &iconId, bool &ok);
+    void enqueueLookupJob();
+
+    bool loadAppInfo(const QString &appPath, AppInfo &appInfo);
+    bool isAppMissing(const QString &appPath);
+
+    void saveAppIcon(const QImage &appIcon, quint32 iconHash, QVariant &iconId, bool &ok);
     void saveAppInfo(
             const QString &appPath, const AppInfo &appInfo, const QVariant &iconId, bool &ok);
+    void saveAppMissing(const QString &appPath, bool &ok);
+    void deleteAppMissing(const QString &appPath, bool &ok);
 
     void deleteExcessAppInfos();
+    void deleteExcessAppMissings();
 
     void getOldAppsAndIcons(
             QStringList &appPaths, QHash<qint64, int> &iconIds, int limitCount) const;
@@ -70,8 +83,15 @@ private:
     void deleteApp(const QString &appPath, bool &ok);
 
 private:
+    bool m_lookupJobQueued = false;
+
     SqliteDbPtr m_sqliteDb;
     QMutex m_mutex;
+
+    // Queued and in progress lookups
+    QStringList m_lookupAppPaths;
+    QSet<QString> m_lookupAppPathSet;
+    QMutex m_lookupMutex;
 };
 
 #endif // APPINFOMANAGER_H
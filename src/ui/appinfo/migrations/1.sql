@@ -12,6 +12,14 @@ CREATE TABLE app(
 
 CREATE INDEX app_access_time_idx ON app(access_time);
 
+CREATE TABLE app_missing(
+  path TEXT PRIMARY KEY,
+  dir_mod_time INTEGER,
+  access_time DATETIME
+) WITHOUT ROWID;
+
+CREATE INDEX app_missing_access_time_idx ON app_missing(access_time);
+
 CREATE TABLE icon(
   icon_id INTEGER PRIMARY KEY,
   ref_count INTEGER NOT NULL,
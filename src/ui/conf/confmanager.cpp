@@ -34,7 +34,7 @@ namespace {
 
 const QLoggingCategory LC("conf");
 
-constexpr int DATABASE_USER_VERSION = 41;
+constexpr int DATABASE_USER_VERSION = 42;
 
 const char *const sqlSelectAddressGroups = "SELECT addr_group_id, include_all, exclude_all,"
                                            "    include_zones, exclude_zones,"
@@ -428,6 +428,7 @@ bool importFile(const QString &filePath, const QString &path)
 ConfManager::ConfManager(const QString &filePath, QObject *parent, quint32 openFlags) :
     QObject(parent), m_sqliteDb(new SqliteDb(filePath, openFlags)), m_conf(createConf())
 {
+    m_sqliteDb->setTuneProfile(SqliteDb::TuneSmall);
 }
 
 IniUser &ConfManager::iniUser() const
@@ -56,8 +56,8 @@ const char *const sqlUpdateZoneEnabled = "UPDATE zone SET enabled = ?2 WHERE zon
 
 const char *const sqlUpdateZoneResult =
         "UPDATE zone"
-        "  SET address_count = ?2, text_checksum = ?3, bin_checksum = ?4,"
-        "    source_modtime = ?5, last_run = ?6, last_success = ?7"
+        "  SET address_count = ?2, range_count = ?3, text_checksum = ?4, bin_checksum = ?5,"
+        "    source_modtime = ?6, last_run = ?7, last_success = ?8"
         "  WHERE zone_id = ?1;";
 
 bool driverWriteZones(ConfUtil &confUtil, bool onlyFlags = false)
@@ -218,6 +218,7 @@ bool ConfZoneManager::updateZoneResult(const Zone &zone)
     const QVariantList vars = {
         zone.zoneId,
         zone.addressCount,
+        zone.rangeCount,
         zone.textChecksum,
         zone.binChecksum,
         zone.sourceModTime,
@@ -237,13 +238,25 @@ bool ConfZoneManager::updateZoneResult(const Zone &zone)
 }
 
 void ConfZoneManager::updateDriverZones(quint32 zonesMask, quint32 enabledMask, quint32 dataSize,
-        const QList<QByteArray> &zonesData)
+        const QList<QByteArray> &zonesData, const QList<QByteArray> &zoneDeltas)
 {
+    // Try to patch the driver's zones, when they are the last successfully written ones
+    if (!zoneDeltas.isEmpty() && m_driverZonesMask == zonesMask
+            && updateDriverZoneDeltas(zoneDeltas))
+        return;
+
     ConfUtil confUtil;
 
     confUtil.writeZones(zonesMask, enabledMask, dataSize, zonesData);
 
-    driverWriteZones(confUtil);
+    const bool ok = driverWriteZones(confUtil);
+
+    m_driverZonesMask = ok ? zonesMask : 0;
+
+    if (ok) {
+        ++m_driverZonesCount;
+        m_driverZonesSize += confUtil.buffer().size();
+    }
 }
 
 bool ConfZoneManager::updateDriverZoneFlag(int zoneId, bool enabled)
@@ -255,6 +268,27 @@ bool ConfZoneManager::updateDriverZoneFlag(int zoneId, bool enabled)
     return driverWriteZones(confUtil, /*onlyFlags=*/true);
 }
 
+bool ConfZoneManager::updateDriverZoneDeltas(const QList<QByteArray> &zoneDeltas)
+{
+    auto driverManager = IoC<DriverManager>();
+
+    for (auto zoneDelta : zoneDeltas) {
+        if (!driverManager->writeZoneDelta(zoneDelta)) {
+            qCDebug(LC) << "Update driver zone delta error:" << driverManager->errorMessage();
+            return false;
+        }
+
+        ++m_driverZoneDeltasCount;
+        m_driverZoneDeltasSize += zoneDelta.size();
+    }
+
+    qCDebug(LC) << "Driver zone deltas:" << m_driverZoneDeltasCount
+                << "size:" << m_driverZoneDeltasSize << "full zones:" << m_driverZonesCount
+                << "size:" << m_driverZonesSize;
+
+    return true;
+}
+
 bool ConfZoneManager::beginTransaction()
 {
     return sqliteDb()->beginWriteTransaction();
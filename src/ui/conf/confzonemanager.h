@@ -31,7 +31,13 @@ public:
     bool updateZoneResult(const Zone &zone);
 
     void updateDriverZones(quint32 zonesMask, quint32 enabledMask, quint32 dataSize,
-            const QList<QByteArray> &zonesData);
+            const QList<QByteArray> &zonesData, const QList<QByteArray> &zoneDeltas = {});
+
+    // Counters of the zones written to the driver: full buffers vs deltas
+    qint64 driverZonesCount() const { return m_driverZonesCount; }
+    qint64 driverZonesSize() const { return m_driverZonesSize; }
+    qint64 driverZoneDeltasCount() const { return m_driverZoneDeltasCount; }
+    qint64 driverZoneDeltasSize() const { return m_driverZoneDeltasSize; }
 
 signals:
     void zoneAdded();
@@ -40,11 +46,19 @@ signals:
 
 private:
     bool updateDriverZoneFlag(int zoneId, bool enabled);
+    bool updateDriverZoneDeltas(const QList<QByteArray> &zoneDeltas);
 
     bool beginTransaction();
     void commitTransaction(bool &ok);
 
 private:
+    quint32 m_driverZonesMask = 0; // of the last zones written to the driver
+
+    qint64 m_driverZonesCount = 0;
+    qint64 m_driverZonesSize = 0;
+    qint64 m_driverZoneDeltasCount = 0;
+    qint64 m_driverZoneDeltasSize = 0;
+
     ConfManager *m_confManager = nullptr;
 };
 
@@ -7,6 +7,7 @@ CREATE TABLE zone(
   url TEXT,
   form_data TEXT,
   address_count INTEGER,
+  range_count INTEGER,
   text_inline TEXT,
   text_checksum TEXT,
   bin_checksum TEXT,
@@ -17,6 +17,7 @@ public:
     int zoneId = 0;
 
     int addressCount = 0;
+    int rangeCount = 0;
 
     QString zoneName;
     QString sourceCode;
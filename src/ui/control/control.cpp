@@ -17,6 +17,8 @@ static const QHash<Command, const char *> g_commandNames = {
     CASE_STRING(Rpc_Result_Error),
 
     CASE_STRING(Rpc_RpcManager_initClient),
+    CASE_STRING(Rpc_RpcManager_getDbStats),
+    CASE_STRING(Rpc_RpcManager_subscribe),
 
     CASE_STRING(Rpc_AppInfoManager_lookupAppInfo),
     CASE_STRING(Rpc_AppInfoManager_checkLookupInfoFinished),
@@ -124,6 +126,8 @@ static const RpcManager g_commandManagers[] = {
     Rpc_NoneManager, // Rpc_Result_Error,
 
     Rpc_NoneManager, // Rpc_RpcManager_initClient,
+    Rpc_NoneManager, // Rpc_RpcManager_getDbStats,
+    Rpc_NoneManager, // Rpc_RpcManager_subscribe,
 
     Rpc_AppInfoManager, // Rpc_AppInfoManager_lookupAppInfo,
     Rpc_AppInfoManager, // Rpc_AppInfoManager_checkLookupFinished,
@@ -211,6 +215,8 @@ static const qint8 g_commandValidations[] = {
     0, // Rpc_Result_Error,
 
     0, // Rpc_RpcManager_initClient,
+    true, // Rpc_RpcManager_getDbStats,
+    0, // Rpc_RpcManager_subscribe,
 
     true, // Rpc_AppInfoManager_lookupAppInfo,
     0, // Rpc_AppInfoManager_checkLookupFinished,
@@ -284,6 +290,184 @@ bool commandRequiresValidation(Command cmd)
     return g_commandValidations[cmd];
 }
 
+static const CommandLayout g_commandLayouts[] = {
+    {}, // CommandNone = 0,
+
+    {}, // CommandHome,
+    {}, // CommandProg,
+    {}, // CommandZone,
+
+    { .compress = true }, // Rpc_Result_Ok,
+    {}, // Rpc_Result_Error,
+
+    {}, // Rpc_RpcManager_initClient,
+    {}, // Rpc_RpcManager_getDbStats,
+    { .argTypes = "u" }, // Rpc_RpcManager_subscribe,
+
+    { .argTypes = "s" }, // Rpc_AppInfoManager_lookupAppInfo,
+    { .argTypes = "s" }, // Rpc_AppInfoManager_checkLookupInfoFinished,
+
+    {}, // Rpc_AutoUpdateManager_startDownload,
+    {}, // Rpc_AutoUpdateManager_runInstaller,
+    {}, // Rpc_AutoUpdateManager_updateState,
+    {}, // Rpc_AutoUpdateManager_restartClients,
+
+    { .compress = true }, // Rpc_ConfManager_saveVariant,
+    {}, // Rpc_ConfManager_exportMasterBackup,
+    {}, // Rpc_ConfManager_importMasterBackup,
+    {}, // Rpc_ConfManager_checkPassword,
+    { .compress = true }, // Rpc_ConfManager_confChanged,
+
+    {}, // Rpc_ConfAppManager_addOrUpdateAppPath,
+    {}, // Rpc_ConfAppManager_deleteAppPath,
+    { .compress = true }, // Rpc_ConfAppManager_addOrUpdateApp,
+    {}, // Rpc_ConfAppManager_updateApp,
+    {}, // Rpc_ConfAppManager_updateAppName,
+    { .compress = true }, // Rpc_ConfAppManager_deleteApps,
+    {}, // Rpc_ConfAppManager_purgeApps,
+    { .compress = true }, // Rpc_ConfAppManager_updateAppsBlocked,
+    {}, // Rpc_ConfAppManager_appEndTimesUpdated,
+    {}, // Rpc_ConfAppManager_appAlerted,
+    {}, // Rpc_ConfAppManager_appsChanged,
+    {}, // Rpc_ConfAppManager_appUpdated,
+
+    { .compress = true }, // Rpc_ConfRuleManager_addOrUpdateRule,
+    {}, // Rpc_ConfRuleManager_deleteRule,
+    {}, // Rpc_ConfRuleManager_updateRuleName,
+    {}, // Rpc_ConfRuleManager_updateRuleEnabled,
+    {}, // Rpc_ConfRuleManager_ruleAdded,
+    { .argTypes = "i" }, // Rpc_ConfRuleManager_ruleRemoved,
+    {}, // Rpc_ConfRuleManager_ruleUpdated,
+
+    { .compress = true }, // Rpc_ConfZoneManager_addOrUpdateZone,
+    {}, // Rpc_ConfZoneManager_deleteZone,
+    {}, // Rpc_ConfZoneManager_updateZoneName,
+    {}, // Rpc_ConfZoneManager_updateZoneEnabled,
+    {}, // Rpc_ConfZoneManager_zoneAdded,
+    { .argTypes = "i" }, // Rpc_ConfZoneManager_zoneRemoved,
+    {}, // Rpc_ConfZoneManager_zoneUpdated,
+
+    { .argTypes = "ub" }, // Rpc_DriverManager_updateState,
+
+    { .argTypes = "i" }, // Rpc_QuotaManager_alert,
+
+    {}, // Rpc_StatManager_deleteStatApp,
+    {}, // Rpc_StatManager_resetAppTrafTotals,
+    {}, // Rpc_StatManager_clearTraffic,
+    {}, // Rpc_StatManager_trafficCleared,
+    { .argTypes = "q" }, // Rpc_StatManager_appStatRemoved,
+    { .argTypes = "qs" }, // Rpc_StatManager_appCreated,
+    { .argTypes = "quu" }, // Rpc_StatManager_trafficAdded,
+    {}, // Rpc_StatManager_appTrafTotalsResetted,
+
+    {}, // Rpc_StatBlockManager_deleteConn,
+    {}, // Rpc_StatBlockManager_connChanged,
+
+    { .argTypes = "s" }, // Rpc_ServiceInfoManager_trackService,
+    { .argTypes = "s" }, // Rpc_ServiceInfoManager_revertService,
+
+    { .argTypes = "i" }, // Rpc_TaskManager_runTask,
+    { .argTypes = "i" }, // Rpc_TaskManager_abortTask,
+    { .argTypes = "i" }, // Rpc_TaskManager_taskStarted,
+    { .argTypes = "i" }, // Rpc_TaskManager_taskFinished,
+    {}, // Rpc_TaskManager_appVersionDownloaded,
+    { .compress = true }, // Rpc_TaskManager_zonesDownloaded,
+};
+
+const CommandLayout &commandLayout(Command cmd)
+{
+    return g_commandLayouts[cmd];
+}
+
+static const CommandNotify g_commandNotifies[] = {
+    {}, // CommandNone = 0,
+
+    {}, // CommandHome,
+    {}, // CommandProg,
+    {}, // CommandZone,
+
+    {}, // Rpc_Result_Ok,
+    {}, // Rpc_Result_Error,
+
+    {}, // Rpc_RpcManager_initClient,
+    {}, // Rpc_RpcManager_getDbStats,
+    {}, // Rpc_RpcManager_subscribe,
+
+    {}, // Rpc_AppInfoManager_lookupAppInfo,
+    {}, // Rpc_AppInfoManager_checkLookupInfoFinished,
+
+    {}, // Rpc_AutoUpdateManager_startDownload,
+    {}, // Rpc_AutoUpdateManager_runInstaller,
+    { .mode = NotifyLatest }, // Rpc_AutoUpdateManager_updateState,
+    {}, // Rpc_AutoUpdateManager_restartClients,
+
+    {}, // Rpc_ConfManager_saveVariant,
+    {}, // Rpc_ConfManager_exportMasterBackup,
+    {}, // Rpc_ConfManager_importMasterBackup,
+    {}, // Rpc_ConfManager_checkPassword,
+    {}, // Rpc_ConfManager_confChanged,
+
+    {}, // Rpc_ConfAppManager_addOrUpdateAppPath,
+    {}, // Rpc_ConfAppManager_deleteAppPath,
+    {}, // Rpc_ConfAppManager_addOrUpdateApp,
+    {}, // Rpc_ConfAppManager_updateApp,
+    {}, // Rpc_ConfAppManager_updateAppName,
+    {}, // Rpc_ConfAppManager_deleteApps,
+    {}, // Rpc_ConfAppManager_purgeApps,
+    {}, // Rpc_ConfAppManager_updateAppsBlocked,
+    {}, // Rpc_ConfAppManager_appEndTimesUpdated,
+    { .mode = NotifyLatest }, // Rpc_ConfAppManager_appAlerted,
+    { .mode = NotifyLatest }, // Rpc_ConfAppManager_appsChanged,
+    { .mode = NotifyLatest }, // Rpc_ConfAppManager_appUpdated,
+
+    {}, // Rpc_ConfRuleManager_addOrUpdateRule,
+    {}, // Rpc_ConfRuleManager_deleteRule,
+    {}, // Rpc_ConfRuleManager_updateRuleName,
+    {}, // Rpc_ConfRuleManager_updateRuleEnabled,
+    { .mode = NotifyLatest }, // Rpc_ConfRuleManager_ruleAdded,
+    {}, // Rpc_ConfRuleManager_ruleRemoved,
+    { .mode = NotifyLatest }, // Rpc_ConfRuleManager_ruleUpdated,
+
+    {}, // Rpc_ConfZoneManager_addOrUpdateZone,
+    {}, // Rpc_ConfZoneManager_deleteZone,
+    {}, // Rpc_ConfZoneManager_updateZoneName,
+    {}, // Rpc_ConfZoneManager_updateZoneEnabled,
+    { .mode = NotifyLatest }, // Rpc_ConfZoneManager_zoneAdded,
+    {}, // Rpc_ConfZoneManager_zoneRemoved,
+    { .mode = NotifyLatest }, // Rpc_ConfZoneManager_zoneUpdated,
+
+    { .mode = NotifyLatest }, // Rpc_DriverManager_updateState,
+
+    {}, // Rpc_QuotaManager_alert,
+
+    {}, // Rpc_StatManager_deleteStatApp,
+    {}, // Rpc_StatManager_resetAppTrafTotals,
+    {}, // Rpc_StatManager_clearTraffic,
+    {}, // Rpc_StatManager_trafficCleared,
+    {}, // Rpc_StatManager_appStatRemoved,
+    {}, // Rpc_StatManager_appCreated,
+    { .mode = NotifySum, .topic = Rpc_TrafficTopic }, // Rpc_StatManager_trafficAdded,
+    {}, // Rpc_StatManager_appTrafTotalsResetted,
+
+    {}, // Rpc_StatBlockManager_deleteConn,
+    { .mode = NotifyLatest, .topic = Rpc_ConnTopic }, // Rpc_StatBlockManager_connChanged,
+
+    {}, // Rpc_ServiceInfoManager_trackService,
+    {}, // Rpc_ServiceInfoManager_revertService,
+
+    {}, // Rpc_TaskManager_runTask,
+    {}, // Rpc_TaskManager_abortTask,
+    {}, // Rpc_TaskManager_taskStarted,
+    {}, // Rpc_TaskManager_taskFinished,
+    {}, // Rpc_TaskManager_appVersionDownloaded,
+    {}, // Rpc_TaskManager_zonesDownloaded,
+};
+
+const CommandNotify &commandNotify(Command cmd)
+{
+    return g_commandNotifies[cmd];
+}
+
 QDebug operator<<(QDebug debug, Command cmd)
 {
     debug << commandString(cmd);
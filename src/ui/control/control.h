@@ -11,6 +11,10 @@ RpcManager managerByCommand(Command cmd);
 
 bool commandRequiresValidation(Command cmd);
 
+const CommandLayout &commandLayout(Command cmd);
+
+const CommandNotify &commandNotify(Command cmd);
+
 QDebug operator<<(QDebug debug, Command cmd);
 QDebug operator<<(QDebug debug, RpcManager rpcManager);
 
@@ -19,6 +19,8 @@ enum Command : qint8 {
     Rpc_Result_Error,
 
     Rpc_RpcManager_initClient,
+    Rpc_RpcManager_getDbStats,
+    Rpc_RpcManager_subscribe,
 
     Rpc_AppInfoManager_lookupAppInfo,
     Rpc_AppInfoManager_checkLookupInfoFinished,
@@ -90,6 +92,38 @@ enum Command : qint8 {
     Rpc_TaskManager_zonesDownloaded,
 };
 
+struct CommandLayout
+{
+    // Fixed layout of the hot commands' arguments, instead of the QDataStream encoding:
+    // 'b' - bool, 'i' - qint32, 'u' - quint32, 'q' - qint64, 's' - QString
+    const char *argTypes = nullptr;
+
+    // Compress the big arguments
+    bool compress = false;
+};
+
+enum NotifyMode : qint8 {
+    NotifyDirect = 0, // Send at once
+    NotifyLatest, // Send the latest pending one only
+    NotifySum, // Sum the pending ones' arguments with the same first (key) argument
+};
+
+enum RpcTopic : quint8 {
+    Rpc_NoneTopic = 0, // Sent to all clients
+    Rpc_TrafficTopic = (1 << 0),
+    Rpc_ConnTopic = (1 << 1),
+    Rpc_AllTopics = (Rpc_TrafficTopic | Rpc_ConnTopic),
+};
+
+struct CommandNotify
+{
+    // How the service's notifications are coalesced before sending to clients
+    NotifyMode mode = NotifyDirect;
+
+    // Sent only to the clients subscribed to the topic
+    RpcTopic topic = Rpc_NoneTopic;
+};
+
 enum RpcManager : qint8 {
     Rpc_NoneManager = 0,
     Rpc_AppInfoManager,
@@ -11,7 +11,9 @@ const QLoggingCategory LC("controlWorker");
 
 constexpr int commandMaxArgs = 32;
 constexpr int commandArgMaxSize = 4 * 1024;
+constexpr int compressMinSize = 128;
 constexpr quint32 dataMaxSize = 1 * 1024 * 1024;
+constexpr int bufferKeepMaxSize = 64 * 1024;
 
 quint32 nextWorkerId()
 {
@@ -19,8 +21,127 @@ quint32 nextWorkerId()
     return ++g_workerId;
 }
 
-bool buildArgsData(QByteArray &buffer, const QVariantList &args, bool &compressed)
+template<typename T>
+void appendValue(QByteArray &buffer, T v)
 {
+    buffer.append((const char *) &v, sizeof(T));
+}
+
+template<typename T>
+bool readValue(const char *&p, const char *end, T &v)
+{
+    if (end - p < qsizetype(sizeof(T)))
+        return false;
+
+    memcpy(&v, p, sizeof(T));
+    p += sizeof(T);
+
+    return true;
+}
+
+bool buildFixedArgsData(QByteArray &buffer, const char *argTypes, const QVariantList &args)
+{
+    if (args.count() != qsizetype(strlen(argTypes))) {
+        qCWarning(LC) << "Bad build args count:" << args.count() << argTypes;
+        return false;
+    }
+
+    auto argIt = args.constBegin();
+
+    for (const char *argType = argTypes; *argType != '\0'; ++argType, ++argIt) {
+        const QVariant &arg = *argIt;
+
+        switch (*argType) {
+        case 'b': {
+            appendValue<quint8>(buffer, arg.toBool());
+        } break;
+        case 'i': {
+            appendValue<qint32>(buffer, arg.toInt());
+        } break;
+        case 'u': {
+            appendValue<quint32>(buffer, arg.toUInt());
+        } break;
+        case 'q': {
+            appendValue<qint64>(buffer, arg.toLongLong());
+        } break;
+        case 's': {
+            const QString text = arg.toString();
+            if (text.size() > commandArgMaxSize) {
+                qCWarning(LC) << "Bad build arg size:" << text.size();
+                return false;
+            }
+
+            appendValue<quint32>(buffer, text.size());
+            buffer.append((const char *) text.constData(), text.size() * sizeof(QChar));
+        } break;
+        default:
+            Q_UNREACHABLE();
+        }
+    }
+
+    return true;
+}
+
+bool parseFixedArgsData(const QByteArray &buffer, const char *argTypes, QVariantList &args)
+{
+    const char *p = buffer.constData();
+    const char *end = p + buffer.size();
+
+    args.reserve(strlen(argTypes));
+
+    for (const char *argType = argTypes; *argType != '\0'; ++argType) {
+        bool ok = false;
+
+        switch (*argType) {
+        case 'b': {
+            quint8 v;
+            if ((ok = readValue(p, end, v))) {
+                args.append(bool(v));
+            }
+        } break;
+        case 'i': {
+            qint32 v;
+            if ((ok = readValue(p, end, v))) {
+                args.append(v);
+            }
+        } break;
+        case 'u': {
+            quint32 v;
+            if ((ok = readValue(p, end, v))) {
+                args.append(v);
+            }
+        } break;
+        case 'q': {
+            qint64 v;
+            if ((ok = readValue(p, end, v))) {
+                args.append(v);
+            }
+        } break;
+        case 's': {
+            quint32 size;
+            if ((ok = readValue(p, end, size) && size <= quint32(end - p) / sizeof(QChar))) {
+                args.append(QString((const QChar *) p, size));
+                p += size * sizeof(QChar);
+            }
+        } break;
+        }
+
+        if (!ok) {
+            qCWarning(LC) << "Bad parse args:" << argTypes;
+            return false;
+        }
+    }
+
+    return p == end;
+}
+
+bool buildArgsData(
+        QByteArray &buffer, const QVariantList &args, Control::Command command, bool &compressed)
+{
+    const auto &layout = Control::commandLayout(command);
+    if (layout.argTypes)
+        return buildFixedArgsData(buffer, layout.argTypes, args);
+
     const int argsCount = args.count();
     if (argsCount == 0)
         return true;
@@ -41,14 +162,19 @@ bool buildArgsData(QByteArray &buffer, const QVariantList &args, bool &compresse
         }
     }
 
-    compressed = (data.size() > 128);
+    compressed = layout.compress && (data.size() > compressMinSize);
     buffer = compressed ? qCompress(data) : std::move(data);
 
     return true;
 }
 
-bool parseArgsData(const QByteArray &buffer, QVariantList &args, bool compressed)
+bool parseArgsData(
+        const QByteArray &buffer, QVariantList &args, Control::Command command, bool compressed)
 {
+    const auto &layout = Control::commandLayout(command);
+    if (layout.argTypes)
+        return parseFixedArgsData(buffer, layout.argTypes, args);
+
     if (buffer.isEmpty())
         return true;
 
@@ -205,7 +331,7 @@ QByteArray ControlWorker::buildCommandData(Control::Command command, const QVari
 {
     QByteArray data;
     bool compressed = false;
-    if (!buildArgsData(data, args, compressed))
+    if (!buildArgsData(data, args, command, compressed))
         return {};
 
     RequestHeader request(command, compressed, data.size());
@@ -281,7 +407,13 @@ void ControlWorker::processRequest()
 void ControlWorker::clearRequest()
 {
     m_requestHeader.clear();
-    m_requestBuffer.clear();
+
+    // Keep the small buffer's memory for the next requests
+    if (m_requestBuffer.capacity() > bufferKeepMaxSize) {
+        m_requestBuffer.clear();
+    } else {
+        m_requestBuffer.resize(0);
+    }
 }
 
 bool ControlWorker::readRequest()
@@ -294,24 +426,28 @@ bool ControlWorker::readRequest()
         if (socket()->bytesAvailable() == 0)
             return true; // need more data
 
-        const QByteArray data = socket()->read(bytesNeeded);
-        if (data.isEmpty()) {
+        // Read into the buffer's memory directly
+        const int bufferSize = m_requestBuffer.size();
+        m_requestBuffer.resize(bufferSize + bytesNeeded);
+
+        const qint64 bytesRead = socket()->read(m_requestBuffer.data() + bufferSize, bytesNeeded);
+        if (bytesRead <= 0) {
             qCWarning(LC) << "Bad request: empty";
             return false;
         }
 
-        m_requestBuffer += data;
+        m_requestBuffer.resize(bufferSize + bytesRead);
 
-        if (data.size() < bytesNeeded)
+        if (bytesRead < bytesNeeded)
             return true; // need more data
     }
 
+    const Control::Command command = m_requestHeader.command();
+
     QVariantList args;
-    if (!parseArgsData(m_requestBuffer, args, m_requestHeader.compressed()))
+    if (!parseArgsData(m_requestBuffer, args, command, m_requestHeader.compressed()))
         return false;
 
-    const Control::Command command = m_requestHeader.command();
-
     clearRequest();
 
     // DBG: qCDebug(LC) << "requestReady>" << id() << command << args;
@@ -25,6 +25,9 @@ public:
     bool isTryReconnect() const { return m_isTryReconnect; }
     void setIsTryReconnect(bool v) { m_isTryReconnect = v; }
 
+    quint8 topics() const { return m_topics; }
+    void setTopics(quint8 v) { m_topics = v; }
+
     quint32 id() const { return m_id; }
 
     QString serverName() const { return m_serverName; }
@@ -105,6 +108,8 @@ private:
     bool m_isTryReconnect : 1 = false;
     bool m_isReconnecting : 1 = false;
 
+    quint8 m_topics = Control::Rpc_AllTopics;
+
     QAtomicInt m_processing = 0;
 
     const quint32 m_id = 0;
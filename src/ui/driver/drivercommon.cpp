@@ -57,6 +57,11 @@ quint32 ioctlSetZoneFlag()
     return FORT_IOCTL_SETZONEFLAG;
 }
 
+quint32 ioctlSetZoneDelta()
+{
+    return FORT_IOCTL_SETZONEDELTA;
+}
+
 quint32 userErrorCode()
 {
     return FORT_ERROR_USER_ERROR;
@@ -190,6 +195,16 @@ void confAppPermsMaskInit(void *drvConf)
     fort_conf_app_perms_mask_init(conf, conf->flags.group_bits);
 }
 
+bool confCheck(const void *drvConf, quint32 len)
+{
+    return fort_conf_check((const PFORT_CONF) drvConf, len);
+}
+
+bool confZonesCheck(const void *drvZones, quint32 len)
+{
+    return fort_conf_zones_check((const PFORT_CONF_ZONES) drvZones, len);
+}
+
 bool confIpInRange(
         const void *drvConf, const quint32 *ip, bool isIPv6, bool included, int addrGroupIndex)
 {
@@ -217,6 +232,23 @@ bool confIp6InRange(const void *drvConf, const ip6_addr_t &ip, bool included, in
     return confIpInRange(drvConf, &ip.addr32[0], /*isIPv6=*/true, included, addrGroupIndex);
 }
 
+bool confAddrListPatch(const char *addrList, const char *removedList, const char *addedList,
+        QByteArray &outList)
+{
+    const PFORT_CONF_ADDR4_LIST addr_list = (const PFORT_CONF_ADDR4_LIST) addrList;
+    const PFORT_CONF_ADDR4_LIST removed_list = (const PFORT_CONF_ADDR4_LIST) removedList;
+    const PFORT_CONF_ADDR4_LIST added_list = (const PFORT_CONF_ADDR4_LIST) addedList;
+
+    const quint32 outSize = fort_conf_addr_list_patch_size(addr_list, removed_list, added_list);
+    if (outSize == 0)
+        return false;
+
+    outList.resize(outSize);
+
+    return fort_conf_addr_list_patch(
+            addr_list, removed_list, added_list, (PFORT_CONF_ADDR4_LIST) outList.data());
+}
+
 quint16 confAppFind(const void *drvConf, const QString &kernelPath)
 {
     const PFORT_CONF conf = (const PFORT_CONF) drvConf;
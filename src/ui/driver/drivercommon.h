@@ -1,6 +1,7 @@
 #ifndef DRIVERCOMMON_H
 #define DRIVERCOMMON_H
 
+#include <QByteArray>
 #include <QString>
 
 #include <common/common_types.h>
@@ -18,6 +19,7 @@ quint32 ioctlAddApp();
 quint32 ioctlDelApp();
 quint32 ioctlSetZones();
 quint32 ioctlSetZoneFlag();
+quint32 ioctlSetZoneDelta();
 
 quint32 userErrorCode();
 
@@ -64,12 +66,18 @@ void logTimeRead(const char *input, int *systemTimeChanged, qint64 *unixTime);
 
 void confAppPermsMaskInit(void *drvConf);
 
+bool confCheck(const void *drvConf, quint32 len);
+bool confZonesCheck(const void *drvZones, quint32 len);
+
 bool confIpInRange(const void *drvConf, const quint32 *ip, bool isIPv6 = false,
         bool included = false, int addrGroupIndex = 0);
 bool confIp4InRange(const void *drvConf, quint32 ip, bool included = false, int addrGroupIndex = 0);
 bool confIp6InRange(
         const void *drvConf, const ip6_addr_t &ip, bool included = false, int addrGroupIndex = 0);
 
+bool confAddrListPatch(const char *addrList, const char *removedList, const char *addedList,
+        QByteArray &outList);
+
 quint16 confAppFind(const void *drvConf, const QString &kernelPath);
 quint8 confAppGroupIndex(quint16 appFlags);
 bool confAppBlocked(const void *drvConf, quint16 appFlags, qint8 *blockReason);
@@ -125,6 +125,11 @@ bool DriverManager::writeZones(QByteArray &buf, bool onlyFlags)
     return writeData(code, buf);
 }
 
+bool DriverManager::writeZoneDelta(QByteArray &buf)
+{
+    return writeData(DriverCommon::ioctlSetZoneDelta(), buf);
+}
+
 bool DriverManager::writeData(quint32 code, QByteArray &buf)
 {
     if (!isDeviceOpened())
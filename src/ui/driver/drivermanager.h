@@ -47,6 +47,7 @@ public slots:
     bool writeConf(QByteArray &buf, bool onlyFlags = false);
     bool writeApp(QByteArray &buf, bool remove = false);
     bool writeZones(QByteArray &buf, bool onlyFlags = false);
+    bool writeZoneDelta(QByteArray &buf);
 
 protected:
     void setErrorCode(quint32 v);
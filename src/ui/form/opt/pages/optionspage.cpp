@@ -27,6 +27,7 @@
 #include <user/iniuser.h>
 #include <util/guiutil.h>
 #include <util/iconcache.h>
+#include <util/net/netutil.h>
 #include <util/osutil.h>
 #include <util/startuputil.h>
 
@@ -135,6 +136,11 @@ void OptionsPage::onAboutToSave()
     }
 }
 
+void OptionsPage::onPageActivated()
+{
+    retranslateIconCacheStats();
+}
+
 void OptionsPage::onEditResetted()
 {
     // Password
@@ -267,6 +273,19 @@ void OptionsPage::onRetranslateUi()
 
     m_cbLogDebug->setText(tr("Log debug messages"));
     m_cbLogConsole->setText(tr("Show log messages in console"));
+    retranslateIconCacheStats();
+}
+
+void OptionsPage::retranslateIconCacheStats()
+{
+    const IconCacheStats stats = IconCache::stats();
+
+    const qint64 lookupCount = stats.hitCount + stats.missCount;
+    const int hitPercent = lookupCount > 0 ? int(stats.hitCount * 100 / lookupCount) : 0;
+
+    m_labelIconCache->setText(tr("Icon cache: %1% hits, %2 images, %3")
+                    .arg(QString::number(hitPercent), QString::number(stats.imageCount),
+                            NetUtil::formatDataSize1(stats.imageBytes)));
 }
 
 void OptionsPage::retranslateComboStartMode()
@@ -1013,9 +1032,12 @@ void OptionsPage::setupLogsBox()
         ctrl()->setIniEdited();
     });
 
+    m_labelIconCache = ControlUtil::createLabel();
+
     auto layout = new QVBoxLayout();
     layout->addWidget(m_cbLogDebug);
     layout->addWidget(m_cbLogConsole);
+    layout->addWidget(m_labelIconCache);
 
     m_gbLogs = new QGroupBox();
     m_gbLogs->setLayout(layout);
@@ -25,6 +25,7 @@ public:
     void setExplorerEdited(bool v) { m_explorerEdited = v; }
 
 public slots:
+    void onPageActivated() override;
     void onResetToDefault() override;
 
 protected slots:
@@ -45,6 +46,7 @@ private:
     void retranslateComboHotKey();
     void retranslateComboTrayEvent();
     void retranslateComboTrayAction();
+    void retranslateIconCacheStats();
 
     void setupStartup();
 
@@ -148,6 +150,7 @@ private:
     QCheckBox *m_cbConfirmQuit = nullptr;
     QCheckBox *m_cbLogDebug = nullptr;
     QCheckBox *m_cbLogConsole = nullptr;
+    QLabel *m_labelIconCache = nullptr;
 };
 
 #endif // OPTIONSPAGE_H
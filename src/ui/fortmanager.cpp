@@ -14,6 +14,7 @@
 #include <form/dialog/passworddialog.h>
 #include <fortsettings.h>
 #include <hostinfo/hostinfocache.h>
+#include <hostinfo/hostinfomanager.h>
 #include <manager/drivelistmanager.h>
 #include <manager/envmanager.h>
 #include <manager/hotkeymanager.h>
@@ -134,7 +135,7 @@ inline void setupServices(IocContainer *ioc, const FortSettings *settings)
 
     ioc->setService(new NativeEventFilter());
     ioc->setService(new AppInfoCache());
-    ioc->setService(new HostInfoCache());
+    ioc->setService(new HostInfoCache(new HostInfoManager(settings->hostInfoFilePath())));
     ioc->setService(new ZoneListModel());
 }
 
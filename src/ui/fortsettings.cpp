@@ -53,6 +53,11 @@ QString FortSettings::cacheFilePath() const
     return noCache() ? ":memory:" : cachePath() + "appinfo.db";
 }
 
+QString FortSettings::hostInfoFilePath() const
+{
+    return noCache() ? ":memory:" : cachePath() + "hostinfo.db";
+}
+
 QString FortSettings::passwordUnlockedTillText() const
 {
     if (passwordUnlockType() == UnlockDisabled)
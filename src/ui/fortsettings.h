@@ -59,6 +59,7 @@ public:
 
     QString cachePath() const { return m_cachePath; }
     QString cacheFilePath() const;
+    QString hostInfoFilePath() const;
 
     QString userPath() const { return m_userPath; }
 
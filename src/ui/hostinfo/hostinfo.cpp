@@ -1 +1,6 @@
 #include "hostinfo.h"
+
+bool HostInfo::isExpired() const
+{
+    return expireTime.isValid() && expireTime <= QDateTime::currentDateTimeUtc();
+}
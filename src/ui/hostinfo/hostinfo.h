@@ -1,12 +1,22 @@
 #ifndef HOSTINFO_H
 #define HOSTINFO_H
 
+#include <QDateTime>
 #include <QObject>
 
 class HostInfo
 {
 public:
+    bool isExpired() const;
+
+public:
+    // Not set, while the lookup is in progress
+    QDateTime expireTime;
+
+    // Empty, when the address is not resolved
     QString hostName;
 };
 
+Q_DECLARE_METATYPE(HostInfo)
+
 #endif // HOSTINFO_H
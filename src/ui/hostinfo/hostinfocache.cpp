@@ -2,9 +2,11 @@
 
 #include "hostinfomanager.h"
 
-HostInfoCache::HostInfoCache(QObject *parent) :
-    QObject(parent), m_manager(new HostInfoManager(this)), m_cache(1000)
+HostInfoCache::HostInfoCache(HostInfoManager *manager, QObject *parent) :
+    QObject(parent), m_manager(manager ? manager : new HostInfoManager()), m_cache(1000)
 {
+    m_manager->setParent(this);
+
     connect(m_manager, &HostInfoManager::lookupFinished, this,
             &HostInfoCache::handleFinishedLookup);
 
@@ -22,6 +24,13 @@ QString HostInfoCache::hostName(const QString &address)
     HostInfo *hostInfo = m_cache.object(address);
 
     if (hostInfo) {
+        // Refresh the expired name, while showing the old one
+        if (hostInfo->isExpired()) {
+            hostInfo->expireTime = {};
+
+            m_manager->lookupHost(address);
+        }
+
         return hostInfo->hostName;
     }
 
@@ -37,7 +46,7 @@ QString HostInfoCache::hostName(const QString &address)
 
 void HostInfoCache::clear()
 {
-    m_manager->clear();
+    m_manager->clearLookups();
     m_cache.clear();
 
     emitCacheChanged();
@@ -48,13 +57,13 @@ void HostInfoCache::close()
     m_manager->abortWorkers();
 }
 
-void HostInfoCache::handleFinishedLookup(const QString &address, const QString &hostName)
+void HostInfoCache::handleFinishedLookup(const QString &address, const HostInfo &hostInfo)
 {
-    HostInfo *hostInfo = m_cache.object(address);
-    if (!hostInfo)
+    HostInfo *cachedInfo = m_cache.object(address);
+    if (!cachedInfo)
         return;
 
-    hostInfo->hostName = hostName;
+    *cachedInfo = hostInfo;
 
     emitCacheChanged();
 }
@@ -16,7 +16,7 @@ class HostInfoCache : public QObject, public IocService
     Q_OBJECT
 
 public:
-    explicit HostInfoCache(QObject *parent = nullptr);
+    explicit HostInfoCache(HostInfoManager *manager = nullptr, QObject *parent = nullptr);
     ~HostInfoCache() override;
 
 signals:
@@ -30,7 +30,7 @@ public slots:
 private slots:
     void close();
 
-    void handleFinishedLookup(const QString &address, const QString &hostName);
+    void handleFinishedLookup(const QString &address, const HostInfo &hostInfo);
 
 private:
     void emitCacheChanged();
@@ -1,15 +1,14 @@
 #include "hostinfojob.h"
 
-#include <util/net/netutil.h>
 #include <util/worker/workerobject.h>
 
 #include "hostinfomanager.h"
 
 HostInfoJob::HostInfoJob(const QString &address) : WorkerJob(address) { }
 
-void HostInfoJob::doJob(WorkerObject & /*worker*/)
+void HostInfoJob::doJob(WorkerObject &worker)
 {
-    m_hostName = NetUtil::getHostName(address());
+    loadHostInfo(static_cast<HostInfoManager *>(worker.manager()));
 }
 
 void HostInfoJob::reportResult(WorkerObject &worker)
@@ -17,7 +16,21 @@ void HostInfoJob::reportResult(WorkerObject &worker)
     emitFinished(static_cast<HostInfoManager *>(worker.manager()));
 }
 
+void HostInfoJob::loadHostInfo(HostInfoManager *manager)
+{
+    // Try to load from DB
+    if (manager->loadFromDb(address(), m_hostInfo) && !m_hostInfo.isExpired())
+        return;
+
+    // Resolve by DNS
+    m_hostInfo = manager->resolveHostInfo(address());
+
+    manager->saveToDb(address(), m_hostInfo);
+}
+
 void HostInfoJob::emitFinished(HostInfoManager *manager)
 {
-    emit manager->lookupFinished(address(), m_hostName);
+    manager->finishLookup(address());
+
+    emit manager->lookupFinished(address(), m_hostInfo);
 }
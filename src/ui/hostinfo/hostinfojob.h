@@ -3,6 +3,8 @@
 
 #include <util/worker/workerjob.h>
 
+#include "hostinfo.h"
+
 class HostInfoManager;
 
 class HostInfoJob : public WorkerJob
@@ -16,10 +18,11 @@ public:
     void reportResult(WorkerObject &worker) override;
 
 private:
+    void loadHostInfo(HostInfoManager *manager);
     void emitFinished(HostInfoManager *manager);
 
 private:
-    QString m_hostName;
+    HostInfo m_hostInfo;
 };
 
 #endif // HOSTINFOJOB_H
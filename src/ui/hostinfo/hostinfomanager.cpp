@@ -1,15 +1,196 @@
 #include "hostinfomanager.h"
 
+#include <QLoggingCategory>
+
+#include <sqlite/dbquery.h>
+#include <sqlite/sqlitedb.h>
+#include <sqlite/sqlitestmt.h>
+
+#include <util/net/netutil.h>
+
 #include "hostinfojob.h"
 
-HostInfoManager::HostInfoManager(QObject *parent) : WorkerManager(parent)
+namespace {
+
+const QLoggingCategory LC("hostInfo");
+
+constexpr int DATABASE_USER_VERSION = 1;
+
+// DNS queries block the workers, so more of them are run in parallel
+constexpr int HOST_WORKERS_MAX_COUNT = 8;
+
+constexpr int HOST_CACHE_MAX_COUNT = 10000;
+
+constexpr int HOST_TTL_SECS = 24 * 60 * 60;
+constexpr int HOST_NOT_FOUND_TTL_SECS = 60 * 60;
+
+const char *const sqlSelectHost = "SELECT host_name, expire_time FROM host WHERE address = ?1;";
+
+const char *const sqlInsertHost = "INSERT OR REPLACE INTO host(address, host_name, expire_time)"
+                                  "  VALUES(?1, ?2, ?3);";
+
+const char *const sqlDeleteExpiredHosts = "DELETE FROM host WHERE expire_time <= ?1;";
+
+const char *const sqlDeleteExcessHosts =
+        "DELETE FROM host WHERE address IN ("
+        "  SELECT address FROM host ORDER BY expire_time"
+        "    LIMIT max(0, (SELECT count(*) FROM host) - ?1));";
+
+}
+
+HostInfoManager::HostInfoManager(const QString &filePath, QObject *parent) :
+    WorkerManager(parent), m_sqliteDb(!filePath.isEmpty() ? new SqliteDb(filePath) : nullptr)
 {
-    setMaxWorkersCount(2);
+    if (m_sqliteDb) {
+        m_sqliteDb->setTuneProfile(SqliteDb::TuneSmall);
+    }
+
+    setMaxWorkersCount(HOST_WORKERS_MAX_COUNT);
+
+    m_threadPool.setMaxThreadCount(HOST_WORKERS_MAX_COUNT);
 
     QSysInfo::machineHostName(); // Initialize ws2_32.dll
 }
 
+HostInfoManager::~HostInfoManager()
+{
+    // Stop the workers before the thread pool
+    abortWorkers();
+}
+
 void HostInfoManager::lookupHost(const QString &address)
 {
+    {
+        QMutexLocker locker(&m_lookupMutex);
+
+        if (m_lookupAddresses.contains(address))
+            return; // already queued or in progress
+
+        m_lookupAddresses.insert(address);
+    }
+
     enqueueJob(WorkerJobPtr(new HostInfoJob(address)));
 }
+
+void HostInfoManager::clearLookups()
+{
+    clear();
+
+    QMutexLocker locker(&m_lookupMutex);
+
+    m_lookupAddresses.clear();
+}
+
+void HostInfoManager::finishLookup(const QString &address)
+{
+    QMutexLocker locker(&m_lookupMutex);
+
+    m_lookupAddresses.remove(address);
+}
+
+HostInfo HostInfoManager::resolveHostInfo(const QString &address)
+{
+    HostInfo hostInfo;
+
+    hostInfo.hostName = resolveHostName(address);
+
+    // The address itself is returned, when it has no name
+    if (hostInfo.hostName == address) {
+        hostInfo.hostName.clear();
+    }
+
+    const int ttlSecs = hostInfo.hostName.isEmpty() ? HOST_NOT_FOUND_TTL_SECS : HOST_TTL_SECS;
+
+    hostInfo.expireTime = QDateTime::currentDateTimeUtc().addSecs(ttlSecs);
+
+    return hostInfo;
+}
+
+QString HostInfoManager::resolveHostName(const QString &address)
+{
+    return NetUtil::getHostName(address);
+}
+
+bool HostInfoManager::loadFromDb(const QString &address, HostInfo &hostInfo)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (!sqliteDb())
+        return false;
+
+    SqliteStmt stmt;
+    if (!stmt.prepare(sqliteDb()->db(), sqlSelectHost))
+        return false;
+
+    stmt.bindText(1, address);
+
+    if (stmt.step() != SqliteStmt::StepRow)
+        return false;
+
+    hostInfo.hostName = stmt.columnText(0);
+    hostInfo.expireTime = stmt.columnDateTime(1);
+
+    return true;
+}
+
+void HostInfoManager::saveToDb(const QString &address, const HostInfo &hostInfo)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (!sqliteDb())
+        return;
+
+    DbQuery(sqliteDb())
+            .sql(sqlInsertHost)
+            .vars({ address, hostInfo.hostName, hostInfo.expireTime })
+            .executeOk();
+}
+
+SqliteDb *HostInfoManager::sqliteDb()
+{
+    // Opened on the first lookup, as the Service doesn't resolve the addresses
+    if (!m_dbChecked) {
+        m_dbChecked = true;
+
+        if (m_sqliteDb && !setupDb()) {
+            m_sqliteDb.reset();
+        }
+    }
+
+    return m_sqliteDb.data();
+}
+
+bool HostInfoManager::setupDb()
+{
+    if (!m_sqliteDb->open()) {
+        qCWarning(LC) << "File open error:" << m_sqliteDb->filePath()
+                      << m_sqliteDb->errorMessage();
+        return false;
+    }
+
+    SqliteDb::MigrateOptions opt = {
+        .sqlDir = ":/hostinfo/migrations",
+        .version = DATABASE_USER_VERSION,
+        .recreate = true,
+        .importOldData = false,
+    };
+
+    if (!m_sqliteDb->migrate(opt)) {
+        qCWarning(LC) << "Migration error" << m_sqliteDb->filePath();
+        return false;
+    }
+
+    deleteOldHosts();
+
+    return true;
+}
+
+void HostInfoManager::deleteOldHosts()
+{
+    DbQuery(m_sqliteDb.data())
+            .sql(sqlDeleteExpiredHosts)
+            .vars({ QDateTime::currentDateTimeUtc() })
+            .executeOk();
+
+    DbQuery(m_sqliteDb.data()).sql(sqlDeleteExcessHosts).vars({ HOST_CACHE_MAX_COUNT }).executeOk();
+}
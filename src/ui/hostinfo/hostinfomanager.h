@@ -1,22 +1,64 @@
 #ifndef HOSTINFOMANAGER_H
 #define HOSTINFOMANAGER_H
 
+#include <QMutex>
+#include <QSet>
+#include <QThreadPool>
+
+#include <sqlite/sqlite_types.h>
+
 #include <util/worker/workermanager.h>
 
+#include "hostinfo.h"
+
 class HostInfoManager : public WorkerManager
 {
     Q_OBJECT
 
 public:
-    explicit HostInfoManager(QObject *parent = nullptr);
+    explicit HostInfoManager(const QString &filePath = {}, QObject *parent = nullptr);
+    ~HostInfoManager() override;
 
     QString workerName() const override { return "HostInfoWorker"; }
 
+    bool loadFromDb(const QString &address, HostInfo &hostInfo);
+    void saveToDb(const QString &address, const HostInfo &hostInfo);
+
+    HostInfo resolveHostInfo(const QString &address);
+
+    void finishLookup(const QString &address);
+
 signals:
-    void lookupFinished(const QString &address, const QString &hostName);
+    void lookupFinished(const QString &address, const HostInfo &hostInfo);
 
 public slots:
     void lookupHost(const QString &address);
+    void clearLookups();
+
+protected:
+    QThreadPool *threadPool() const override { return &m_threadPool; }
+
+    // Blocking resolver, called by the workers concurrently
+    virtual QString resolveHostName(const QString &address);
+
+private:
+    SqliteDb *sqliteDb();
+
+    bool setupDb();
+
+    void deleteOldHosts();
+
+private:
+    bool m_dbChecked = false;
+
+    SqliteDbPtr m_sqliteDb;
+    QMutex m_mutex;
+
+    // Queued and in progress lookups
+    QSet<QString> m_lookupAddresses;
+    QMutex m_lookupMutex;
+
+    mutable QThreadPool m_threadPool;
 };
 
 #endif // HOSTINFOMANAGER_H
@@ -1,18 +1,74 @@
 #include "dberrormanager.h"
 
+#include <algorithm>
+
 #include <QLoggingCategory>
 #include <QTimer>
 
 #include <sqlite/sqlitedb.h>
+#include <sqlite/sqlitedbpool.h>
 
+#include <appinfo/appinfomanager.h>
+#include <conf/confmanager.h>
 #include <fortmanager.h>
 #include <fortsettings.h>
+#include <stat/statblockmanager.h>
+#include <stat/statmanager.h>
 #include <util/ioc/ioccontainer.h>
 
 namespace {
 
 const QLoggingCategory LC("manager.dbError");
 
+constexpr int LOG_TOP_STMT_COUNT = 10;
+
+struct DbStmtStat
+{
+    QString dbName;
+    SqliteStmtStat stat;
+};
+
+void appendDbStats(QVector<DbStmtStat> &list, const QString &dbName, SqliteDb *db,
+        SqliteDbPool *roDbPool = nullptr)
+{
+    const auto appendStats = [&](const QString &name, const SqliteStmtStatList &stats) {
+        for (const SqliteStmtStat &stat : stats) {
+            list.append({ name, stat });
+        }
+    };
+
+    appendStats(dbName, db->stmtStats());
+
+    if (roDbPool) {
+        // The stats of other threads are as of their last finished statements
+        appendStats(dbName + "-ro", roDbPool->stmtStats());
+    }
+}
+
+QVector<DbStmtStat> collectDbStats(int topCount)
+{
+    QVector<DbStmtStat> list;
+
+    appendDbStats(list, "conf", IoC<ConfManager>()->sqliteDb());
+    appendDbStats(list, "appInfo", IoC<AppInfoManager>()->sqliteDb());
+
+    auto statManager = IoC<StatManager>();
+    appendDbStats(list, "stat", statManager->sqliteDb(), statManager->roDbPool());
+
+    auto statBlockManager = IoC<StatBlockManager>();
+    appendDbStats(list, "statBlock", statBlockManager->sqliteDb(), statBlockManager->roDbPool());
+
+    std::sort(list.begin(), list.end(), [](const DbStmtStat &a, const DbStmtStat &b) {
+        return a.stat.stepTimeNsec > b.stat.stepTimeNsec;
+    });
+
+    if (topCount > 0 && list.size() > topCount) {
+        list.resize(topCount);
+    }
+
+    return list;
+}
+
 void sqliteLogHandler(void * /*context*/, int errCode, const char *message)
 {
     const auto messageLine =
@@ -39,6 +95,49 @@ void DbErrorManager::setUp()
     setupTimer();
 }
 
+void DbErrorManager::tearDown()
+{
+    const auto list = collectDbStats(LOG_TOP_STMT_COUNT);
+
+    for (const DbStmtStat &dbStat : list) {
+        const SqliteStmtStat &stat = dbStat.stat;
+        if (stat.stepCount == 0)
+            break;
+
+        qCDebug(LC) << "Top SQL:" << dbStat.dbName << (stat.stepTimeNsec / 1000) << "usec"
+                    << "exec:" << stat.execCount << "steps:" << stat.stepCount
+                    << "vm-steps:" << stat.vmStepCount << "fullscan:" << stat.fullscanStepCount
+                    << "sort:" << stat.sortCount << "autoindex:" << stat.autoindexCount
+                    << "busy:" << stat.busyWaitCount << stat.sql;
+    }
+}
+
+QVariantList DbErrorManager::dbStats(int topCount) const
+{
+    QVariantList list;
+
+    const auto dbStats = collectDbStats(topCount);
+
+    for (const DbStmtStat &dbStat : dbStats) {
+        const SqliteStmtStat &stat = dbStat.stat;
+
+        list.append(QVariantMap {
+                { "db", dbStat.dbName },
+                { "sql", QString::fromUtf8(stat.sql) },
+                { "execCount", stat.execCount },
+                { "stepCount", stat.stepCount },
+                { "busyWaitCount", stat.busyWaitCount },
+                { "stepTimeUsec", stat.stepTimeNsec / 1000 },
+                { "fullscanStepCount", stat.fullscanStepCount },
+                { "sortCount", stat.sortCount },
+                { "autoindexCount", stat.autoindexCount },
+                { "vmStepCount", stat.vmStepCount },
+        });
+    }
+
+    return list;
+}
+
 void DbErrorManager::checkProfileDir()
 {
     if (m_confDir.checkIsValid())
@@ -2,6 +2,7 @@
 #define DBERRORMANAGER_H
 
 #include <QObject>
+#include <QVariant>
 
 #include <util/dirinfo.h>
 #include <util/ioc/iocservice.h>
@@ -14,6 +15,10 @@ public:
     explicit DbErrorManager(QObject *parent = nullptr);
 
     void setUp() override;
+    void tearDown() override;
+
+    // Per SQL statement stats of the databases, the slowest first
+    QVariantList dbStats(int topCount = 0) const;
 
 private slots:
     void checkProfileDir();
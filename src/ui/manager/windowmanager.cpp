@@ -29,6 +29,7 @@
 #include <stat/statmanager.h>
 #include <user/usersettings.h>
 #include <util/guiutil.h>
+#include <util/iconcache.h>
 #include <util/ioc/ioccontainer.h>
 #include <util/osutil.h>
 
@@ -814,6 +815,11 @@ void WindowManager::windowClosed(quint32 code)
 {
     m_openedWindows &= ~code;
 
+    // Release the decoded app icons, while the app is in the tray only
+    if (m_openedWindows == 0) {
+        IconCache::trimImages();
+    }
+
     emit windowVisibilityChanged(code, /*isVisible=*/false);
 }
 
@@ -324,6 +324,8 @@ SqliteDb *AppListModel::sqliteDb() const
 
 void AppListModel::initialize()
 {
+    setupAsyncLoading();
+
     setSortColumn(7);
     setSortOrder(Qt::DescendingOrder);
 
@@ -332,7 +334,7 @@ void AppListModel::initialize()
     connect(confAppManager(), &ConfAppManager::appsChanged, this, &TableItemModel::reset);
     connect(confAppManager(), &ConfAppManager::appUpdated, this, &TableItemModel::refresh);
 
-    connect(appInfoCache(), &AppInfoCache::cacheChanged, this, &AppListModel::refresh);
+    connect(appInfoCache(), &AppInfoCache::cacheChanged, this, &AppListModel::refreshView);
 }
 
 int AppListModel::columnCount(const QModelIndex & /*parent*/) const
@@ -362,6 +364,10 @@ QVariant AppListModel::data(const QModelIndex &index, int role) const
     if (!index.isValid())
         return QVariant();
 
+    // Placeholder of the row being loaded
+    if (appRowAt(index.row()).isNull())
+        return QVariant();
+
     switch (role) {
     // Label
     case Qt::DisplayRole:
@@ -466,6 +472,13 @@ bool AppListModel::updateAppRow(const QString &sql, const QVariantHash &vars, Ap
         return false;
     }
 
+    fillAppRow(stmt, appRow);
+
+    return true;
+}
+
+void AppListModel::fillAppRow(SqliteStmt &stmt, AppRow &appRow)
+{
     appRow.appId = stmt.columnInt64(0);
     appRow.appOriginPath = stmt.columnText(1);
     appRow.appPath = stmt.columnText(2);
@@ -490,8 +503,6 @@ bool AppListModel::updateAppRow(const QString &sql, const QVariantHash &vars, Ap
     appRow.groupIndex = stmt.columnInt(21);
     appRow.alerted = stmt.columnBool(22);
     appRow.ruleName = stmt.columnText(23);
-
-    return true;
 }
 
 const AppRow &AppListModel::appRowAt(int row) const
@@ -525,9 +536,9 @@ AppRow AppListModel::appRowByPath(const QString &appPath) const
     return appRow;
 }
 
-bool AppListModel::updateTableRow(const QVariantHash &vars, int /*row*/) const
+bool AppListModel::updateTableRow(const QVariantHash & /*vars*/, int row) const
 {
-    return updateAppRow(sql(), vars, m_appRow);
+    return updateTableRowCached(m_appRows, row, m_appRow, &AppListModel::fillAppRow);
 }
 
 QString AppListModel::sqlBase() const
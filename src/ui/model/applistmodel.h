@@ -63,6 +63,7 @@ signals:
 protected:
     bool updateTableRow(const QVariantHash &vars, int row) const override;
     TableRow &tableRow() const override { return m_appRow; }
+    TableRowCacheBase *rowCache() const override { return &m_appRows; }
 
     QString sqlBase() const override;
     QString sqlWhere() const override;
@@ -78,12 +79,14 @@ private:
     QIcon appIcon(const AppRow &appRow) const;
 
     bool updateAppRow(const QString &sql, const QVariantHash &vars, AppRow &appRow) const;
+    static void fillAppRow(SqliteStmt &stmt, AppRow &appRow);
 
 private:
     FilterFlags m_filters = FilterNone;
     FilterFlags m_filterValues = FilterNone;
 
     mutable AppRow m_appRow;
+    mutable TableRowCache<AppRow> m_appRows;
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(AppListModel::FilterFlags)
@@ -29,7 +29,7 @@ void ConnBlockListModel::setResolveAddress(bool v)
 {
     if (m_resolveAddress != v) {
         m_resolveAddress = v;
-        refresh();
+        refreshView();
     }
 }
 
@@ -60,8 +60,10 @@ HostInfoCache *ConnBlockListModel::hostInfoCache() const
 
 void ConnBlockListModel::initialize()
 {
-    connect(appInfoCache(), &AppInfoCache::cacheChanged, this, &ConnBlockListModel::refresh);
-    connect(hostInfoCache(), &HostInfoCache::cacheChanged, this, &ConnBlockListModel::refresh);
+    setupAsyncLoading();
+
+    connect(appInfoCache(), &AppInfoCache::cacheChanged, this, &ConnBlockListModel::refreshView);
+    connect(hostInfoCache(), &HostInfoCache::cacheChanged, this, &ConnBlockListModel::refreshView);
     connect(statBlockManager(), &StatBlockManager::connChanged, this,
             &ConnBlockListModel::updateConnIdRange);
 
@@ -88,6 +90,10 @@ QVariant ConnBlockListModel::data(const QModelIndex &index, int role) const
     if (!index.isValid())
         return QVariant();
 
+    // Placeholder of the row being loaded
+    if (connRowAt(index.row()).isNull())
+        return QVariant();
+
     switch (role) {
     // Label
     case Qt::DisplayRole:
@@ -268,36 +274,39 @@ void ConnBlockListModel::updateConnIdRange()
 
 bool ConnBlockListModel::updateTableRow(const QVariantHash & /*vars*/, int row) const
 {
-    const qint64 connId = connIdMin() + row;
-
-    SqliteStmt stmt;
-    if (!DbQuery(sqliteDb()).sql(sql()).vars({ connId }).prepareRow(stmt))
-        return false;
-
-    m_connRow.connId = stmt.columnInt64(0);
-    m_connRow.appId = stmt.columnInt64(1);
-    m_connRow.connTime = stmt.columnUnixTime(2);
-    m_connRow.pid = stmt.columnInt(3);
-    m_connRow.inbound = stmt.columnBool(4);
-    m_connRow.inherited = stmt.columnBool(5);
-    m_connRow.ipProto = stmt.columnInt(6);
-    m_connRow.localPort = stmt.columnInt(7);
-    m_connRow.remotePort = stmt.columnInt(8);
-
-    m_connRow.isIPv6 = stmt.columnIsNull(9);
-    if (!m_connRow.isIPv6) {
-        m_connRow.localIp.v4 = stmt.columnInt(9);
-        m_connRow.remoteIp.v4 = stmt.columnInt(10);
+    return updateTableRowCached(m_connRows, row, m_connRow, &ConnBlockListModel::fillConnRow);
+}
+
+void ConnBlockListModel::fillQueryVarsForRow(QVariantHash &vars, int row) const
+{
+    vars.insert(":conn_id", connIdMin() + TableRowCacheBase::blockStart(row));
+    vars.insert(":limit", TableRowCacheBase::blockSize);
+}
+
+void ConnBlockListModel::fillConnRow(SqliteStmt &stmt, ConnRow &connRow)
+{
+    connRow.connId = stmt.columnInt64(0);
+    connRow.appId = stmt.columnInt64(1);
+    connRow.connTime = stmt.columnUnixTime(2);
+    connRow.pid = stmt.columnInt(3);
+    connRow.inbound = stmt.columnBool(4);
+    connRow.inherited = stmt.columnBool(5);
+    connRow.ipProto = stmt.columnInt(6);
+    connRow.localPort = stmt.columnInt(7);
+    connRow.remotePort = stmt.columnInt(8);
+
+    connRow.isIPv6 = stmt.columnIsNull(9);
+    if (!connRow.isIPv6) {
+        connRow.localIp.v4 = stmt.columnInt(9);
+        connRow.remoteIp.v4 = stmt.columnInt(10);
     } else {
-        m_connRow.localIp.v6 = NetUtil::rawArrayToIp6(stmt.columnBlob(11, /*isRaw=*/true));
-        m_connRow.remoteIp.v6 = NetUtil::rawArrayToIp6(stmt.columnBlob(12, /*isRaw=*/true));
+        connRow.localIp.v6 = NetUtil::rawArrayToIp6(stmt.columnBlob(11, /*isRaw=*/true));
+        connRow.remoteIp.v6 = NetUtil::rawArrayToIp6(stmt.columnBlob(12, /*isRaw=*/true));
     }
 
-    m_connRow.blockReason = stmt.columnInt(13);
+    connRow.blockReason = stmt.columnInt(13);
 
-    m_connRow.appPath = stmt.columnText(14);
-
-    return true;
+    connRow.appPath = stmt.columnText(14);
 }
 
 int ConnBlockListModel::doSqlCount() const
@@ -329,12 +338,17 @@ QString ConnBlockListModel::sqlBase() const
 
 QString ConnBlockListModel::sqlWhere() const
 {
-    return " WHERE t.conn_id = ?1";
+    return " WHERE t.conn_id >= :conn_id";
+}
+
+QString ConnBlockListModel::sqlOrder() const
+{
+    return " ORDER BY t.conn_id";
 }
 
 QString ConnBlockListModel::sqlLimitOffset() const
 {
-    return QString();
+    return " LIMIT :limit";
 }
 
 QString ConnBlockListModel::formatIpPort(const ip_addr_t &ip, quint16 port, bool isIPv6) const
@@ -394,6 +408,7 @@ void ConnBlockListModel::insertConnRows(qint64 idMax, int endRow, int count)
 {
     beginInsertRows({}, endRow, endRow + count - 1);
     m_connIdMax = idMax;
-    invalidateRowCache();
+    // Keep the cached blocks: the rows are appended, the last block is refetched on miss
+    setSqlRowCount(-1);
     endInsertRows();
 }
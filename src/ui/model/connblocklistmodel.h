@@ -72,12 +72,14 @@ protected slots:
 protected:
     bool updateTableRow(const QVariantHash &vars, int row) const override;
     TableRow &tableRow() const override { return m_connRow; }
+    TableRowCacheBase *rowCache() const override { return &m_connRows; }
 
-    void fillQueryVarsForRow(QVariantHash & /*vars*/, int /*row*/) const override { }
+    void fillQueryVarsForRow(QVariantHash &vars, int row) const override;
 
     int doSqlCount() const override;
     QString sqlBase() const override;
     QString sqlWhere() const override;
+    QString sqlOrder() const override;
     QString sqlLimitOffset() const override;
 
 private:
@@ -90,6 +92,8 @@ private:
     static QString blockReasonText(const ConnRow &connRow);
     static QString connIconPath(const ConnRow &connRow);
 
+    static void fillConnRow(SqliteStmt &stmt, ConnRow &connRow);
+
     qint64 connIdMin() const { return m_connIdMin; }
     qint64 connIdMax() const { return m_connIdMax; }
 
@@ -107,6 +111,7 @@ private:
     qint64 m_connIdMax = 0;
 
     mutable ConnRow m_connRow;
+    mutable TableRowCache<ConnRow> m_connRows;
 };
 
 #endif // CONNBLOCKLISTMODEL_H
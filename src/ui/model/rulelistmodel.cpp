@@ -282,9 +282,9 @@ RuleRow RuleListModel::ruleRowById(int ruleId, Rule::RuleType ruleType) const
     return ruleRow;
 }
 
-bool RuleListModel::updateTableRow(const QVariantHash &vars, int /*row*/) const
+bool RuleListModel::updateTableRow(const QVariantHash & /*vars*/, int row) const
 {
-    return updateRuleRow(sql(), vars, m_ruleRow);
+    return updateTableRowCached(m_ruleRows, row, m_ruleRow, &RuleListModel::fillRuleRow);
 }
 
 bool RuleListModel::updateRuleRow(
@@ -296,6 +296,13 @@ bool RuleListModel::updateRuleRow(
         return false;
     }
 
+    fillRuleRow(stmt, ruleRow);
+
+    return true;
+}
+
+void RuleListModel::fillRuleRow(SqliteStmt &stmt, RuleRow &ruleRow)
+{
     ruleRow.ruleId = stmt.columnInt(0);
     ruleRow.enabled = stmt.columnBool(1);
     ruleRow.blocked = stmt.columnBool(2);
@@ -307,8 +314,11 @@ bool RuleListModel::updateRuleRow(
     ruleRow.acceptZones = stmt.columnUInt(8);
     ruleRow.rejectZones = stmt.columnUInt(9);
     ruleRow.modTime = stmt.columnDateTime(10);
+}
 
-    return true;
+qint64 RuleListModel::rowCacheKey(int row) const
+{
+    return (qint64(sqlRuleType()) << 32) | row;
 }
 
 QString RuleListModel::sqlBase() const
@@ -346,7 +356,9 @@ void RuleListModel::setSqlRuleType(qint8 v) const
 
     m_sqlRuleType = v;
 
-    invalidateRowCache();
+    // The cached blocks are keyed by the rule type
+    setSqlRowCount(-1);
+    tableRow().invalidate();
 }
 
 void RuleListModel::setSqlRuleType(const QModelIndex &index) const
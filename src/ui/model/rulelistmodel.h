@@ -61,8 +61,11 @@ protected:
 
     bool updateTableRow(const QVariantHash &vars, int row) const override;
     TableRow &tableRow() const override { return m_ruleRow; }
+    TableRowCacheBase *rowCache() const override { return &m_ruleRows; }
+    qint64 rowCacheKey(int row) const override;
 
     bool updateRuleRow(const QString &sql, const QVariantHash &vars, RuleRow &ruleRow) const;
+    static void fillRuleRow(SqliteStmt &stmt, RuleRow &ruleRow);
 
     QString sqlBase() const override;
     QString sqlWhereFts() const override;
@@ -84,6 +87,7 @@ private:
     mutable qint8 m_sqlRuleType = 0;
 
     mutable RuleRow m_ruleRow;
+    mutable TableRowCache<RuleRow> m_ruleRows; // keyed by rule type and row
 };
 
 #endif // RULELISTMODEL_H
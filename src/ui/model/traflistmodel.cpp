@@ -3,64 +3,20 @@
 #include <QLocale>
 
 #include <stat/statmanager.h>
-#include <stat/statsql.h>
 #include <util/dateutil.h>
 #include <util/ioc/ioccontainer.h>
 #include <util/net/netutil.h>
 
 namespace {
 
-bool checkTrafType(TrafListModel::TrafType type)
+StatManager::TrafType toStatTrafType(TrafListModel::TrafType type)
 {
-    if (type >= TrafListModel::TrafHourly && type <= TrafListModel::TrafTotal)
-        return true;
+    static_assert(int(TrafListModel::TrafTotal) == int(StatManager::TrafTotal),
+            "TrafType mismatch");
 
-    Q_UNREACHABLE();
-    return false;
-}
-
-static const char *const sqlSelectMinTrafApps[] = {
-    StatSql::sqlSelectMinTrafAppHour,
-    StatSql::sqlSelectMinTrafAppDay,
-    StatSql::sqlSelectMinTrafAppMonth,
-    StatSql::sqlSelectMinTrafAppTotal,
-};
-
-static const char *const sqlSelectMinTrafs[] = {
-    StatSql::sqlSelectMinTrafHour,
-    StatSql::sqlSelectMinTrafDay,
-    StatSql::sqlSelectMinTrafMonth,
-    StatSql::sqlSelectMinTrafTotal,
-};
-
-const char *getSqlMinTrafTime(TrafListModel::TrafType type, qint64 appId)
-{
-    if (!checkTrafType(type))
-        return nullptr;
-
-    return (appId != 0 ? sqlSelectMinTrafApps : sqlSelectMinTrafs)[type];
-}
-
-static const char *const sqlSelectTrafApps[] = {
-    StatSql::sqlSelectTrafAppHour,
-    StatSql::sqlSelectTrafAppDay,
-    StatSql::sqlSelectTrafAppMonth,
-    StatSql::sqlSelectTrafAppTotal,
-};
-
-static const char *const sqlSelectTrafs[] = {
-    StatSql::sqlSelectTrafHour,
-    StatSql::sqlSelectTrafDay,
-    StatSql::sqlSelectTrafMonth,
-    StatSql::sqlSelectTrafTotal,
-};
-
-const char *getSqlSelectTraffic(TrafListModel::TrafType type, qint64 appId)
-{
-    if (!checkTrafType(type))
-        return nullptr;
+    Q_ASSERT(type >= TrafListModel::TrafHourly && type <= TrafListModel::TrafTotal);
 
-    return (appId != 0 ? sqlSelectTrafApps : sqlSelectTrafs)[type];
+    return StatManager::TrafType(type);
 }
 
 }
@@ -147,11 +103,9 @@ void TrafListModel::resetAppTotals()
 
 void TrafListModel::resetTraf()
 {
-    const char *sqlMinTrafTime = getSqlMinTrafTime(m_type, m_appId);
-
     beginResetModel();
 
-    m_minTrafTime = statManager()->getTrafficTime(sqlMinTrafTime, m_appId);
+    m_minTrafTime = statManager()->getTrafficTime(toStatTrafType(m_type), m_appId);
 
     m_maxTrafTime = getMaxTrafTime(m_type);
 
@@ -181,10 +135,8 @@ bool TrafListModel::updateTableRow(const QVariantHash & /*vars*/, int row) const
 {
     m_trafRow.trafTime = getTrafTime(row);
 
-    const char *sqlSelectTraffic = getSqlSelectTraffic(m_type, m_appId);
-
-    statManager()->getTraffic(
-            sqlSelectTraffic, m_trafRow.trafTime, m_trafRow.inBytes, m_trafRow.outBytes, m_appId);
+    statManager()->getTraffic(toStatTrafType(m_type), m_trafRow.trafTime, m_trafRow.inBytes,
+            m_trafRow.outBytes, m_appId);
 
     return true;
 }
@@ -18,7 +18,22 @@
 #include "zonetypewrapper.h"
 
 namespace {
+
 const QLoggingCategory LC("model.zoneList");
+
+QVariant dataDisplayAddressCount(const ZoneRow &zoneRow, int role)
+{
+    if (role != Qt::ToolTipRole || zoneRow.rangeCount <= 0
+            || zoneRow.rangeCount >= zoneRow.addressCount)
+        return zoneRow.addressCount;
+
+    const int percent = 100 - zoneRow.rangeCount * 100 / zoneRow.addressCount;
+
+    return ZoneListModel::tr("Addresses: %1\nMerged into ranges: %2 (-%3%)")
+            .arg(QString::number(zoneRow.addressCount), QString::number(zoneRow.rangeCount),
+                    QString::number(percent));
+}
+
 }
 
 ZoneListModel::ZoneListModel(QObject *parent) : TableSqlModel(parent) { }
@@ -72,7 +87,7 @@ QVariant ZoneListModel::data(const QModelIndex &index, int role) const
     // Label
     case Qt::DisplayRole:
     case Qt::ToolTipRole:
-        return dataDisplay(index);
+        return dataDisplay(index, role);
 
     // Enabled
     case Qt::CheckStateRole:
@@ -99,7 +114,7 @@ QVariant ZoneListModel::headerDataDisplay(int section) const
     return QVariant();
 }
 
-QVariant ZoneListModel::dataDisplay(const QModelIndex &index) const
+QVariant ZoneListModel::dataDisplay(const QModelIndex &index, int role) const
 {
     const int row = index.row();
     const int column = index.column();
@@ -114,7 +129,7 @@ QVariant ZoneListModel::dataDisplay(const QModelIndex &index) const
         return zoneSource.title();
     }
     case 2:
-        return zoneRow.addressCount;
+        return dataDisplayAddressCount(zoneRow, role);
     case 3:
         return zoneRow.lastRun;
     case 4:
@@ -172,18 +187,13 @@ QVariant ZoneListModel::zoneSourceByCode(const QString &sourceCode) const
     return m_zoneSourcesMap.value(sourceCode);
 }
 
-bool ZoneListModel::updateTableRow(const QVariantHash &vars, int /*row*/) const
+bool ZoneListModel::updateTableRow(const QVariantHash & /*vars*/, int row) const
 {
-    return updateZoneRow(sql(), vars, m_zoneRow);
+    return updateTableRowCached(m_zoneRows, row, m_zoneRow, &ZoneListModel::fillZoneRow);
 }
 
-bool ZoneListModel::updateZoneRow(
-        const QString &sql, const QVariantHash &vars, ZoneRow &zoneRow) const
+void ZoneListModel::fillZoneRow(SqliteStmt &stmt, ZoneRow &zoneRow)
 {
-    SqliteStmt stmt;
-    if (!DbQuery(sqliteDb()).sql(sql).vars(vars).prepareRow(stmt))
-        return false;
-
     zoneRow.zoneId = stmt.columnInt(0);
     zoneRow.enabled = stmt.columnBool(1);
     zoneRow.customUrl = stmt.columnBool(2);
@@ -192,14 +202,13 @@ bool ZoneListModel::updateZoneRow(
     zoneRow.url = stmt.columnText(5);
     zoneRow.formData = stmt.columnText(6);
     zoneRow.addressCount = stmt.columnInt(7);
-    zoneRow.textInline = stmt.columnText(8);
-    zoneRow.textChecksum = stmt.columnText(9);
-    zoneRow.binChecksum = stmt.columnText(10);
-    zoneRow.sourceModTime = stmt.columnDateTime(11);
-    zoneRow.lastRun = stmt.columnDateTime(12);
-    zoneRow.lastSuccess = stmt.columnDateTime(13);
-
-    return true;
+    zoneRow.rangeCount = stmt.columnInt(8);
+    zoneRow.textInline = stmt.columnText(9);
+    zoneRow.textChecksum = stmt.columnText(10);
+    zoneRow.binChecksum = stmt.columnText(11);
+    zoneRow.sourceModTime = stmt.columnDateTime(12);
+    zoneRow.lastRun = stmt.columnDateTime(13);
+    zoneRow.lastSuccess = stmt.columnDateTime(14);
 }
 
 QString ZoneListModel::sqlBase() const
@@ -213,6 +222,7 @@ QString ZoneListModel::sqlBase() const
            "    url,"
            "    form_data,"
            "    address_count,"
+           "    range_count,"
            "    text_inline,"
            "    text_checksum,"
            "    bin_checksum,"
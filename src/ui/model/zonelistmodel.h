@@ -49,14 +49,15 @@ protected:
 
     bool updateTableRow(const QVariantHash &vars, int row) const override;
     TableRow &tableRow() const override { return m_zoneRow; }
+    TableRowCacheBase *rowCache() const override { return &m_zoneRows; }
 
-    bool updateZoneRow(const QString &sql, const QVariantHash &vars, ZoneRow &zoneRow) const;
+    static void fillZoneRow(SqliteStmt &stmt, ZoneRow &zoneRow);
 
     QString sqlBase() const override;
 
 private:
     QVariant headerDataDisplay(int section) const;
-    QVariant dataDisplay(const QModelIndex &index) const;
+    QVariant dataDisplay(const QModelIndex &index, int role) const;
     QVariant dataCheckState(const QModelIndex &index) const;
 
     void setupZoneTypes();
@@ -71,6 +72,7 @@ private:
     QVariantHash m_zoneSourcesMap;
 
     mutable ZoneRow m_zoneRow;
+    mutable TableRowCache<ZoneRow> m_zoneRows;
 };
 
 #endif // ZONELISTMODEL_H
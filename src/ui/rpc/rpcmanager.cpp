@@ -8,6 +8,7 @@
 #include <control/controlmanager.h>
 #include <control/controlworker.h>
 #include <fortsettings.h>
+#include <manager/dberrormanager.h>
 #include <manager/windowmanager.h>
 #include <rpc/appinfomanagerrpc.h>
 #include <rpc/autoupdatemanagerrpc.h>
@@ -21,6 +22,8 @@
 #include <rpc/statblockmanagerrpc.h>
 #include <rpc/statmanagerrpc.h>
 #include <rpc/taskmanagerrpc.h>
+#include <stat/statblockmanager.h>
+#include <stat/statmanager.h>
 #include <util/ioc/ioccontainer.h>
 #include <util/osutil.h>
 #include <util/variantutil.h>
@@ -29,6 +32,8 @@ namespace {
 
 const QLoggingCategory LC("rpc");
 
+constexpr int notifyIntervalMsec = 100;
+
 void showErrorBox(const QString &text)
 {
     auto windowManager = IoC<WindowManager>();
@@ -37,15 +42,20 @@ void showErrorBox(const QString &text)
             windowManager, [=] { windowManager->showErrorBox(text); }, Qt::QueuedConnection);
 }
 
+inline bool isClientSubscribed(ControlWorker *w, quint8 topic)
+{
+    return w->isServiceClient() && (topic == Control::Rpc_NoneTopic || (w->topics() & topic) != 0);
+}
+
 inline bool sendCommandDataToClients(
-        const QByteArray &commandData, const QList<ControlWorker *> &clients)
+        const QByteArray &commandData, const QList<ControlWorker *> &clients, quint8 topic)
 {
     bool ok = true;
 
     // XXX: OsUtil::setThreadIsBusy(true);
 
     for (ControlWorker *w : clients) {
-        if (!w->isServiceClient())
+        if (!isClientSubscribed(w, topic))
             continue;
 
         if (!w->sendCommandData(commandData)) {
@@ -59,9 +69,34 @@ inline bool sendCommandDataToClients(
     return ok;
 }
 
+QByteArray buildNotificationsFrame(const QList<RpcNotification> &notifications, quint8 topics)
+{
+    QByteArray frame;
+
+    for (const auto &notification : notifications) {
+        const Control::Command cmd = notification.command;
+        if (cmd == Control::CommandNone)
+            continue; // coalesced
+
+        const quint8 topic = Control::commandNotify(cmd).topic;
+        if (topic != Control::Rpc_NoneTopic && (topics & topic) == 0)
+            continue;
+
+        const QByteArray buffer = ControlWorker::buildCommandData(cmd, notification.args);
+        if (buffer.isEmpty()) {
+            qCWarning(LC) << "Bad RPC command to notify:" << cmd << notification.args;
+            continue;
+        }
+
+        frame += buffer;
+    }
+
+    return frame;
+}
+
 }
 
-RpcManager::RpcManager(QObject *parent) : QObject(parent) { }
+RpcManager::RpcManager(QObject *parent) : QObject(parent), m_notifyTimer(notifyIntervalMsec) { }
 
 void RpcManager::setUp()
 {
@@ -79,6 +114,8 @@ void RpcManager::tearDown()
 
 void RpcManager::setupServerSignals()
 {
+    connect(&m_notifyTimer, &QTimer::timeout, this, &RpcManager::flushNotifications);
+
     AppInfoManagerRpc::setupServerSignals(this);
     AutoUpdateManagerRpc::setupServerSignals(this);
     ConfManagerRpc::setupServerSignals(this);
@@ -98,8 +135,17 @@ void RpcManager::setupClient()
 
     m_client = controlManager->newServiceClient(this);
 
-    connect(client(), &ControlWorker::connected, this,
-            [&] { invokeOnServer(Control::Rpc_RpcManager_initClient); });
+    connect(client(), &ControlWorker::connected, this, [&] {
+        invokeOnServer(Control::Rpc_RpcManager_initClient);
+        subscribeClientTopics();
+    });
+
+    connect(IoC<WindowManager>(), &WindowManager::windowVisibilityChanged, this,
+            &RpcManager::updateClientTopics);
+    connect(IoC<StatManager>(), &StatManager::statFeedAttached, this,
+            &RpcManager::updateClientTopics);
+
+    updateClientTopics();
 
     client()->setIsTryReconnect(true);
     client()->reconnectToServer();
@@ -114,6 +160,42 @@ void RpcManager::closeClient()
     client()->close();
 }
 
+void RpcManager::updateClientTopics()
+{
+    auto windowManager = IoC<WindowManager>();
+
+    quint8 topics = Control::Rpc_NoneTopic;
+
+    // The traffic is read from the stat feed, when it's available
+    if (windowManager->isWindowOpen(WindowGraph) && !IoC<StatManager>()->isStatFeedAttached()) {
+        topics |= Control::Rpc_TrafficTopic;
+    }
+    if (windowManager->isWindowOpen(WindowStatistics)) {
+        topics |= Control::Rpc_ConnTopic;
+    }
+
+    if (m_clientTopics == topics)
+        return;
+
+    const quint8 addedTopics = (topics & ~m_clientTopics);
+
+    m_clientTopics = topics;
+
+    if (client()->isConnected()) {
+        subscribeClientTopics();
+    }
+
+    // Refresh the connections changed while unsubscribed
+    if ((addedTopics & Control::Rpc_ConnTopic) != 0) {
+        emit IoC<StatBlockManager>()->connChanged();
+    }
+}
+
+void RpcManager::subscribeClientTopics()
+{
+    invokeOnServer(Control::Rpc_RpcManager_subscribe, { quint32(m_clientTopics) });
+}
+
 bool RpcManager::waitResult()
 {
     m_resultCommand = Control::CommandNone;
@@ -172,6 +254,14 @@ void RpcManager::invokeOnClients(Control::Command cmd, const QVariantList &args)
     if (clients.isEmpty())
         return;
 
+    if (addNotification(cmd, args)) {
+        m_notifyTimer.startTrigger();
+        return;
+    }
+
+    // Keep the notifications' order
+    flushNotifications();
+
     const QByteArray buffer = ControlWorker::buildCommandData(cmd, args);
     if (buffer.isEmpty()) {
         qCWarning(LC) << "Bad RPC command to invoke:" << cmd << args;
@@ -180,11 +270,90 @@ void RpcManager::invokeOnClients(Control::Command cmd, const QVariantList &args)
 
     // DBG: qCDebug(LC) << "Invoke On Clients:" << cmd << args.size() << clients.size();
 
-    if (!sendCommandDataToClients(buffer, clients)) {
+    if (!sendCommandDataToClients(buffer, clients, Control::commandNotify(cmd).topic)) {
         qCWarning(LC) << "Invoke on clients error:" << cmd << args;
     }
 }
 
+void RpcManager::flushNotifications()
+{
+    m_notifyTimer.stop();
+
+    if (m_notifications.isEmpty())
+        return;
+
+    QList<RpcNotification> notifications;
+    notifications.swap(m_notifications);
+
+    m_notificationIndexes.clear();
+
+    // Build the frame once per the clients' topics
+    QHash<quint8, QByteArray> topicFrames;
+
+    const auto &clients = IoC<ControlManager>()->clients();
+
+    for (ControlWorker *w : clients) {
+        if (!w->isServiceClient())
+            continue;
+
+        const quint8 topics = w->topics();
+
+        auto it = topicFrames.find(topics);
+        if (it == topicFrames.end()) {
+            it = topicFrames.insert(topics, buildNotificationsFrame(notifications, topics));
+        }
+
+        const QByteArray &frame = it.value();
+        if (frame.isEmpty())
+            continue;
+
+        if (!w->sendCommandData(frame)) {
+            qCWarning(LC) << "Send notifications error:" << w->id() << w->errorString();
+        }
+    }
+}
+
+bool RpcManager::addNotification(Control::Command cmd, const QVariantList &args)
+{
+    const Control::NotifyMode mode = Control::commandNotify(cmd).mode;
+    if (mode == Control::NotifyDirect)
+        return false;
+
+    const int index = m_notificationIndexes.value(cmd, -1);
+    if (index >= 0) {
+        RpcNotification &notification = m_notifications[index];
+
+        if (mode == Control::NotifyLatest) {
+            // Send the latest one in its place
+            notification.command = Control::CommandNone;
+        } else if (notification.args.value(0) == args.value(0)) {
+            // Sum the values with the same key
+            for (int i = 1; i < args.size(); ++i) {
+                notification.args[i] =
+                        notification.args.value(i).toLongLong() + args[i].toLongLong();
+            }
+            return true;
+        }
+    }
+
+    m_notificationIndexes.insert(cmd, m_notifications.size());
+    m_notifications.append({ .command = cmd, .args = args });
+
+    return true;
+}
+
+bool RpcManager::getDbStats(QVariantList &dbStats, int topCount)
+{
+    QVariantList resArgs;
+
+    if (!doOnServer(Control::Rpc_RpcManager_getDbStats, { topCount }, &resArgs))
+        return false;
+
+    dbStats = resArgs.value(0).toList();
+
+    return true;
+}
+
 bool RpcManager::checkClientValidated(ControlWorker *w) const
 {
     return !IoC<FortSettings>()->isPasswordRequired() || w->isClientValidated();
@@ -198,6 +367,21 @@ void RpcManager::initClientOnServer(ControlWorker *w) const
     DriverManagerRpc::processInitClient(w);
 }
 
+void RpcManager::subscribeClientOnServer(ControlWorker *w, quint8 topics) const
+{
+    w->setTopics(topics);
+}
+
+void RpcManager::sendDbStatsOnServer(ControlWorker *w, int topCount)
+{
+    if (!checkClientValidated(w)) {
+        sendResult(w, false);
+        return;
+    }
+
+    sendResult(w, true, { IoC<DbErrorManager>()->dbStats(topCount) });
+}
+
 bool RpcManager::processCommandRpc(const ProcessCommandArgs &p)
 {
     switch (p.command) {
@@ -211,6 +395,14 @@ bool RpcManager::processCommandRpc(const ProcessCommandArgs &p)
         initClientOnServer(p.worker);
         return true;
     }
+    case Control::Rpc_RpcManager_subscribe: {
+        subscribeClientOnServer(p.worker, p.args.value(0).toUInt());
+        return true;
+    }
+    case Control::Rpc_RpcManager_getDbStats: {
+        sendDbStatsOnServer(p.worker, p.args.value(0).toInt());
+        return true;
+    }
     default:
         return processManagerRpc(p);
     }
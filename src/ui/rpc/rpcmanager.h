@@ -1,15 +1,23 @@
 #ifndef RPCMANAGER_H
 #define RPCMANAGER_H
 
+#include <QHash>
 #include <QObject>
 #include <QVariant>
 
 #include <control/control.h>
 #include <util/ioc/iocservice.h>
+#include <util/triggertimer.h>
 
 struct ProcessCommandArgs;
 class ControlWorker;
 
+struct RpcNotification
+{
+    Control::Command command = Control::CommandNone;
+    QVariantList args;
+};
+
 using processManager_func = bool (*)(
         const ProcessCommandArgs &p, QVariantList &resArgs, bool &ok, bool &isSendResult);
 
@@ -35,10 +43,15 @@ public:
     bool doOnServer(
             Control::Command cmd, const QVariantList &args = {}, QVariantList *resArgs = nullptr);
 
+    // Notifications are coalesced and sent to the subscribed clients in one frame per tick
     void invokeOnClients(Control::Command cmd, const QVariantList &args = {});
+    void flushNotifications();
 
     bool processCommandRpc(const ProcessCommandArgs &p);
 
+    // Diagnostics: per SQL statement stats of the service's databases, the slowest first
+    bool getDbStats(QVariantList &dbStats, int topCount = 0);
+
     template<typename F>
     constexpr static F *getProcessFunc(
             Control::Command command, F *const funcList[], int minIndex, int maxIndex)
@@ -56,8 +69,15 @@ private:
     void setupClient();
     void closeClient();
 
+    void updateClientTopics();
+    void subscribeClientTopics();
+
+    bool addNotification(Control::Command cmd, const QVariantList &args);
+
     bool checkClientValidated(ControlWorker *w) const;
     void initClientOnServer(ControlWorker *w) const;
+    void subscribeClientOnServer(ControlWorker *w, quint8 topics) const;
+    void sendDbStatsOnServer(ControlWorker *w, int topCount);
 
     bool processManagerRpc(const ProcessCommandArgs &p);
 
@@ -65,7 +85,14 @@ private:
     Control::Command m_resultCommand = Control::CommandNone;
     QVariantList m_resultArgs;
 
+    quint8 m_clientTopics = Control::Rpc_NoneTopic;
+
     ControlWorker *m_client = nullptr;
+
+    QList<RpcNotification> m_notifications;
+    QHash<Control::Command, int> m_notificationIndexes;
+
+    TriggerTimer m_notifyTimer;
 };
 
 #endif // RPCMANAGER_H
@@ -2,6 +2,8 @@
 
 #include <sqlite/sqlitedb.h>
 
+#include <conf/confmanager.h>
+#include <conf/firewallconf.h>
 #include <rpc/rpcmanager.h>
 #include <util/ioc/ioccontainer.h>
 
@@ -27,6 +29,10 @@ bool processStatManager_appCreated(StatManager *statManager, const ProcessComman
 
 bool processStatManager_trafficAdded(StatManager *statManager, const ProcessCommandArgs &p)
 {
+    // Read from the stat feed
+    if (statManager->isStatFeedAttached())
+        return true;
+
     emit statManager->trafficAdded(
             p.args.value(0).toLongLong(), p.args.value(1).toUInt(), p.args.value(2).toUInt());
     return true;
@@ -59,6 +65,8 @@ inline bool processStatManagerRpcSignal(StatManager *statManager, const ProcessC
     return func ? func(statManager, p) : false;
 }
 
+constexpr int statFeedReadIntervalMsec = 250;
+
 inline bool processStatManagerRpcResult(StatManager *statManager, const ProcessCommandArgs &p)
 {
     switch (p.command) {
@@ -80,6 +88,46 @@ StatManagerRpc::StatManagerRpc(const QString &filePath, QObject *parent) :
 {
 }
 
+void StatManagerRpc::setupStatFeed()
+{
+    setStatFeed(new StatFeed());
+
+    connect(&m_statFeedTimer, &QTimer::timeout, this, &StatManagerRpc::readStatFeed);
+
+    m_statFeedTimer.start(statFeedReadIntervalMsec);
+}
+
+int StatManagerRpc::monthStart() const
+{
+    // The service's conf is not set for the clients
+    const FirewallConf *conf = IoC<ConfManager>()->conf();
+
+    return conf ? conf->ini().monthStart() : 1;
+}
+
+void StatManagerRpc::readStatFeed()
+{
+    // The service may start later
+    if (!isStatFeedAttached()) {
+        if (!statFeed()->attach())
+            return;
+
+        emit statFeedAttached();
+    }
+
+    if (statFeed()->version() == m_statFeedVersion)
+        return;
+
+    if (!statFeed()->read(m_statFeedSnapshot, m_statFeedVersion))
+        return;
+
+    m_statFeedVersion = m_statFeedSnapshot.version;
+
+    for (const auto &traf : std::as_const(m_statFeedSnapshot.trafs)) {
+        emit trafficAdded(traf.unixTime, traf.inBytes, traf.outBytes);
+    }
+}
+
 bool StatManagerRpc::deleteStatApp(qint64 appId)
 {
     return IoC<RpcManager>()->doOnServer(Control::Rpc_StatManager_deleteStatApp, { appId });
@@ -1,6 +1,8 @@
 #ifndef STATMANAGERRPC_H
 #define STATMANAGERRPC_H
 
+#include <QTimer>
+
 #include <stat/statmanager.h>
 
 class RpcManager;
@@ -20,6 +22,9 @@ public:
 
     bool resetAppTrafTotals() override;
 
+    // The apps' traffic of the last read from the stat feed
+    const StatFeedSnapshot &statFeedSnapshot() const { return m_statFeedSnapshot; }
+
     static bool processServerCommand(
             const ProcessCommandArgs &p, QVariantList &resArgs, bool &ok, bool &isSendResult);
 
@@ -27,6 +32,22 @@ public:
 
 public slots:
     bool clearTraffic() override;
+
+protected:
+    void setupWorker() override { }
+    void setupStatFeed() override;
+
+    int monthStart() const override;
+
+private:
+    void readStatFeed();
+
+private:
+    quint32 m_statFeedVersion = 0;
+
+    StatFeedSnapshot m_statFeedSnapshot;
+
+    QTimer m_statFeedTimer;
 };
 
 #endif // STATMANAGERRPC_H
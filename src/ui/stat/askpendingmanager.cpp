@@ -14,11 +14,14 @@ namespace {
 
 const QLoggingCategory LC("pendingManager");
 
+constexpr int maxBlockedIpCount = 1000;
+
 }
 
 AskPendingManager::AskPendingManager(QObject *parent) :
     QObject(parent), m_sqliteDb(new SqliteDb(":memory:"))
 {
+    connect(&m_flushTimer, &QTimer::timeout, this, &AskPendingManager::flushBlockedIps);
 }
 
 void AskPendingManager::setUp()
@@ -49,6 +52,82 @@ bool AskPendingManager::setupDb()
 
 void AskPendingManager::logBlockedIp(const LogEntryBlockedIp &entry)
 {
-    // TODO
-    Q_UNUSED(entry);
+    if (m_blockedIps.size() >= maxBlockedIpCount)
+        return; // drop excessive data
+
+    m_blockedIps.append(entry);
+
+    m_flushTimer.startTrigger();
+}
+
+void AskPendingManager::flushBlockedIps()
+{
+    if (m_blockedIps.isEmpty())
+        return;
+
+    const QVector<LogEntryBlockedIp> entries = m_blockedIps;
+    m_blockedIps.clear();
+
+    QHash<qint64, int> appConnCounts; // appId -> inserted connections count
+
+    sqliteDb()->beginWriteTransaction();
+
+    SqliteStmt *stmt = sqliteDb()->stmt(StatSql::sqlInsertConnBlock);
+
+    for (const LogEntryBlockedIp &entry : entries) {
+        const qint64 appId = getOrCreateAppId(entry.path(), entry.connTime());
+        if (appId == INVALID_APP_ID)
+            continue;
+
+        LogBlockedIpJob::bindConn(stmt, 1, entry, appId);
+
+        if (sqliteDb()->done(stmt)) {
+            ++appConnCounts[appId];
+        }
+    }
+
+    // Update the connections counts of apps once per batch
+    for (auto it = appConnCounts.constBegin(); it != appConnCounts.constEnd(); ++it) {
+        updateAppConnCount(it.key(), it.value());
+    }
+
+    if (!sqliteDb()->endTransaction()) {
+        qCWarning(LC) << "Insert error:" << sqliteDb()->errorMessage();
+
+        // The new apps are rolled back
+        m_appIds.clear();
+    }
+}
+
+qint64 AskPendingManager::getOrCreateAppId(const QString &appPath, qint64 unixTime)
+{
+    const qint64 appId = m_appIds.value(appPath, INVALID_APP_ID);
+    if (appId != INVALID_APP_ID)
+        return appId;
+
+    // The database is recreated on start: the cache has all apps
+    SqliteStmt *stmt = sqliteDb()->stmt(StatSql::sqlInsertAppId);
+
+    stmt->bindText(1, appPath);
+    stmt->bindInt64(2, unixTime);
+
+    if (!sqliteDb()->done(stmt))
+        return INVALID_APP_ID;
+
+    const qint64 newAppId = sqliteDb()->lastInsertRowid();
+
+    m_appIds.insert(appPath, newAppId);
+
+    return newAppId;
+}
+
+void AskPendingManager::updateAppConnCount(qint64 appId, int delta)
+{
+    SqliteStmt *stmt = sqliteDb()->stmt(StatSql::sqlUpdateAppConnCount);
+
+    stmt->bindInt64(1, appId);
+    stmt->bindInt(2, delta);
+
+    stmt->step();
+    stmt->reset();
 }
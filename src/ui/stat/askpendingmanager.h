@@ -1,20 +1,24 @@
 #ifndef ASKPENDINGMANAGER_H
 #define ASKPENDINGMANAGER_H
 
+#include <QHash>
 #include <QObject>
+#include <QVector>
 
 #include <sqlite/sqlite_types.h>
 
+#include <log/logentryblockedip.h>
 #include <util/classhelpers.h>
 #include <util/ioc/iocservice.h>
-
-class LogEntryBlockedIp;
+#include <util/triggertimer.h>
 
 class AskPendingManager : public QObject, public IocService
 {
     Q_OBJECT
 
 public:
+    static constexpr qint64 INVALID_APP_ID = Q_INT64_C(-1);
+
     explicit AskPendingManager(QObject *parent = nullptr);
     CLASS_DELETE_COPY_MOVE(AskPendingManager)
 
@@ -22,13 +26,26 @@ public:
 
     void setUp() override;
 
+    // The entries are inserted in batches by the timer
     void logBlockedIp(const LogEntryBlockedIp &entry);
 
+public slots:
+    void flushBlockedIps();
+
 private:
     bool setupDb();
 
+    qint64 getOrCreateAppId(const QString &appPath, qint64 unixTime);
+    void updateAppConnCount(qint64 appId, int delta);
+
 private:
     SqliteDbPtr m_sqliteDb;
+
+    QVector<LogEntryBlockedIp> m_blockedIps;
+
+    QHash<QString, qint64> m_appIds; // appPath -> appId
+
+    TriggerTimer m_flushTimer;
 };
 
 #endif // ASKPENDINGMANAGER_H
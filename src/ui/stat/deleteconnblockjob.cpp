@@ -31,19 +31,18 @@ void DeleteConnBlockJob::processJob()
 
     sqliteDb()->beginWriteTransaction();
 
-    SqliteStmtList stmtList;
     if (isDeleteAll) {
-        stmtList = { getStmt(StatSql::sqlDeleteAllConnBlock), getStmt(StatSql::sqlDeleteAllApps) };
+        DbUtil::doList(
+                { getStmt(StatSql::sqlDeleteAllConnBlock), getStmt(StatSql::sqlDeleteAllApps) });
     } else {
-        stmtList = { getIdStmt(StatSql::sqlDeleteConnBlock, connIdTo()),
-            getStmt(StatSql::sqlDeleteConnBlockApps) };
+        deleteConns(connIdTo());
     }
 
-    DbUtil::doList(stmtList);
-
     sqliteDb()->commitTransaction();
 
     if (isDeleteAll) {
+        manager()->clearAppIdCache();
+
         sqliteDb()->vacuum(); // Vacuum outside of transaction
     }
 
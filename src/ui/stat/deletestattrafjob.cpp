@@ -0,0 +1,146 @@
+#include "deletestattrafjob.h"
+
+#include <sqlite/dbutil.h>
+#include <sqlite/sqlitedb.h>
+#include <sqlite/sqlitestmt.h>
+
+#include "statmanager.h"
+#include "statsql.h"
+#include "trafsegmentstore.h"
+
+DeleteStatTrafJob::DeleteStatTrafJob(DeleteType deleteType, qint64 id) :
+    m_deleteType(deleteType), m_id(id)
+{
+}
+
+void DeleteStatTrafJob::setOldTrafTimes(qint32 oldTrafHour, qint32 oldTrafDay, qint32 oldTrafMonth)
+{
+    m_oldTrafHour = oldTrafHour;
+    m_oldTrafDay = oldTrafDay;
+    m_oldTrafMonth = oldTrafMonth;
+}
+
+bool DeleteStatTrafJob::processMerge(const StatBaseJob & /*statJob*/)
+{
+    return false;
+}
+
+void DeleteStatTrafJob::processJob()
+{
+    bool ok = false;
+
+    switch (deleteType()) {
+    case DeleteOldTraffic: {
+        ok = deleteOldTraffic();
+    } break;
+    case DeleteAppTraffic: {
+        ok = deleteAppTraffic();
+    } break;
+    case DeleteAllTraffic: {
+        ok = deleteAllTraffic();
+    } break;
+    case ResetAppTrafTotals: {
+        ok = resetAppTrafTotals();
+    } break;
+    }
+
+    setResultCount(ok ? 1 : 0);
+}
+
+void DeleteStatTrafJob::emitFinished()
+{
+    switch (deleteType()) {
+    case DeleteAppTraffic: {
+        emit manager()->appStatRemoved(id());
+    } break;
+    case DeleteAllTraffic: {
+        emit manager()->trafficCleared();
+    } break;
+    case ResetAppTrafTotals: {
+        emit manager()->appTrafTotalsResetted();
+    } break;
+    default:
+        break;
+    }
+}
+
+bool DeleteStatTrafJob::deleteOldTraffic()
+{
+    SqliteStmtList deleteTrafStmts;
+
+    // Traffic Hour
+    if (m_oldTrafHour >= 0) {
+        deleteTrafStmts << getTrafficStmt(StatSql::sqlDeleteTrafAppHour, m_oldTrafHour)
+                        << getTrafficStmt(StatSql::sqlDeleteTrafHour, m_oldTrafHour);
+
+        // Drop the whole days' segments
+        manager()->trafStore()->removeBefore(m_oldTrafHour);
+    }
+
+    // Traffic Day
+    if (m_oldTrafDay >= 0) {
+        deleteTrafStmts << getTrafficStmt(StatSql::sqlDeleteTrafAppDay, m_oldTrafDay)
+                        << getTrafficStmt(StatSql::sqlDeleteTrafDay, m_oldTrafDay);
+    }
+
+    // Traffic Month
+    if (m_oldTrafMonth >= 0) {
+        deleteTrafStmts << getTrafficStmt(StatSql::sqlDeleteTrafAppMonth, m_oldTrafMonth)
+                        << getTrafficStmt(StatSql::sqlDeleteTrafMonth, m_oldTrafMonth);
+    }
+
+    sqliteDb()->beginWriteTransaction();
+
+    DbUtil::doList(deleteTrafStmts);
+
+    sqliteDb()->commitTransaction();
+
+    return true;
+}
+
+bool DeleteStatTrafJob::deleteAppTraffic()
+{
+    const qint64 appId = id();
+
+    sqliteDb()->beginWriteTransaction();
+
+    DbUtil::doList({ getIdStmt(StatSql::sqlDeleteAppTrafHour, appId),
+            getIdStmt(StatSql::sqlDeleteAppTrafDay, appId),
+            getIdStmt(StatSql::sqlDeleteAppTrafMonth, appId),
+            getIdStmt(StatSql::sqlDeleteAppTrafTotal, appId) });
+
+    manager()->deleteAppId(appId);
+
+    sqliteDb()->commitTransaction();
+
+    manager()->trafStore()->removeApp(appId);
+
+    return true;
+}
+
+bool DeleteStatTrafJob::deleteAllTraffic()
+{
+    sqliteDb()->beginWriteTransaction();
+
+    bool ok = sqliteDb()->execute(StatSql::sqlDeleteAllTraffic);
+
+    ok = sqliteDb()->endTransaction(ok);
+
+    if (!ok)
+        return false;
+
+    sqliteDb()->vacuum(); // Vacuum outside of transaction
+
+    manager()->trafStore()->clear();
+
+    manager()->clearAppIdCache();
+
+    return true;
+}
+
+bool DeleteStatTrafJob::resetAppTrafTotals()
+{
+    SqliteStmt *stmt = getTrafficStmt(StatSql::sqlResetAppTrafTotals, qint32(id()));
+
+    return sqliteDb()->done(stmt);
+}
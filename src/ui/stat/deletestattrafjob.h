@@ -0,0 +1,49 @@
+#ifndef DELETESTATTRAFJOB_H
+#define DELETESTATTRAFJOB_H
+
+#include "statbasejob.h"
+
+class DeleteStatTrafJob : public StatBaseJob
+{
+public:
+    enum DeleteType : qint8 {
+        DeleteOldTraffic = 0,
+        DeleteAppTraffic,
+        DeleteAllTraffic,
+        ResetAppTrafTotals,
+    };
+
+    explicit DeleteStatTrafJob(DeleteType deleteType, qint64 id = 0);
+
+    DeleteType deleteType() const { return m_deleteType; }
+
+    // App ID or the traffic hour
+    qint64 id() const { return m_id; }
+
+    // Delete the older rows, the negative time keeps all
+    void setOldTrafTimes(qint32 oldTrafHour, qint32 oldTrafDay, qint32 oldTrafMonth);
+
+    StatJobType jobType() const override { return JobTypeDeleteTraf; }
+
+protected:
+    bool processMerge(const StatBaseJob &statJob) override;
+    void processJob() override;
+    void emitFinished() override;
+
+private:
+    bool deleteOldTraffic();
+    bool deleteAppTraffic();
+    bool deleteAllTraffic();
+    bool resetAppTrafTotals();
+
+private:
+    DeleteType m_deleteType = DeleteOldTraffic;
+
+    qint32 m_oldTrafHour = -1;
+    qint32 m_oldTrafDay = -1;
+    qint32 m_oldTrafMonth = -1;
+
+    qint64 m_id = 0;
+};
+
+#endif // DELETESTATTRAFJOB_H
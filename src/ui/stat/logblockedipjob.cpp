@@ -12,12 +12,73 @@
 
 namespace {
 
-constexpr qint64 INVALID_APP_ID = Q_INT64_C(-1);
+constexpr qint64 INVALID_APP_ID = StatBlockManager::INVALID_APP_ID;
 constexpr int MAX_LOG_BLOCKED_IP_MERGE_COUNT = 1000;
 
+// Rows of a multi-row statement: 64 * 13 parameters fit the SQLite's default limit of 999
+constexpr int BULK_ROW_COUNT = 64;
+constexpr int CONN_BLOCK_COLUMN_COUNT = 13;
+
+QByteArray makeParams(int &index, int count)
+{
+    QByteArray params;
+    for (int i = 0; i < count; ++i) {
+        if (i > 0) {
+            params += ", ";
+        }
+        params += '?' + QByteArray::number(++index);
+    }
+    return params;
+}
+
+QByteArray makeRowsValues(int rowCount, int columnCount)
+{
+    QByteArray values;
+    int index = 0;
+    for (int row = 0; row < rowCount; ++row) {
+        if (row > 0) {
+            values += ", ";
+        }
+        values += '(' + makeParams(index, columnCount) + ')';
+    }
+    return values;
+}
+
+const char *sqlSelectAppIds()
+{
+    static const QByteArray sql = [] {
+        int index = 0;
+        return "SELECT app_id, path FROM app WHERE path IN ("
+                + makeParams(index, BULK_ROW_COUNT) + ");";
+    }();
+
+    return sql.constData();
 }
 
-LogBlockedIpJob::LogBlockedIpJob(const LogEntryBlockedIp &entry)
+const char *sqlInsertAppIds()
+{
+    static const QByteArray sql = "INSERT INTO app(path, creat_time) VALUES "
+            + makeRowsValues(BULK_ROW_COUNT, 2)
+            + " ON CONFLICT(path) DO NOTHING RETURNING app_id, path;";
+
+    return sql.constData();
+}
+
+const char *sqlInsertConnBlocks()
+{
+    static const QByteArray sql =
+            "INSERT INTO conn_block(app_id, conn_time, process_id, inbound, inherited,"
+            "    ip_proto, local_port, remote_port, local_ip, remote_ip,"
+            "    local_ip6, remote_ip6, block_reason) VALUES "
+            + makeRowsValues(BULK_ROW_COUNT, CONN_BLOCK_COLUMN_COUNT) + ';';
+
+    return sql.constData();
+}
+
+}
+
+LogBlockedIpJob::LogBlockedIpJob(const LogEntryBlockedIp &entry, int keepCount) :
+    m_keepCount(keepCount)
 {
     m_entries.append(entry);
 }
@@ -30,25 +91,32 @@ bool LogBlockedIpJob::processMerge(const StatBlockBaseJob &statJob)
         return false;
 
     m_entries.append(job.entries());
+    m_keepCount = job.keepCount();
 
     return true;
 }
 
 void LogBlockedIpJob::processJob()
 {
-    int resultCount = 0;
+    QVector<qint64> appIds;
 
     sqliteDb()->beginWriteTransaction();
 
-    for (const LogEntryBlockedIp &entry : entries()) {
-        if (processEntry(entry)) {
-            ++resultCount;
-        }
-    }
+    resolveAppIds(appIds);
+
+    const int resultCount = insertConns(appIds);
+
+    trimConns();
 
-    sqliteDb()->endTransaction();
+    const bool ok = sqliteDb()->endTransaction();
 
-    setResultCount(resultCount);
+    // The rolled back apps must not be cached
+    if (ok) {
+        cacheNewAppIds();
+    }
+    m_newAppIdMap.clear();
+
+    setResultCount(ok ? resultCount : 0);
 }
 
 void LogBlockedIpJob::emitFinished()
@@ -56,94 +124,237 @@ void LogBlockedIpJob::emitFinished()
     emit manager()->logBlockedIpFinished(resultCount(), m_connId);
 }
 
-bool LogBlockedIpJob::processEntry(const LogEntryBlockedIp &entry)
+void LogBlockedIpJob::resolveAppIds(QVector<qint64> &appIds)
 {
-    const qint64 appId = getOrCreateAppId(entry.path(), entry.connTime());
-    if (appId == INVALID_APP_ID)
-        return false;
+    QStringList entryPaths;
+    entryPaths.reserve(m_entries.size());
 
-    const qint64 connId = insertConn(entry, appId);
-    if (connId <= 0)
-        return false;
+    AppIdHash appIdMap;
+    QStringList appPaths;
+    QVector<qint64> unixTimes;
 
-    if (m_connId < connId) {
-        m_connId = connId;
+    // Deduplicate the paths and look up the cache
+    for (const LogEntryBlockedIp &entry : entries()) {
+        const QString appPath = entry.path();
+        entryPaths.append(appPath);
+
+        if (appIdMap.contains(appPath))
+            continue;
+
+        const qint64 appId = manager()->getCachedAppId(appPath);
+        appIdMap.insert(appPath, appId);
+
+        if (appId == INVALID_APP_ID) {
+            appPaths.append(appPath);
+            unixTimes.append(entry.connTime());
+        }
     }
 
-    return true;
+    if (!appPaths.isEmpty()) {
+        selectAppIds(appPaths, appIdMap);
+
+        // Create the missing apps
+        QStringList newPaths;
+        QVector<qint64> newTimes;
+
+        for (int i = 0; i < appPaths.size(); ++i) {
+            if (appIdMap.value(appPaths[i]) == INVALID_APP_ID) {
+                newPaths.append(appPaths[i]);
+                newTimes.append(unixTimes[i]);
+            }
+        }
+
+        if (!newPaths.isEmpty()) {
+            insertAppIds(newPaths, newTimes, appIdMap);
+        }
+
+        for (const QString &appPath : std::as_const(appPaths)) {
+            const qint64 appId = appIdMap.value(appPath);
+            if (appId != INVALID_APP_ID) {
+                m_newAppIdMap.insert(appPath, appId);
+            }
+        }
+    }
+
+    appIds.reserve(entryPaths.size());
+
+    for (const QString &appPath : std::as_const(entryPaths)) {
+        appIds.append(appIdMap.value(appPath, INVALID_APP_ID));
+    }
 }
 
-qint64 LogBlockedIpJob::getAppId(const QString &appPath)
+void LogBlockedIpJob::cacheNewAppIds()
 {
-    qint64 appId = INVALID_APP_ID;
+    for (auto it = m_newAppIdMap.constBegin(); it != m_newAppIdMap.constEnd(); ++it) {
+        manager()->addCachedAppId(it.key(), it.value());
+    }
+}
 
-    SqliteStmt *stmt = getStmt(StatSql::sqlSelectAppId);
+void LogBlockedIpJob::removeCachedAppId(const QString &appPath)
+{
+    // The app is deleted by the trim in the same transaction
+    m_newAppIdMap.remove(appPath);
 
-    stmt->bindText(1, appPath);
-    if (stmt->step() == SqliteStmt::StepRow) {
-        appId = stmt->columnInt64();
+    StatBlockBaseJob::removeCachedAppId(appPath);
+}
+
+void LogBlockedIpJob::selectAppIds(const QStringList &appPaths, AppIdHash &appIdMap)
+{
+    SqliteStmt *stmt = getStmt(sqlSelectAppIds());
+
+    const int count = appPaths.size();
+
+    for (int from = 0; from < count; from += BULK_ROW_COUNT) {
+        for (int i = 0; i < BULK_ROW_COUNT; ++i) {
+            const int index = from + i;
+            if (index < count) {
+                stmt->bindText(i + 1, appPaths[index]);
+            } else {
+                stmt->bindNull(i + 1); // never matches
+            }
+        }
+
+        while (stmt->step() == SqliteStmt::StepRow) {
+            appIdMap.insert(stmt->columnText(1), stmt->columnInt64(0));
+        }
+        stmt->reset();
     }
-    stmt->reset();
+}
+
+void LogBlockedIpJob::insertAppIds(
+        const QStringList &appPaths, const QVector<qint64> &unixTimes, AppIdHash &appIdMap)
+{
+    SqliteStmt *stmt = getStmt(sqlInsertAppIds());
 
-    return appId;
+    const int count = appPaths.size();
+
+    for (int from = 0; from < count; from += BULK_ROW_COUNT) {
+        for (int i = 0; i < BULK_ROW_COUNT; ++i) {
+            // Pad with the last app: the duplicates are ignored on conflict
+            const int index = qMin(from + i, count - 1);
+
+            stmt->bindText(i * 2 + 1, appPaths[index]);
+            stmt->bindInt64(i * 2 + 2, unixTimes[index]);
+        }
+
+        while (stmt->step() == SqliteStmt::StepRow) {
+            appIdMap.insert(stmt->columnText(1), stmt->columnInt64(0));
+        }
+        stmt->reset();
+    }
 }
 
-qint64 LogBlockedIpJob::createAppId(const QString &appPath, qint64 unixTime)
+int LogBlockedIpJob::insertConns(const QVector<qint64> &appIds)
 {
-    SqliteStmt *stmt = getStmt(StatSql::sqlInsertAppId);
+    QVector<int> indexes; // of the entries having the app id
+    indexes.reserve(appIds.size());
 
-    stmt->bindText(1, appPath);
-    stmt->bindInt64(2, unixTime);
+    for (int i = 0; i < appIds.size(); ++i) {
+        if (appIds[i] != INVALID_APP_ID) {
+            indexes.append(i);
+        }
+    }
+
+    const int count = indexes.size();
+
+    AppConnCountHash appConnCounts;
+    int resultCount = 0;
+    int from = 0;
 
-    if (sqliteDb()->done(stmt)) {
-        return sqliteDb()->lastInsertRowid();
+    // Insert the full blocks of rows
+    for (; from + BULK_ROW_COUNT <= count; from += BULK_ROW_COUNT) {
+        resultCount += insertConnRows(indexes, from, appIds, appConnCounts);
     }
 
-    return INVALID_APP_ID;
+    // Insert the rest row by row
+    SqliteStmt *stmt = getStmt(StatSql::sqlInsertConnBlock);
+
+    for (; from < count; ++from) {
+        const int index = indexes[from];
+
+        bindConn(stmt, 1, m_entries[index], appIds[index]);
+
+        if (sqliteDb()->done(stmt)) {
+            updateConnId(sqliteDb()->lastInsertRowid());
+            ++appConnCounts[appIds[index]];
+            ++resultCount;
+        }
+    }
+
+    // Update the connections counts of apps once per batch
+    for (auto it = appConnCounts.constBegin(); it != appConnCounts.constEnd(); ++it) {
+        updateAppConnCount(it.key(), it.value());
+    }
+
+    return resultCount;
 }
 
-qint64 LogBlockedIpJob::getOrCreateAppId(const QString &appPath, qint64 unixTime)
+int LogBlockedIpJob::insertConnRows(const QVector<int> &indexes, int from,
+        const QVector<qint64> &appIds, AppConnCountHash &appConnCounts)
 {
-    qint64 appId = getAppId(appPath);
-    if (appId == INVALID_APP_ID) {
-        appId = createAppId(appPath, unixTime);
+    SqliteStmt *stmt = getStmt(sqlInsertConnBlocks());
+
+    for (int i = 0; i < BULK_ROW_COUNT; ++i) {
+        const int index = indexes[from + i];
+
+        bindConn(stmt, i * CONN_BLOCK_COLUMN_COUNT + 1, m_entries[index], appIds[index]);
     }
 
-    Q_ASSERT(appId != INVALID_APP_ID);
+    if (!sqliteDb()->done(stmt))
+        return 0;
+
+    updateConnId(sqliteDb()->lastInsertRowid());
+
+    for (int i = 0; i < BULK_ROW_COUNT; ++i) {
+        ++appConnCounts[appIds[indexes[from + i]]];
+    }
 
-    return appId;
+    return BULK_ROW_COUNT;
 }
 
-qint64 LogBlockedIpJob::insertConn(const LogEntryBlockedIp &entry, qint64 appId)
+void LogBlockedIpJob::trimConns()
 {
-    SqliteStmt *stmt = getStmt(StatSql::sqlInsertConnBlock);
+    if (m_keepCount <= 0)
+        return;
 
-    stmt->bindInt64(1, appId);
-    stmt->bindInt64(2, entry.connTime());
-    stmt->bindInt(3, entry.pid());
-    stmt->bindInt(4, entry.inbound());
-    stmt->bindInt(5, entry.inherited());
-    stmt->bindInt(6, entry.ipProto());
-    stmt->bindInt(7, entry.localPort());
-    stmt->bindInt(8, entry.remotePort());
+    // Keep the window of the last connection ids: the older rows are deleted by the id range
+    const qint64 connIdTo = m_connId - m_keepCount;
+    if (connIdTo <= 0)
+        return;
 
-    if (!entry.isIPv6()) {
-        stmt->bindInt(9, entry.localIp4());
-        stmt->bindInt(10, entry.remoteIp4());
-        stmt->bindNull(11);
-        stmt->bindNull(12);
-    } else {
-        stmt->bindNull(9);
-        stmt->bindNull(10);
-        stmt->bindBlob(11, entry.localIp6());
-        stmt->bindBlob(12, entry.remoteIp6());
+    deleteConns(connIdTo);
+}
+
+void LogBlockedIpJob::updateConnId(qint64 connId)
+{
+    if (m_connId < connId) {
+        m_connId = connId;
     }
+}
 
-    stmt->bindInt(13, entry.blockReason());
+void LogBlockedIpJob::bindConn(
+        SqliteStmt *stmt, int index, const LogEntryBlockedIp &entry, qint64 appId)
+{
+    stmt->bindInt64(index, appId);
+    stmt->bindInt64(index + 1, entry.connTime());
+    stmt->bindInt(index + 2, entry.pid());
+    stmt->bindInt(index + 3, entry.inbound());
+    stmt->bindInt(index + 4, entry.inherited());
+    stmt->bindInt(index + 5, entry.ipProto());
+    stmt->bindInt(index + 6, entry.localPort());
+    stmt->bindInt(index + 7, entry.remotePort());
 
-    if (sqliteDb()->done(stmt)) {
-        return sqliteDb()->lastInsertRowid();
+    if (!entry.isIPv6()) {
+        stmt->bindInt(index + 8, entry.localIp4());
+        stmt->bindInt(index + 9, entry.remoteIp4());
+        stmt->bindNull(index + 10);
+        stmt->bindNull(index + 11);
+    } else {
+        stmt->bindNull(index + 8);
+        stmt->bindNull(index + 9);
+        stmt->bindBlob(index + 10, entry.localIp6());
+        stmt->bindBlob(index + 11, entry.remoteIp6());
     }
 
-    return 0;
+    stmt->bindInt(index + 12, entry.blockReason());
 }
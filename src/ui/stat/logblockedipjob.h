@@ -1,6 +1,8 @@
 #ifndef LOGBLOCKEDIPJOB_H
 #define LOGBLOCKEDIPJOB_H
 
+#include <QHash>
+#include <QStringList>
 #include <QVector>
 
 #include <log/logentryblockedip.h>
@@ -12,30 +14,51 @@ class StatBlockManager;
 class LogBlockedIpJob : public StatBlockBaseJob
 {
 public:
-    explicit LogBlockedIpJob(const LogEntryBlockedIp &entry);
+    explicit LogBlockedIpJob(const LogEntryBlockedIp &entry, int keepCount = 0);
+
+    int keepCount() const { return m_keepCount; }
 
     const QVector<LogEntryBlockedIp> &entries() const { return m_entries; }
 
     StatBlockJobType jobType() const override { return JobTypeBlockedIp; }
 
+    static void bindConn(
+            SqliteStmt *stmt, int index, const LogEntryBlockedIp &entry, qint64 appId);
+
 protected:
     bool processMerge(const StatBlockBaseJob &statJob) override;
     void processJob() override;
     void emitFinished() override;
 
+    void removeCachedAppId(const QString &appPath) override;
+
 private:
-    bool processEntry(const LogEntryBlockedIp &entry);
+    using AppIdHash = QHash<QString, qint64>; // appPath -> appId
+    using AppConnCountHash = QHash<qint64, int>; // appId -> connections count
+
+    void resolveAppIds(QVector<qint64> &appIds);
+    void selectAppIds(const QStringList &appPaths, AppIdHash &appIdMap);
+    void insertAppIds(const QStringList &appPaths, const QVector<qint64> &unixTimes,
+            AppIdHash &appIdMap);
 
-    qint64 getAppId(const QString &appPath);
-    qint64 createAppId(const QString &appPath, qint64 unixTime);
-    qint64 getOrCreateAppId(const QString &appPath, qint64 unixTime = 0);
+    int insertConns(const QVector<qint64> &appIds);
+    int insertConnRows(const QVector<int> &indexes, int from, const QVector<qint64> &appIds,
+            AppConnCountHash &appConnCounts);
 
-    qint64 insertConn(const LogEntryBlockedIp &entry, qint64 appId);
+    void trimConns();
+
+    void cacheNewAppIds();
+
+    void updateConnId(qint64 connId);
 
 private:
+    int m_keepCount = 0;
+
     qint64 m_connId = 0;
 
     QVector<LogEntryBlockedIp> m_entries;
+
+    AppIdHash m_newAppIdMap; // resolved in the transaction, cached after its commit
 };
 
 #endif // LOGBLOCKEDIPJOB_H
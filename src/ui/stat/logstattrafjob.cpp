@@ -0,0 +1,139 @@
+#include "logstattrafjob.h"
+
+#include <sqlite/sqlitedb.h>
+#include <sqlite/sqlitestmt.h>
+
+#include <util/dateutil.h>
+
+#include "statmanager.h"
+#include "statsql.h"
+#include "trafsegmentstore.h"
+
+LogStatTrafJob::LogStatTrafJob(
+        qint32 trafHour, const TrafBytes &trafBytes, const AppTrafBytesHash &appTrafBytes) :
+    m_trafHour(trafHour),
+    m_trafBytes(trafBytes),
+    m_appTrafBytes(appTrafBytes)
+{
+    m_queuedTimer.start();
+}
+
+bool LogStatTrafJob::processMerge(const StatBaseJob &statJob)
+{
+    const auto &job = static_cast<const LogStatTrafJob &>(statJob);
+
+    if (trafHour() != job.trafHour())
+        return false;
+
+    m_trafBytes.add(job.trafBytes());
+
+    for (auto it = job.appTrafBytes().constBegin(); it != job.appTrafBytes().constEnd(); ++it) {
+        m_appTrafBytes[it.key()].add(it.value());
+    }
+
+    return true;
+}
+
+void LogStatTrafJob::processJob()
+{
+    sqliteDb()->beginWriteTransaction();
+
+    // The clock went back: keep the rolled up hours immutable
+    m_trafHour = qMax(m_trafHour, getRollupTrafHour());
+
+    sealAppTrafHours();
+
+    if (!m_appTrafBytes.isEmpty()) {
+        const SqliteStmtList upsertTrafAppStmts = SqliteStmtList()
+                << getTrafficStmt(StatSql::sqlUpsertTrafAppHour, m_trafHour)
+                << getTrafficStmt(StatSql::sqlUpsertTrafAppTotal, m_trafHour);
+
+        updateAppTraffic(upsertTrafAppStmts);
+    }
+
+    if (!m_trafBytes.isEmpty()) {
+        // Days and months are rolled up from the hours
+        const SqliteStmtList upsertTrafStmts = SqliteStmtList()
+                << getTrafficStmt(StatSql::sqlUpsertTrafHour, m_trafHour);
+
+        // Update or insert total bytes
+        updateTrafficList(upsertTrafStmts, m_trafBytes);
+    }
+
+    sqliteDb()->commitTransaction();
+
+    // Time from the enqueueing to the commit
+    m_flushMsec = m_queuedTimer.elapsed();
+
+    setResultCount(1);
+}
+
+void LogStatTrafJob::emitFinished()
+{
+    for (int i = 0; i < m_createdAppIds.size(); ++i) {
+        emit manager()->appCreated(m_createdAppIds[i], m_createdAppPaths[i]);
+    }
+
+    emit manager()->logStatTrafFinished(m_flushMsec);
+}
+
+void LogStatTrafJob::sealAppTrafHours()
+{
+    TrafSegmentStore *trafStore = manager()->trafStore();
+
+    if (!trafStore->isEnabled() || !manager()->checkSealTrafHour(m_trafHour))
+        return;
+
+    // Move the previous hours from the database to the segments
+    SqliteStmt *stmt = getTrafficStmt(StatSql::sqlSelectTrafAppHoursToSeal, m_trafHour);
+
+    bool ok = true;
+    qint32 rowsHour = 0;
+    AppTrafRowList rows;
+
+    const auto appendRows = [&] {
+        if (!rows.isEmpty()) {
+            ok = trafStore->appendHour(rowsHour, rows) && ok;
+            rows.clear();
+        }
+    };
+
+    while (stmt->step() == SqliteStmt::StepRow) {
+        const qint32 trafHour = stmt->columnInt(0);
+        if (trafHour != rowsHour) {
+            appendRows();
+            rowsHour = trafHour;
+        }
+
+        rows.append({ stmt->columnInt64(1), { stmt->columnInt64(2), stmt->columnInt64(3) } });
+    }
+    stmt->reset();
+
+    appendRows();
+
+    // Keep the rows to retry on the next hour
+    if (ok) {
+        sqliteDb()->done(getTrafficStmt(StatSql::sqlDeleteSealedTrafAppHours, m_trafHour));
+    }
+}
+
+void LogStatTrafJob::updateAppTraffic(const SqliteStmtList &upsertStmtList)
+{
+    const qint64 unixTime = DateUtil::getUnixTime();
+
+    for (auto it = m_appTrafBytes.constBegin(); it != m_appTrafBytes.constEnd(); ++it) {
+        const QString &appPath = it.key();
+
+        const qint64 appId = manager()->getOrCreateAppId(appPath, unixTime);
+        if (appId == StatManager::INVALID_APP_ID)
+            continue;
+
+        if (manager()->checkNewTrafApp(appId)) {
+            m_createdAppIds.append(appId);
+            m_createdAppPaths.append(appPath);
+        }
+
+        // Update or insert app bytes
+        updateTrafficList(upsertStmtList, it.value(), appId);
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef LOGSTATTRAFJOB_H
+#define LOGSTATTRAFJOB_H
+
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QVector>
+
+#include "statbasejob.h"
+
+class LogStatTrafJob : public StatBaseJob
+{
+public:
+    explicit LogStatTrafJob(
+            qint32 trafHour, const TrafBytes &trafBytes, const AppTrafBytesHash &appTrafBytes);
+
+    qint32 trafHour() const { return m_trafHour; }
+
+    const TrafBytes &trafBytes() const { return m_trafBytes; }
+    const AppTrafBytesHash &appTrafBytes() const { return m_appTrafBytes; }
+
+    StatJobType jobType() const override { return JobTypeLogTraf; }
+
+protected:
+    bool processMerge(const StatBaseJob &statJob) override;
+    void processJob() override;
+    void emitFinished() override;
+
+private:
+    void sealAppTrafHours();
+
+    void updateAppTraffic(const SqliteStmtList &upsertStmtList);
+
+private:
+    qint32 m_trafHour = 0;
+
+    qint64 m_flushMsec = 0;
+
+    QElapsedTimer m_queuedTimer;
+
+    TrafBytes m_trafBytes;
+    AppTrafBytesHash m_appTrafBytes;
+
+    QVector<qint64> m_createdAppIds;
+    QStringList m_createdAppPaths;
+};
+
+#endif // LOGSTATTRAFJOB_H
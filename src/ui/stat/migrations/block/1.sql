@@ -1,7 +1,8 @@
 CREATE TABLE app(
   app_id INTEGER PRIMARY KEY,
   path TEXT NOT NULL,
-  creat_time INTEGER NOT NULL
+  creat_time INTEGER NOT NULL,
+  conn_count INTEGER NOT NULL DEFAULT 0
 );
 
 CREATE UNIQUE INDEX app_path_uk ON app(path);
@@ -23,5 +24,3 @@ CREATE TABLE conn_block(
   --
   block_reason INTEGER NOT NULL
 );
-
-CREATE INDEX conn_block_app_id_idx ON conn_block(app_id);
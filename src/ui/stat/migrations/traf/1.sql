@@ -54,3 +54,7 @@ CREATE TABLE traffic_month(
   in_bytes INTEGER NOT NULL,
   out_bytes INTEGER NOT NULL
 ) WITHOUT ROWID;
+
+CREATE TABLE traffic_rollup(
+  traf_time INTEGER NOT NULL
+);
@@ -6,8 +6,6 @@
 #include <util/dateutil.h>
 #include <util/ioc/ioccontainer.h>
 
-#include "statsql.h"
-
 QuotaManager::QuotaManager(QObject *parent) : QObject(parent) { }
 
 void QuotaManager::setQuotaDayBytes(qint64 bytes)
@@ -193,9 +191,9 @@ void QuotaManager::setupByConf(const IniOptions &ini)
     auto statManager = IoC<StatManager>();
     qint64 inBytes, outBytes;
 
-    statManager->getTraffic(StatSql::sqlSelectTrafDay, trafDay, inBytes, outBytes);
+    statManager->getTraffic(StatManager::TrafDay, trafDay, inBytes, outBytes);
     setTrafDayBytes(inBytes);
 
-    statManager->getTraffic(StatSql::sqlSelectTrafMonth, trafMonth, inBytes, outBytes);
+    statManager->getTraffic(StatManager::TrafMonth, trafMonth, inBytes, outBytes);
     setTrafMonthBytes(inBytes);
 }
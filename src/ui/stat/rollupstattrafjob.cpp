@@ -0,0 +1,86 @@
+#include "rollupstattrafjob.h"
+
+#include <QVector>
+
+#include <sqlite/dbutil.h>
+#include <sqlite/sqlitedb.h>
+#include <sqlite/sqlitestmt.h>
+
+#include <util/dateutil.h>
+
+#include "statmanager.h"
+#include "statsql.h"
+
+RollupStatTrafJob::RollupStatTrafJob(qint32 trafHour, int monthStart) :
+    m_trafHour(trafHour), m_monthStart(monthStart)
+{
+    setPriority(PriorityLow); // after the logged traffic
+}
+
+bool RollupStatTrafJob::processMerge(const StatBaseJob &statJob)
+{
+    const auto &job = static_cast<const RollupStatTrafJob &>(statJob);
+
+    if (monthStart() != job.monthStart())
+        return false;
+
+    m_trafHour = qMax(m_trafHour, job.trafHour());
+
+    return true;
+}
+
+void RollupStatTrafJob::processJob()
+{
+    sqliteDb()->beginWriteTransaction();
+
+    const qint32 rollupTrafHour = getRollupTrafHour();
+
+    if (rollupTrafHour < m_trafHour) {
+        QVector<qint32> trafHours;
+
+        SqliteStmt *stmt = getTrafficStmt(StatSql::sqlSelectTrafHoursToRollup, rollupTrafHour);
+        stmt->bindInt(2, m_trafHour);
+
+        while (stmt->step() == SqliteStmt::StepRow) {
+            trafHours.append(stmt->columnInt());
+        }
+        stmt->reset();
+
+        for (const qint32 trafHour : trafHours) {
+            rollupTrafHour(trafHour);
+        }
+
+        sqliteDb()->done(getTrafficStmt(StatSql::sqlUpdateTrafRollupTime, m_trafHour));
+    }
+
+    sqliteDb()->commitTransaction();
+
+    setResultCount(1);
+}
+
+void RollupStatTrafJob::emitFinished()
+{
+    emit manager()->rollupTrafFinished(m_trafHour);
+}
+
+void RollupStatTrafJob::rollupTrafHour(qint32 trafHour)
+{
+    const qint64 unixTime = DateUtil::toUnixTime(trafHour);
+
+    const qint32 trafDay = DateUtil::getUnixDay(unixTime);
+    const qint32 trafMonth = DateUtil::getUnixMonth(unixTime, monthStart());
+
+    DbUtil::doList({ getRollupStmt(StatSql::sqlRollupTrafAppDay, trafHour, trafDay),
+            getRollupStmt(StatSql::sqlRollupTrafAppMonth, trafHour, trafMonth),
+            getRollupStmt(StatSql::sqlRollupTrafDay, trafHour, trafDay),
+            getRollupStmt(StatSql::sqlRollupTrafMonth, trafHour, trafMonth) });
+}
+
+SqliteStmt *RollupStatTrafJob::getRollupStmt(const char *sql, qint32 trafHour, qint32 rollupTime)
+{
+    SqliteStmt *stmt = getTrafficStmt(sql, trafHour);
+
+    stmt->bindInt(2, rollupTime);
+
+    return stmt;
+}
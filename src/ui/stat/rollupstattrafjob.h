@@ -0,0 +1,33 @@
+#ifndef ROLLUPSTATTRAFJOB_H
+#define ROLLUPSTATTRAFJOB_H
+
+#include "statbasejob.h"
+
+class RollupStatTrafJob : public StatBaseJob
+{
+public:
+    explicit RollupStatTrafJob(qint32 trafHour, int monthStart);
+
+    // Hours before it are rolled up
+    qint32 trafHour() const { return m_trafHour; }
+
+    int monthStart() const { return m_monthStart; }
+
+    StatJobType jobType() const override { return JobTypeRollupTraf; }
+
+protected:
+    bool processMerge(const StatBaseJob &statJob) override;
+    void processJob() override;
+    void emitFinished() override;
+
+private:
+    void rollupTrafHour(qint32 trafHour);
+
+    SqliteStmt *getRollupStmt(const char *sql, qint32 trafHour, qint32 rollupTime);
+
+private:
+    qint32 m_trafHour = 0;
+    int m_monthStart = 1;
+};
+
+#endif // ROLLUPSTATTRAFJOB_H
@@ -0,0 +1,34 @@
+#ifndef STAT_TYPES_H
+#define STAT_TYPES_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+struct TrafBytes
+{
+    bool isEmpty() const { return inBytes == 0 && outBytes == 0; }
+
+    void add(qint64 in, qint64 out)
+    {
+        inBytes += in;
+        outBytes += out;
+    }
+
+    void add(const TrafBytes &o) { add(o.inBytes, o.outBytes); }
+
+    qint64 inBytes = 0;
+    qint64 outBytes = 0;
+};
+
+struct AppTrafRow
+{
+    qint64 appId = 0;
+    TrafBytes trafBytes;
+};
+
+using AppTrafRowList = QVector<AppTrafRow>; // sorted by appId
+
+using AppTrafBytesHash = QHash<QString, TrafBytes>; // appPath -> traffic bytes
+
+#endif // STAT_TYPES_H
@@ -0,0 +1,106 @@
+#include "statbasejob.h"
+
+#include <QLoggingCategory>
+
+#include <sqlite/sqlitedb.h>
+#include <sqlite/sqlitestmt.h>
+
+#include <util/worker/workerobject.h>
+
+#include "statmanager.h"
+#include "statsql.h"
+
+namespace {
+
+const QLoggingCategory LC("stat");
+
+}
+
+SqliteDb *StatBaseJob::sqliteDb() const
+{
+    return manager()->sqliteDb();
+}
+
+bool StatBaseJob::mergeJob(const WorkerJob &job)
+{
+    const auto &statJob = static_cast<const StatBaseJob &>(job);
+
+    return jobType() == statJob.jobType() && processMerge(statJob);
+}
+
+void StatBaseJob::doJob(WorkerObject &worker)
+{
+    m_manager = static_cast<StatManager *>(worker.manager());
+
+    processJob();
+}
+
+void StatBaseJob::reportResult(WorkerObject & /*worker*/)
+{
+    if (resultCount() > 0) {
+        emitFinished();
+    }
+}
+
+SqliteStmt *StatBaseJob::getStmt(const char *sql)
+{
+    return sqliteDb()->stmt(sql);
+}
+
+SqliteStmt *StatBaseJob::getIdStmt(const char *sql, qint64 id)
+{
+    SqliteStmt *stmt = getStmt(sql);
+
+    stmt->bindInt64(1, id);
+
+    return stmt;
+}
+
+SqliteStmt *StatBaseJob::getTrafficStmt(const char *sql, qint32 trafTime)
+{
+    SqliteStmt *stmt = getStmt(sql);
+
+    stmt->bindInt(1, trafTime);
+
+    return stmt;
+}
+
+qint32 StatBaseJob::getRollupTrafHour()
+{
+    qint32 trafHour = 0;
+
+    SqliteStmt *stmt = getStmt(StatSql::sqlSelectTrafRollupTime);
+
+    if (stmt->step() == SqliteStmt::StepRow) {
+        trafHour = stmt->columnInt();
+    }
+    stmt->reset();
+
+    return trafHour;
+}
+
+void StatBaseJob::updateTrafficList(
+        const SqliteStmtList &upsertStmtList, const TrafBytes &trafBytes, qint64 appId)
+{
+    int i = 0;
+    for (SqliteStmt *stmt : upsertStmtList) {
+        if (!updateTraffic(stmt, trafBytes, appId)) {
+            qCCritical(LC) << "Update traffic error:" << sqliteDb()->errorMessage()
+                           << "inBytes:" << trafBytes.inBytes << "outBytes:" << trafBytes.outBytes
+                           << "appId:" << appId << "index:" << i;
+        }
+        ++i;
+    }
+}
+
+bool StatBaseJob::updateTraffic(SqliteStmt *stmt, const TrafBytes &trafBytes, qint64 appId)
+{
+    stmt->bindInt64(2, trafBytes.inBytes);
+    stmt->bindInt64(3, trafBytes.outBytes);
+
+    if (appId != 0) {
+        stmt->bindInt64(4, appId);
+    }
+
+    return sqliteDb()->done(stmt);
+}
@@ -0,0 +1,53 @@
+#ifndef STATBASEJOB_H
+#define STATBASEJOB_H
+
+#include <sqlite/sqlite_types.h>
+
+#include <util/worker/workerjob.h>
+
+#include "stat_types.h"
+
+class StatManager;
+
+class StatBaseJob : public WorkerJob
+{
+public:
+    enum StatJobType : qint8 { JobTypeLogTraf, JobTypeRollupTraf, JobTypeDeleteTraf };
+
+    StatManager *manager() const { return m_manager; }
+    SqliteDb *sqliteDb() const;
+
+    bool mergeJob(const WorkerJob &job) override;
+
+    void doJob(WorkerObject &worker) override;
+    void reportResult(WorkerObject &worker) override;
+
+    virtual StatJobType jobType() const = 0;
+
+protected:
+    virtual bool processMerge(const StatBaseJob &statJob) = 0;
+    virtual void processJob() = 0;
+    virtual void emitFinished() = 0;
+
+    int resultCount() const { return m_resultCount; }
+    void setResultCount(int v) { m_resultCount = v; }
+
+    SqliteStmt *getStmt(const char *sql);
+    SqliteStmt *getIdStmt(const char *sql, qint64 id);
+    SqliteStmt *getTrafficStmt(const char *sql, qint32 trafTime);
+
+    qint32 getRollupTrafHour();
+
+    void updateTrafficList(
+            const SqliteStmtList &upsertStmtList, const TrafBytes &trafBytes, qint64 appId = 0);
+
+private:
+    bool updateTraffic(SqliteStmt *stmt, const TrafBytes &trafBytes, qint64 appId);
+
+private:
+    int m_resultCount = 0;
+
+    StatManager *m_manager = nullptr;
+};
+
+#endif // STATBASEJOB_H
@@ -1,11 +1,14 @@
 #include "statblockbasejob.h"
 
+#include <QHash>
+
 #include <sqlite/sqlitedb.h>
 #include <sqlite/sqlitestmt.h>
 
 #include <util/worker/workerobject.h>
 
 #include "statblockmanager.h"
+#include "statsql.h"
 
 SqliteDb *StatBlockBaseJob::sqliteDb() const
 {
@@ -46,3 +49,56 @@ SqliteStmt *StatBlockBaseJob::getIdStmt(const char *sql, qint64 id)
 
     return stmt;
 }
+
+int StatBlockBaseJob::deleteConns(qint64 connIdTo)
+{
+    QHash<qint64, int> appConnCounts; // appId -> deleted connections count
+
+    SqliteStmt *stmt = getIdStmt(StatSql::sqlSelectConnBlockAppCounts, connIdTo);
+    while (stmt->step() == SqliteStmt::StepRow) {
+        appConnCounts.insert(stmt->columnInt64(0), stmt->columnInt(1));
+    }
+    stmt->reset();
+
+    if (appConnCounts.isEmpty())
+        return 0;
+
+    if (!sqliteDb()->done(getIdStmt(StatSql::sqlDeleteConnBlock, connIdTo)))
+        return 0;
+
+    int deletedCount = 0;
+    for (auto it = appConnCounts.constBegin(); it != appConnCounts.constEnd(); ++it) {
+        updateAppConnCount(it.key(), -it.value());
+        deletedCount += it.value();
+    }
+
+    return deletedCount;
+}
+
+void StatBlockBaseJob::updateAppConnCount(qint64 appId, int delta)
+{
+    SqliteStmt *stmt = getIdStmt(StatSql::sqlUpdateAppConnCount, appId);
+    stmt->bindInt(2, delta);
+
+    const bool isUnused = (stmt->step() == SqliteStmt::StepRow && stmt->columnInt64(0) <= 0);
+    stmt->reset();
+
+    if (isUnused) {
+        deleteApp(appId);
+    }
+}
+
+void StatBlockBaseJob::deleteApp(qint64 appId)
+{
+    SqliteStmt *stmt = getIdStmt(StatSql::sqlDeleteAppId, appId);
+
+    if (stmt->step() == SqliteStmt::StepRow) {
+        removeCachedAppId(stmt->columnText(0));
+    }
+    stmt->reset();
+}
+
+void StatBlockBaseJob::removeCachedAppId(const QString &appPath)
+{
+    manager()->removeCachedAppId(appPath);
+}
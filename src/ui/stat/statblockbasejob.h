@@ -1,6 +1,8 @@
 #ifndef STATBLOCKBASEJOB_H
 #define STATBLOCKBASEJOB_H
 
+#include <QString>
+
 #include <sqlite/sqlite_types.h>
 
 #include <util/worker/workerjob.h>
@@ -33,6 +35,14 @@ protected:
     SqliteStmt *getStmt(const char *sql);
     SqliteStmt *getIdStmt(const char *sql, qint64 id);
 
+    // Delete the connections up to the id and the apps left without connections
+    int deleteConns(qint64 connIdTo);
+
+    void updateAppConnCount(qint64 appId, int delta);
+    void deleteApp(qint64 appId);
+
+    virtual void removeCachedAppId(const QString &appPath);
+
 private:
     int m_resultCount = 0;
 
@@ -4,6 +4,7 @@
 
 #include <sqlite/dbquery.h>
 #include <sqlite/sqlitedb.h>
+#include <sqlite/sqlitedbpool.h>
 #include <sqlite/sqlitestmt.h>
 
 #include <conf/confmanager.h>
@@ -19,7 +20,9 @@ namespace {
 
 const QLoggingCategory LC("statBlock");
 
-constexpr int DATABASE_USER_VERSION = 7;
+constexpr int DATABASE_USER_VERSION = 8;
+
+constexpr int APP_ID_CACHE_MAX_COUNT = 2000;
 
 bool migrateFunc(SqliteDb *db, int version, bool isNewDb, void *ctx)
 {
@@ -31,26 +34,39 @@ bool migrateFunc(SqliteDb *db, int version, bool isNewDb, void *ctx)
     }
 
     // COMPAT: DB content
-    if (version < 7) {
-        const QString srcSchema = SqliteDb::migrationOldSchemaName();
-        const QString dstSchema = SqliteDb::migrationNewSchemaName();
+    const QString srcSchema = SqliteDb::migrationOldSchemaName();
+    const QString dstSchema = SqliteDb::migrationNewSchemaName();
 
-        db->executeStr(QString("INSERT INTO %1 (%3) SELECT %3 FROM %2;")
-                               .arg(SqliteDb::entityName(dstSchema, "app"),
-                                       SqliteDb::entityName(srcSchema, "app"),
-                                       "app_id, path, creat_time"));
+    const QString connColumns = "conn_id, app_id, conn_time, process_id, inbound,"
+                                " inherited, ip_proto, local_port, remote_port,"
+                                " local_ip, remote_ip, local_ip6, remote_ip6,"
+                                " block_reason";
+
+    db->executeStr(QString("INSERT INTO %1 (%3) SELECT %3 FROM %2;")
+                           .arg(SqliteDb::entityName(dstSchema, "app"),
+                                   SqliteDb::entityName(srcSchema, "app"),
+                                   "app_id, path, creat_time"));
 
+    if (version < 7) {
         // Union the "conn" & "conn_block" tables
         db->executeStr(QString("INSERT INTO %1 (%4) SELECT %4 FROM %2 JOIN %3 USING(conn_id);")
                                .arg(SqliteDb::entityName(dstSchema, "conn_block"),
                                        SqliteDb::entityName(srcSchema, "conn"),
                                        SqliteDb::entityName(srcSchema, "conn_block"),
-                                       "conn_id, app_id, conn_time, process_id, inbound,"
-                                       " inherited, ip_proto, local_port, remote_port,"
-                                       " local_ip, remote_ip, local_ip6, remote_ip6,"
-                                       " block_reason"));
+                                       connColumns));
+    } else {
+        db->executeStr(QString("INSERT INTO %1 (%3) SELECT %3 FROM %2;")
+                               .arg(SqliteDb::entityName(dstSchema, "conn_block"),
+                                       SqliteDb::entityName(srcSchema, "conn_block"),
+                                       connColumns));
     }
 
+    // Count the connections of apps
+    db->executeStr(QString("UPDATE %1 SET conn_count ="
+                           " (SELECT count(*) FROM %2 c WHERE c.app_id = %1.app_id);")
+                           .arg(SqliteDb::entityName(dstSchema, "app"),
+                                   SqliteDb::entityName(dstSchema, "conn_block")));
+
     return true;
 }
 
@@ -59,12 +75,23 @@ bool migrateFunc(SqliteDb *db, int version, bool isNewDb, void *ctx)
 StatBlockManager::StatBlockManager(const QString &filePath, QObject *parent, quint32 openFlags) :
     WorkerManager(parent),
     m_sqliteDb(new SqliteDb(filePath, openFlags)),
-    m_roSqliteDb((openFlags == 0 || (openFlags & SqliteDb::OpenReadWrite) != 0)
-                    ? SqliteDbPtr::create(filePath, SqliteDb::OpenDefaultReadOnly)
-                    : m_sqliteDb),
-    m_connChangedTimer(500)
+    m_connChangedTimer(500),
+    m_appIdCache(APP_ID_CACHE_MAX_COUNT)
 {
     connect(&m_connChangedTimer, &QTimer::timeout, this, &StatBlockManager::connChanged);
+
+    const bool isReadWrite = (openFlags == 0 || (openFlags & SqliteDb::OpenReadWrite) != 0);
+
+    m_sqliteDb->setTuneProfile(isReadWrite ? SqliteDb::TuneWriter : SqliteDb::TuneReader);
+
+    if (isReadWrite) {
+        m_roDbPool = new SqliteDbPool(filePath, this);
+    }
+}
+
+SqliteDb *StatBlockManager::roSqliteDb() const
+{
+    return m_roDbPool ? m_roDbPool->threadDb() : sqliteDb();
 }
 
 void StatBlockManager::emitConnChanged()
@@ -91,7 +118,7 @@ void StatBlockManager::logBlockedIp(const LogEntryBlockedIp &entry)
     if (jobCount() >= maxJobCount)
         return; // drop excessive data
 
-    enqueueJob(WorkerJobPtr(new LogBlockedIpJob(entry)));
+    enqueueJob(WorkerJobPtr(new LogBlockedIpJob(entry, m_keepCount)));
 }
 
 void StatBlockManager::deleteConn(qint64 connIdTo)
@@ -111,28 +138,31 @@ void StatBlockManager::getConnIdRange(SqliteDb *db, qint64 &connIdMin, qint64 &c
     connIdMax = vars.value(1).toLongLong();
 }
 
-void StatBlockManager::onLogBlockedIpFinished(int count, qint64 /*newConnId*/)
+qint64 StatBlockManager::getCachedAppId(const QString &appPath)
 {
-    emitConnChanged();
+    const qint64 *appId = m_appIdCache.object(appPath);
 
-    if (m_keepCount <= 0)
-        return;
-
-    constexpr int connBlockIncMax = 99;
+    return appId ? *appId : INVALID_APP_ID;
+}
 
-    m_connInc += count;
-    if (m_connInc < connBlockIncMax)
-        return;
+void StatBlockManager::addCachedAppId(const QString &appPath, qint64 appId)
+{
+    m_appIdCache.insert(appPath, new qint64(appId));
+}
 
-    m_connInc = 0;
+void StatBlockManager::removeCachedAppId(const QString &appPath)
+{
+    m_appIdCache.remove(appPath);
+}
 
-    qint64 idMin, idMax;
-    getConnIdRange(roSqliteDb(), idMin, idMax);
+void StatBlockManager::clearAppIdCache()
+{
+    m_appIdCache.clear();
+}
 
-    const qint64 idMinKeep = idMax - m_keepCount;
-    if (idMinKeep > 0 && idMinKeep > idMin) {
-        deleteConn(idMinKeep);
-    }
+void StatBlockManager::onLogBlockedIpFinished(int /*count*/, qint64 /*newConnId*/)
+{
+    emitConnChanged();
 }
 
 void StatBlockManager::onDeleteConnBlockFinished(qint64 /*connIdTo*/)
@@ -174,8 +204,8 @@ bool StatBlockManager::setupDb()
         .sqlDir = ":/stat/migrations/block",
         .version = DATABASE_USER_VERSION,
         .recreate = true,
-        // COMPAT: Union the "conn" & "conn_block" tables
-        .autoCopyTables = (DATABASE_USER_VERSION != 7),
+        // COMPAT: The tables are copied by migrateFunc()
+        .autoCopyTables = false,
         .migrateFunc = &migrateFunc,
     };
 
@@ -184,18 +214,10 @@ bool StatBlockManager::setupDb()
         return false;
     }
 
-    if (roSqliteDb() != sqliteDb()) {
-        if (!roSqliteDb()->open()) {
-            qCCritical(LC) << "File open error:" << roSqliteDb()->filePath()
-                           << roSqliteDb()->errorMessage();
-            return false;
-        }
-    }
-
     return true;
 }
 
 void StatBlockManager::setupByConf(const IniOptions &ini)
 {
-    m_keepCount = ini.blockedIpKeepCount();
+    setKeepCount(ini.blockedIpKeepCount());
 }
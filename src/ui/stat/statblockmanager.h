@@ -1,6 +1,7 @@
 #ifndef STATBLOCKMANAGER_H
 #define STATBLOCKMANAGER_H
 
+#include <QCache>
 #include <QObject>
 
 #include <sqlite/sqlite_types.h>
@@ -18,12 +19,15 @@ class StatBlockManager : public WorkerManager, public IocService
     Q_OBJECT
 
 public:
+    static constexpr qint64 INVALID_APP_ID = Q_INT64_C(-1);
+
     explicit StatBlockManager(
             const QString &filePath, QObject *parent = nullptr, quint32 openFlags = 0);
     CLASS_DELETE_COPY_MOVE(StatBlockManager)
 
     SqliteDb *sqliteDb() const { return m_sqliteDb.data(); }
-    SqliteDb *roSqliteDb() const { return m_roSqliteDb.data(); }
+    SqliteDb *roSqliteDb() const;
+    SqliteDbPool *roDbPool() const { return m_roDbPool; }
 
     void setUp() override;
     void tearDown() override;
@@ -34,6 +38,12 @@ public:
 
     static void getConnIdRange(SqliteDb *db, qint64 &rowIdMin, qint64 &rowIdMax);
 
+    // Called by the jobs in the worker's thread
+    qint64 getCachedAppId(const QString &appPath);
+    void addCachedAppId(const QString &appPath, qint64 appId);
+    void removeCachedAppId(const QString &appPath);
+    void clearAppIdCache();
+
 signals:
     void connChanged();
 
@@ -53,20 +63,23 @@ protected:
     virtual void setupWorker();
     virtual void setupConfManager();
 
+    void setKeepCount(int v) { m_keepCount = v; }
+
 private:
     bool setupDb();
 
     void setupByConf(const IniOptions &ini);
 
 private:
-    int m_connInc = 999999999; // to trigger on first check
-
     int m_keepCount = 0;
 
     SqliteDbPtr m_sqliteDb;
-    SqliteDbPtr m_roSqliteDb;
+    SqliteDbPool *m_roDbPool = nullptr; // read-only connections of threads
 
     TriggerTimer m_connChangedTimer;
+
+    // Used in the worker's thread
+    QCache<QString, qint64> m_appIdCache; // appPath -> appId
 };
 
 #endif // STATBLOCKMANAGER_H
@@ -0,0 +1,321 @@
+#include "statfeed.h"
+
+#include <QLoggingCategory>
+#include <QThread>
+
+#include <atomic>
+
+#include <fort_version.h>
+
+#ifdef Q_OS_WIN
+#    define WIN32_LEAN_AND_MEAN
+#    include <qt_windows.h>
+#    include <sddl.h>
+
+#    include <util/osutil.h>
+#endif
+
+namespace {
+
+const QLoggingCategory LC("stat.statFeed");
+
+constexpr quint32 feedMagic = 0x44454546; // "FEED"
+
+constexpr int readMaxTries = 1000;
+
+struct FeedHeader
+{
+    quint32 magic;
+    QAtomicInteger<quint32> sequence; // odd while writing
+    quint32 version; // count of the publishes
+};
+
+struct FeedData
+{
+    FeedHeader header;
+    StatFeedTraf trafs[StatFeed::trafMaxCount]; // ring buffer indexed by version
+};
+
+template<typename F>
+void writeFeed(FeedData *data, F write)
+{
+    const quint32 sequence = data->header.sequence.loadRelaxed();
+
+    data->header.sequence.storeRelaxed(sequence + 1);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    write();
+
+    data->header.sequence.storeRelease(sequence + 2);
+}
+
+template<typename F>
+bool readFeed(const FeedData *data, F read)
+{
+    for (int tryCount = 0; tryCount < readMaxTries; ++tryCount) {
+        const quint32 sequence = data->header.sequence.loadAcquire();
+        if ((sequence & 1) != 0) {
+            QThread::yieldCurrentThread();
+            continue; // writing
+        }
+
+        if (!read())
+            return false;
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (data->header.sequence.loadRelaxed() == sequence)
+            return true;
+    }
+
+    qCWarning(LC) << "Read tries exceeded";
+
+    return false;
+}
+
+}
+
+StatFeed::StatFeed(const QString &key)
+{
+#ifdef Q_OS_WIN
+    // Shared by the service's and the users' sessions
+    m_nativeKey = "Global\\" + key;
+#else
+    m_sharedMemory.setKey(key);
+#endif
+}
+
+StatFeed::~StatFeed()
+{
+    detach();
+}
+
+bool StatFeed::create()
+{
+    m_isWriter = true;
+
+    if (!createMemory(sizeof(FeedData))) {
+        qCWarning(LC) << "Create error:" << errorString();
+        return false;
+    }
+
+    auto data = static_cast<FeedData *>(m_data);
+
+    // Restart the versions
+    writeFeed(data, [&] {
+        data->header.magic = feedMagic;
+        data->header.version = 0;
+    });
+
+    return true;
+}
+
+void StatFeed::publish(qint64 unixTime, quint32 inBytes, quint32 outBytes)
+{
+    if (!m_isWriter || !isAttached())
+        return;
+
+    auto data = static_cast<FeedData *>(m_data);
+
+    writeFeed(data, [&] {
+        const quint32 version = data->header.version;
+
+        data->trafs[version % trafMaxCount] = {
+            .unixTime = unixTime, .inBytes = inBytes, .outBytes = outBytes
+        };
+
+        data->header.version = version + 1;
+    });
+}
+
+bool StatFeed::attach()
+{
+    m_isWriter = false;
+
+    if (isAttached())
+        return true;
+
+    return attachMemory(sizeof(FeedData));
+}
+
+quint32 StatFeed::version() const
+{
+    if (!isAttached())
+        return 0;
+
+    auto data = static_cast<const FeedData *>(m_data);
+
+    quint32 version = 0;
+
+    readFeed(data, [&] {
+        version = data->header.version;
+        return true;
+    });
+
+    return version;
+}
+
+bool StatFeed::read(StatFeedSnapshot &snapshot, quint32 sinceVersion) const
+{
+    if (!isAttached())
+        return false;
+
+    auto data = static_cast<const FeedData *>(m_data);
+
+    return readFeed(data, [&] {
+        const FeedHeader &header = data->header;
+
+        if (header.magic != feedMagic)
+            return false; // not created yet
+
+        const quint32 version = header.version;
+
+        // The writer is restarted
+        if (sinceVersion > version) {
+            sinceVersion = 0;
+        }
+
+        const int trafCount = int(qMin(version - sinceVersion, quint32(trafMaxCount)));
+
+        snapshot.version = version;
+
+        snapshot.trafs.resize(trafCount);
+        for (int i = 0; i < trafCount; ++i) {
+            snapshot.trafs[i] = data->trafs[(version - trafCount + i) % trafMaxCount];
+        }
+
+        return true;
+    });
+}
+
+void StatFeed::detach()
+{
+    detachMemory();
+}
+
+QString StatFeed::defaultKey()
+{
+    return QLatin1String(APP_BASE "StatFeed");
+}
+
+#ifdef Q_OS_WIN
+
+bool StatFeed::createMemory(int size)
+{
+    // Readable by the users, writable by the service and the administrators only
+    SECURITY_ATTRIBUTES sa = { sizeof(SECURITY_ATTRIBUTES), nullptr, FALSE };
+
+    if (!ConvertStringSecurityDescriptorToSecurityDescriptorW(
+                L"D:P(A;;GA;;;SY)(A;;GA;;;BA)(A;;GR;;;AU)", SDDL_REVISION_1,
+                &sa.lpSecurityDescriptor, nullptr)) {
+        m_errorString = OsUtil::errorMessage();
+        return false;
+    }
+
+    // Opens the mapping left by the previous writer or still attached by the readers
+    m_mappingHandle = CreateFileMappingW(INVALID_HANDLE_VALUE, &sa, PAGE_READWRITE, 0, size,
+            (LPCWSTR) m_nativeKey.utf16());
+
+    LocalFree(sa.lpSecurityDescriptor);
+
+    if (!m_mappingHandle) {
+        m_errorString = OsUtil::errorMessage();
+        return false;
+    }
+
+    m_data = MapViewOfFile(m_mappingHandle, FILE_MAP_WRITE, 0, 0, size);
+
+    if (!m_data) {
+        m_errorString = OsUtil::errorMessage();
+        detachMemory();
+        return false;
+    }
+
+    return true;
+}
+
+bool StatFeed::attachMemory(int size)
+{
+    m_mappingHandle = OpenFileMappingW(FILE_MAP_READ, FALSE, (LPCWSTR) m_nativeKey.utf16());
+
+    if (!m_mappingHandle) {
+        m_errorString = OsUtil::errorMessage();
+        return false;
+    }
+
+    // Fails for the smaller mapping
+    m_data = MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, size);
+
+    if (!m_data) {
+        m_errorString = OsUtil::errorMessage();
+        qCWarning(LC) << "Attach error:" << errorString();
+        detachMemory();
+        return false;
+    }
+
+    return true;
+}
+
+void StatFeed::detachMemory()
+{
+    if (m_data) {
+        UnmapViewOfFile(m_data);
+        m_data = nullptr;
+    }
+
+    if (m_mappingHandle) {
+        CloseHandle(m_mappingHandle);
+        m_mappingHandle = nullptr;
+    }
+}
+
+#else
+
+bool StatFeed::createMemory(int size)
+{
+    if (!m_sharedMemory.create(size)) {
+        // Left by the previous writer or still attached by the readers
+        if (m_sharedMemory.error() != QSharedMemory::AlreadyExists || !m_sharedMemory.attach()) {
+            m_errorString = m_sharedMemory.errorString();
+            return false;
+        }
+
+        if (m_sharedMemory.size() < size) {
+            m_errorString = QLatin1String("Size mismatch");
+            m_sharedMemory.detach();
+            return false;
+        }
+    }
+
+    m_data = m_sharedMemory.data();
+
+    return true;
+}
+
+bool StatFeed::attachMemory(int size)
+{
+    if (!m_sharedMemory.attach(QSharedMemory::ReadOnly)) {
+        m_errorString = m_sharedMemory.errorString();
+        return false;
+    }
+
+    if (m_sharedMemory.size() < size) {
+        m_errorString = QLatin1String("Size mismatch");
+        qCWarning(LC) << "Attach error:" << errorString();
+        m_sharedMemory.detach();
+        return false;
+    }
+
+    m_data = m_sharedMemory.data();
+
+    return true;
+}
+
+void StatFeed::detachMemory()
+{
+    m_data = nullptr;
+
+    m_sharedMemory.detach();
+}
+
+#endif
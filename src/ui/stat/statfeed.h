@@ -0,0 +1,79 @@
+#ifndef STATFEED_H
+#define STATFEED_H
+
+#include <QString>
+#include <QVector>
+
+#ifndef Q_OS_WIN
+#    include <QSharedMemory>
+#endif
+
+#include <util/classhelpers.h>
+
+struct StatFeedTraf
+{
+    qint64 unixTime = 0;
+    quint32 inBytes = 0;
+    quint32 outBytes = 0;
+};
+
+struct StatFeedSnapshot
+{
+    quint32 version = 0;
+
+    // The published traffic after the requested version, the oldest first
+    QVector<StatFeedTraf> trafs;
+};
+
+// Traffic feed of the service for the UI clients, published in a shared memory.
+// One writer (the service) and many readers (the clients) without locks:
+// the writer makes the sequence counter odd while writing (seqlock),
+// the readers retry copying while the counter is odd or changed.
+class StatFeed
+{
+public:
+    static constexpr int trafMaxCount = 256;
+
+    explicit StatFeed(const QString &key = defaultKey());
+    ~StatFeed();
+    CLASS_DELETE_COPY_MOVE(StatFeed)
+
+    bool isWriter() const { return m_isWriter; }
+    bool isAttached() const { return m_data != nullptr; }
+
+    const QString &errorString() const { return m_errorString; }
+
+    // Writer
+    bool create();
+    void publish(qint64 unixTime, quint32 inBytes, quint32 outBytes);
+
+    // Reader
+    bool attach();
+    quint32 version() const;
+    bool read(StatFeedSnapshot &snapshot, quint32 sinceVersion = 0) const;
+
+    void detach();
+
+    static QString defaultKey();
+
+private:
+    bool createMemory(int size);
+    bool attachMemory(int size);
+    void detachMemory();
+
+private:
+    bool m_isWriter = false;
+
+    void *m_data = nullptr;
+
+    QString m_errorString;
+
+#ifdef Q_OS_WIN
+    QString m_nativeKey;
+    void *m_mappingHandle = nullptr;
+#else
+    QSharedMemory m_sharedMemory;
+#endif
+};
+
+#endif // STATFEED_H
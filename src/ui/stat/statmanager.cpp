@@ -4,10 +4,12 @@
 
 #include <sqlite/dbutil.h>
 #include <sqlite/sqlitedb.h>
+#include <sqlite/sqlitedbpool.h>
 #include <sqlite/sqlitestmt.h>
 
 #include <conf/firewallconf.h>
 #include <driver/drivercommon.h>
+#include <fortsettings.h>
 #include <log/logentryprocnew.h>
 #include <log/logentrystattraf.h>
 #include <stat/quotamanager.h>
@@ -16,17 +18,66 @@
 #include <util/ioc/ioccontainer.h>
 #include <util/osutil.h>
 
+#include "deletestattrafjob.h"
+#include "logstattrafjob.h"
+#include "rollupstattrafjob.h"
 #include "statsql.h"
+#include "statworker.h"
 
 namespace {
 
 const QLoggingCategory LC("stat");
 
-constexpr int DATABASE_USER_VERSION = 7;
+constexpr int DATABASE_USER_VERSION = 8;
 
 constexpr qint32 ACTIVE_PERIOD_CHECK_SECS = 60 * OS_TICKS_PER_SECOND;
 
-constexpr qint64 INVALID_APP_ID = Q_INT64_C(-1);
+constexpr qint64 TRAF_FLUSH_SECS = 30;
+
+constexpr int MAX_WRITE_JOB_COUNT = 16;
+
+constexpr qint64 SLOW_FLUSH_MSEC = 1000;
+
+const char *const sqlSelectMinTrafApps[] = {
+    StatSql::sqlSelectMinTrafAppHour,
+    StatSql::sqlSelectMinTrafAppDay,
+    StatSql::sqlSelectMinTrafAppMonth,
+    StatSql::sqlSelectMinTrafAppTotal,
+};
+
+const char *const sqlSelectMinTrafs[] = {
+    StatSql::sqlSelectMinTrafHour,
+    StatSql::sqlSelectMinTrafDay,
+    StatSql::sqlSelectMinTrafMonth,
+    StatSql::sqlSelectMinTrafTotal,
+};
+
+const char *const sqlSelectTrafApps[] = {
+    StatSql::sqlSelectTrafAppHour,
+    StatSql::sqlSelectTrafAppDay,
+    StatSql::sqlSelectTrafAppMonth,
+    StatSql::sqlSelectTrafAppTotal,
+};
+
+const char *const sqlSelectTrafs[] = {
+    StatSql::sqlSelectTrafHour,
+    StatSql::sqlSelectTrafDay,
+    StatSql::sqlSelectTrafMonth,
+    StatSql::sqlSelectTrafTotal,
+};
+
+bool isRollupTrafType(StatManager::TrafType type)
+{
+    return type == StatManager::TrafDay || type == StatManager::TrafMonth;
+}
+
+QString trafSegmentsPath(const QString &filePath)
+{
+    if (filePath.isEmpty() || filePath.startsWith(':'))
+        return QString(); // in-memory database
+
+    return filePath + ".traf";
+}
 
 bool migrateFunc(SqliteDb *db, int version, bool isNewDb, void *ctx)
 {
@@ -56,8 +107,22 @@ bool migrateFunc(SqliteDb *db, int version, bool isNewDb, void *ctx)
 }
 
 StatManager::StatManager(const QString &filePath, QObject *parent, quint32 openFlags) :
-    QObject(parent), m_sqliteDb(new SqliteDb(filePath, openFlags))
+    WorkerManager(parent),
+    m_sqliteDb(new SqliteDb(filePath, openFlags)),
+    m_trafStore(trafSegmentsPath(filePath))
 {
+    const bool isReadWrite = (openFlags == 0 || (openFlags & SqliteDb::OpenReadWrite) != 0);
+
+    m_sqliteDb->setTuneProfile(isReadWrite ? SqliteDb::TuneWriter : SqliteDb::TuneReader);
+
+    if (isReadWrite) {
+        m_roDbPool = new SqliteDbPool(filePath, this);
+    }
+}
+
+SqliteDb *StatManager::roSqliteDb() const
+{
+    return m_roDbPool ? m_roDbPool->threadDb() : sqliteDb();
 }
 
 void StatManager::setConf(const FirewallConf *conf)
@@ -74,7 +139,37 @@ const IniOptions *StatManager::ini() const
 
 void StatManager::setUp()
 {
+    setupWorker();
+
     setupDb();
+
+    setupStatFeed();
+}
+
+void StatManager::tearDown()
+{
+    flushTraf();
+
+    finishWorkers();
+}
+
+void StatManager::setupStatFeed()
+{
+    const auto settings = IoC<FortSettings>();
+    if (!settings || !settings->isService())
+        return;
+
+    setStatFeed(new StatFeed());
+
+    if (!statFeed()->create()) {
+        qCWarning(LC) << "Stat feed error:" << statFeed()->errorString();
+        m_statFeed.reset();
+    }
+}
+
+int StatManager::monthStart() const
+{
+    return conf() ? ini()->monthStart() : 1;
 }
 
 void StatManager::setupTrafDate()
@@ -148,11 +243,17 @@ bool StatManager::updateTrafDay(qint64 unixTime)
     const qint32 trafHour = DateUtil::getUnixHour(unixTime);
     const bool isNewHour = (trafHour != m_trafHour);
 
+    // Flush the previous hour's traffic and roll it up into the days and months
+    if (isNewHour) {
+        flushTraf();
+        rollupTraf(trafHour);
+    }
+
     const qint32 trafDay = isNewHour ? DateUtil::getUnixDay(unixTime) : m_trafDay;
     const bool isNewDay = (trafDay != m_trafDay);
 
     const qint32 trafMonth =
-            isNewDay ? DateUtil::getUnixMonth(unixTime, ini()->monthStart()) : m_trafMonth;
+            isNewDay ? DateUtil::getUnixMonth(unixTime, monthStart()) : m_trafMonth;
     const bool isNewMonth = (trafMonth != m_trafMonth);
 
     // Initialize quotas traffic bytes
@@ -165,30 +266,81 @@ bool StatManager::updateTrafDay(qint64 unixTime)
     return isNewDay;
 }
 
-bool StatManager::clearTraffic()
+bool StatManager::isTrafFlushTime(qint64 unixTime) const
 {
-    bool ok = true;
+    return qAbs(unixTime - m_trafFlushTime) >= TRAF_FLUSH_SECS;
+}
 
-    beginTransaction();
-    ok = sqliteDb()->execute(StatSql::sqlDeleteAllTraffic);
-    commitTransaction(ok);
+bool StatManager::isWriteQueueFull()
+{
+    const int count = jobCount();
 
-    if (!ok)
-        return false;
+    m_maxJobCount = qMax(m_maxJobCount, count);
+
+    const bool isFull = (count >= MAX_WRITE_JOB_COUNT);
+
+    if (m_isWriteQueueFull != isFull) {
+        m_isWriteQueueFull = isFull;
+
+        if (isFull) {
+            qCWarning(LC) << "Write queue is full:" << count << "jobs";
+        }
+    }
 
-    sqliteDb()->vacuum(); // Vacuum outside of transaction
+    return isFull;
+}
+
+void StatManager::clearTrafBytes()
+{
+    m_trafBytes = {};
+    m_appTrafBytes.clear();
+}
+
+void StatManager::rollupTraf(qint32 trafHour)
+{
+    enqueueJob(WorkerJobPtr(new RollupStatTrafJob(trafHour, monthStart())));
+}
+
+bool StatManager::clearTraffic()
+{
+    clear(); // drop the queued jobs
 
-    clearAppIdCache();
+    clearTrafBytes();
 
     setupTrafDate();
 
     IoC<QuotaManager>()->clear();
 
-    emit trafficCleared();
+    enqueueJob(WorkerJobPtr(new DeleteStatTrafJob(DeleteStatTrafJob::DeleteAllTraffic)));
 
     return true;
 }
 
+void StatManager::onLogStatTrafFinished(qint64 flushMsec)
+{
+    m_lastFlushMsec = flushMsec;
+
+    if (m_maxFlushMsec < flushMsec) {
+        m_maxFlushMsec = flushMsec;
+    }
+
+    if (flushMsec >= SLOW_FLUSH_MSEC) {
+        qCWarning(LC) << "Slow traffic flush:" << flushMsec << "msec";
+    }
+}
+
+WorkerObject *StatManager::createWorker()
+{
+    return new StatWorker(this);
+}
+
+void StatManager::setupWorker()
+{
+    setMaxWorkersCount(1);
+
+    connect(this, &StatManager::logStatTrafFinished, this, &StatManager::onLogStatTrafFinished);
+}
+
 bool StatManager::setupDb()
 {
     if (!sqliteDb()->open()) {
@@ -209,9 +361,20 @@ bool StatManager::setupDb()
         return false;
     }
 
+    setupTrafRollup();
+
     return true;
 }
 
+void StatManager::setupTrafRollup()
+{
+    // The old database wrote the hours to the days and months directly:
+    // unroll its last hour, which is still being logged
+    sqliteDb()->beginWriteTransaction();
+    sqliteDb()->execute(StatSql::sqlSetupTrafRollup);
+    sqliteDb()->commitTransaction();
+}
+
 void StatManager::logClear()
 {
     m_appPidPathMap.clear();
@@ -240,17 +403,20 @@ void StatManager::clearCachedAppId(const QString &appPath)
 void StatManager::clearAppIdCache()
 {
     m_appPathIdCache.clear();
+    m_trafAppIds.clear();
 }
 
 bool StatManager::logProcNew(const LogEntryProcNew &entry, qint64 unixTime)
 {
+    Q_UNUSED(unixTime);
+
     const quint32 pid = entry.pid();
     const QString appPath = entry.path();
 
     Q_ASSERT(!m_appPidPathMap.contains(pid));
     m_appPidPathMap.insert(pid, appPath);
 
-    return getOrCreateAppId(appPath, unixTime) != INVALID_APP_ID;
+    return true;
 }
 
 bool StatManager::logStatTraf(const LogEntryStatTraf &entry, qint64 unixTime)
@@ -262,8 +428,6 @@ bool StatManager::logStatTraf(const LogEntryStatTraf &entry, qint64 unixTime)
 
     const bool isNewDay = updateTrafDay(unixTime);
 
-    sqliteDb()->beginWriteTransaction();
-
     // Delete old data
     if (isNewDay) {
         deleteOldTraffic(m_trafHour);
@@ -274,114 +438,110 @@ bool StatManager::logStatTraf(const LogEntryStatTraf &entry, qint64 unixTime)
     quint32 sumOutBytes = 0;
 
     const quint16 procCount = entry.procCount();
-    {
-        const quint32 *procTrafBytes = entry.procTrafBytes();
-
-        const SqliteStmtList insertTrafAppStmts = SqliteStmtList()
-                << getTrafficStmt(StatSql::sqlInsertTrafAppHour, m_trafHour)
-                << getTrafficStmt(StatSql::sqlInsertTrafAppDay, m_trafDay)
-                << getTrafficStmt(StatSql::sqlInsertTrafAppMonth, m_trafMonth)
-                << getTrafficStmt(StatSql::sqlInsertTrafAppTotal, m_trafHour);
-
-        const SqliteStmtList updateTrafAppStmts = SqliteStmtList()
-                << getTrafficStmt(StatSql::sqlUpdateTrafAppHour, m_trafHour)
-                << getTrafficStmt(StatSql::sqlUpdateTrafAppDay, m_trafDay)
-                << getTrafficStmt(StatSql::sqlUpdateTrafAppMonth, m_trafMonth)
-                << getTrafficStmt(StatSql::sqlUpdateTrafAppTotal, -1);
-
-        for (int i = 0; i < procCount; ++i) {
-            const quint32 pidFlag = *procTrafBytes++;
-            const quint32 inBytes = *procTrafBytes++;
-            const quint32 outBytes = *procTrafBytes++;
-
-            const bool inactive = (pidFlag & 1) != 0;
-            const quint32 pid = pidFlag & ~quint32(1);
-
-            logTrafBytes(insertTrafAppStmts, updateTrafAppStmts, sumInBytes, sumOutBytes, pid,
-                    inBytes, outBytes, unixTime, logStat);
-
-            if (inactive) {
-                logClearApp(pid);
-            }
+    const quint32 *procTrafBytes = entry.procTrafBytes();
+
+    for (int i = 0; i < procCount; ++i) {
+        const quint32 pidFlag = *procTrafBytes++;
+        const quint32 inBytes = *procTrafBytes++;
+        const quint32 outBytes = *procTrafBytes++;
+
+        const bool inactive = (pidFlag & 1) != 0;
+        const quint32 pid = pidFlag & ~quint32(1);
+
+        logTrafBytes(sumInBytes, sumOutBytes, pid, inBytes, outBytes, logStat);
+
+        if (inactive) {
+            logClearApp(pid);
         }
     }
 
     if (logStat) {
-        const SqliteStmtList insertTrafStmts = SqliteStmtList()
-                << getTrafficStmt(StatSql::sqlInsertTrafHour, m_trafHour)
-                << getTrafficStmt(StatSql::sqlInsertTrafDay, m_trafDay)
-                << getTrafficStmt(StatSql::sqlInsertTrafMonth, m_trafMonth);
+        // Accumulate total bytes
+        m_trafBytes.add(sumInBytes, sumOutBytes);
+    }
 
-        const SqliteStmtList updateTrafStmts = SqliteStmtList()
-                << getTrafficStmt(StatSql::sqlUpdateTrafHour, m_trafHour)
-                << getTrafficStmt(StatSql::sqlUpdateTrafDay, m_trafDay)
-                << getTrafficStmt(StatSql::sqlUpdateTrafMonth, m_trafMonth);
+    // Write the accumulated traffic periodically, keep accumulating while the writer is busy
+    if (isTrafFlushTime(unixTime) && !isWriteQueueFull()) {
+        flushTraf();
 
-        // Update or insert total bytes
-        updateTrafficList(insertTrafStmts, updateTrafStmts, sumInBytes, sumOutBytes);
+        m_trafFlushTime = unixTime;
     }
 
-    sqliteDb()->commitTransaction();
-
     // Check quotas
     checkQuotas(sumInBytes);
 
+    // Publish for the clients
+    if (m_statFeed) {
+        m_statFeed->publish(unixTime, sumInBytes, sumOutBytes);
+    }
+
     // Notify about sum traffic bytes
     emit trafficAdded(unixTime, sumInBytes, sumOutBytes);
 
     return true;
 }
 
-bool StatManager::deleteStatApp(qint64 appId)
+void StatManager::flushTraf()
 {
-    sqliteDb()->beginWriteTransaction();
-
-    DbUtil::doList({ getIdStmt(StatSql::sqlDeleteAppTrafHour, appId),
-            getIdStmt(StatSql::sqlDeleteAppTrafDay, appId),
-            getIdStmt(StatSql::sqlDeleteAppTrafMonth, appId),
-            getIdStmt(StatSql::sqlDeleteAppTrafTotal, appId) });
+    if (m_trafBytes.isEmpty() && m_appTrafBytes.isEmpty())
+        return;
 
-    deleteAppId(appId);
+    enqueueJob(WorkerJobPtr(new LogStatTrafJob(m_trafHour, m_trafBytes, m_appTrafBytes)));
 
-    sqliteDb()->commitTransaction();
+    clearTrafBytes();
+}
 
-    emit appStatRemoved(appId);
+bool StatManager::deleteStatApp(qint64 appId)
+{
+    enqueueJob(WorkerJobPtr(new DeleteStatTrafJob(DeleteStatTrafJob::DeleteAppTraffic, appId)));
 
     return true;
 }
 
 bool StatManager::resetAppTrafTotals()
 {
-    SqliteStmt *stmt = getStmt(StatSql::sqlResetAppTrafTotals);
-    const qint64 unixTime = DateUtil::getUnixTime();
+    flushTraf();
 
-    stmt->bindInt(1, DateUtil::getUnixHour(unixTime));
-
-    const bool ok = sqliteDb()->done(stmt);
+    const qint64 unixTime = DateUtil::getUnixTime();
+    const qint32 trafHour = DateUtil::getUnixHour(unixTime);
 
-    if (ok) {
-        emit appTrafTotalsResetted();
-    }
+    enqueueJob(
+            WorkerJobPtr(new DeleteStatTrafJob(DeleteStatTrafJob::ResetAppTrafTotals, trafHour)));
 
-    return ok;
+    return true;
 }
 
-bool StatManager::hasAppTraf(qint64 appId)
+bool StatManager::checkNewTrafApp(qint64 appId)
 {
-    SqliteStmt *stmt = getStmt(StatSql::sqlSelectStatAppExists);
+    if (m_trafAppIds.contains(appId))
+        return false;
+
+    m_trafAppIds.insert(appId);
+
+    SqliteStmt *stmt = getWriteStmt(StatSql::sqlSelectStatAppExists);
 
     stmt->bindInt64(1, appId);
-    const bool res = (stmt->step() == SqliteStmt::StepRow);
+    const bool exists = (stmt->step() == SqliteStmt::StepRow);
     stmt->reset();
 
-    return res;
+    return !exists;
+}
+
+bool StatManager::checkSealTrafHour(qint32 trafHour)
+{
+    if (m_sealedTrafHour == trafHour)
+        return false;
+
+    m_sealedTrafHour = trafHour;
+
+    return true;
 }
 
 qint64 StatManager::getAppId(const QString &appPath)
 {
     qint64 appId = INVALID_APP_ID;
 
-    SqliteStmt *stmt = getStmt(StatSql::sqlSelectAppId);
+    SqliteStmt *stmt = getWriteStmt(StatSql::sqlSelectAppId);
 
     stmt->bindText(1, appPath);
     if (stmt->step() == SqliteStmt::StepRow) {
@@ -394,7 +554,7 @@ qint64 StatManager::getAppId(const QString &appPath)
 
 qint64 StatManager::createAppId(const QString &appPath, qint64 unixTime)
 {
-    SqliteStmt *stmt = getStmt(StatSql::sqlInsertAppId);
+    SqliteStmt *stmt = getWriteStmt(StatSql::sqlInsertAppId);
 
     stmt->bindText(1, appPath);
     stmt->bindInt64(2, unixTime);
@@ -412,9 +572,6 @@ qint64 StatManager::getOrCreateAppId(const QString &appPath, qint64 unixTime)
     if (appId == INVALID_APP_ID) {
         appId = getAppId(appPath);
         if (appId == INVALID_APP_ID) {
-            if (unixTime == 0) {
-                unixTime = DateUtil::getUnixTime();
-            }
             appId = createAppId(appPath, unixTime);
         }
 
@@ -427,7 +584,9 @@ qint64 StatManager::getOrCreateAppId(const QString &appPath, qint64 unixTime)
 
 bool StatManager::deleteAppId(qint64 appId)
 {
-    SqliteStmt *stmt = getIdStmt(StatSql::sqlDeleteAppId, appId);
+    SqliteStmt *stmt = getWriteStmt(StatSql::sqlDeleteAppId);
+
+    stmt->bindInt64(1, appId);
 
     const bool ok = (stmt->step() == SqliteStmt::StepDone && sqliteDb()->changes() != 0);
     if (ok) {
@@ -435,41 +594,33 @@ bool StatManager::deleteAppId(qint64 appId)
         clearCachedAppId(appPath);
     }
     stmt->reset();
+
+    m_trafAppIds.remove(appId);
+
     return ok;
 }
 
 void StatManager::deleteOldTraffic(qint32 trafHour)
 {
-    SqliteStmtList deleteTrafStmts;
+    auto job = new DeleteStatTrafJob(DeleteStatTrafJob::DeleteOldTraffic);
 
     // Traffic Hour
     const int trafHourKeepDays = ini()->trafHourKeepDays();
-    if (trafHourKeepDays >= 0) {
-        const qint32 oldTrafHour = trafHour - 24 * trafHourKeepDays;
-
-        deleteTrafStmts << getTrafficStmt(StatSql::sqlDeleteTrafAppHour, oldTrafHour)
-                        << getTrafficStmt(StatSql::sqlDeleteTrafHour, oldTrafHour);
-    }
+    const qint32 oldTrafHour = (trafHourKeepDays >= 0) ? trafHour - 24 * trafHourKeepDays : -1;
 
     // Traffic Day
     const int trafDayKeepDays = ini()->trafDayKeepDays();
-    if (trafDayKeepDays >= 0) {
-        const qint32 oldTrafDay = trafHour - 24 * trafDayKeepDays;
-
-        deleteTrafStmts << getTrafficStmt(StatSql::sqlDeleteTrafAppDay, oldTrafDay)
-                        << getTrafficStmt(StatSql::sqlDeleteTrafDay, oldTrafDay);
-    }
+    const qint32 oldTrafDay = (trafDayKeepDays >= 0) ? trafHour - 24 * trafDayKeepDays : -1;
 
     // Traffic Month
     const int trafMonthKeepMonths = ini()->trafMonthKeepMonths();
-    if (trafMonthKeepMonths >= 0) {
-        const qint32 oldTrafMonth = DateUtil::addUnixMonths(trafHour, -trafMonthKeepMonths);
+    const qint32 oldTrafMonth = (trafMonthKeepMonths >= 0)
+            ? DateUtil::addUnixMonths(trafHour, -trafMonthKeepMonths)
+            : -1;
 
-        deleteTrafStmts << getTrafficStmt(StatSql::sqlDeleteTrafAppMonth, oldTrafMonth)
-                        << getTrafficStmt(StatSql::sqlDeleteTrafMonth, oldTrafMonth);
-    }
+    job->setOldTrafTimes(oldTrafHour, oldTrafDay, oldTrafMonth);
 
-    DbUtil::doList(deleteTrafStmts);
+    enqueueJob(WorkerJobPtr(job));
 }
 
 void StatManager::getStatAppList(QStringList &list, QVector<qint64> &appIds)
@@ -483,9 +634,8 @@ void StatManager::getStatAppList(QStringList &list, QVector<qint64> &appIds)
     stmt->reset();
 }
 
-void StatManager::logTrafBytes(const SqliteStmtList &insertStmtList,
-        const SqliteStmtList &updateStmtList, quint32 &sumInBytes, quint32 &sumOutBytes,
-        quint32 pid, quint32 inBytes, quint32 outBytes, qint64 unixTime, bool logStat)
+void StatManager::logTrafBytes(quint32 &sumInBytes, quint32 &sumOutBytes, quint32 pid,
+        quint32 inBytes, quint32 outBytes, bool logStat)
 {
     const QString appPath = m_appPidPathMap.value(pid);
 
@@ -498,16 +648,9 @@ void StatManager::logTrafBytes(const SqliteStmtList &insertStmtList,
     if (inBytes == 0 && outBytes == 0)
         return;
 
-    const qint64 appId = getOrCreateAppId(appPath, unixTime);
-    Q_ASSERT(appId != INVALID_APP_ID);
-
     if (logStat) {
-        if (!hasAppTraf(appId)) {
-            emit appCreated(appId, appPath);
-        }
-
-        // Update or insert app bytes
-        updateTrafficList(insertStmtList, updateStmtList, inBytes, outBytes, appId);
+        // Accumulate app bytes
+        m_appTrafBytes[appPath].add(inBytes, outBytes);
     }
 
     // Update sum traffic bytes
@@ -515,40 +658,13 @@ void StatManager::logTrafBytes(const SqliteStmtList &insertStmtList,
     sumOutBytes += outBytes;
 }
 
-void StatManager::updateTrafficList(const SqliteStmtList &insertStmtList,
-        const SqliteStmtList &updateStmtList, quint32 inBytes, quint32 outBytes, qint64 appId)
+qint32 StatManager::getTrafficTime(TrafType type, qint64 appId)
 {
-    int i = 0;
-    for (SqliteStmt *stmtUpdate : updateStmtList) {
-        if (!updateTraffic(stmtUpdate, inBytes, outBytes, appId)) {
-            SqliteStmt *stmtInsert = insertStmtList.at(i);
-            if (!updateTraffic(stmtInsert, inBytes, outBytes, appId)) {
-                qCCritical(LC) << "Update traffic error:" << sqliteDb()->errorMessage()
-                               << "inBytes:" << inBytes << "outBytes:" << outBytes
-                               << "appId:" << appId << "index:" << i;
-            }
-        }
-        ++i;
-    }
-}
+    qint32 trafTime = getSealedTrafficTime(type, appId);
+    if (trafTime != 0)
+        return trafTime;
 
-bool StatManager::updateTraffic(SqliteStmt *stmt, quint32 inBytes, quint32 outBytes, qint64 appId)
-{
-    stmt->bindInt64(2, inBytes);
-    stmt->bindInt64(3, outBytes);
-
-    if (appId != 0) {
-        stmt->bindInt64(4, appId);
-    }
-
-    return sqliteDb()->done(stmt);
-}
-
-qint32 StatManager::getTrafficTime(const char *sql, qint64 appId)
-{
-    qint32 trafTime = 0;
-
-    SqliteStmt *stmt = getStmt(sql);
+    SqliteStmt *stmt = getStmt((appId != 0 ? sqlSelectMinTrafApps : sqlSelectMinTrafs)[type]);
 
     if (appId != 0) {
         stmt->bindInt64(1, appId);
@@ -559,13 +675,26 @@ qint32 StatManager::getTrafficTime(const char *sql, qint64 appId)
     }
     stmt->reset();
 
+    if (trafTime == 0) {
+        trafTime = getUnrolledTrafficTime(type, appId);
+    }
+
     return trafTime;
 }
 
 void StatManager::getTraffic(
-        const char *sql, qint32 trafTime, qint64 &inBytes, qint64 &outBytes, qint64 appId)
+        TrafType type, qint32 trafTime, qint64 &inBytes, qint64 &outBytes, qint64 appId)
 {
-    SqliteStmt *stmt = getStmt(sql);
+    const bool isRollup = isRollupTrafType(type);
+
+    // Read the rolled up and the unrolled hours in the same snapshot
+    if (isRollup) {
+        roSqliteDb()->beginTransaction();
+    }
+
+    TrafBytes trafBytes;
+
+    SqliteStmt *stmt = getStmt((appId != 0 ? sqlSelectTrafApps : sqlSelectTrafs)[type]);
 
     stmt->bindInt(1, trafTime);
 
@@ -574,44 +703,96 @@ void StatManager::getTraffic(
     }
 
     if (stmt->step() == SqliteStmt::StepRow) {
-        inBytes = stmt->columnInt64(0);
-        outBytes = stmt->columnInt64(1);
+        trafBytes.add(stmt->columnInt64(0), stmt->columnInt64(1));
     } else {
-        inBytes = outBytes = 0;
+        getSealedTraffic(type, trafTime, appId, trafBytes);
     }
 
     stmt->reset();
+
+    if (isRollup) {
+        addUnrolledTraffic(type, trafTime, appId, trafBytes);
+
+        roSqliteDb()->commitTransaction();
+    }
+
+    inBytes = trafBytes.inBytes;
+    outBytes = trafBytes.outBytes;
 }
 
-SqliteStmt *StatManager::getStmt(const char *sql)
+qint32 StatManager::getRollupTrafTime(TrafType type, qint32 trafHour) const
 {
-    return sqliteDb()->stmt(sql);
+    const qint64 unixTime = DateUtil::toUnixTime(trafHour);
+
+    return (type == TrafDay) ? DateUtil::getUnixDay(unixTime)
+                             : DateUtil::getUnixMonth(unixTime, monthStart());
 }
 
-SqliteStmt *StatManager::getTrafficStmt(const char *sql, qint32 trafTime)
+qint32 StatManager::getUnrolledTrafficTime(TrafType type, qint64 appId)
 {
-    SqliteStmt *stmt = getStmt(sql);
+    if (!isRollupTrafType(type))
+        return 0;
 
-    stmt->bindInt(1, trafTime);
+    qint32 trafTime = 0;
+
+    SqliteStmt *stmt = getStmt(appId != 0 ? StatSql::sqlSelectTrafAppUnrolledHours
+                                          : StatSql::sqlSelectTrafUnrolledHours);
 
-    return stmt;
+    if (appId != 0) {
+        stmt->bindInt64(1, appId);
+    }
+
+    // The earliest unrolled hour
+    if (stmt->step() == SqliteStmt::StepRow) {
+        trafTime = getRollupTrafTime(type, stmt->columnInt(0));
+    }
+    stmt->reset();
+
+    return trafTime;
+}
+
+void StatManager::addUnrolledTraffic(
+        TrafType type, qint32 trafTime, qint64 appId, TrafBytes &trafBytes)
+{
+    SqliteStmt *stmt = getStmt(appId != 0 ? StatSql::sqlSelectTrafAppUnrolledHours
+                                          : StatSql::sqlSelectTrafUnrolledHours);
+
+    if (appId != 0) {
+        stmt->bindInt64(1, appId);
+    }
+
+    while (stmt->step() == SqliteStmt::StepRow) {
+        if (getRollupTrafTime(type, stmt->columnInt(0)) != trafTime)
+            continue;
+
+        trafBytes.add(stmt->columnInt64(1), stmt->columnInt64(2));
+    }
+    stmt->reset();
 }
 
-SqliteStmt *StatManager::getIdStmt(const char *sql, qint64 id)
+qint32 StatManager::getSealedTrafficTime(TrafType type, qint64 appId)
 {
-    SqliteStmt *stmt = getStmt(sql);
+    if (type != TrafHour || appId == 0)
+        return 0;
 
-    stmt->bindInt64(1, id);
+    return m_trafStore.getAppMinTrafHour(appId);
+}
 
-    return stmt;
+bool StatManager::getSealedTraffic(
+        TrafType type, qint32 trafTime, qint64 appId, TrafBytes &trafBytes)
+{
+    if (type != TrafHour || appId == 0)
+        return false;
+
+    return m_trafStore.getAppTraffic(appId, trafTime, trafBytes);
 }
 
-bool StatManager::beginTransaction()
+SqliteStmt *StatManager::getStmt(const char *sql)
 {
-    return sqliteDb()->beginWriteTransaction();
+    return roSqliteDb()->stmt(sql);
 }
 
-void StatManager::commitTransaction(bool &ok)
+SqliteStmt *StatManager::getWriteStmt(const char *sql)
 {
-    ok = sqliteDb()->endTransaction(ok);
+    return sqliteDb()->stmt(sql);
 }
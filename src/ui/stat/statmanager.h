@@ -3,6 +3,7 @@
 
 #include <QHash>
 #include <QObject>
+#include <QSet>
 #include <QStringList>
 #include <QVector>
 
@@ -10,17 +11,26 @@
 
 #include <util/classhelpers.h>
 #include <util/ioc/iocservice.h>
+#include <util/worker/workermanager.h>
+
+#include "stat_types.h"
+#include "statfeed.h"
+#include "trafsegmentstore.h"
 
 class FirewallConf;
 class IniOptions;
 class LogEntryProcNew;
 class LogEntryStatTraf;
 
-class StatManager : public QObject, public IocService
+class StatManager : public WorkerManager, public IocService
 {
     Q_OBJECT
 
 public:
+    static constexpr qint64 INVALID_APP_ID = Q_INT64_C(-1);
+
+    enum TrafType : qint8 { TrafHour = 0, TrafDay, TrafMonth, TrafTotal };
+
     explicit StatManager(const QString &filePath, QObject *parent = nullptr, quint32 openFlags = 0);
     CLASS_DELETE_COPY_MOVE(StatManager)
 
@@ -30,23 +40,45 @@ public:
     const IniOptions *ini() const;
 
     SqliteDb *sqliteDb() const { return m_sqliteDb.data(); }
+    SqliteDb *roSqliteDb() const;
+    SqliteDbPool *roDbPool() const { return m_roDbPool; }
+
+    TrafSegmentStore *trafStore() { return &m_trafStore; }
+
+    StatFeed *statFeed() const { return m_statFeed.data(); }
+    bool isStatFeedAttached() const { return m_statFeed && m_statFeed->isAttached(); }
+
+    // Backpressure of the writer
+    int maxJobCount() const { return m_maxJobCount; }
+    qint64 lastFlushMsec() const { return m_lastFlushMsec; }
+    qint64 maxFlushMsec() const { return m_maxFlushMsec; }
 
     void setUp() override;
+    void tearDown() override;
 
     bool logProcNew(const LogEntryProcNew &entry, qint64 unixTime = 0);
     bool logStatTraf(const LogEntryStatTraf &entry, qint64 unixTime = 0);
 
+    // Write the accumulated traffic to the database
+    void flushTraf();
+
     void getStatAppList(QStringList &list, QVector<qint64> &appIds);
 
     virtual bool deleteStatApp(qint64 appId);
 
     virtual bool resetAppTrafTotals();
-    bool hasAppTraf(qint64 appId);
 
-    qint32 getTrafficTime(const char *sql, qint64 appId = 0);
+    qint32 getTrafficTime(TrafType type, qint64 appId = 0);
 
     void getTraffic(
-            const char *sql, qint32 trafTime, qint64 &inBytes, qint64 &outBytes, qint64 appId = 0);
+            TrafType type, qint32 trafTime, qint64 &inBytes, qint64 &outBytes, qint64 appId = 0);
+
+    // Called by the jobs in the worker's thread
+    qint64 getOrCreateAppId(const QString &appPath, qint64 unixTime);
+    bool deleteAppId(qint64 appId);
+    bool checkNewTrafApp(qint64 appId);
+    bool checkSealTrafHour(qint32 trafHour);
+    void clearAppIdCache();
 
 signals:
     void trafficCleared();
@@ -54,16 +86,35 @@ signals:
     void appStatRemoved(qint64 appId);
     void appCreated(qint64 appId, const QString &appPath);
     void trafficAdded(qint64 unixTime, quint32 inBytes, quint32 outBytes);
+    void statFeedAttached();
 
     void connChanged();
 
     void appTrafTotalsResetted();
 
+    void logStatTrafFinished(qint64 flushMsec);
+    void rollupTrafFinished(qint32 trafHour);
+
 public slots:
     virtual bool clearTraffic();
 
+private:
+    void onLogStatTrafFinished(qint64 flushMsec);
+
+protected:
+    WorkerObject *createWorker() override;
+    bool canMergeJobs() const override { return true; }
+
+    virtual void setupWorker();
+    virtual void setupStatFeed();
+
+    virtual int monthStart() const;
+
+    void setStatFeed(StatFeed *statFeed) { m_statFeed.reset(statFeed); }
+
 private:
     bool setupDb();
+    void setupTrafRollup();
 
     void setupTrafDate();
 
@@ -77,41 +128,42 @@ private:
 
     bool updateTrafDay(qint64 unixTime);
 
+    bool isTrafFlushTime(qint64 unixTime) const;
+    bool isWriteQueueFull();
+    void clearTrafBytes();
+
+    void rollupTraf(qint32 trafHour);
+
     void logClear();
     void logClearApp(quint32 pid);
 
     void addCachedAppId(const QString &appPath, qint64 appId);
     qint64 getCachedAppId(const QString &appPath) const;
     void clearCachedAppId(const QString &appPath);
-    void clearAppIdCache();
 
     qint64 getAppId(const QString &appPath);
     qint64 createAppId(const QString &appPath, qint64 unixTime);
-    qint64 getOrCreateAppId(const QString &appPath, qint64 unixTime = 0);
-    bool deleteAppId(qint64 appId);
 
     void deleteOldTraffic(qint32 trafHour);
 
-    void logTrafBytes(const SqliteStmtList &insertStmtList, const SqliteStmtList &updateStmtList,
-            quint32 &sumInBytes, quint32 &sumOutBytes, quint32 pid, quint32 inBytes,
-            quint32 outBytes, qint64 unixTime, bool logStat);
+    qint32 getRollupTrafTime(TrafType type, qint32 trafHour) const;
 
-    void updateTrafficList(const SqliteStmtList &insertStmtList,
-            const SqliteStmtList &updateStmtList, quint32 inBytes, quint32 outBytes,
-            qint64 appId = 0);
+    qint32 getUnrolledTrafficTime(TrafType type, qint64 appId);
+    void addUnrolledTraffic(TrafType type, qint32 trafTime, qint64 appId, TrafBytes &trafBytes);
 
-    bool updateTraffic(SqliteStmt *stmt, quint32 inBytes, quint32 outBytes, qint64 appId = 0);
+    qint32 getSealedTrafficTime(TrafType type, qint64 appId);
+    bool getSealedTraffic(TrafType type, qint32 trafTime, qint64 appId, TrafBytes &trafBytes);
 
-    SqliteStmt *getStmt(const char *sql);
-    SqliteStmt *getTrafficStmt(const char *sql, qint32 trafTime);
-    SqliteStmt *getIdStmt(const char *sql, qint64 id);
+    void logTrafBytes(quint32 &sumInBytes, quint32 &sumOutBytes, quint32 pid, quint32 inBytes,
+            quint32 outBytes, bool logStat);
 
-    bool beginTransaction();
-    void commitTransaction(bool &ok);
+    SqliteStmt *getStmt(const char *sql);
+    SqliteStmt *getWriteStmt(const char *sql);
 
 private:
     bool m_isActivePeriodSet : 1 = false;
     bool m_isActivePeriod : 1 = false;
+    bool m_isWriteQueueFull : 1 = false;
 
     quint8 m_activePeriodFromHour = 0;
     quint8 m_activePeriodFromMinute = 0;
@@ -123,12 +175,33 @@ private:
     qint32 m_trafMonth = 0;
     qint32 m_tick = 0;
 
+    qint64 m_trafFlushTime = 0;
+
+    int m_maxJobCount = 0;
+    qint64 m_lastFlushMsec = 0;
+    qint64 m_maxFlushMsec = 0;
+
     const FirewallConf *m_conf = nullptr;
 
     SqliteDbPtr m_sqliteDb;
+    SqliteDbPool *m_roDbPool = nullptr; // read-only connections of threads
+
+    // Sealed hours of the apps' hourly traffic
+    TrafSegmentStore m_trafStore;
 
     QHash<quint32, QString> m_appPidPathMap; // pid -> appPath
+
+    // Traffic of the current hour, not flushed yet
+    TrafBytes m_trafBytes;
+    AppTrafBytesHash m_appTrafBytes;
+
+    // Traffic published for the service's clients
+    QScopedPointer<StatFeed> m_statFeed;
+
+    // Used in the worker's thread
+    qint32 m_sealedTrafHour = 0;
     QHash<QString, qint64> m_appPathIdCache; // appPath -> appId
+    QSet<qint64> m_trafAppIds; // apps having the total traffic
 };
 
 #endif // STATMANAGER_H
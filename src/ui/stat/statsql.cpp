@@ -12,68 +12,98 @@ const char *const StatSql::sqlSelectStatAppList = "SELECT t.app_id, t.path FROM
                                                   "  JOIN traffic_app ta ON ta.app_id = t.app_id"
                                                   "  ORDER BY t.app_id;";
 
-const char *const StatSql::sqlInsertTrafAppHour =
+const char *const StatSql::sqlUpsertTrafAppHour =
         "INSERT INTO traffic_app_hour(app_id, traf_time, in_bytes, out_bytes)"
-        "  VALUES(?4, ?1, ?2, ?3);";
+        "  VALUES(?4, ?1, ?2, ?3)"
+        "  ON CONFLICT(app_id, traf_time) DO UPDATE"
+        "  SET in_bytes = in_bytes + ?2, out_bytes = out_bytes + ?3;";
 
-const char *const StatSql::sqlInsertTrafAppDay =
-        "INSERT INTO traffic_app_day(app_id, traf_time, in_bytes, out_bytes)"
-        "  VALUES(?4, ?1, ?2, ?3);";
-
-const char *const StatSql::sqlInsertTrafAppMonth =
-        "INSERT INTO traffic_app_month(app_id, traf_time, in_bytes, out_bytes)"
-        "  VALUES(?4, ?1, ?2, ?3);";
-
-const char *const StatSql::sqlInsertTrafAppTotal =
+const char *const StatSql::sqlUpsertTrafAppTotal =
         "INSERT INTO traffic_app(app_id, traf_time, in_bytes, out_bytes)"
-        "  VALUES(?4, ?1, ?2, ?3);";
+        "  VALUES(?4, ?1, ?2, ?3)"
+        "  ON CONFLICT(app_id) DO UPDATE"
+        "  SET in_bytes = in_bytes + ?2, out_bytes = out_bytes + ?3;";
 
-const char *const StatSql::sqlInsertTrafHour =
+const char *const StatSql::sqlUpsertTrafHour =
         "INSERT INTO traffic_hour(traf_time, in_bytes, out_bytes)"
-        "  VALUES(?1, ?2, ?3);";
+        "  VALUES(?1, ?2, ?3)"
+        "  ON CONFLICT(traf_time) DO UPDATE"
+        "  SET in_bytes = in_bytes + ?2, out_bytes = out_bytes + ?3;";
+
+const char *const StatSql::sqlSetupTrafRollup =
+        "UPDATE traffic_app_day AS d"
+        "  SET in_bytes = d.in_bytes - h.in_bytes, out_bytes = d.out_bytes - h.out_bytes"
+        "  FROM traffic_app_hour AS h"
+        "  WHERE h.traf_time = (SELECT max(traf_time) FROM traffic_hour) AND d.app_id = h.app_id"
+        "    AND d.traf_time = (SELECT max(traf_time) FROM traffic_day)"
+        "    AND NOT EXISTS (SELECT 1 FROM traffic_rollup);"
+        "UPDATE traffic_app_month AS m"
+        "  SET in_bytes = m.in_bytes - h.in_bytes, out_bytes = m.out_bytes - h.out_bytes"
+        "  FROM traffic_app_hour AS h"
+        "  WHERE h.traf_time = (SELECT max(traf_time) FROM traffic_hour) AND m.app_id = h.app_id"
+        "    AND m.traf_time = (SELECT max(traf_time) FROM traffic_month)"
+        "    AND NOT EXISTS (SELECT 1 FROM traffic_rollup);"
+        "UPDATE traffic_day AS d"
+        "  SET in_bytes = d.in_bytes - h.in_bytes, out_bytes = d.out_bytes - h.out_bytes"
+        "  FROM traffic_hour AS h"
+        "  WHERE h.traf_time = (SELECT max(traf_time) FROM traffic_hour)"
+        "    AND d.traf_time = (SELECT max(traf_time) FROM traffic_day)"
+        "    AND NOT EXISTS (SELECT 1 FROM traffic_rollup);"
+        "UPDATE traffic_month AS m"
+        "  SET in_bytes = m.in_bytes - h.in_bytes, out_bytes = m.out_bytes - h.out_bytes"
+        "  FROM traffic_hour AS h"
+        "  WHERE h.traf_time = (SELECT max(traf_time) FROM traffic_hour)"
+        "    AND m.traf_time = (SELECT max(traf_time) FROM traffic_month)"
+        "    AND NOT EXISTS (SELECT 1 FROM traffic_rollup);"
+        "INSERT INTO traffic_rollup(traf_time)"
+        "  SELECT t FROM (SELECT coalesce(max(traf_time), 0) AS t FROM traffic_hour)"
+        "  WHERE NOT EXISTS (SELECT 1 FROM traffic_rollup);";
+
+const char *const StatSql::sqlSelectTrafRollupTime = "SELECT traf_time FROM traffic_rollup;";
+
+const char *const StatSql::sqlUpdateTrafRollupTime = "UPDATE traffic_rollup SET traf_time = ?1;";
+
+const char *const StatSql::sqlSelectTrafHoursToRollup = "SELECT traf_time FROM traffic_hour"
+                                                        "  WHERE traf_time >= ?1 AND traf_time < ?2"
+                                                        "  ORDER BY traf_time;";
+
+const char *const StatSql::sqlRollupTrafAppDay =
+        "INSERT INTO traffic_app_day(app_id, traf_time, in_bytes, out_bytes)"
+        "  SELECT app_id, ?2, in_bytes, out_bytes FROM traffic_app_hour WHERE traf_time = ?1"
+        "  ON CONFLICT(app_id, traf_time) DO UPDATE"
+        "  SET in_bytes = in_bytes + excluded.in_bytes,"
+        "    out_bytes = out_bytes + excluded.out_bytes;";
+
+const char *const StatSql::sqlRollupTrafAppMonth =
+        "INSERT INTO traffic_app_month(app_id, traf_time, in_bytes, out_bytes)"
+        "  SELECT app_id, ?2, in_bytes, out_bytes FROM traffic_app_hour WHERE traf_time = ?1"
+        "  ON CONFLICT(app_id, traf_time) DO UPDATE"
+        "  SET in_bytes = in_bytes + excluded.in_bytes,"
+        "    out_bytes = out_bytes + excluded.out_bytes;";
 
-const char *const StatSql::sqlInsertTrafDay =
+const char *const StatSql::sqlRollupTrafDay =
         "INSERT INTO traffic_day(traf_time, in_bytes, out_bytes)"
-        "  VALUES(?1, ?2, ?3);";
+        "  SELECT ?2, in_bytes, out_bytes FROM traffic_hour WHERE traf_time = ?1"
+        "  ON CONFLICT(traf_time) DO UPDATE"
+        "  SET in_bytes = in_bytes + excluded.in_bytes,"
+        "    out_bytes = out_bytes + excluded.out_bytes;";
 
-const char *const StatSql::sqlInsertTrafMonth =
+const char *const StatSql::sqlRollupTrafMonth =
         "INSERT INTO traffic_month(traf_time, in_bytes, out_bytes)"
-        "  VALUES(?1, ?2, ?3);";
-
-const char *const StatSql::sqlUpdateTrafAppHour = "UPDATE traffic_app_hour"
-                                                  "  SET in_bytes = in_bytes + ?2,"
-                                                  "    out_bytes = out_bytes + ?3"
-                                                  "  WHERE app_id = ?4 AND traf_time = ?1;";
-
-const char *const StatSql::sqlUpdateTrafAppDay = "UPDATE traffic_app_day"
-                                                 "  SET in_bytes = in_bytes + ?2,"
-                                                 "    out_bytes = out_bytes + ?3"
-                                                 "  WHERE app_id = ?4 AND traf_time = ?1;";
-
-const char *const StatSql::sqlUpdateTrafAppMonth = "UPDATE traffic_app_month"
-                                                   "  SET in_bytes = in_bytes + ?2,"
-                                                   "    out_bytes = out_bytes + ?3"
-                                                   "  WHERE app_id = ?4 AND traf_time = ?1;";
-
-const char *const StatSql::sqlUpdateTrafAppTotal = "UPDATE traffic_app"
-                                                   "  SET in_bytes = in_bytes + ?2,"
-                                                   "    out_bytes = out_bytes + ?3"
-                                                   "  WHERE app_id = ?4 AND 0 != ?1;";
-
-const char *const StatSql::sqlUpdateTrafHour = "UPDATE traffic_hour"
-                                               "  SET in_bytes = in_bytes + ?2,"
-                                               "    out_bytes = out_bytes + ?3"
-                                               "  WHERE traf_time = ?1;";
-
-const char *const StatSql::sqlUpdateTrafDay = "UPDATE traffic_day"
-                                              "  SET in_bytes = in_bytes + ?2,"
-                                              "    out_bytes = out_bytes + ?3"
-                                              "  WHERE traf_time = ?1;";
-
-const char *const StatSql::sqlUpdateTrafMonth = "UPDATE traffic_month"
-                                                "  SET in_bytes = in_bytes + ?2,"
-                                                "    out_bytes = out_bytes + ?3"
-                                                "  WHERE traf_time = ?1;";
+        "  SELECT ?2, in_bytes, out_bytes FROM traffic_hour WHERE traf_time = ?1"
+        "  ON CONFLICT(traf_time) DO UPDATE"
+        "  SET in_bytes = in_bytes + excluded.in_bytes,"
+        "    out_bytes = out_bytes + excluded.out_bytes;";
+
+const char *const StatSql::sqlSelectTrafAppUnrolledHours =
+        "SELECT traf_time, in_bytes, out_bytes FROM traffic_app_hour"
+        "  WHERE app_id = ?1 AND traf_time >= (SELECT traf_time FROM traffic_rollup)"
+        "  ORDER BY traf_time;";
+
+const char *const StatSql::sqlSelectTrafUnrolledHours =
+        "SELECT traf_time, in_bytes, out_bytes FROM traffic_hour"
+        "  WHERE traf_time >= (SELECT traf_time FROM traffic_rollup)"
+        "  ORDER BY traf_time;";
 
 const char *const StatSql::sqlSelectMinTrafAppHour = "SELECT min(traf_time) FROM traffic_app_hour"
                                                      "  WHERE app_id = ?1;";
@@ -123,6 +153,18 @@ const char *const StatSql::sqlSelectTrafMonth = "SELECT in_bytes, out_bytes"
 const char *const StatSql::sqlSelectTrafTotal = "SELECT sum(in_bytes), sum(out_bytes)"
                                                 "  FROM traffic_app WHERE 0 != ?1;";
 
+const char *const StatSql::sqlSelectTrafAppHoursToSeal =
+        "SELECT traf_time, app_id, in_bytes, out_bytes"
+        "  FROM traffic_app_hour"
+        "  WHERE traf_time < ?1"
+        "    AND traf_time < (SELECT traf_time FROM traffic_rollup)"
+        "  ORDER BY traf_time, app_id;";
+
+const char *const StatSql::sqlDeleteSealedTrafAppHours =
+        "DELETE FROM traffic_app_hour"
+        "  WHERE traf_time < ?1"
+        "    AND traf_time < (SELECT traf_time FROM traffic_rollup);";
+
 const char *const StatSql::sqlDeleteTrafAppHour = "DELETE FROM traffic_app_hour"
                                                   "  WHERE traf_time < ?1 AND app_id > 0;";
 
@@ -172,13 +214,13 @@ const char *const StatSql::sqlInsertConnBlock =
 const char *const StatSql::sqlSelectMinMaxConnBlockId =
         "SELECT MIN(conn_id), MAX(conn_id) FROM conn_block;";
 
+const char *const StatSql::sqlSelectConnBlockAppCounts = "SELECT app_id, count(*) FROM conn_block"
+                                                         "  WHERE conn_id <= ?1 GROUP BY app_id;";
+
 const char *const StatSql::sqlDeleteConnBlock = "DELETE FROM conn_block WHERE conn_id <= ?1;";
 
-const char *const StatSql::sqlDeleteConnBlockApps =
-        "DELETE FROM app t"
-        "  WHERE ("
-        "    SELECT 1 FROM conn_block c WHERE c.app_id = t.app_id LIMIT 1"
-        "  ) IS NULL;";
+const char *const StatSql::sqlUpdateAppConnCount = "UPDATE app SET conn_count = conn_count + ?2"
+                                                   "  WHERE app_id = ?1 RETURNING conn_count;";
 
 const char *const StatSql::sqlDeleteAllConnBlock = "DELETE FROM conn_block;";
 
@@ -11,24 +11,23 @@ public:
     static const char *const sqlSelectStatAppExists;
     static const char *const sqlSelectStatAppList;
 
-    static const char *const sqlInsertTrafAppHour;
-    static const char *const sqlInsertTrafAppDay;
-    static const char *const sqlInsertTrafAppMonth;
-    static const char *const sqlInsertTrafAppTotal;
+    static const char *const sqlUpsertTrafAppHour;
+    static const char *const sqlUpsertTrafAppTotal;
 
-    static const char *const sqlInsertTrafHour;
-    static const char *const sqlInsertTrafDay;
-    static const char *const sqlInsertTrafMonth;
+    static const char *const sqlUpsertTrafHour;
 
-    static const char *const sqlUpdateTrafAppHour;
-    static const char *const sqlUpdateTrafAppDay;
-    static const char *const sqlUpdateTrafAppMonth;
+    static const char *const sqlSetupTrafRollup;
+    static const char *const sqlSelectTrafRollupTime;
+    static const char *const sqlUpdateTrafRollupTime;
 
-    static const char *const sqlUpdateTrafHour;
-    static const char *const sqlUpdateTrafDay;
-    static const char *const sqlUpdateTrafMonth;
+    static const char *const sqlSelectTrafHoursToRollup;
+    static const char *const sqlRollupTrafAppDay;
+    static const char *const sqlRollupTrafAppMonth;
+    static const char *const sqlRollupTrafDay;
+    static const char *const sqlRollupTrafMonth;
 
-    static const char *const sqlUpdateTrafAppTotal;
+    static const char *const sqlSelectTrafAppUnrolledHours;
+    static const char *const sqlSelectTrafUnrolledHours;
 
     static const char *const sqlSelectMinTrafAppHour;
     static const char *const sqlSelectMinTrafAppDay;
@@ -50,6 +49,9 @@ public:
     static const char *const sqlSelectTrafMonth;
     static const char *const sqlSelectTrafTotal;
 
+    static const char *const sqlSelectTrafAppHoursToSeal;
+    static const char *const sqlDeleteSealedTrafAppHours;
+
     static const char *const sqlDeleteTrafAppHour;
     static const char *const sqlDeleteTrafAppDay;
     static const char *const sqlDeleteTrafAppMonth;
@@ -70,8 +72,9 @@ public:
 
     static const char *const sqlSelectMinMaxConnBlockId;
 
+    static const char *const sqlSelectConnBlockAppCounts;
     static const char *const sqlDeleteConnBlock;
-    static const char *const sqlDeleteConnBlockApps;
+    static const char *const sqlUpdateAppConnCount;
 
     static const char *const sqlDeleteAllConnBlock;
     static const char *const sqlDeleteAllApps;
@@ -0,0 +1,5 @@
+#include "statworker.h"
+
+#include "statmanager.h"
+
+StatWorker::StatWorker(StatManager *manager) : WorkerObject(manager) { }
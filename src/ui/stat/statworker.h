@@ -0,0 +1,18 @@
+#ifndef STATWORKER_H
+#define STATWORKER_H
+
+#include <util/worker/workerobject.h>
+
+class StatManager;
+
+class StatWorker : public WorkerObject
+{
+public:
+    explicit StatWorker(StatManager *manager);
+
+    QThread::Priority priority() const override { return QThread::HighPriority; }
+
+    QString workerName() const override { return "StatWorker"; }
+};
+
+#endif // STATWORKER_H
@@ -0,0 +1,605 @@
+#include "trafsegmentstore.h"
+
+#include <algorithm>
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QLoggingCategory>
+
+#include <util/fileutil.h>
+
+namespace {
+
+const QLoggingCategory LC("stat.trafSegment");
+
+constexpr quint32 segmentBlockMagic = 0x53544652; // "RFTS"
+constexpr quint8 segmentBlockVersion = 1;
+
+const QString segmentFileSuffix = QStringLiteral(".seg");
+
+struct TrafSegmentBlockHeader
+{
+    quint32 magic;
+    quint8 version;
+    qint8 hour_offset;
+    quint16 checksum; // of the payload
+
+    quint32 count;
+    quint32 in_offset;
+    quint32 out_offset;
+    quint32 size; // of the payload
+
+    qint64 min_app_id;
+    qint64 max_app_id;
+};
+
+static_assert(sizeof(TrafSegmentBlockHeader) == 40, "TrafSegmentBlockHeader size mismatch");
+
+void putVarint(QByteArray &data, quint64 v)
+{
+    while (v >= 0x80) {
+        data.append(char(v | 0x80));
+        v >>= 7;
+    }
+    data.append(char(v));
+}
+
+bool getVarint(const uchar *&p, const uchar *end, quint64 &v)
+{
+    v = 0;
+
+    for (int shift = 0; p < end && shift < 64; shift += 7) {
+        const uchar c = *p++;
+
+        v |= quint64(c & 0x7F) << shift;
+
+        if ((c & 0x80) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+bool skipVarints(const uchar *&p, const uchar *end, int count)
+{
+    while (count > 0 && p < end) {
+        if ((*p++ & 0x80) == 0) {
+            --count;
+        }
+    }
+
+    return count == 0;
+}
+
+quint16 payloadChecksum(const char *data, qsizetype size)
+{
+    return qChecksum(QByteArrayView(data, size));
+}
+
+}
+
+TrafSegmentStore::TrafSegmentStore(const QString &dirPath) :
+    m_dirPath(dirPath.isEmpty() ? QString() : FileUtil::pathSlash(dirPath))
+{
+}
+
+bool TrafSegmentStore::appendHour(qint32 trafHour, const AppTrafRowList &rows)
+{
+    if (!isEnabled())
+        return false;
+
+    QMutexLocker locker(&m_mutex);
+
+    const qint32 day = segmentDay(trafHour);
+    const qint8 hourOffset = qint8(trafHour - day * 24);
+
+    const Segment *seg = segment(day);
+    qint64 validSize = 0;
+
+    if (seg) {
+        // The blocks are immutable: an already sealed hour is skipped
+        for (const BlockIndex &block : seg->blocks) {
+            if (block.hourOffset == hourOffset)
+                return true;
+        }
+
+        validSize = seg->validSize;
+    }
+
+    const QByteArray data = encodeBlock(hourOffset, rows);
+
+    FileUtil::makePath(m_dirPath);
+
+    QFile file(segmentFilePath(day));
+    if (!file.open(QFile::ReadWrite)) {
+        qCWarning(LC) << "File open error:" << file.fileName() << file.errorString();
+        return false;
+    }
+
+    // Drop a torn tail of the interrupted write
+    if (file.size() > validSize) {
+        file.resize(validSize);
+    }
+
+    const bool ok = file.seek(validSize) && file.write(data) == data.size();
+
+    file.close();
+
+    m_segments.remove(day);
+
+    if (m_cachedDay == day) {
+        invalidateCache();
+    }
+
+    if (!ok) {
+        qCWarning(LC) << "File write error:" << file.fileName() << file.errorString();
+    }
+
+    return ok;
+}
+
+void TrafSegmentStore::removeBefore(qint32 trafHour)
+{
+    if (!isEnabled())
+        return;
+
+    QMutexLocker locker(&m_mutex);
+
+    const auto days = segmentDays();
+
+    for (const qint32 day : days) {
+        if ((day + 1) * 24 > trafHour)
+            break;
+
+        FileUtil::removeFile(segmentFilePath(day));
+
+        m_segments.remove(day);
+    }
+
+    invalidateCache();
+}
+
+bool TrafSegmentStore::removeApp(qint64 appId)
+{
+    if (!isEnabled())
+        return false;
+
+    QMutexLocker locker(&m_mutex);
+
+    bool removed = false;
+
+    const auto days = segmentDays();
+
+    for (const qint32 day : days) {
+        const Segment *seg = segment(day);
+        if (!seg)
+            continue;
+
+        const bool hasApp = std::any_of(seg->blocks.constBegin(), seg->blocks.constEnd(),
+                [&](const BlockIndex &block) {
+                    return appId >= block.minAppId && appId <= block.maxAppId;
+                });
+        if (!hasApp)
+            continue;
+
+        // Rewrite the segment without the app
+        const QString filePath = segmentFilePath(day);
+
+        const QByteArray fileData = FileUtil::readFileData(filePath);
+        QByteArray newData;
+        bool ok = true;
+
+        for (const BlockIndex &block : seg->blocks) {
+            if (appId < block.minAppId || appId > block.maxAppId) {
+                newData.append(fileData.mid(block.offset - sizeof(TrafSegmentBlockHeader),
+                        sizeof(TrafSegmentBlockHeader) + block.size));
+                continue;
+            }
+
+            AppTrafRowList rows;
+            ok = decodeBlock(fileData, block, rows);
+            if (!ok)
+                break;
+
+            rows.removeIf([&](const AppTrafRow &row) { return row.appId == appId; });
+
+            newData.append(encodeBlock(block.hourOffset, rows));
+        }
+
+        // Keep the segment as is, rather than lose its other apps
+        if (!ok) {
+            qCWarning(LC) << "Segment decode error:" << filePath;
+            continue;
+        }
+
+        const QString tmpFilePath = filePath + ".tmp";
+
+        if (!FileUtil::writeFileData(tmpFilePath, newData)
+                || !FileUtil::renameFile(tmpFilePath, filePath)) {
+            qCWarning(LC) << "Segment rewrite error:" << filePath;
+            continue;
+        }
+
+        m_segments.remove(day);
+
+        removed = true;
+    }
+
+    invalidateCache();
+
+    return removed;
+}
+
+void TrafSegmentStore::clear()
+{
+    if (!isEnabled())
+        return;
+
+    QMutexLocker locker(&m_mutex);
+
+    const auto days = segmentDays();
+
+    for (const qint32 day : days) {
+        FileUtil::removeFile(segmentFilePath(day));
+    }
+
+    m_segments.clear();
+
+    invalidateCache();
+}
+
+bool TrafSegmentStore::getAppTraffic(qint64 appId, qint32 trafHour, TrafBytes &trafBytes)
+{
+    if (!isEnabled())
+        return false;
+
+    QMutexLocker locker(&m_mutex);
+
+    const qint32 day = segmentDay(trafHour);
+    const int hourOffset = trafHour - day * 24;
+
+    const Segment *seg = segment(day);
+    if (!seg)
+        return false;
+
+    if (m_cachedAppId != appId || m_cachedDay != day || m_cachedFileSize != seg->fileSize) {
+        invalidateCache();
+
+        if (!readAppDay(appId, day, m_cachedDayTraf, m_cachedDayHas))
+            return false;
+
+        m_cachedAppId = appId;
+        m_cachedDay = day;
+        m_cachedFileSize = seg->fileSize;
+    }
+
+    if (!m_cachedDayHas[hourOffset])
+        return false;
+
+    trafBytes = m_cachedDayTraf[hourOffset];
+
+    return true;
+}
+
+qint32 TrafSegmentStore::getAppMinTrafHour(qint64 appId)
+{
+    if (!isEnabled())
+        return 0;
+
+    QMutexLocker locker(&m_mutex);
+
+    const auto days = segmentDays();
+
+    for (const qint32 day : days) {
+        const Segment *seg = segment(day);
+        if (!seg)
+            continue;
+
+        // The blocks' app id ranges skip the days without the app
+        QVector<BlockIndex> blocks;
+
+        for (const BlockIndex &block : seg->blocks) {
+            if (appId >= block.minAppId && appId <= block.maxAppId) {
+                blocks.append(block);
+            }
+        }
+
+        if (blocks.isEmpty())
+            continue;
+
+        std::sort(blocks.begin(), blocks.end(), [](const BlockIndex &a, const BlockIndex &b) {
+            return a.hourOffset < b.hourOffset;
+        });
+
+        QFile file(segmentFilePath(day));
+        if (!file.open(QFile::ReadOnly))
+            continue;
+
+        for (const BlockIndex &block : blocks) {
+            if (!file.seek(block.offset))
+                break;
+
+            const QByteArray data = file.read(block.size);
+
+            TrafBytes trafBytes;
+            if (readBlockApp(data, block, appId, trafBytes))
+                return day * 24 + block.hourOffset;
+        }
+    }
+
+    return 0;
+}
+
+qint32 TrafSegmentStore::segmentDay(qint32 trafHour)
+{
+    return (trafHour >= 0) ? trafHour / 24 : (trafHour - 23) / 24;
+}
+
+QString TrafSegmentStore::segmentFilePath(qint32 day) const
+{
+    return m_dirPath + QString::number(day) + segmentFileSuffix;
+}
+
+QVector<qint32> TrafSegmentStore::segmentDays() const
+{
+    QVector<qint32> days;
+
+    const QStringList fileNames =
+            QDir(m_dirPath).entryList({ '*' + segmentFileSuffix }, QDir::Files);
+
+    for (const QString &fileName : fileNames) {
+        bool ok;
+        const qint32 day = QStringView(fileName).chopped(segmentFileSuffix.size()).toInt(&ok);
+        if (ok) {
+            days.append(day);
+        }
+    }
+
+    std::sort(days.begin(), days.end());
+
+    return days;
+}
+
+TrafSegmentStore::Segment *TrafSegmentStore::segment(qint32 day)
+{
+    const QFileInfo fi(segmentFilePath(day));
+
+    if (!fi.exists()) {
+        m_segments.remove(day);
+        return nullptr;
+    }
+
+    Segment &seg = m_segments[day];
+
+    // The segment was appended by another process?
+    if (seg.fileSize != fi.size()) {
+        seg = {};
+
+        if (!readSegment(day, seg)) {
+            m_segments.remove(day);
+            return nullptr;
+        }
+    }
+
+    return &seg;
+}
+
+bool TrafSegmentStore::readSegment(qint32 day, Segment &seg) const
+{
+    QFile file(segmentFilePath(day));
+    if (!file.open(QFile::ReadOnly))
+        return false;
+
+    const qint64 fileSize = file.size();
+    qint64 offset = 0;
+
+    TrafSegmentBlockHeader header;
+
+    while (offset + qint64(sizeof(header)) <= fileSize) {
+        if (!file.seek(offset)
+                || file.read((char *) &header, sizeof(header)) != qint64(sizeof(header)))
+            break;
+
+        const qint64 payloadOffset = offset + sizeof(header);
+
+        if (header.magic != segmentBlockMagic || header.version != segmentBlockVersion
+                || header.hour_offset < 0 || header.hour_offset >= 24
+                || header.in_offset > header.out_offset || header.out_offset > header.size
+                || payloadOffset + header.size > fileSize)
+            break; // torn tail
+
+        BlockIndex block;
+        block.hourOffset = header.hour_offset;
+        block.count = header.count;
+        block.offset = quint32(payloadOffset);
+        block.inOffset = header.in_offset;
+        block.outOffset = header.out_offset;
+        block.size = header.size;
+        block.minAppId = header.min_app_id;
+        block.maxAppId = header.max_app_id;
+
+        seg.blocks.append(block);
+
+        offset = payloadOffset + header.size;
+    }
+
+    if (offset != fileSize) {
+        qCDebug(LC) << "Segment has a torn tail:" << file.fileName() << offset << fileSize;
+    }
+
+    seg.fileSize = fileSize;
+    seg.validSize = offset;
+
+    return true;
+}
+
+void TrafSegmentStore::invalidateCache()
+{
+    m_cachedAppId = 0;
+    m_cachedDay = -1;
+    m_cachedFileSize = -1;
+
+    std::fill(m_cachedDayTraf, m_cachedDayTraf + 24, TrafBytes());
+    std::fill(m_cachedDayHas, m_cachedDayHas + 24, false);
+}
+
+bool TrafSegmentStore::readAppDay(qint64 appId, qint32 day, TrafBytes *dayTraf, bool *dayHas)
+{
+    const Segment *seg = segment(day);
+    if (!seg)
+        return false;
+
+    QFile file(segmentFilePath(day));
+    if (!file.open(QFile::ReadOnly))
+        return false;
+
+    for (const BlockIndex &block : seg->blocks) {
+        if (appId < block.minAppId || appId > block.maxAppId)
+            continue;
+
+        if (!file.seek(block.offset))
+            return false;
+
+        const QByteArray data = file.read(block.size);
+
+        TrafBytes &trafBytes = dayTraf[block.hourOffset];
+        trafBytes = {};
+
+        if (readBlockApp(data, block, appId, trafBytes)) {
+            dayHas[block.hourOffset] = true;
+        }
+    }
+
+    return true;
+}
+
+bool TrafSegmentStore::readBlockApp(
+        const QByteArray &data, const BlockIndex &block, qint64 appId, TrafBytes &trafBytes) const
+{
+    if (data.size() != qsizetype(block.size))
+        return false;
+
+    const uchar *begin = (const uchar *) data.constData();
+    const uchar *inBegin = begin + block.inOffset;
+    const uchar *outBegin = begin + block.outOffset;
+    const uchar *end = begin + block.size;
+
+    // Find the app's index in the sorted app ids column
+    const uchar *p = begin;
+    qint64 id = 0;
+    int index = 0;
+
+    for (;; ++index) {
+        if (quint32(index) >= block.count)
+            return false;
+
+        quint64 delta;
+        if (!getVarint(p, inBegin, delta))
+            return false;
+
+        id += qint64(delta);
+
+        if (id >= appId)
+            break;
+    }
+
+    if (id != appId)
+        return false;
+
+    quint64 inBytes, outBytes;
+
+    const uchar *inP = inBegin;
+    if (!skipVarints(inP, outBegin, index) || !getVarint(inP, outBegin, inBytes))
+        return false;
+
+    const uchar *outP = outBegin;
+    if (!skipVarints(outP, end, index) || !getVarint(outP, end, outBytes))
+        return false;
+
+    trafBytes.inBytes = qint64(inBytes);
+    trafBytes.outBytes = qint64(outBytes);
+
+    return true;
+}
+
+QByteArray TrafSegmentStore::encodeBlock(qint8 hourOffset, const AppTrafRowList &rows)
+{
+    QByteArray idsData, inData, outData;
+
+    qint64 prevAppId = 0;
+
+    for (const AppTrafRow &row : rows) {
+        Q_ASSERT(row.appId >= prevAppId);
+
+        putVarint(idsData, quint64(row.appId - prevAppId));
+        putVarint(inData, quint64(row.trafBytes.inBytes));
+        putVarint(outData, quint64(row.trafBytes.outBytes));
+
+        prevAppId = row.appId;
+    }
+
+    TrafSegmentBlockHeader header;
+    header.magic = segmentBlockMagic;
+    header.version = segmentBlockVersion;
+    header.hour_offset = hourOffset;
+    header.count = quint32(rows.size());
+    header.in_offset = quint32(idsData.size());
+    header.out_offset = quint32(idsData.size() + inData.size());
+    header.size = quint32(idsData.size() + inData.size() + outData.size());
+    header.min_app_id = rows.isEmpty() ? 1 : rows.first().appId;
+    header.max_app_id = rows.isEmpty() ? 0 : rows.last().appId;
+
+    QByteArray data;
+    data.reserve(sizeof(header) + header.size);
+    data.append((const char *) &header, sizeof(header));
+    data.append(idsData);
+    data.append(inData);
+    data.append(outData);
+
+    // Checksum of the payload
+    auto &dataHeader = *(TrafSegmentBlockHeader *) data.data();
+    dataHeader.checksum = payloadChecksum(data.constData() + sizeof(header), header.size);
+
+    return data;
+}
+
+bool TrafSegmentStore::decodeBlock(
+        const QByteArray &data, const BlockIndex &block, AppTrafRowList &rows)
+{
+    if (qsizetype(block.offset + block.size) > data.size())
+        return false;
+
+    const uchar *begin = (const uchar *) data.constData() + block.offset;
+    const uchar *ids = begin;
+    const uchar *ins = begin + block.inOffset;
+    const uchar *outs = begin + block.outOffset;
+    const uchar *end = begin + block.size;
+
+    const auto &header = *(const TrafSegmentBlockHeader *) (begin - sizeof(TrafSegmentBlockHeader));
+    if (header.checksum != payloadChecksum((const char *) begin, block.size)) {
+        qCWarning(LC) << "Segment block checksum mismatch";
+        return false;
+    }
+
+    rows.reserve(block.count);
+
+    const uchar *inEnd = begin + block.inOffset;
+    const uchar *outEnd = begin + block.outOffset;
+
+    qint64 appId = 0;
+
+    for (quint32 i = 0; i < block.count; ++i) {
+        quint64 delta, inBytes, outBytes;
+
+        if (!getVarint(ids, inEnd, delta) || !getVarint(ins, outEnd, inBytes)
+                || !getVarint(outs, end, outBytes))
+            return false;
+
+        appId += qint64(delta);
+
+        rows.append({ appId, { qint64(inBytes), qint64(outBytes) } });
+    }
+
+    return true;
+}
@@ -0,0 +1,91 @@
+#ifndef TRAFSEGMENTSTORE_H
+#define TRAFSEGMENTSTORE_H
+
+#include <QHash>
+#include <QMutex>
+#include <QVector>
+
+#include <util/classhelpers.h>
+
+#include "stat_types.h"
+
+// Append-only columnar store of the apps' hourly traffic.
+// One segment file per UTC day, one block per sealed hour:
+// block header + delta-encoded app ids + varint in/out bytes columns.
+// The blocks' headers make a small sparse index with app id ranges.
+// Retention drops whole segment files.
+class TrafSegmentStore
+{
+public:
+    explicit TrafSegmentStore(const QString &dirPath = QString());
+    CLASS_DELETE_COPY_MOVE(TrafSegmentStore)
+
+    bool isEnabled() const { return !m_dirPath.isEmpty(); }
+
+    const QString &dirPath() const { return m_dirPath; }
+
+    // Writer
+    bool appendHour(qint32 trafHour, const AppTrafRowList &rows);
+
+    void removeBefore(qint32 trafHour);
+    bool removeApp(qint64 appId);
+    void clear();
+
+    // Reader
+    bool getAppTraffic(qint64 appId, qint32 trafHour, TrafBytes &trafBytes);
+    qint32 getAppMinTrafHour(qint64 appId);
+
+    static qint32 segmentDay(qint32 trafHour);
+
+private:
+    struct BlockIndex
+    {
+        qint8 hourOffset = 0;
+        quint32 count = 0;
+        quint32 offset = 0; // of the payload
+        quint32 inOffset = 0; // in the payload
+        quint32 outOffset = 0;
+        quint32 size = 0;
+        qint64 minAppId = 0;
+        qint64 maxAppId = 0;
+    };
+
+    struct Segment
+    {
+        qint64 fileSize = -1;
+        qint64 validSize = 0;
+        QVector<BlockIndex> blocks;
+    };
+
+    QString segmentFilePath(qint32 day) const;
+
+    QVector<qint32> segmentDays() const;
+
+    Segment *segment(qint32 day);
+    bool readSegment(qint32 day, Segment &seg) const;
+
+    void invalidateCache();
+
+    bool readAppDay(qint64 appId, qint32 day, TrafBytes *dayTraf, bool *dayHas);
+    bool readBlockApp(const QByteArray &data, const BlockIndex &block, qint64 appId,
+            TrafBytes &trafBytes) const;
+
+    static QByteArray encodeBlock(qint8 hourOffset, const AppTrafRowList &rows);
+    static bool decodeBlock(const QByteArray &data, const BlockIndex &block, AppTrafRowList &rows);
+
+private:
+    QString m_dirPath;
+
+    QHash<qint32, Segment> m_segments; // day -> segment's index
+
+    // Last read app's day
+    qint64 m_cachedAppId = 0;
+    qint32 m_cachedDay = -1;
+    qint64 m_cachedFileSize = -1;
+    TrafBytes m_cachedDayTraf[24];
+    bool m_cachedDayHas[24] = {};
+
+    QMutex m_mutex;
+};
+
+#endif // TRAFSEGMENTSTORE_H
@@ -134,7 +134,7 @@ TaskInfo::TaskType TaskInfo::stringToType(const QString &name)
 
 void TaskInfo::run()
 {
-    if (taskWorker())
+    if (running())
         return;
 
     setRunning(true);
@@ -170,6 +170,11 @@ void TaskInfo::abortTask()
     // to avoid recursive call on worker.abort() -> handleFinished(false) -> abort()
     m_aborted = true;
 
+    abortTaskWorker();
+}
+
+void TaskInfo::abortTaskWorker()
+{
     if (taskWorker()) {
         taskWorker()->finish();
         taskWorker()->deleteLater();
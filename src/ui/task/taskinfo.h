@@ -91,6 +91,11 @@ public slots:
 
     virtual bool processResult(bool success) = 0;
 
+protected:
+    void setAborted(bool v) { m_aborted = v; }
+
+    virtual void abortTaskWorker();
+
 protected slots:
     virtual void setupTaskWorker();
     virtual void runTaskWorker();
@@ -13,12 +13,15 @@
 #include <util/ioc/ioccontainer.h>
 
 #include "taskmanager.h"
+#include "taskzonecompiler.h"
 #include "taskzonedownloader.h"
 
 namespace {
 
 const QLoggingCategory LC("task.zoneDownloader");
 
+constexpr int maxZoneWorkersCount = 4;
+
 }
 
 TaskInfoZoneDownloader::TaskInfoZoneDownloader(TaskManager &taskManager) :
@@ -26,9 +29,10 @@ TaskInfoZoneDownloader::TaskInfoZoneDownloader(TaskManager &taskManager) :
 {
 }
 
-TaskZoneDownloader *TaskInfoZoneDownloader::zoneDownloader() const
+TaskInfoZoneDownloader::~TaskInfoZoneDownloader()
 {
-    return static_cast<TaskZoneDownloader *>(taskWorker());
+    // Stop the compilation before the workers are deleted
+    delete m_zoneCompiler;
 }
 
 ZoneListModel *TaskInfoZoneDownloader::zoneListModel() const
@@ -54,46 +58,97 @@ bool TaskInfoZoneDownloader::saveZoneAsText(const QString &filePath, int zoneInd
 {
     TaskZoneDownloader worker;
 
-    m_zoneIndex = zoneIndex;
-
-    setupTaskWorkerByZone(&worker);
+    setupTaskWorkerByZone(&worker, zoneIndex);
 
     return worker.saveAddressesAsText(filePath);
 }
 
+void TaskInfoZoneDownloader::abortTaskWorker()
+{
+    // Stop the compilation before deleting the workers
+    delete m_zoneCompiler;
+    m_zoneCompiler = nullptr;
+
+    for (auto worker : std::as_const(m_zoneWorkers)) {
+        worker->disconnect(this); // to avoid recursive call on finish()
+
+        worker->finish();
+        worker->deleteLater();
+    }
+    m_zoneWorkers.clear();
+
+    m_zoneIndex = m_zoneCount;
+
+    finishZoneWorkers();
+}
+
 void TaskInfoZoneDownloader::setupTaskWorker()
 {
+    setAborted(false);
+
     m_success = false;
     m_zoneIndex = 0;
+    m_zoneCount = zoneListModel()->rowCount();
+    m_zoneFinishedCount = 0;
     m_zonesMask = 0;
     m_zoneNames.clear();
 
     clearSubResults();
 
-    setupNextTaskWorker();
+    m_zoneCompiler = new TaskZoneCompiler(this);
+
+    m_timer.start();
 }
 
-void TaskInfoZoneDownloader::setupNextTaskWorker()
+void TaskInfoZoneDownloader::runTaskWorker()
 {
-    const int rowCount = zoneListModel()->rowCount();
-    if (m_zoneIndex >= rowCount) {
-        emitZonesUpdated();
+    startZoneWorkers();
+}
 
-        TaskInfo::handleFinished(m_success);
-        return;
+void TaskInfoZoneDownloader::startZoneWorkers()
+{
+    while (m_zoneIndex < m_zoneCount && m_zoneWorkers.size() < maxZoneWorkersCount) {
+        startZoneWorker();
     }
 
-    abortTask();
+    finishZoneWorkers();
+}
+
+void TaskInfoZoneDownloader::startZoneWorker()
+{
+    auto worker = new TaskZoneDownloader(this);
+
+    setupTaskWorkerByZone(worker, m_zoneIndex++);
+
+    worker->setZoneCompiler(m_zoneCompiler);
 
-    TaskInfo::setupTaskWorker();
-    auto worker = zoneDownloader();
+    // Queued to not start the next worker from the finishing one
+    connect(
+            worker, &TaskWorker::finished, this,
+            [=, this](bool success) { handleZoneFinished(worker, success); },
+            Qt::QueuedConnection);
 
-    setupTaskWorkerByZone(worker);
+    m_zoneWorkers.append(worker);
+
+    worker->run();
 }
 
-void TaskInfoZoneDownloader::setupTaskWorkerByZone(TaskZoneDownloader *worker)
+void TaskInfoZoneDownloader::finishZoneWorkers()
 {
-    const auto &zoneRow = zoneListModel()->zoneRowAt(m_zoneIndex);
+    if (!running() || m_zoneIndex < m_zoneCount || !m_zoneWorkers.isEmpty())
+        return;
+
+    qCDebug(LC) << "Zones processed:" << m_zoneFinishedCount << "of" << m_zoneCount
+                << "msec:" << m_timer.elapsed();
+
+    emitZonesUpdated();
+
+    TaskInfo::handleFinished(m_success);
+}
+
+void TaskInfoZoneDownloader::setupTaskWorkerByZone(TaskZoneDownloader *worker, int zoneIndex)
+{
+    const auto &zoneRow = zoneListModel()->zoneRowAt(zoneIndex);
 
     const ZoneSourceWrapper zoneSource(zoneListModel()->zoneSourceByCode(zoneRow.sourceCode));
     const ZoneTypeWrapper zoneType(zoneListModel()->zoneTypeByCode(zoneSource.zoneType()));
@@ -108,6 +163,7 @@ void TaskInfoZoneDownloader::setupTaskWorkerByZone(TaskZoneDownloader *worker)
     worker->setTextInline(zoneRow.textInline);
     worker->setPattern(zoneType.pattern());
     worker->setAddressCount(zoneRow.addressCount);
+    worker->setRangeCount(zoneRow.rangeCount);
     worker->setTextChecksum(zoneRow.textChecksum);
     worker->setBinChecksum(zoneRow.binChecksum);
     worker->setCachePath(cachePath());
@@ -117,34 +173,33 @@ void TaskInfoZoneDownloader::setupTaskWorkerByZone(TaskZoneDownloader *worker)
     insertZoneId(m_zonesMask, zoneRow.zoneId);
 }
 
-void TaskInfoZoneDownloader::handleFinished(bool success)
+void TaskInfoZoneDownloader::handleZoneFinished(TaskZoneDownloader *worker, bool success)
 {
-    processSubResult(success);
+    m_zoneWorkers.removeOne(worker);
+
+    ++m_zoneFinishedCount;
+
+    qCDebug(LC) << "Zone finished:" << worker->zoneName() << "success:" << success
+                << "addresses:" << worker->addressCount() << "ranges:" << worker->rangeCount()
+                << "progress:" << m_zoneFinishedCount << "of" << m_zoneCount;
+
+    processSubResult(worker, success);
 
     if (success) {
         m_success = true;
     }
 
-    if (aborted()) {
-        m_zoneIndex = INT_MAX;
-    } else {
-        ++m_zoneIndex;
-    }
+    worker->deleteLater();
 
-    setupNextTaskWorker();
-    runTaskWorker();
+    startZoneWorkers();
 }
 
-void TaskInfoZoneDownloader::processSubResult(bool success)
+void TaskInfoZoneDownloader::processSubResult(TaskZoneDownloader *worker, bool success)
 {
-    if (aborted() && !success)
-        return;
-
-    auto worker = zoneDownloader();
-
     Zone zone;
     zone.zoneId = worker->zoneId();
     zone.addressCount = worker->addressCount();
+    zone.rangeCount = worker->rangeCount();
     zone.textChecksum = worker->textChecksum();
     zone.binChecksum = worker->binChecksum();
 
@@ -163,12 +218,20 @@ void TaskInfoZoneDownloader::clearSubResults()
     m_enabledMask = 0;
     m_dataSize = 0;
     m_zonesData.clear();
+    m_zoneFiles.clear();
+
+    m_zoneDeltasValid = true;
+    m_deltaAddedCount = 0;
+    m_deltaRemovedCount = 0;
+    m_zoneDeltas.clear();
 }
 
 void TaskInfoZoneDownloader::addSubResult(TaskZoneDownloader *worker, bool success)
 {
     if (success) {
         m_zoneNames.append(worker->zoneName());
+
+        addZoneDelta(worker);
     } else if (!worker->loadAddresses()) {
         return;
     }
@@ -180,7 +243,12 @@ void TaskInfoZoneDownloader::addSubResult(TaskZoneDownloader *worker, bool succe
         return;
 
     m_dataSize += size;
-    m_zonesData.append(zoneData);
+    m_zonesData.insert(worker->zoneId(), zoneData);
+
+    // Keep the cache file mapped until the zones are gathered for the driver
+    if (worker->zoneFile()) {
+        m_zoneFiles.append(worker->zoneFile());
+    }
 
     insertZoneId(m_dataZonesMask, worker->zoneId());
 
@@ -189,9 +257,36 @@ void TaskInfoZoneDownloader::addSubResult(TaskZoneDownloader *worker, bool succe
     }
 }
 
+void TaskInfoZoneDownloader::addZoneDelta(TaskZoneDownloader *worker)
+{
+    const auto &zoneDelta = worker->zoneDelta();
+
+    if (zoneDelta.isEmpty()) {
+        m_zoneDeltasValid = false;
+    } else {
+        m_zoneDeltas.append(zoneDelta);
+    }
+
+    m_deltaAddedCount += worker->deltaAddedCount();
+    m_deltaRemovedCount += worker->deltaRemovedCount();
+
+    qCDebug(LC) << "Zone delta:" << worker->zoneName() << "added:" << worker->deltaAddedCount()
+                << "removed:" << worker->deltaRemovedCount() << "size:" << zoneDelta.size()
+                << "of" << worker->zoneData().size();
+}
+
 void TaskInfoZoneDownloader::emitZonesUpdated()
 {
-    emit taskManager()->zonesUpdated(m_dataZonesMask, m_enabledMask, m_dataSize, m_zonesData);
+    // The driver's zones can be patched, when only the addresses are changed
+    const bool canPatch = m_zoneDeltasValid && !m_zoneDeltas.isEmpty();
+
+    if (canPatch) {
+        qCDebug(LC) << "Zones delta:" << m_zoneDeltas.size() << "added:" << m_deltaAddedCount
+                    << "removed:" << m_deltaRemovedCount;
+    }
+
+    emit taskManager()->zonesUpdated(m_dataZonesMask, m_enabledMask, m_dataSize,
+            m_zonesData.values(), canPatch ? m_zoneDeltas : QList<QByteArray>());
 
     removeOrphanCacheFiles();
 
@@ -2,9 +2,14 @@
 #define TASKINFOZONEDOWNLOADER_H
 
 #include <QByteArray>
+#include <QElapsedTimer>
+#include <QMap>
+
+#include <util/conf/zonefile.h>
 
 #include "taskinfo.h"
 
+class TaskZoneCompiler;
 class TaskZoneDownloader;
 class ZoneListModel;
 
@@ -14,8 +19,9 @@ class TaskInfoZoneDownloader : public TaskInfo
 
 public:
     explicit TaskInfoZoneDownloader(TaskManager &taskManager);
+    ~TaskInfoZoneDownloader() override;
+    CLASS_DELETE_COPY_MOVE(TaskInfoZoneDownloader)
 
-    TaskZoneDownloader *zoneDownloader() const;
     ZoneListModel *zoneListModel() const;
 
 public slots:
@@ -23,18 +29,26 @@ public slots:
 
     bool saveZoneAsText(const QString &filePath, int zoneIndex);
 
+protected:
+    void abortTaskWorker() override;
+
 protected slots:
     void setupTaskWorker() override;
+    void runTaskWorker() override;
 
-    void handleFinished(bool success) override;
+    void handleZoneFinished(TaskZoneDownloader *worker, bool success);
 
-    void processSubResult(bool success);
+    void processSubResult(TaskZoneDownloader *worker, bool success);
     void clearSubResults();
 
 private:
-    void setupNextTaskWorker();
-    void setupTaskWorkerByZone(TaskZoneDownloader *worker);
+    void startZoneWorkers();
+    void startZoneWorker();
+    void finishZoneWorkers();
+
+    void setupTaskWorkerByZone(TaskZoneDownloader *worker, int zoneIndex);
     void addSubResult(TaskZoneDownloader *worker, bool success);
+    void addZoneDelta(TaskZoneDownloader *worker);
 
     void insertZoneId(quint32 &zonesMask, int zoneId);
     bool containsZoneId(quint32 zonesMask, int zoneId) const;
@@ -48,14 +62,27 @@ private:
 private:
     bool m_success = false;
     int m_zoneIndex = 0;
+    int m_zoneCount = 0;
+    int m_zoneFinishedCount = 0;
     quint32 m_zonesMask = 0;
 
     quint32 m_dataZonesMask = 0;
     quint32 m_enabledMask = 0;
     quint32 m_dataSize = 0;
 
+    bool m_zoneDeltasValid = true;
+    int m_deltaAddedCount = 0;
+    int m_deltaRemovedCount = 0;
+
+    TaskZoneCompiler *m_zoneCompiler = nullptr;
+
     QStringList m_zoneNames;
-    QList<QByteArray> m_zonesData;
+    QList<TaskZoneDownloader *> m_zoneWorkers;
+    QMap<int, QByteArray> m_zonesData; // ordered by zone id
+    QList<QByteArray> m_zoneDeltas;
+    QList<ZoneFilePtr> m_zoneFiles;
+
+    QElapsedTimer m_timer;
 };
 
 #endif // TASKINFOZONEDOWNLOADER_H
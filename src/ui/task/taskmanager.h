@@ -38,7 +38,7 @@ signals:
     void appVersionDownloaded(const QString &version);
 
     void zonesUpdated(quint32 zonesMask, quint32 enabledMask, quint32 dataSize,
-            const QList<QByteArray> &zonesData);
+            const QList<QByteArray> &zonesData, const QList<QByteArray> &zoneDeltas);
     void zonesDownloaded(const QStringList &zoneNames);
 
 public slots:
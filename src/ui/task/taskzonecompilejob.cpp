@@ -0,0 +1,25 @@
+#include "taskzonecompilejob.h"
+
+#include "taskzonedownloader.h"
+
+TaskZoneCompileJob::TaskZoneCompileJob(TaskZoneDownloader *worker, const QByteArray &data) :
+    m_zoneDownloader(worker), m_data(data)
+{
+}
+
+void TaskZoneCompileJob::doJob(WorkerObject & /*worker*/)
+{
+    m_success = zoneDownloader()->compileAddresses(m_data);
+
+    m_data.clear();
+}
+
+void TaskZoneCompileJob::reportResult(WorkerObject & /*worker*/)
+{
+    TaskZoneDownloader *worker = zoneDownloader();
+    const bool success = m_success;
+
+    // Finish in the worker's thread
+    QMetaObject::invokeMethod(
+            worker, [=] { worker->finish(success); }, Qt::QueuedConnection);
+}
@@ -0,0 +1,28 @@
+#ifndef TASKZONECOMPILEJOB_H
+#define TASKZONECOMPILEJOB_H
+
+#include <util/worker/workerjob.h>
+
+class TaskZoneDownloader;
+
+// Parses the downloaded text and stores the zone's binary cache file.
+// The worker must outlive the job: TaskZoneCompiler is aborted before deleting the workers.
+class TaskZoneCompileJob : public WorkerJob
+{
+public:
+    explicit TaskZoneCompileJob(TaskZoneDownloader *worker, const QByteArray &data);
+
+    TaskZoneDownloader *zoneDownloader() const { return m_zoneDownloader; }
+
+    void doJob(WorkerObject &worker) override;
+    void reportResult(WorkerObject &worker) override;
+
+private:
+    bool m_success = false;
+
+    TaskZoneDownloader *m_zoneDownloader = nullptr;
+
+    QByteArray m_data;
+};
+
+#endif // TASKZONECOMPILEJOB_H
@@ -0,0 +1,19 @@
+#include "taskzonecompiler.h"
+
+#include <QThread>
+
+#include "taskzonecompilejob.h"
+
+namespace {
+constexpr int maxCompilersCount = 4;
+}
+
+TaskZoneCompiler::TaskZoneCompiler(QObject *parent) : WorkerManager(parent)
+{
+    setMaxWorkersCount(qBound(1, QThread::idealThreadCount(), maxCompilersCount));
+}
+
+void TaskZoneCompiler::compileZone(TaskZoneDownloader *worker, const QByteArray &data)
+{
+    enqueueJob(WorkerJobPtr(new TaskZoneCompileJob(worker, data)));
+}
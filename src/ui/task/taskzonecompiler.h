@@ -0,0 +1,21 @@
+#ifndef TASKZONECOMPILER_H
+#define TASKZONECOMPILER_H
+
+#include <util/worker/workermanager.h>
+
+class TaskZoneDownloader;
+
+class TaskZoneCompiler : public WorkerManager
+{
+    Q_OBJECT
+
+public:
+    explicit TaskZoneCompiler(QObject *parent = nullptr);
+
+    QString workerName() const override { return "TaskZoneCompiler"; }
+
+public slots:
+    void compileZone(TaskZoneDownloader *worker, const QByteArray &data);
+};
+
+#endif // TASKZONECOMPILER_H
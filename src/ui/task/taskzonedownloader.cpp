@@ -5,11 +5,14 @@
 #include <QUrl>
 
 #include <util/conf/confutil.h>
+#include <util/conf/zonefile.h>
 #include <util/fileutil.h>
 #include <util/net/iprange.h>
 #include <util/net/netdownloader.h>
 #include <util/stringutil.h>
 
+#include "taskzonecompiler.h"
+
 namespace {
 const QLoggingCategory LC("task.zoneDownloader");
 }
@@ -36,20 +39,14 @@ void TaskZoneDownloader::setupDownloader()
 
 void TaskZoneDownloader::downloadFinished(const QByteArray &data, bool success)
 {
+    if (success && zoneCompiler()) {
+        // Parse and store the addresses in a worker thread
+        zoneCompiler()->compileZone(this, data);
+        return;
+    }
+
     if (success) {
-        success = false;
-
-        QString textChecksum;
-        const auto text = QString::fromLatin1(data);
-        const auto list = parseAddresses(text, textChecksum);
-
-        if (!list.isEmpty()
-                && (this->textChecksum() != textChecksum
-                        || !FileUtil::fileExists(cacheFileBinPath()))) {
-            setTextChecksum(textChecksum);
-            success = storeAddresses(list);
-            setAddressCount(success ? list.size() : 0);
-        }
+        success = compileAddresses(data);
     }
 
     finish(success);
@@ -78,6 +75,28 @@ void TaskZoneDownloader::loadLocalFile()
     downloadFinished(data, success);
 }
 
+bool TaskZoneDownloader::compileAddresses(const QByteArray &data)
+{
+    QString textChecksum;
+    const auto text = QString::fromLatin1(data);
+    const auto list = parseAddresses(text, textChecksum);
+
+    if (list.isEmpty()
+            || (this->textChecksum() == textChecksum && FileUtil::fileExists(cacheFileBinPath())))
+        return false;
+
+    setTextChecksum(textChecksum);
+
+    const bool success = storeAddresses(list);
+    setAddressCount(success ? list.size() : 0);
+
+    if (!success) {
+        setRangeCount(0);
+    }
+
+    return success;
+}
+
 StringViewList TaskZoneDownloader::parseAddresses(const QString &text, QString &checksum) const
 {
     StringViewList list;
@@ -118,6 +137,16 @@ bool TaskZoneDownloader::storeAddresses(const StringViewList &list)
         return false;
     }
 
+    setRangeCount(ipRange.size());
+
+    qCDebug(LC) << "Zone merged:" << zoneName() << "addresses:" << list.size()
+                << "ranges:" << rangeCount();
+
+    // Compare with the previously cached addresses
+    storeZoneDelta(ipRange);
+
+    m_zoneFile.clear();
+
     FileUtil::removeFile(cacheFileBinPath());
 
     // Store binary file
@@ -129,12 +158,48 @@ bool TaskZoneDownloader::storeAddresses(const StringViewList &list)
     if (m_zoneData.isEmpty())
         return false;
 
-    const auto binData = qCompress(m_zoneData);
+    QString binChecksum;
+    if (!ZoneFile::write(cacheFileBinPath(), m_zoneData, binChecksum))
+        return false;
+
+    setBinChecksum(binChecksum);
+
+    return true;
+}
+
+void TaskZoneDownloader::storeZoneDelta(const IpRange &ipRange)
+{
+    m_zoneDelta.clear();
+    m_deltaAddedCount = 0;
+    m_deltaRemovedCount = 0;
+
+    // The driver can patch only sorted address lists
+    if (!sort() || !loadAddresses())
+        return;
 
-    const auto binChecksumData = QCryptographicHash::hash(binData, QCryptographicHash::Sha256);
-    setBinChecksum(QString::fromLatin1(binChecksumData.toHex()));
+    ConfUtil confUtil(zoneData());
 
-    return FileUtil::writeFileData(cacheFileBinPath(), binData);
+    IpRange prevRange;
+    if (!confUtil.loadZone(prevRange))
+        return;
+
+    IpRange removedRange;
+    IpRange addedRange;
+
+    prevRange.difference(ipRange, removedRange);
+    ipRange.difference(prevRange, addedRange);
+
+    m_deltaRemovedCount = removedRange.size();
+    m_deltaAddedCount = addedRange.size();
+
+    // Send the whole zone, when most of it is changed
+    if ((m_deltaRemovedCount + m_deltaAddedCount) * 2 > ipRange.size())
+        return;
+
+    ConfUtil deltaUtil;
+    deltaUtil.writeZoneDelta(zoneId(), removedRange, addedRange);
+
+    m_zoneDelta = deltaUtil.buffer();
 }
 
 bool TaskZoneDownloader::loadAddresses()
@@ -142,16 +207,17 @@ bool TaskZoneDownloader::loadAddresses()
     if (!FileUtil::fileExists(cacheFileBinPath()))
         return false;
 
-    const auto binData = FileUtil::readFileData(cacheFileBinPath());
-
-    const auto binChecksumData = QCryptographicHash::hash(binData, QCryptographicHash::Sha256);
+    // Map the binary file without reading it into memory
+    auto zoneFile = ZoneFilePtr::create(cacheFileBinPath());
 
-    if (binChecksum() != QString::fromLatin1(binChecksumData.toHex())) {
+    if (!zoneFile->map(binChecksum())) {
+        zoneFile.clear();
         FileUtil::removeFile(cacheFileBinPath());
         return false;
     }
 
-    m_zoneData = qUncompress(binData);
+    m_zoneFile = zoneFile;
+    m_zoneData = m_zoneFile->zoneData();
 
     return true;
 }
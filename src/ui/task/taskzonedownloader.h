@@ -3,10 +3,14 @@
 
 #include <QDateTime>
 
+#include <util/conf/zonefile.h>
 #include <util/util_types.h>
 
 #include "taskdownloader.h"
 
+class IpRange;
+class TaskZoneCompiler;
+
 class TaskZoneDownloader : public TaskDownloader
 {
     Q_OBJECT
@@ -29,6 +33,9 @@ public:
     int addressCount() const { return m_addressCount; }
     void setAddressCount(int v) { m_addressCount = v; }
 
+    int rangeCount() const { return m_rangeCount; }
+    void setRangeCount(int v) { m_rangeCount = v; }
+
     QString zoneName() const { return m_zoneName; }
     void setZoneName(const QString &v) { m_zoneName = v; }
 
@@ -59,8 +66,23 @@ public:
     QDateTime lastSuccess() const { return m_lastSuccess; }
     void setLastSuccess(const QDateTime &v) { m_lastSuccess = v; }
 
+    // Compiles the downloaded addresses in its worker threads, when set
+    TaskZoneCompiler *zoneCompiler() const { return m_zoneCompiler; }
+    void setZoneCompiler(TaskZoneCompiler *v) { m_zoneCompiler = v; }
+
     const QByteArray &zoneData() const { return m_zoneData; }
 
+    // The mapped cache file, which keeps the zoneData() valid
+    const ZoneFilePtr &zoneFile() const { return m_zoneFile; }
+
+    // Changes against the previously cached addresses, to patch the driver's zone
+    const QByteArray &zoneDelta() const { return m_zoneDelta; }
+
+    int deltaAddedCount() const { return m_deltaAddedCount; }
+    int deltaRemovedCount() const { return m_deltaRemovedCount; }
+
+    bool compileAddresses(const QByteArray &data);
+
     StringViewList parseAddresses(const QString &text, QString &textChecksum) const;
 
     bool storeAddresses(const StringViewList &list);
@@ -81,6 +103,8 @@ private:
     void loadTextInline();
     void loadLocalFile();
 
+    void storeZoneDelta(const IpRange &ipRange);
+
 private:
     bool m_zoneEnabled : 1 = false;
     bool m_sort : 1 = false;
@@ -90,6 +114,10 @@ private:
     int m_zoneId = 0;
 
     int m_addressCount = 0;
+    int m_rangeCount = 0;
+
+    int m_deltaAddedCount = 0;
+    int m_deltaRemovedCount = 0;
 
     QString m_zoneName;
 
@@ -109,6 +137,11 @@ private:
     QDateTime m_lastSuccess;
 
     QByteArray m_zoneData;
+    QByteArray m_zoneDelta;
+
+    ZoneFilePtr m_zoneFile;
+
+    TaskZoneCompiler *m_zoneCompiler = nullptr;
 };
 
 #endif // TASKZONEDOWNLOADER_H
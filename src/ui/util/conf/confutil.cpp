@@ -461,6 +461,26 @@ void ConfUtil::writeZoneFlag(int zoneId, bool enabled)
     confZoneFlag->enabled = enabled;
 }
 
+void ConfUtil::writeZoneDelta(int zoneId, const IpRange &removedRange, const IpRange &addedRange)
+{
+    const int removedSize = FORT_CONF_ADDR_LIST_SIZE(removedRange.ip4Size(),
+            removedRange.pair4Size(), removedRange.ip6Size(), removedRange.pair6Size());
+    const int addedSize = FORT_CONF_ADDR_LIST_SIZE(addedRange.ip4Size(), addedRange.pair4Size(),
+            addedRange.ip6Size(), addedRange.pair6Size());
+
+    buffer().resize(FORT_CONF_ZONE_DELTA_OFF + removedSize + addedSize);
+
+    // Fill the buffer
+    PFORT_CONF_ZONE_DELTA confZoneDelta = (PFORT_CONF_ZONE_DELTA) buffer().data();
+    char *data = confZoneDelta->data;
+
+    confZoneDelta->zone_id = zoneId;
+    confZoneDelta->added_off = removedSize;
+
+    writeAddressList(&data, removedRange);
+    writeAddressList(&data, addedRange);
+}
+
 bool ConfUtil::loadZone(IpRange &ipRange)
 {
     const char *data = buffer().data();
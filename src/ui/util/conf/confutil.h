@@ -65,6 +65,7 @@ public slots:
     void writeZones(quint32 zonesMask, quint32 enabledMask, quint32 dataSize,
             const QList<QByteArray> &zonesData);
     void writeZoneFlag(int zoneId, bool enabled);
+    void writeZoneDelta(int zoneId, const IpRange &removedRange, const IpRange &addedRange);
 
     bool loadZone(IpRange &ipRange);
 
@@ -0,0 +1,229 @@
+#include "zonefile.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+#include <QtEndian>
+
+#include <common/fortconf.h>
+
+#include <util/fileutil.h>
+
+namespace {
+
+constexpr quint32 zoneFileMagic = 0x4E5A5246; // "FRZN"
+constexpr quint16 zoneFileVersion = 3;
+constexpr qint64 zoneFilePageSize = 4096;
+
+struct ZoneFileSection
+{
+    quint32 offset;
+    quint32 size;
+    quint64 checksum; // the first 64 bits of the data's SHA-256
+};
+
+// Its SHA-256 is the file's checksum, which covers the sections' checksums
+struct ZoneFileHeader
+{
+    quint32 magic;
+    quint16 version;
+    quint16 sections_n;
+
+    quint32 data_size;
+    quint32 reserved;
+
+    ZoneFileSection sections[ZoneFile::SectionCount];
+};
+
+static_assert(sizeof(ZoneFileHeader) <= zoneFilePageSize, "ZoneFileHeader size mismatch");
+
+// Identifies the file's content, which has passed the sections check
+struct ZoneFileStamp
+{
+    qint64 size = 0;
+    QDateTime modTime;
+    QString checksum;
+
+    bool operator==(const ZoneFileStamp &o) const
+    {
+        return size == o.size && modTime == o.modTime && checksum == o.checksum;
+    }
+};
+
+QMutex g_checkedFilesMutex;
+QHash<QString, ZoneFileStamp> g_checkedFiles;
+
+bool isFileChecked(const QString &filePath, const ZoneFileStamp &stamp)
+{
+    QMutexLocker locker(&g_checkedFilesMutex);
+
+    return g_checkedFiles.value(filePath) == stamp;
+}
+
+void setFileChecked(const QString &filePath, const ZoneFileStamp &stamp)
+{
+    QMutexLocker locker(&g_checkedFilesMutex);
+
+    g_checkedFiles.insert(filePath, stamp);
+}
+
+quint64 dataChecksum(const char *data, qsizetype size)
+{
+    const QByteArray hash = QCryptographicHash::hash(
+            QByteArray::fromRawData(data, size), QCryptographicHash::Sha256);
+
+    return qFromLittleEndian<quint64>(hash.constData());
+}
+
+QString headerChecksum(const ZoneFileHeader &header)
+{
+    const QByteArray hash = QCryptographicHash::hash(
+            QByteArray::fromRawData((const char *) &header, sizeof(ZoneFileHeader)),
+            QCryptographicHash::Sha256);
+
+    return QString::fromLatin1(hash.toHex());
+}
+
+void fillSection(ZoneFileSection &section, const char *data, quint32 offset, quint32 size)
+{
+    section.offset = offset;
+    section.size = size;
+    section.checksum = dataChecksum(data, size);
+}
+
+}
+
+ZoneFile::ZoneFile(const QString &filePath) : m_file(filePath) { }
+
+ZoneFile::~ZoneFile()
+{
+    unmap();
+}
+
+bool ZoneFile::map(const QString &checksum)
+{
+    unmap();
+
+    if (!mapFile(checksum)) {
+        unmap();
+        return false;
+    }
+
+    return true;
+}
+
+void ZoneFile::unmap()
+{
+    m_zoneData.clear();
+
+    if (m_mapData) {
+        m_file.unmap(m_mapData);
+        m_mapData = nullptr;
+    }
+
+    m_file.close();
+}
+
+bool ZoneFile::write(const QString &filePath, const QByteArray &zoneData, QString &checksum)
+{
+    const quint32 dataSize = zoneData.size();
+    if (dataSize < FORT_CONF_ADDR4_LIST_OFF)
+        return false;
+
+    const PFORT_CONF_ADDR4_LIST addr4List = (PFORT_CONF_ADDR4_LIST) zoneData.constData();
+    const quint32 addr4Size = FORT_CONF_ADDR4_LIST_SIZE(addr4List->ip_n, addr4List->pair_n);
+
+    if (addr4Size > dataSize)
+        return false;
+
+    QByteArray fileData(zoneFilePageSize, '\0');
+    fileData.append(zoneData);
+
+    ZoneFileHeader &header = *(ZoneFileHeader *) fileData.data();
+    header.magic = zoneFileMagic;
+    header.version = zoneFileVersion;
+    header.sections_n = SectionCount;
+    header.data_size = dataSize;
+
+    const char *data = zoneData.constData();
+
+    fillSection(header.sections[SectionAddr4], data, zoneFilePageSize, addr4Size);
+    fillSection(header.sections[SectionAddr6], data + addr4Size, zoneFilePageSize + addr4Size,
+            dataSize - addr4Size);
+
+    checksum = headerChecksum(header);
+
+    return FileUtil::writeFileData(filePath, fileData);
+}
+
+bool ZoneFile::mapFile(const QString &checksum)
+{
+    if (!m_file.open(QFile::ReadOnly))
+        return false;
+
+    const qint64 fileSize = m_file.size();
+    if (fileSize <= zoneFilePageSize)
+        return false;
+
+    m_mapData = m_file.map(0, fileSize);
+    if (!m_mapData)
+        return false;
+
+    const ZoneFileHeader &header = *(const ZoneFileHeader *) m_mapData;
+
+    if (header.magic != zoneFileMagic || header.version != zoneFileVersion
+            || header.sections_n != SectionCount || headerChecksum(header) != checksum
+            || !checkSections(m_mapData, fileSize))
+        return false;
+
+    // Check the sections' data once per the file's change
+    const ZoneFileStamp stamp = {
+        .size = fileSize,
+        .modTime = FileUtil::fileModTime(filePath()),
+        .checksum = checksum,
+    };
+
+    if (!isFileChecked(filePath(), stamp)) {
+        if (!checkSectionsData(m_mapData))
+            return false;
+
+        setFileChecked(filePath(), stamp);
+    }
+
+    m_zoneData = QByteArray::fromRawData(
+            (const char *) m_mapData + zoneFilePageSize, header.data_size);
+
+    return true;
+}
+
+bool ZoneFile::checkSections(const uchar *data, qint64 fileSize) const
+{
+    const ZoneFileHeader &header = *(const ZoneFileHeader *) data;
+
+    if (zoneFilePageSize + header.data_size != fileSize)
+        return false;
+
+    qint64 offset = zoneFilePageSize;
+
+    for (const ZoneFileSection &section : header.sections) {
+        if (section.offset != offset || offset + section.size > fileSize)
+            return false;
+
+        offset += section.size;
+    }
+
+    return offset == fileSize;
+}
+
+bool ZoneFile::checkSectionsData(const uchar *data) const
+{
+    const ZoneFileHeader &header = *(const ZoneFileHeader *) data;
+
+    for (const ZoneFileSection &section : header.sections) {
+        if (section.checksum != dataChecksum((const char *) data + section.offset, section.size))
+            return false;
+    }
+
+    return true;
+}
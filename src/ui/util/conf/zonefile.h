@@ -0,0 +1,56 @@
+#ifndef ZONEFILE_H
+#define ZONEFILE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QSharedPointer>
+
+#include <util/classhelpers.h>
+
+class ZoneFile;
+
+using ZoneFilePtr = QSharedPointer<ZoneFile>;
+
+// Uncompressed, page-aligned and versioned zone cache file.
+// The zone data (FORT_CONF_ADDR4_LIST + FORT_CONF_ADDR6_LIST) is stored as is
+// after the header page, so it can be memory-mapped and gathered into the
+// driver's FORT_CONF_ZONES buffer without decompression.
+class ZoneFile
+{
+public:
+    enum Section : quint8 {
+        SectionAddr4 = 0,
+        SectionAddr6,
+        SectionCount,
+    };
+
+    explicit ZoneFile(const QString &filePath);
+    ~ZoneFile();
+    CLASS_DELETE_COPY_MOVE(ZoneFile)
+
+    QString filePath() const { return m_file.fileName(); }
+
+    bool isMapped() const { return m_mapData != nullptr; }
+
+    // Points into the mapped file, valid while the file is mapped
+    const QByteArray &zoneData() const { return m_zoneData; }
+
+    bool map(const QString &checksum);
+    void unmap();
+
+    static bool write(const QString &filePath, const QByteArray &zoneData, QString &checksum);
+
+private:
+    bool mapFile(const QString &checksum);
+    bool checkSections(const uchar *data, qint64 fileSize) const;
+    bool checkSectionsData(const uchar *data) const;
+
+private:
+    uchar *m_mapData = nullptr;
+
+    QFile m_file;
+
+    QByteArray m_zoneData;
+};
+
+#endif // ZONEFILE_H
@@ -3,7 +3,9 @@
 #include <QCache>
 #include <QDir>
 #include <QIcon>
+#include <QImage>
 #include <QLoggingCategory>
+#include <QPixmap>
 
 #include "fileutil.h"
 
@@ -12,17 +14,33 @@ namespace {
 const QLoggingCategory LC("util.iconCache");
 
 constexpr int CacheLimitCount = 200; // icons max count
+constexpr int ImageCacheLimitBytes = 16 * 1024 * 1024; // decoded images max size
 
 static struct IconCachePrivate
 {
-    IconCachePrivate() : cache(CacheLimitCount) { }
+    IconCachePrivate() : cache(CacheLimitCount), imageCache(ImageCacheLimitBytes) { }
 
     bool dirChecked : 1 = false;
     bool dirExists : 1 = false;
 
+    qint64 hitCount = 0;
+    qint64 missCount = 0;
+
     QCache<QString, QIcon> cache;
+    QCache<qint64, QIcon> imageCache;
 } g_iconCache;
 
+template<typename T>
+T *findCached(T *obj)
+{
+    if (obj) {
+        ++g_iconCache.hitCount;
+    } else {
+        ++g_iconCache.missCount;
+    }
+    return obj;
+}
+
 QString adjustFilePath(const QString &filePath)
 {
     if (!g_iconCache.dirChecked) {
@@ -49,7 +67,7 @@ QString adjustFilePath(const QString &filePath)
 
 QIcon *IconCache::findObject(const QString &key)
 {
-    return g_iconCache.cache.object(key);
+    return findCached(g_iconCache.cache.object(key));
 }
 
 bool IconCache::insertObject(const QString &key, QIcon *iconObj)
@@ -126,3 +144,44 @@ QPixmap IconCache::pixmap(const QString &filePath, int extent)
 
     return pixmap(filePath, size);
 }
+
+bool IconCache::findImage(qint64 key, QIcon &icon)
+{
+    const QIcon *iconObj = findCached(g_iconCache.imageCache.object(key));
+
+    if (iconObj) {
+        icon = *iconObj;
+        return true;
+    }
+    return false;
+}
+
+void IconCache::insertImage(qint64 key, const QImage &image)
+{
+    // The pixmaps of requested sizes are scaled by the icon on demand
+    QIcon *iconObj = new QIcon(image.isNull() ? QPixmap() : QPixmap::fromImage(image));
+
+    const qsizetype cost = qMax<qsizetype>(image.sizeInBytes(), 1);
+
+    g_iconCache.imageCache.insert(key, iconObj, cost);
+}
+
+void IconCache::trimImages(qint64 maxBytes)
+{
+    auto &imageCache = g_iconCache.imageCache;
+
+    const qsizetype maxCost = imageCache.maxCost();
+
+    imageCache.setMaxCost(maxBytes);
+    imageCache.setMaxCost(maxCost);
+}
+
+IconCacheStats IconCache::stats()
+{
+    return {
+        .hitCount = g_iconCache.hitCount,
+        .missCount = g_iconCache.missCount,
+        .imageCount = int(g_iconCache.imageCache.count()),
+        .imageBytes = g_iconCache.imageCache.totalCost(),
+    };
+}
@@ -3,6 +3,15 @@
 
 #include <QObject>
 
+struct IconCacheStats
+{
+    qint64 hitCount = 0;
+    qint64 missCount = 0;
+
+    int imageCount = 0;
+    qint64 imageBytes = 0;
+};
+
 class IconCache
 {
 public:
@@ -18,6 +27,13 @@ public:
 
     static QPixmap pixmap(const QString &filePath, const QSize &size);
     static QPixmap pixmap(const QString &filePath, int extent = 32);
+
+    // Decoded images by their content's key, shared by the files with the same icon
+    static bool findImage(qint64 key, QIcon &icon);
+    static void insertImage(qint64 key, const QImage &image);
+    static void trimImages(qint64 maxBytes = 0);
+
+    static IconCacheStats stats();
 };
 
 #endif // ICONCACHE_H
@@ -60,6 +60,11 @@ void TableItemModel::refresh()
 {
     invalidateRowCache();
 
+    refreshView();
+}
+
+void TableItemModel::refreshView()
+{
     const auto firstCell = index(0, 0);
     const auto lastCell = index(rowCount() - 1, columnCount(firstCell) - 1);
 
@@ -38,6 +38,7 @@ public slots:
     void resetLater();
     void reset();
     void refresh();
+    void refreshView();
 
 protected:
     virtual Qt::ItemFlags flagHasChildren(const QModelIndex &index) const;
@@ -0,0 +1,83 @@
+#ifndef TABLEROWCACHE_H
+#define TABLEROWCACHE_H
+
+#include <QVector>
+
+class TableRowCacheBase
+{
+public:
+    static constexpr int blockSize = 256;
+    static constexpr int maxBlockCount = 4;
+
+    virtual ~TableRowCacheBase() = default;
+
+    static int blockStart(int row) { return row - row % blockSize; }
+
+    virtual void clear() = 0;
+};
+
+// Least recently used blocks of consecutive rows, keyed by the block's first row key
+template<typename T>
+class TableRowCache : public TableRowCacheBase
+{
+public:
+    bool contains(qint64 key) const { return findBlock(key) >= 0; }
+
+    const T *row(qint64 key)
+    {
+        const int index = findBlock(key);
+        if (index < 0)
+            return nullptr;
+
+        if (index > 0) {
+            m_blocks.move(index, 0);
+        }
+
+        const Block &block = m_blocks.first();
+        return &block.rows[key - block.startKey];
+    }
+
+    void setBlock(qint64 startKey, const QVector<T> &rows)
+    {
+        removeBlock(startKey);
+
+        if (rows.isEmpty())
+            return;
+
+        if (m_blocks.size() >= maxBlockCount) {
+            m_blocks.removeLast();
+        }
+
+        m_blocks.prepend({ startKey, rows });
+    }
+
+    void clear() override { m_blocks.clear(); }
+
+private:
+    struct Block
+    {
+        qint64 startKey = 0;
+        QVector<T> rows;
+    };
+
+    int findBlock(qint64 key) const
+    {
+        const int n = m_blocks.size();
+        for (int i = 0; i < n; ++i) {
+            const Block &block = m_blocks[i];
+            if (key >= block.startKey && key < block.startKey + block.rows.size())
+                return i;
+        }
+        return -1;
+    }
+
+    void removeBlock(qint64 startKey)
+    {
+        m_blocks.removeIf([&](const Block &block) { return block.startKey == startKey; });
+    }
+
+private:
+    QVector<Block> m_blocks;
+};
+
+#endif // TABLEROWCACHE_H
@@ -0,0 +1,81 @@
+#ifndef TABLESQLBLOCK_H
+#define TABLESQLBLOCK_H
+
+#include <QSharedPointer>
+#include <QVariant>
+#include <QVector>
+
+#include <sqlite/sqlitestmt.h>
+
+#include "tablerowcache.h"
+
+// Block of rows to fetch: filled in the loader's thread, stored in the model's thread
+class TableSqlBlock
+{
+public:
+    explicit TableSqlBlock(quint32 generation, int startRow, qint64 startKey) :
+        m_generation(generation), m_startRow(startRow), m_startKey(startKey)
+    {
+    }
+    virtual ~TableSqlBlock() = default;
+
+    quint32 generation() const { return m_generation; }
+    int startRow() const { return m_startRow; }
+    qint64 startKey() const { return m_startKey; }
+
+    const QString &sql() const { return m_sql; }
+    void setSql(const QString &v) { m_sql = v; }
+
+    const QVariantHash &vars() const { return m_vars; }
+    void setVars(const QVariantHash &v) { m_vars = v; }
+
+    virtual int rowCount() const = 0;
+
+    virtual void fillRows(SqliteStmt &stmt) = 0;
+    virtual void storeRows() = 0;
+
+private:
+    const quint32 m_generation = 0;
+    const int m_startRow = 0;
+    const qint64 m_startKey = 0;
+
+    QString m_sql;
+    QVariantHash m_vars;
+};
+
+using TableSqlBlockPtr = QSharedPointer<TableSqlBlock>;
+
+Q_DECLARE_METATYPE(TableSqlBlockPtr)
+
+template<typename T, typename F>
+class TableSqlRowBlock : public TableSqlBlock
+{
+public:
+    explicit TableSqlRowBlock(TableRowCache<T> &cache, F fillRow, quint32 generation, int startRow,
+            qint64 startKey) :
+        TableSqlBlock(generation, startRow, startKey), m_cache(cache), m_fillRow(fillRow)
+    {
+    }
+
+    int rowCount() const override { return m_rows.size(); }
+
+    void fillRows(SqliteStmt &stmt) override
+    {
+        m_rows.reserve(TableRowCacheBase::blockSize);
+
+        while (stmt.step() == SqliteStmt::StepRow) {
+            T &row = m_rows.emplace_back();
+            m_fillRow(stmt, row);
+        }
+    }
+
+    void storeRows() override { m_cache.setBlock(startKey(), m_rows); }
+
+private:
+    TableRowCache<T> &m_cache;
+    F m_fillRow;
+
+    QVector<T> m_rows;
+};
+
+#endif // TABLESQLBLOCK_H
@@ -0,0 +1,51 @@
+#include "tablesqljob.h"
+
+#include <sqlite/dbquery.h>
+
+#include <util/worker/workerobject.h>
+
+#include "tablesqlloader.h"
+
+namespace {
+
+TableSqlLoader *workerLoader(WorkerObject &worker)
+{
+    return static_cast<TableSqlLoader *>(worker.manager());
+}
+
+}
+
+TableSqlCountJob::TableSqlCountJob(
+        const QString &sql, const QVariantHash &vars, quint32 generation) :
+    WorkerJob(sql), m_generation(generation), m_vars(vars)
+{
+    setPriority(PriorityHigh);
+}
+
+void TableSqlCountJob::doJob(WorkerObject &worker)
+{
+    m_count = DbQuery(workerLoader(worker)->sqliteDb()).sql(text()).vars(m_vars).execute().toInt();
+}
+
+void TableSqlCountJob::reportResult(WorkerObject &worker)
+{
+    emit workerLoader(worker)->countLoaded(m_generation, m_count);
+}
+
+TableSqlBlockJob::TableSqlBlockJob(const TableSqlBlockPtr &block) :
+    WorkerJob(block->sql()), m_block(block)
+{
+}
+
+void TableSqlBlockJob::doJob(WorkerObject &worker)
+{
+    SqliteStmt stmt;
+    if (DbQuery(workerLoader(worker)->sqliteDb()).sql(text()).vars(m_block->vars()).prepare(stmt)) {
+        m_block->fillRows(stmt);
+    }
+}
+
+void TableSqlBlockJob::reportResult(WorkerObject &worker)
+{
+    emit workerLoader(worker)->blockLoaded(m_block);
+}
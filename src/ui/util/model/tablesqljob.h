@@ -0,0 +1,39 @@
+#ifndef TABLESQLJOB_H
+#define TABLESQLJOB_H
+
+#include <QVariant>
+
+#include <util/worker/workerjob.h>
+
+#include "tablesqlblock.h"
+
+class TableSqlLoader;
+
+class TableSqlCountJob : public WorkerJob
+{
+public:
+    explicit TableSqlCountJob(const QString &sql, const QVariantHash &vars, quint32 generation);
+
+    void doJob(WorkerObject &worker) override;
+    void reportResult(WorkerObject &worker) override;
+
+private:
+    const quint32 m_generation = 0;
+    int m_count = 0;
+
+    QVariantHash m_vars;
+};
+
+class TableSqlBlockJob : public WorkerJob
+{
+public:
+    explicit TableSqlBlockJob(const TableSqlBlockPtr &block);
+
+    void doJob(WorkerObject &worker) override;
+    void reportResult(WorkerObject &worker) override;
+
+private:
+    TableSqlBlockPtr m_block;
+};
+
+#endif // TABLESQLJOB_H
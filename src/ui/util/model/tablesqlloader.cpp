@@ -0,0 +1,66 @@
+#include "tablesqlloader.h"
+
+#include <QLoggingCategory>
+
+#include <sqlite/sqlitedb.h>
+
+#include "tablesqljob.h"
+
+namespace {
+
+const QLoggingCategory LC("util.model.tableSqlLoader");
+
+}
+
+TableSqlLoader::TableSqlLoader(const QString &filePath, QObject *parent) :
+    WorkerManager(parent),
+    m_sqliteDb(new SqliteDb(filePath, SqliteDb::OpenDefaultReadOnly)),
+    m_cancelToken(new WorkerCancelToken())
+{
+    m_sqliteDb->setTuneProfile(SqliteDb::TuneReader);
+
+    setMaxWorkersCount(1); // the connection is used by one thread at a time
+}
+
+TableSqlLoader::~TableSqlLoader()
+{
+    // Stop the worker before closing its connection
+    abortWorkers();
+}
+
+bool TableSqlLoader::open()
+{
+    if (!m_sqliteDb->open()) {
+        qCWarning(LC) << "File open error:" << m_sqliteDb->filePath()
+                      << m_sqliteDb->errorMessage();
+        return false;
+    }
+
+    return true;
+}
+
+void TableSqlLoader::loadCount(const QString &sql, const QVariantHash &vars, quint32 generation)
+{
+    enqueueLoadJob(new TableSqlCountJob(sql, vars, generation));
+}
+
+void TableSqlLoader::loadBlock(const TableSqlBlockPtr &block, WorkerJob::Priority priority)
+{
+    auto job = new TableSqlBlockJob(block);
+    job->setPriority(priority);
+
+    enqueueLoadJob(job);
+}
+
+void TableSqlLoader::cancelJobs()
+{
+    m_cancelToken->cancel();
+    m_cancelToken.reset(new WorkerCancelToken());
+}
+
+void TableSqlLoader::enqueueLoadJob(WorkerJob *job)
+{
+    job->setCancelToken(m_cancelToken);
+
+    enqueueJob(WorkerJobPtr(job));
+}
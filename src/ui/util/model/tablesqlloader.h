@@ -0,0 +1,48 @@
+#ifndef TABLESQLLOADER_H
+#define TABLESQLLOADER_H
+
+#include <sqlite/sqlite_types.h>
+
+#include <util/classhelpers.h>
+#include <util/worker/workerjob.h>
+#include <util/worker/workermanager.h>
+
+#include "tablesqlblock.h"
+
+// Runs the count and row block queries of a table model on its own read-only connection
+class TableSqlLoader : public WorkerManager
+{
+    Q_OBJECT
+
+public:
+    explicit TableSqlLoader(const QString &filePath, QObject *parent = nullptr);
+    ~TableSqlLoader() override;
+    CLASS_DELETE_COPY_MOVE(TableSqlLoader)
+
+    SqliteDb *sqliteDb() const { return m_sqliteDb.data(); }
+
+    QString workerName() const override { return "TableSqlLoader"; }
+
+    bool open();
+
+    void loadCount(const QString &sql, const QVariantHash &vars, quint32 generation);
+    void loadBlock(const TableSqlBlockPtr &block,
+            WorkerJob::Priority priority = WorkerJob::PriorityHigh);
+
+    // Skip the queued jobs of the previous model's generation
+    void cancelJobs();
+
+signals:
+    void countLoaded(quint32 generation, int count);
+    void blockLoaded(const TableSqlBlockPtr &block);
+
+private:
+    void enqueueLoadJob(WorkerJob *job);
+
+private:
+    SqliteDbPtr m_sqliteDb;
+
+    WorkerCancelTokenPtr m_cancelToken;
+};
+
+#endif // TABLESQLLOADER_H
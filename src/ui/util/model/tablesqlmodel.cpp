@@ -4,8 +4,37 @@
 #include <sqlite/sqlitedb.h>
 #include <sqlite/sqlitestmt.h>
 
+#include "tablesqlloader.h"
+
 TableSqlModel::TableSqlModel(QObject *parent) : TableItemModel(parent) { }
 
+TableSqlModel::~TableSqlModel()
+{
+    // Stop the loader before the row caches are destroyed
+    delete m_loader;
+}
+
+void TableSqlModel::setupAsyncLoading()
+{
+    if (m_loader)
+        return;
+
+    const QString filePath = sqliteDb()->filePath();
+    if (filePath.isEmpty() || filePath.startsWith(':')) // in-memory database
+        return;
+
+    auto loader = new TableSqlLoader(filePath, this);
+    if (!loader->open()) {
+        delete loader;
+        return;
+    }
+
+    connect(loader, &TableSqlLoader::countLoaded, this, &TableSqlModel::onSqlCountLoaded);
+    connect(loader, &TableSqlLoader::blockLoaded, this, &TableSqlModel::onRowBlockLoaded);
+
+    m_loader = loader;
+}
+
 int TableSqlModel::rowCount(const QModelIndex & /*parent*/) const
 {
     if (m_sqlRowCount < 0) {
@@ -17,24 +46,82 @@ int TableSqlModel::rowCount(const QModelIndex & /*parent*/) const
 
 void TableSqlModel::sort(int column, Qt::SortOrder order)
 {
-    if (m_sortColumn != column || m_sortOrder != order) {
-        m_sortColumn = column;
-        m_sortOrder = order;
+    if (m_sortColumn == column && m_sortOrder == order)
+        return;
 
-        reset();
-    }
+    m_sortColumn = column;
+    m_sortOrder = order;
+
+    beginResetModel();
+
+    // Sorting keeps the rows count
+    const int rowCount = sqlRowCount();
+    const quint32 countGeneration = m_countGeneration;
+
+    invalidateRowCache();
+
+    setSqlRowCount(rowCount);
+    m_countGeneration = countGeneration;
+
+    endResetModel();
 }
 
 void TableSqlModel::invalidateRowCache() const
 {
     setSqlRowCount(-1);
     TableItemModel::invalidateRowCache();
+
+    TableRowCacheBase *cache = rowCache();
+    if (cache) {
+        cache->clear();
+    }
+
+    // Drop the rows being loaded
+    ++m_countGeneration;
+    ++m_loadGeneration;
+    m_loadingBlockKeys.clear();
+
+    if (loader()) {
+        loader()->cancelJobs();
+    }
 }
 
 void TableSqlModel::fillQueryVarsForRow(QVariantHash &vars, int row) const
 {
     fillQueryVars(vars);
-    vars.insert(":offset", row);
+
+    if (rowCache()) {
+        vars.insert(":offset", TableRowCacheBase::blockStart(row));
+        vars.insert(":limit", TableRowCacheBase::blockSize);
+    } else {
+        vars.insert(":offset", row);
+        vars.insert(":limit", 1);
+    }
+}
+
+bool TableSqlModel::fetchRowBlock(const TableSqlBlockPtr &block) const
+{
+    SqliteStmt stmt;
+    if (!DbQuery(sqliteDb()).sql(block->sql()).vars(block->vars()).prepare(stmt))
+        return false;
+
+    block->fillRows(stmt);
+    block->storeRows();
+
+    return true;
+}
+
+void TableSqlModel::loadRowBlock(
+        const TableSqlBlockPtr &block, WorkerJob::Priority priority) const
+{
+    m_loadingBlockKeys.insert(block->startKey());
+
+    loader()->loadBlock(block, priority);
+}
+
+bool TableSqlModel::isRowBlockLoading(int row) const
+{
+    return m_loadingBlockKeys.contains(rowCacheKey(TableRowCacheBase::blockStart(row)));
 }
 
 int TableSqlModel::doSqlCount() const
@@ -42,6 +129,11 @@ int TableSqlModel::doSqlCount() const
     QVariantHash vars;
     fillQueryVars(vars);
 
+    if (loader()) {
+        loader()->loadCount(sqlCount(), vars, m_countGeneration);
+        return m_loadedRowCount;
+    }
+
     return DbQuery(sqliteDb()).sql(sqlCount()).vars(vars).execute().toInt();
 }
 
@@ -80,5 +172,49 @@ QString TableSqlModel::sqlOrderColumn() const
 
 QString TableSqlModel::sqlLimitOffset() const
 {
-    return " LIMIT 1 OFFSET :offset";
+    return " LIMIT :limit OFFSET :offset";
+}
+
+void TableSqlModel::onSqlCountLoaded(quint32 generation, int count)
+{
+    if (generation != m_countGeneration)
+        return;
+
+    m_loadedRowCount = count;
+
+    const int oldCount = sqlRowCount();
+    if (count == oldCount)
+        return;
+
+    if (count > oldCount) {
+        beginInsertRows({}, oldCount, count - 1);
+        setSqlRowCount(count);
+        endInsertRows();
+    } else {
+        beginRemoveRows({}, count, oldCount - 1);
+        setSqlRowCount(count);
+        endRemoveRows();
+    }
+}
+
+void TableSqlModel::onRowBlockLoaded(const TableSqlBlockPtr &block)
+{
+    if (block->generation() != loadGeneration())
+        return;
+
+    m_loadingBlockKeys.remove(block->startKey());
+
+    if (block->rowCount() == 0)
+        return;
+
+    block->storeRows();
+
+    tableRow().invalidate();
+
+    const int startRow = block->startRow();
+    const int endRow = qMin(startRow + block->rowCount(), sqlRowCount()) - 1;
+    if (endRow < startRow)
+        return;
+
+    emit dataChanged(index(startRow, 0), index(endRow, columnCount() - 1));
 }
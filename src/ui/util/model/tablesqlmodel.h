@@ -1,9 +1,17 @@
 #ifndef TABLESQLMODEL_H
 #define TABLESQLMODEL_H
 
+#include <QSet>
+
 #include <sqlite/sqlite_types.h>
 
+#include <util/worker/workerjob.h>
+
 #include "tableitemmodel.h"
+#include "tablerowcache.h"
+#include "tablesqlblock.h"
+
+class TableSqlLoader;
 
 class TableSqlModel : public TableItemModel
 {
@@ -11,9 +19,15 @@ class TableSqlModel : public TableItemModel
 
 public:
     explicit TableSqlModel(QObject *parent = nullptr);
+    ~TableSqlModel() override;
 
     virtual SqliteDb *sqliteDb() const = 0;
 
+    TableSqlLoader *loader() const { return m_loader; }
+
+    // Load the rows in a worker, when the database is not in memory
+    void setupAsyncLoading();
+
     int rowCount(const QModelIndex &parent = QModelIndex()) const override;
 
     void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
@@ -23,6 +37,23 @@ protected:
 
     void fillQueryVarsForRow(QVariantHash &vars, int row) const override;
 
+    virtual TableRowCacheBase *rowCache() const { return nullptr; }
+    virtual qint64 rowCacheKey(int row) const { return row; }
+
+    template<typename T, typename F>
+    bool updateTableRowCached(TableRowCache<T> &cache, int row, T &tableRow, F fillRow) const;
+
+    template<typename T, typename F>
+    TableSqlBlockPtr createRowBlock(TableRowCache<T> &cache, int row, F fillRow) const;
+
+    template<typename T, typename F>
+    void prefetchRowBlock(TableRowCache<T> &cache, int row, bool forward, F fillRow) const;
+
+    bool fetchRowBlock(const TableSqlBlockPtr &block) const;
+    void loadRowBlock(const TableSqlBlockPtr &block,
+            WorkerJob::Priority priority = WorkerJob::PriorityHigh) const;
+    bool isRowBlockLoading(int row) const;
+
     virtual int doSqlCount() const;
     virtual QString sqlCount() const;
 
@@ -43,11 +74,123 @@ protected:
     int sqlRowCount() const { return m_sqlRowCount; }
     void setSqlRowCount(int v) const { m_sqlRowCount = v; }
 
+    quint32 loadGeneration() const { return m_loadGeneration; }
+
+private:
+    void onSqlCountLoaded(quint32 generation, int count);
+    void onRowBlockLoaded(const TableSqlBlockPtr &block);
+
 private:
     int m_sortColumn = -1;
     Qt::SortOrder m_sortOrder = Qt::AscendingOrder;
 
     mutable int m_sqlRowCount = -1;
+    mutable int m_lastCachedRow = -1;
+
+    // Shown while the rows are counted by the loader
+    int m_loadedRowCount = 0;
+
+    mutable quint32 m_countGeneration = 0;
+    mutable quint32 m_loadGeneration = 0;
+
+    mutable QSet<qint64> m_loadingBlockKeys;
+
+    TableSqlLoader *m_loader = nullptr;
 };
 
+template<typename T, typename F>
+bool TableSqlModel::updateTableRowCached(
+        TableRowCache<T> &cache, int row, T &tableRow, F fillRow) const
+{
+    const qint64 key = rowCacheKey(row);
+
+    if (!cache.contains(key)) {
+        if (loader()) {
+            // Show a placeholder until the block is loaded
+            tableRow = T();
+
+            if (!isRowBlockLoading(row)) {
+                loadRowBlock(createRowBlock(cache, row, fillRow));
+            }
+            return false;
+        }
+
+        if (!fetchRowBlock(createRowBlock(cache, row, fillRow)))
+            return false;
+    }
+
+    const T *cachedRow = cache.row(key);
+    if (!cachedRow)
+        return false;
+
+    tableRow = *cachedRow;
+
+    const int lastRow = m_lastCachedRow;
+    m_lastCachedRow = row;
+
+    if (lastRow != -1 && lastRow != row) {
+        prefetchRowBlock(cache, row, /*forward=*/row > lastRow, fillRow);
+    }
+
+    return true;
+}
+
+template<typename T, typename F>
+TableSqlBlockPtr TableSqlModel::createRowBlock(TableRowCache<T> &cache, int row, F fillRow) const
+{
+    const int startRow = TableRowCacheBase::blockStart(row);
+
+    QVariantHash vars;
+    fillQueryVarsForRow(vars, startRow);
+
+    TableSqlBlockPtr block(new TableSqlRowBlock<T, F>(
+            cache, fillRow, loadGeneration(), startRow, rowCacheKey(startRow)));
+    block->setSql(sql());
+    block->setVars(vars);
+
+    return block;
+}
+
+template<typename T, typename F>
+void TableSqlModel::prefetchRowBlock(
+        TableRowCache<T> &cache, int row, bool forward, F fillRow) const
+{
+    constexpr int edgeSize = TableRowCacheBase::blockSize / 4;
+
+    const int startRow = TableRowCacheBase::blockStart(row);
+    const int blockRow = row - startRow;
+
+    // Fetch the neighbour block in the scroll direction, when the row is near the block's edge
+    int nextRow = -1;
+    if (forward) {
+        if (blockRow >= TableRowCacheBase::blockSize - edgeSize) {
+            nextRow = startRow + TableRowCacheBase::blockSize;
+        }
+    } else if (blockRow < edgeSize) {
+        nextRow = startRow - 1;
+    }
+
+    if (nextRow < 0 || nextRow >= sqlRowCount() || cache.contains(rowCacheKey(nextRow)))
+        return;
+
+    if (loader()) {
+        if (!isRowBlockLoading(nextRow)) {
+            loadRowBlock(createRowBlock(cache, nextRow, fillRow), WorkerJob::PriorityNormal);
+        }
+        return;
+    }
+
+    const quint32 generation = loadGeneration();
+
+    QMetaObject::invokeMethod(
+            const_cast<TableSqlModel *>(this),
+            [=, this, &cache] {
+                if (loadGeneration() != generation || cache.contains(rowCacheKey(nextRow)))
+                    return;
+
+                fetchRowBlock(createRowBlock(cache, nextRow, fillRow));
+            },
+            Qt::QueuedConnection);
+}
+
 #endif // TABLESQLMODEL_H
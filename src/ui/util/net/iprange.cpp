@@ -16,37 +16,135 @@ inline bool checkIp6MaskBitsCount(const int nbits)
     return (nbits >= 0 && nbits <= 128);
 }
 
-bool compareLessIp6(const ip6_addr_t &l, const ip6_addr_t &r)
+int compareIp4(quint32 l, quint32 r)
 {
-    return memcmp(&l, &r, sizeof(ip6_addr_t)) < 0;
+    return (l < r) ? -1 : (l > r);
 }
 
-void sortIp6Array(ip6_arr_t &array)
+int compareIp6(const ip6_addr_t &l, const ip6_addr_t &r)
 {
-    std::sort(array.begin(), array.end(), compareLessIp6);
+    return memcmp(&l, &r, sizeof(ip6_addr_t));
 }
 
-void sortIp6PairArray(ip6_arr_t &fromArray, ip6_arr_t &toArray)
+// Set difference of sorted addresses (or address pairs, when the "to" arrays are given)
+template<typename T, typename Compare>
+void arrayDifference(const QVector<T> &fromArray, const QVector<T> *toArray,
+        const QVector<T> &otherFromArray, const QVector<T> *otherToArray, QVector<T> &outFromArray,
+        QVector<T> *outToArray, Compare compare)
 {
-    Q_ASSERT(fromArray.size() == toArray.size());
+    const auto compareAt = [&](int i, int j) {
+        const int res = compare(otherFromArray[j], fromArray[i]);
+        return (res != 0 || !toArray) ? res : compare((*otherToArray)[j], (*toArray)[i]);
+    };
 
     const int arraySize = fromArray.size();
+    const int otherSize = otherFromArray.size();
 
-    ip6_pair_arr_t pairArray;
-    pairArray.reserve(arraySize);
-
+    int j = 0;
     for (int i = 0; i < arraySize; ++i) {
-        pairArray.append(Ip6Pair { fromArray[i], toArray[i] });
+        while (j < otherSize && compareAt(i, j) < 0) {
+            ++j;
+        }
+
+        if (j < otherSize && compareAt(i, j) == 0) {
+            ++j;
+            continue;
+        }
+
+        outFromArray.append(fromArray[i]);
+        if (toArray) {
+            outToArray->append((*toArray)[i]);
+        }
     }
+}
 
-    std::sort(pairArray.begin(), pairArray.end(),
-            [](const Ip6Pair &l, const Ip6Pair &r) { return compareLessIp6(l.from, r.from); });
+template<typename T>
+struct IpInterval
+{
+    T from, to;
+};
 
-    for (int i = 0; i < arraySize; ++i) {
-        const Ip6Pair &pair = pairArray[i];
-        fromArray[i] = pair.from;
-        toArray[i] = pair.to;
+// Merge the addresses and overlapping or adjacent pairs into the minimal sorted disjoint set
+template<typename T, typename Compare, typename Next>
+void arrayMerge(
+        QVector<T> &ipArray, QVector<T> &fromArray, QVector<T> &toArray, Compare compare, Next next)
+{
+    Q_ASSERT(fromArray.size() == toArray.size());
+
+    const int pairSize = fromArray.size();
+
+    QVector<IpInterval<T>> intervals;
+    intervals.reserve(ipArray.size() + pairSize);
+
+    for (const T &ip : std::as_const(ipArray)) {
+        intervals.append(IpInterval<T> { ip, ip });
+    }
+
+    for (int i = 0; i < pairSize; ++i) {
+        intervals.append(IpInterval<T> { fromArray[i], toArray[i] });
+    }
+
+    std::sort(intervals.begin(), intervals.end(),
+            [&](const IpInterval<T> &l, const IpInterval<T> &r) {
+                return compare(l.from, r.from) < 0;
+            });
+
+    ipArray.clear();
+    fromArray.clear();
+    toArray.clear();
+
+    const auto appendInterval = [&](const IpInterval<T> &ip) {
+        if (compare(ip.from, ip.to) == 0) {
+            ipArray.append(ip.from);
+        } else {
+            fromArray.append(ip.from);
+            toArray.append(ip.to);
+        }
+    };
+
+    const int intervalsSize = intervals.size();
+    if (intervalsSize == 0)
+        return;
+
+    IpInterval<T> prevIp = intervals[0];
+
+    for (int i = 1; i < intervalsSize; ++i) {
+        const IpInterval<T> &ip = intervals[i];
+
+        T nextIp;
+        const bool isMerge = compare(ip.from, prevIp.to) <= 0
+                || (next(prevIp.to, nextIp) && compare(ip.from, nextIp) == 0);
+
+        if (isMerge) {
+            if (compare(ip.to, prevIp.to) > 0) {
+                prevIp.to = ip.to;
+            }
+        } else {
+            appendInterval(prevIp);
+            prevIp = ip;
+        }
     }
+
+    appendInterval(prevIp);
+}
+
+bool nextIp4(quint32 ip, quint32 &next)
+{
+    next = ip + 1;
+    return next != 0;
+}
+
+bool nextIp6(const ip6_addr_t &ip, ip6_addr_t &next)
+{
+    next = ip;
+
+    // Addresses are in network byte order
+    for (int i = sizeof(next.data) - 1; i >= 0; --i) {
+        if (++next.data[i] != 0)
+            return true;
+    }
+
+    return false; // overflow
 }
 
 }
@@ -84,6 +182,27 @@ bool IpRange::isEmpty() const
     return ip4Size() == 0 && pair4Size() == 0 && ip6Size() == 0 && pair6Size() == 0;
 }
 
+void IpRange::difference(const IpRange &other, IpRange &result) const
+{
+    result.clear();
+
+    arrayDifference(m_ip4Array, nullptr, other.ip4Array(), nullptr, result.ip4Array(), nullptr,
+            compareIp4);
+    arrayDifference(m_pair4FromArray, &m_pair4ToArray, other.pair4FromArray(),
+            &other.pair4ToArray(), result.pair4FromArray(), &result.pair4ToArray(), compareIp4);
+
+    arrayDifference(m_ip6Array, nullptr, other.ip6Array(), nullptr, result.ip6Array(), nullptr,
+            compareIp6);
+    arrayDifference(m_pair6FromArray, &m_pair6ToArray, other.pair6FromArray(),
+            &other.pair6ToArray(), result.pair6FromArray(), &result.pair6ToArray(), compareIp6);
+}
+
+void IpRange::optimize()
+{
+    arrayMerge(m_ip4Array, m_pair4FromArray, m_pair4ToArray, compareIp4, nextIp4);
+    arrayMerge(m_ip6Array, m_pair6FromArray, m_pair6ToArray, compareIp6, nextIp6);
+}
+
 QString IpRange::toText() const
 {
     QString text;
@@ -146,8 +265,7 @@ bool IpRange::fromList(const StringViewList &list, bool sort)
     fillIp4Range(ip4RangeMap, pair4Size);
 
     if (sort) {
-        sortIp6Array(m_ip6Array);
-        sortIp6PairArray(m_pair6FromArray, m_pair6ToArray);
+        optimize();
     }
 
     return true;
@@ -198,7 +316,13 @@ IpRange::ParseError IpRange::parseIp4Address(const QStringView &ip, const QStrin
     if (err != ErrorOk)
         return err;
 
-    ip4RangeMap.insert(from, to);
+    // keep the widest range for the same start address
+    auto it = ip4RangeMap.find(from);
+    if (it == ip4RangeMap.end()) {
+        ip4RangeMap.insert(from, to);
+    } else if (to > it.value()) {
+        it.value() = to;
+    }
 
     if (from != to) {
         ++pair4Size;
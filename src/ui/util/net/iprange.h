@@ -78,6 +78,14 @@ public:
 
     bool isEmpty() const;
 
+    int size() const { return ip4Size() + pair4Size() + ip6Size() + pair6Size(); }
+
+    // Normalize into the minimal sorted set of disjoint addresses and pairs
+    void optimize();
+
+    // Addresses of this sorted range, which are not in the other one
+    void difference(const IpRange &other, IpRange &result) const;
+
     QString toText() const;
 
     // Parse IP ranges
@@ -1,6 +1,7 @@
 #ifndef WORKER_TYPES_H
 #define WORKER_TYPES_H
 
+#include <QAtomicInt>
 #include <QSharedPointer>
 
 class WorkerJob;
@@ -9,4 +10,29 @@ class WorkerManager;
 
 using WorkerJobPtr = QSharedPointer<WorkerJob>;
 
+// Shared by the jobs to cancel them at once
+class WorkerCancelToken
+{
+public:
+    bool isCanceled() const { return m_canceled.loadRelaxed() != 0; }
+    void cancel() { m_canceled.storeRelaxed(1); }
+
+private:
+    QAtomicInt m_canceled;
+};
+
+using WorkerCancelTokenPtr = QSharedPointer<WorkerCancelToken>;
+
+struct WorkerStats
+{
+    quint64 enqueuedCount = 0;
+    quint64 mergedCount = 0;
+    quint64 canceledCount = 0;
+    quint64 processedCount = 0;
+
+    // Time from the enqueue to the dequeue of processed jobs
+    qint64 queueLatencyUsec = 0;
+    qint64 maxQueueLatencyUsec = 0;
+};
+
 #endif // WORKER_TYPES_H
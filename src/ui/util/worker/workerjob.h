@@ -1,6 +1,7 @@
 #ifndef WORKERJOB_H
 #define WORKERJOB_H
 
+#include <QElapsedTimer>
 #include <QObject>
 
 #include <util/classhelpers.h>
@@ -10,11 +11,28 @@
 class WorkerJob
 {
 public:
+    enum Priority : qint8 {
+        PriorityLow = 0, // Background maintenance
+        PriorityNormal,
+        PriorityHigh, // User visible lookups
+        PriorityCount
+    };
+
     explicit WorkerJob(const QString &text = {});
     virtual ~WorkerJob() = default;
 
     const QString &text() const { return m_text; }
 
+    Priority priority() const { return m_priority; }
+    void setPriority(Priority v) { m_priority = v; }
+
+    const WorkerCancelTokenPtr &cancelToken() const { return m_cancelToken; }
+    void setCancelToken(const WorkerCancelTokenPtr &v) { m_cancelToken = v; }
+
+    bool isCanceled() const { return m_cancelToken && m_cancelToken->isCanceled(); }
+
+    QElapsedTimer &queueTimer() { return m_queueTimer; }
+
     virtual bool mergeJob(const WorkerJob &job)
     {
         Q_UNUSED(job);
@@ -25,7 +43,13 @@ public:
     virtual void reportResult(WorkerObject &worker) { Q_UNUSED(worker); }
 
 private:
+    Priority m_priority = PriorityNormal;
+
     const QString m_text;
+
+    WorkerCancelTokenPtr m_cancelToken;
+
+    QElapsedTimer m_queueTimer;
 };
 
 #endif // WORKERJOB_H
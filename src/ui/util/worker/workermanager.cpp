@@ -24,7 +24,7 @@ void WorkerManager::setupWorker()
     WorkerObject *worker = createWorker(); // autoDelete = true
     m_workers.append(worker);
 
-    QThreadPool::globalInstance()->start(worker);
+    threadPool()->start(worker);
 }
 
 bool WorkerManager::checkNewWorkerNeeded() const
@@ -34,12 +34,15 @@ bool WorkerManager::checkNewWorkerNeeded() const
     if (workersCount == 0)
         return true;
 
-    return workersCount < maxWorkersCount() && !m_jobQueue.isEmpty();
+    return workersCount < maxWorkersCount() && m_jobCount > 0;
 }
 
 void WorkerManager::clearJobQueue()
 {
-    m_jobQueue.clear();
+    for (auto &jobQueue : m_jobQueues) {
+        jobQueue.clear();
+    }
+    m_jobCount = 0;
 }
 
 void WorkerManager::workerFinished(WorkerObject *worker)
@@ -48,7 +51,7 @@ void WorkerManager::workerFinished(WorkerObject *worker)
 
     m_workers.removeOne(worker);
 
-    if (m_workers.isEmpty() && aborted()) {
+    if (m_workers.isEmpty() && (aborted() || m_finishing)) {
         m_abortWaitCondition.wakeOne();
     }
 }
@@ -58,19 +61,64 @@ WorkerObject *WorkerManager::createWorker()
     return new WorkerObject(this);
 }
 
+QThreadPool *WorkerManager::threadPool() const
+{
+    return QThreadPool::globalInstance();
+}
+
 int WorkerManager::jobCount() const
 {
     QMutexLocker locker(&m_mutex);
 
-    return m_jobQueue.size();
+    return m_jobCount;
+}
+
+WorkerStats WorkerManager::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    return m_stats;
 }
 
 bool WorkerManager::mergeJob(WorkerJobPtr job)
 {
-    if (!canMergeJobs() || m_jobQueue.isEmpty())
+    if (!canMergeJobs())
+        return false;
+
+    const auto &jobQueue = m_jobQueues[job->priority()];
+    if (jobQueue.isEmpty())
         return false;
 
-    return m_jobQueue.last()->mergeJob(*job);
+    const WorkerJobPtr &lastJob = jobQueue.last();
+
+    return !lastJob->isCanceled() && lastJob->mergeJob(*job);
+}
+
+WorkerJobPtr WorkerManager::takeJob()
+{
+    for (int priority = WorkerJob::PriorityCount; --priority >= 0;) {
+        auto &jobQueue = m_jobQueues[priority];
+
+        while (!jobQueue.isEmpty()) {
+            WorkerJobPtr job = jobQueue.dequeue();
+            --m_jobCount;
+
+            if (job->isCanceled()) {
+                ++m_stats.canceledCount;
+                continue;
+            }
+
+            const qint64 latencyUsec = job->queueTimer().nsecsElapsed() / 1000;
+
+            m_stats.queueLatencyUsec += latencyUsec;
+            m_stats.maxQueueLatencyUsec = qMax(m_stats.maxQueueLatencyUsec, latencyUsec);
+            ++m_stats.processedCount;
+
+            return job;
+        }
+    }
+
+    return nullptr;
 }
 
 void WorkerManager::clear()
@@ -95,6 +143,22 @@ void WorkerManager::abortWorkers()
     }
 }
 
+void WorkerManager::finishWorkers()
+{
+    QMutexLocker locker(&m_mutex);
+
+    // Process the queued jobs and stop
+    m_finishing = true;
+
+    m_jobWaitCondition.wakeAll();
+
+    while (!m_workers.isEmpty()) {
+        m_abortWaitCondition.wait(&m_mutex);
+    }
+
+    m_aborted = true;
+}
+
 void WorkerManager::enqueueJob(WorkerJobPtr job)
 {
     QMutexLocker locker(&m_mutex);
@@ -104,10 +168,17 @@ void WorkerManager::enqueueJob(WorkerJobPtr job)
 
     setupWorker();
 
-    if (mergeJob(job))
+    ++m_stats.enqueuedCount;
+
+    if (mergeJob(job)) {
+        ++m_stats.mergedCount;
         return;
+    }
+
+    job->queueTimer().start();
 
-    m_jobQueue.enqueue(job);
+    m_jobQueues[job->priority()].enqueue(job);
+    ++m_jobCount;
 
     m_jobWaitCondition.wakeOne();
 }
@@ -116,13 +187,19 @@ WorkerJobPtr WorkerManager::dequeueJob()
 {
     QMutexLocker locker(&m_mutex);
 
-    while (!aborted() && m_jobQueue.isEmpty()) {
-        if (!m_jobWaitCondition.wait(&m_mutex, WORKER_TIMEOUT_MSEC))
-            break; // timed out
-    }
+    for (;;) {
+        while (!aborted() && !m_finishing && m_jobCount == 0) {
+            if (!m_jobWaitCondition.wait(&m_mutex, WORKER_TIMEOUT_MSEC))
+                break; // timed out
+        }
 
-    if (aborted() || m_jobQueue.isEmpty())
-        return nullptr;
+        if (aborted() || m_jobCount == 0)
+            return nullptr;
 
-    return m_jobQueue.dequeue();
+        WorkerJobPtr job = takeJob();
+        if (job)
+            return job;
+
+        // The queued jobs were canceled
+    }
 }
@@ -10,7 +10,9 @@
 
 #include <util/classhelpers.h>
 
-#include "worker_types.h"
+#include "workerjob.h"
+
+QT_FORWARD_DECLARE_CLASS(QThreadPool)
 
 class WorkerManager : public QObject
 {
@@ -28,9 +30,12 @@ public:
 
     virtual QString workerName() const { return QString(); }
 
+    WorkerStats stats() const;
+
 public slots:
     void clear();
     void abortWorkers();
+    void finishWorkers();
 
     void enqueueJob(WorkerJobPtr job);
     WorkerJobPtr dequeueJob();
@@ -39,12 +44,15 @@ public slots:
 
 protected:
     virtual WorkerObject *createWorker();
+    virtual QThreadPool *threadPool() const;
     virtual bool canMergeJobs() const { return false; }
 
     int jobCount() const;
 
     bool mergeJob(WorkerJobPtr job);
 
+    WorkerJobPtr takeJob();
+
 private:
     void setupWorker();
 
@@ -54,12 +62,18 @@ private:
 
 private:
     volatile bool m_aborted = false;
+    volatile bool m_finishing = false;
 
     int m_maxWorkersCount = 0;
 
     QList<WorkerObject *> m_workers;
 
-    QQueue<WorkerJobPtr> m_jobQueue;
+    int m_jobCount = 0;
+
+    // Dequeued by the higher priority first
+    QQueue<WorkerJobPtr> m_jobQueues[WorkerJob::PriorityCount];
+
+    WorkerStats m_stats;
 
     mutable QMutex m_mutex;
     QWaitCondition m_jobWaitCondition;
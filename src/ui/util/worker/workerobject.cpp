@@ -33,7 +33,7 @@ void WorkerObject::doJob(WorkerJob &job)
 {
     job.doJob(*this);
 
-    if (!manager()->aborted()) {
+    if (!manager()->aborted() && !job.isCanceled()) {
         job.reportResult(*this);
     }
 }